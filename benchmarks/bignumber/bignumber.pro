@@ -0,0 +1,20 @@
+QT -= gui
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/utilites/BigNumber.cpp \
+    ../../src/utilites/BigNumber256.cpp
+
+
+HEADERS += \
+    ../../src/utilites/BigNumber.h \
+    ../../src/utilites/BigNumber256.h
+
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
@@ -0,0 +1,99 @@
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include "utilites/BigNumber.h"
+#include "utilites/BigNumber256.h"
+
+static const int countValues = 1000;
+
+void calcTime(const QString &name, std::function<void()> func, int nmax = 20)
+{
+    qreal time = 0.0;
+    for (int n = 0; n < nmax; n++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        func();
+        std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+        time += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    }
+    time /= nmax;
+    time /= 1000000.0;
+
+    qDebug() << name << QString::number(time, 'f', 6) << "s";
+}
+
+static std::vector<QByteArray> makeValues()
+{
+    std::vector<QByteArray> values;
+    for (int i = 0; i < countValues; i++) {
+        values.emplace_back(QByteArray::number(1000000000000000000ULL + i * 7919ULL) + QByteArray::number(i * 104729));
+    }
+    return values;
+}
+
+// Mirrors BalanceInfo::calcBalance and balance merge in Transactions::newBalance
+template<class Number>
+static void calcBalances(const std::vector<Number> &numbers)
+{
+    Number sum;
+    for (size_t i = 0; i + 2 < numbers.size(); i++) {
+        const Number balance = numbers[i] - numbers[i + 1] - numbers[i + 2];
+        sum += balance;
+    }
+    volatile bool isNegative = sum.isNegative();
+    Q_UNUSED(isNegative);
+}
+
+template<class Number>
+static void parseValues(const std::vector<QByteArray> &values)
+{
+    std::vector<Number> numbers;
+    numbers.reserve(values.size());
+    for (const QByteArray &value: values) {
+        numbers.emplace_back(value);
+    }
+}
+
+template<class Number>
+static void printValues(const std::vector<Number> &numbers)
+{
+    for (const Number &number: numbers) {
+        volatile int size = number.getDecimal().size();
+        Q_UNUSED(size);
+    }
+}
+
+template<class Number>
+static void copyBalances(const std::vector<Number> &numbers)
+{
+    for (int n = 0; n < 10; n++) {
+        std::vector<Number> copy(numbers);
+        volatile bool isZero = copy.back().isZero();
+        Q_UNUSED(isZero);
+    }
+}
+
+template<class Number>
+static void runAll(const QString &name, const std::vector<QByteArray> &values)
+{
+    std::vector<Number> numbers(values.begin(), values.end());
+    calcTime(name + " parse", std::bind(parseValues<Number>, std::cref(values)));
+    calcTime(name + " arithmetic", std::bind(calcBalances<Number>, std::cref(numbers)));
+    calcTime(name + " getDecimal", std::bind(printValues<Number>, std::cref(numbers)));
+    calcTime(name + " copy", std::bind(copyBalances<Number>, std::cref(numbers)));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const std::vector<QByteArray> values = makeValues();
+
+    runAll<BigNumber>("BigNumber", values);
+    runAll<BigNumber256>("BigNumber256", values);
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+QT -= gui
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/Wallets/BtcCoinSelection.cpp
+
+
+HEADERS += \
+    ../../src/Wallets/BtcCoinSelection.h \
+    ../../src/Wallets/BtcWallet.h
+
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
@@ -0,0 +1,117 @@
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <chrono>
+#include <functional>
+#include <random>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "Wallets/BtcWallet.h"
+#include "Wallets/BtcCoinSelection.h"
+
+using namespace wallets;
+
+// 20 satoshi per byte
+static const uint64_t FEE_PER_INPUT = 148 * 20;
+static const uint64_t COST_OF_CHANGE = 34 * 20;
+static const uint64_t BASE_FEE = 78 * 20;
+
+void calcTime(const QString &name, std::function<void()> func, int nmax = 5)
+{
+    qreal time = 0.0;
+    for (int n = 0; n < nmax; n++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        func();
+        std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+        time += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    }
+    time /= nmax;
+    time /= 1000.0;
+
+    qDebug() << name << QString::number(time, 'f', 3) << "ms";
+}
+
+// Selection of BtcWallet before the coin selection
+static std::vector<BtcInput> greedyAlg(const std::vector<BtcInput> &elements, uint64_t allValue) {
+    std::vector<BtcInput> sortedVect(elements.begin(), elements.end());
+    std::sort(sortedVect.begin(), sortedVect.end());
+    std::vector<BtcInput> result;
+    uint64_t currValue = 0;
+    while (currValue < allValue && !sortedVect.empty()) {
+        auto foundIter = std::lower_bound(sortedVect.begin(), sortedVect.end(), BtcInput(allValue - currValue));
+        if (foundIter == sortedVect.end()) {
+            foundIter--;
+        }
+        currValue += foundIter->outBalance;
+        result.emplace_back(*foundIter);
+        sortedVect.erase(foundIter);
+    }
+    return result;
+}
+
+// Balances from 10 000 to 100 000 000 satoshi, uniform on the log scale
+static std::vector<BtcInput> generateUtxos(size_t count) {
+    std::mt19937_64 random(count);
+    std::uniform_real_distribution<double> distribution(4.0, 8.0);
+    std::vector<BtcInput> utxos;
+    for (size_t i = 0; i < count; i++) {
+        BtcInput input;
+        input.spendtxid = std::to_string(i);
+        input.spendoutnum = 0;
+        input.outBalance = (uint64_t)std::pow(10.0, distribution(random));
+        utxos.emplace_back(input);
+    }
+    return utxos;
+}
+
+static void testSet(const std::vector<BtcInput> &utxos, uint64_t value) {
+    CoinSelectionParams params;
+    params.target = value + BASE_FEE;
+    params.feePerInput = FEE_PER_INPUT;
+    params.costOfChange = COST_OF_CHANGE;
+
+    qDebug() << "utxos" << utxos.size() << "value" << value;
+
+    std::vector<BtcInput> greedy;
+    calcTime("greedy", [&]{
+        greedy = greedyAlg(utxos, value + BASE_FEE);
+    });
+    uint64_t greedyValue = 0;
+    for (const BtcInput &input: greedy) {
+        greedyValue += input.outBalance;
+    }
+    qDebug() << "    inputs" << greedy.size() << "value" << greedyValue;
+
+    for (const CoinSelectionAlgorithm algorithm: {CoinSelectionAlgorithm::BranchAndBound, CoinSelectionAlgorithm::Knapsack, CoinSelectionAlgorithm::LargestFirst, CoinSelectionAlgorithm::Auto}) {
+        CoinSelectionResult result;
+        bool isFound = false;
+        calcTime(coinSelectionAlgorithmName(algorithm), [&]{
+            isFound = selectCoins(utxos, params, algorithm, result);
+        });
+        if (isFound) {
+            qDebug() << "    inputs" << result.indexes.size() << "value" << result.value << "excess" << (result.effectiveValue - params.target) << "waste" << result.waste << coinSelectionAlgorithmName(result.algorithm);
+        } else {
+            qDebug() << "    not found";
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    for (const size_t count: {1000, 10000, 100000}) {
+        const std::vector<BtcInput> utxos = generateUtxos(count);
+        uint64_t sum = 0;
+        for (const BtcInput &input: utxos) {
+            sum += input.outBalance;
+        }
+
+        testSet(utxos, 123456789);
+        testSet(utxos, sum / 2);
+    }
+
+    return 0;
+}
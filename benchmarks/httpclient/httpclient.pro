@@ -0,0 +1,26 @@
+QT -= gui
+QT += network
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/Network/HttpClient.cpp \
+    ../../src/TypedException.cpp \
+    ../../src/qt_utilites/QRegister.cpp \
+    ../../tests/LogMock.cpp
+
+
+HEADERS += \
+    ../../src/Network/HttpClient.h \
+    ../../src/TypedException.h \
+    ../../src/qt_utilites/QRegister.h \
+    ../../src/Log.h
+
+QMAKE_LFLAGS += -rdynamic
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
@@ -0,0 +1,119 @@
+#include <QCoreApplication>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QEventLoop>
+#include <QDebug>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#include "Network/HttpClient.h"
+#include "TypedException.h"
+
+// Answers every POST with its body. Connection stays open until client asks to close it
+class EchoServer : public QTcpServer {
+protected:
+    void incomingConnection(qintptr handle) override {
+        QTcpSocket *socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(handle);
+        std::shared_ptr<QByteArray> buffer = std::make_shared<QByteArray>();
+        QObject::connect(socket, &QTcpSocket::readyRead, [socket, buffer]{
+            *buffer += socket->readAll();
+            while (true) {
+                const int headerEnd = buffer->indexOf("\r\n\r\n");
+                if (headerEnd == -1) {
+                    return;
+                }
+                const QByteArray header = buffer->left(headerEnd).toLower();
+                int contentLength = 0;
+                const int pos = header.indexOf("content-length:");
+                if (pos != -1) {
+                    const int end = header.indexOf("\r\n", pos);
+                    contentLength = header.mid(pos + 15, end == -1 ? -1 : end - pos - 15).trimmed().toInt();
+                }
+                if (buffer->size() < headerEnd + 4 + contentLength) {
+                    return;
+                }
+                const QByteArray body = buffer->mid(headerEnd + 4, contentLength);
+                buffer->remove(0, headerEnd + 4 + contentLength);
+
+                const bool isClose = header.contains("connection: close");
+                QByteArray response = "HTTP/1.1 200 OK\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\n";
+                if (isClose) {
+                    response += "Connection: close\r\n";
+                }
+                response += "\r\n" + body;
+                socket->write(response);
+                if (isClose) {
+                    socket->disconnectFromHost();
+                    return;
+                }
+            }
+        });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+};
+
+static void runTest(const QString &name, const QUrl &url, bool isKeepAlive, size_t maxConnections, int countRequests, int concurrency)
+{
+    HttpSimpleClient client;
+    client.setPoolParameters(isKeepAlive, maxConnections, 30s);
+    QObject::connect(&client, &HttpSimpleClient::callbackCall, [](const HttpSimpleClient::ReturnCallback &callback) {
+        callback();
+    });
+
+    const QString message = QStringLiteral("{\"id\":1,\"version\":\"1.0.0\",\"method\":\"fetch-balance\",\"params\":{\"address\":\"0x00fa2a5a7a4bcb3bdd93a5a66add1e30e4a42c4fbd9e9b0e8d\"}}");
+
+    QEventLoop loop;
+    int countSent = 0;
+    int countDone = 0;
+    int countErrors = 0;
+    std::function<void()> sendNext;
+    sendNext = [&]() {
+        countSent++;
+        client.sendMessagePost(url, message, [&](const std::string &response, const TypedException &exception) {
+            countDone++;
+            if (exception.isSet() || response != message.toStdString()) {
+                countErrors++;
+            }
+            if (countSent < countRequests) {
+                sendNext();
+            }
+            if (countDone == countRequests) {
+                loop.quit();
+            }
+        }, 10s);
+    };
+
+    const auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < concurrency && countSent < countRequests; i++) {
+        sendNext();
+    }
+    loop.exec();
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1000000.;
+    qDebug().noquote() << name << "concurrency" << concurrency << ":" << QString::number(countRequests / seconds, 'f', 0) << "requests/sec," << countErrors << "errors";
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    EchoServer server;
+    if (!server.listen(QHostAddress::LocalHost, 0)) {
+        qDebug() << "Listen error" << server.errorString();
+        return 1;
+    }
+    const QUrl url(QStringLiteral("http://127.0.0.1:%1").arg(server.serverPort()));
+
+    const int countRequests = argc > 1 ? QString(argv[1]).toInt() : 20000;
+    for (const int concurrency: {1, 8, 32}) {
+        runTest("Without pool", url, false, 0, countRequests, concurrency);
+        runTest("Keep-alive pool", url, true, 8, countRequests, concurrency);
+    }
+
+    qDebug() << "ok";
+    return 0;
+}
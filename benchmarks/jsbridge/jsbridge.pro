@@ -0,0 +1,22 @@
+QT -= gui
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/TypedException.cpp \
+    ../../tests/LogMock.cpp
+
+
+HEADERS += \
+    ../../src/qt_utilites/makeJsFunc.h \
+    ../../src/TypedException.h \
+    ../../src/Log.h
+
+QMAKE_LFLAGS += -rdynamic
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
@@ -0,0 +1,102 @@
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QDebug>
+
+#include <chrono>
+#include <functional>
+
+#include "qt_utilites/makeJsFunc.h"
+#include "TypedException.h"
+
+static const int countTxs = 1000;
+
+void calcTime(const QString &name, std::function<void()> func, int nmax = 20)
+{
+    qreal time = 0.0;
+    for (int n = 0; n < nmax; n++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        func();
+        std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+        time += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    }
+    time /= nmax;
+    time /= 1000000.0;
+
+    qDebug() << name << QString::number(time, 'f', 6) << "s";
+}
+
+// Same fields as txToJson in TransactionsJavascript
+static QJsonDocument makeTxs()
+{
+    QJsonArray txs;
+    for (int i = 0; i < countTxs; i++) {
+        QJsonObject txJson;
+        txJson.insert("id", QString("a1b2c3d4e5f6a1b2c3d4e5f6a1b2c3d4e5f6a1b2c3d4e5f6a1b2c3d4e5f6") + QString::number(i));
+        txJson.insert("from", "0x00fa2a5279f8f0fd2f0f9d3280ad70403f01f9d62f52373833");
+        txJson.insert("to", "0x00a16d75a11a5fe0bb2cc6a13d0f8d0a6b9f3d42c1a2d3e4f5");
+        txJson.insert("value", QString::number(1000000000ULL + i));
+        txJson.insert("data", "{\"method\":\"delegate\",\"params\":{\"value\":\"1000\"}}\n");
+        txJson.insert("timestamp", QString::number(1560000000 + i));
+        txJson.insert("fee", "0");
+        txJson.insert("nonce", QString::number(i));
+        txJson.insert("blockNumber", QString::number(100000 + i));
+        txJson.insert("blockIndex", QString::number(i % 50));
+        txJson.insert("intStatus", 20);
+        txJson.insert("status", "ok");
+        txJson.insert("type", "simple");
+        txs.push_back(txJson);
+    }
+    return QJsonDocument(txs);
+}
+
+// What the page does with script from runJavaScript: parse string literal, then JSON.parse on it
+static QJsonDocument pageParseScript(const QString &script)
+{
+    const int begin = script.indexOf("\", \"") + 4;
+    const int end = script.lastIndexOf("\", 0, \"\"");
+    QString literal = script.mid(begin, end - begin);
+    literal.replace("\\n", "\n");
+    literal.replace("\\\"", "\"");
+    literal.replace("\\\\", "\\");
+    return QJsonDocument::fromJson(literal.toUtf8());
+}
+
+// What QWebChannel does with a signal: one json message, parsed once by the page
+static QJsonDocument pageParseChannelMessage(const QString &function, const QJsonArray &args)
+{
+    QJsonObject message;
+    message.insert("type", 1);
+    message.insert("object", "transactions");
+    message.insert("signal", 5);
+    message.insert("args", QJsonArray{function, args});
+    const QByteArray transport = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    return QJsonDocument::fromJson(transport);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const QString address = "0x00fa2a5279f8f0fd2f0f9d3280ad70403f01f9d62f52373833";
+    const QString currency = "tmh";
+    const QJsonDocument txs = makeTxs();
+
+    qDebug() << "getTxs2 result with" << countTxs << "transactions";
+
+    int countParsed = 0;
+    calcTime("javascript source", [&]{
+        const QString script = makeJsFunc3<false>("txsGetTxs2Js", "", TypedException(), address, currency, txs);
+        countParsed = pageParseScript(script).array().size();
+    });
+    qDebug() << "parsed" << countParsed;
+
+    calcTime("structured", [&]{
+        const QJsonArray args = makeJsArgs3(TypedException(), address, currency, txs);
+        countParsed = pageParseChannelMessage("txsGetTxs2Js", args).object().value("args").toArray().at(1).toArray().at(2).toArray().size();
+    });
+    qDebug() << "parsed" << countParsed;
+
+    return 0;
+}
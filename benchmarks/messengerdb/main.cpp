@@ -4,6 +4,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <tuple>
 
 #include "MessengerDBStorage.h"
 
@@ -18,7 +19,7 @@ const QString pragmaJournalWAL = "PRAGMA journal_mode=WAL";
 
 using TestFunction = std::function<void(messenger::MessengerDBStorage &)>;
 
-void calcTime(TestFunction func, const QStringList &pragmas = QStringList())
+void calcTime(TestFunction func, const QStringList &pragmas = QStringList(), TestFunction prepare = nullptr)
 {
     qDebug() << "Start test";
     for (const QString &sql: pragmas)
@@ -32,6 +33,9 @@ void calcTime(TestFunction func, const QStringList &pragmas = QStringList())
         db.init();
         for (const QString &sql: pragmas)
             db.execPragma(sql);
+        if (prepare) {
+            prepare(db);
+        }
 
         std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
         func(db);
@@ -67,6 +71,50 @@ void insert1000Messages(messenger::MessengerDBStorage &db)
     transactionGuard.commit();
 }
 
+static const int countNotDecrypted = 20000;
+
+static const size_t decryptPageSize = 1000;
+
+void insertNotDecryptedMessages(messenger::MessengerDBStorage &db)
+{
+    auto transactionGuard = db.beginTransaction();
+    for (int n = 0; n < countNotDecrypted; n++) {
+        db.addMessage("1234", "3454", "abcd" + QString::number(n), "", false, 1000000 + n, 4001 + n, true, true, true, "hash" + QString::number(n), 1);
+    }
+    transactionGuard.commit();
+}
+
+// Stands in for CryptographicManager, every fifth message fails to decrypt
+static std::vector<std::tuple<DBStorage::DbId, bool, QString>> fakeDecrypt(const std::pair<std::vector<DBStorage::DbId>, std::vector<messenger::Message>> &page)
+{
+    std::vector<std::tuple<DBStorage::DbId, bool, QString>> result;
+    result.reserve(page.first.size());
+    for (size_t i = 0; i < page.first.size(); i++) {
+        const bool isDecrypted = page.first[i] % 5 != 0;
+        result.emplace_back(page.first[i], isDecrypted, isDecrypted ? page.second[i].dataHex : QString(""));
+    }
+    return result;
+}
+
+void decryptBackfillAll(messenger::MessengerDBStorage &db)
+{
+    const auto all = db.getNotDecryptedMessage("1234");
+    db.updateDecryptedMessage(fakeDecrypt(all));
+}
+
+void decryptBackfillPaged(messenger::MessengerDBStorage &db)
+{
+    DBStorage::DbId afterId = -1;
+    while (true) {
+        const auto page = db.getNotDecryptedMessagePage("1234", false, afterId, decryptPageSize);
+        if (page.first.empty()) {
+            break;
+        }
+        db.updateDecryptedMessage(fakeDecrypt(page));
+        afterId = page.first.back();
+    }
+}
+
 int main(int argc, char *argv[])
 {
     //QCoreApplication a(argc, argv);
@@ -86,6 +134,11 @@ int main(int argc, char *argv[])
     calcTime(insert1Message, QStringList{pragmaJournalWAL});
     */
 
+    qDebug() << "Decrypt backfill" << countNotDecrypted << "messages, all at once";
+    calcTime(decryptBackfillAll, QStringList{pragmaSyncNormal, pragmaJournalWAL}, insertNotDecryptedMessages);
+    qDebug() << "Decrypt backfill" << countNotDecrypted << "messages, pages of" << decryptPageSize;
+    calcTime(decryptBackfillPaged, QStringList{pragmaSyncNormal, pragmaJournalWAL}, insertNotDecryptedMessages);
+
     qDebug() << "Insert one message";
     calcTime(insert1MessageTrans);
     calcTime(insert1MessageTrans, QStringList{pragmaSyncOff});
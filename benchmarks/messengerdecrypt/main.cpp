@@ -0,0 +1,76 @@
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <string>
+
+#include "Wallets/openssl_wrapper/openssl_wrapper.h"
+#include "utilites/ThreadPool.h"
+#include "utilites/utils.h"
+
+static const size_t countMessages = 10000;
+
+void calcTime(const QString &name, std::function<void()> func, int nmax = 3)
+{
+    qreal time = 0.0;
+    for (int n = 0; n < nmax; n++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        func();
+        std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+        time += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    }
+    time /= nmax;
+    time /= 1000000.0;
+
+    qDebug() << name << QString::number(time, 'f', 6) << "s";
+}
+
+// Same work as decryptOneMsg in CryptographicManager
+static std::string decryptOne(const RsaKey &privateKeyRsa, const std::string &publicKey, const std::string &message)
+{
+    return toHex(decrypt(privateKeyRsa, message, publicKey));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    InitOpenSSL();
+
+    const std::string password = "password";
+    const std::string privateKey = createRsaKey(password);
+    const std::string publicKey = getPublic(privateKey, password);
+    const RsaKey publicKeyRsa = getPublicRsa(publicKey);
+    const RsaKey privateKeyRsa = getPrivateRsa(privateKey, password);
+
+    std::vector<std::string> messages;
+    messages.reserve(countMessages);
+    for (size_t i = 0; i < countMessages; i++) {
+        messages.emplace_back(encrypt(publicKeyRsa, "Message number " + std::to_string(i), publicKey));
+    }
+
+    std::vector<std::string> serialResult;
+    calcTime("serial", [&]{
+        serialResult.assign(messages.size(), "");
+        for (size_t i = 0; i < messages.size(); i++) {
+            serialResult[i] = decryptOne(privateKeyRsa, publicKey, messages[i]);
+        }
+    });
+
+    ThreadPool pool(ThreadPool::defaultCountThreads());
+    std::vector<std::string> parallelResult;
+    calcTime("parallel " + QString::number(pool.size() + 1) + " threads", [&]{
+        parallelResult.assign(messages.size(), "");
+        pool.parallelFor(messages.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                parallelResult[i] = decryptOne(privateKeyRsa, publicKey, messages[i]);
+            }
+        });
+    });
+
+    qDebug() << "equal" << (serialResult == parallelResult);
+
+    return 0;
+}
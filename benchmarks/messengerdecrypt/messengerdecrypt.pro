@@ -0,0 +1,24 @@
+QT -= gui
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/Wallets/openssl_wrapper/openssl_wrapper.cpp \
+    ../../src/utilites/ThreadPool.cpp \
+    ../../src/utilites/utils.cpp \
+    ../../tests/LogMock.cpp
+
+
+HEADERS += \
+    ../../src/Wallets/openssl_wrapper/openssl_wrapper.h \
+    ../../src/utilites/ThreadPool.h \
+    ../../src/utilites/utils.h
+
+QMAKE_LFLAGS += -rdynamic
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
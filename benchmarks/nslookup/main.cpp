@@ -0,0 +1,196 @@
+#include <QCoreApplication>
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QEventLoop>
+#include <QDebug>
+
+#include <chrono>
+#include <memory>
+
+#include "NsLookup/ParallelLookup.h"
+#include "Network/UdpSocketClient.h"
+#include "Network/SimpleClient.h"
+
+// Answers every A request with countIps addresses 127.0.0.x after delay
+class FakeDns : public QObject {
+public:
+    FakeDns(int countIps, milliseconds delay)
+        : countIps(countIps)
+        , delay(delay)
+    {
+        socket.bind(QHostAddress::LocalHost, 0);
+        QObject::connect(&socket, &QUdpSocket::readyRead, this, &FakeDns::onReadyRead);
+    }
+
+    int port() const {
+        return socket.localPort();
+    }
+
+private:
+
+    void onReadyRead() {
+        while (socket.hasPendingDatagrams()) {
+            const QNetworkDatagram datagram = socket.receiveDatagram();
+            const QByteArray request = datagram.data();
+            if (request.size() <= 12) {
+                continue;
+            }
+            QByteArray response;
+            response += request.left(2);
+            response += QByteArray::fromHex("81800001");
+            response += char(countIps >> 8);
+            response += char(countIps & 0xFF);
+            response += QByteArray::fromHex("00000000");
+            response += request.mid(12);
+            for (int i = 0; i < countIps; i++) {
+                response += QByteArray::fromHex("c00c000100010000003c0004");
+                response += char(127);
+                response += char(0);
+                response += char(i / 250);
+                response += char(i % 250 + 1);
+            }
+            const QHostAddress sender = datagram.senderAddress();
+            const quint16 senderPort = datagram.senderPort();
+            QTimer::singleShot(delay.count(), this, [this, response, sender, senderPort]{
+                socket.writeDatagram(response, sender, senderPort);
+            });
+        }
+    }
+
+private:
+
+    QUdpSocket socket;
+
+    const int countIps;
+
+    const milliseconds delay;
+};
+
+// Answers every http request after delay and closes connection
+class FakeHttp : public QTcpServer {
+public:
+    explicit FakeHttp(milliseconds delay)
+        : delay(delay)
+    {
+        listen(QHostAddress::AnyIPv4, 0);
+    }
+
+protected:
+    void incomingConnection(qintptr handle) override {
+        QTcpSocket *socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(handle);
+        std::shared_ptr<QByteArray> buffer = std::make_shared<QByteArray>();
+        QObject::connect(socket, &QTcpSocket::readyRead, [this, socket, buffer]{
+            *buffer += socket->readAll();
+            const int headerEnd = buffer->indexOf("\r\n\r\n");
+            if (headerEnd == -1) {
+                return;
+            }
+            const QByteArray header = buffer->left(headerEnd).toLower();
+            int contentLength = 0;
+            const int pos = header.indexOf("content-length:");
+            if (pos != -1) {
+                const int end = header.indexOf("\r\n", pos);
+                contentLength = header.mid(pos + 15, end == -1 ? -1 : end - pos - 15).trimmed().toInt();
+            }
+            if (buffer->size() < headerEnd + 4 + contentLength) {
+                return;
+            }
+            buffer->clear();
+            QTimer::singleShot(delay.count(), socket, [socket]{
+                socket->write("HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nok");
+                socket->disconnectFromHost();
+            });
+        });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+
+private:
+
+    const milliseconds delay;
+};
+
+static void runTest(const QString &name, size_t countDns, size_t countPings, const std::vector<NodeType> &nodes, int dnsPort)
+{
+    std::vector<std::unique_ptr<UdpSocketClient>> udpClients;
+    std::vector<UdpSocketClient*> clients;
+    for (size_t i = 0; i < countDns; i++) {
+        udpClients.emplace_back(std::make_unique<UdpSocketClient>());
+        QObject::connect(udpClients.back().get(), &UdpSocketClient::callbackCall, [](const UdpSocketClient::ReturnCallback &callback) {
+            callback();
+        });
+        udpClients.back()->startTm();
+        clients.emplace_back(udpClients.back().get());
+    }
+    SimpleClient client;
+    QObject::connect(&client, &SimpleClient::callbackCall, [](const SimpleClient::ReturnCallback &callback) {
+        callback();
+    });
+
+    const auto getPingRequest = [](const NodeType &, const std::function<void(const nslookup::ParallelLookup::PingRequest &request)> &callback) {
+        nslookup::ParallelLookup::PingRequest request;
+        request.get = "/status";
+        request.post = "{}";
+        request.parse = [](const QString &address, const SimpleClient::Response &response) {
+            NodeInfo info;
+            info.address = address;
+            info.ping = response.time;
+            info.isTimeout = response.exception.isSet();
+            return info;
+        };
+        callback(request);
+    };
+
+    QEventLoop loop;
+    size_t countNodes = 0;
+    size_t countWorked = 0;
+    size_t countFailed = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    const auto lookup = std::make_shared<nslookup::ParallelLookup>(clients, client, "127.0.0.1", dnsPort, 5s, countPings);
+    lookup->start(nodes, {}, getPingRequest, [](const NodeType &, const std::vector<QString> &) {}, [&](std::map<NodeType::Node, std::vector<NodeInfo>> &result, const std::set<NodeType::Node> &failedNodes) {
+        for (const auto &pair: result) {
+            for (const NodeInfo &info: pair.second) {
+                countNodes++;
+                if (!info.isTimeout) {
+                    countWorked++;
+                }
+            }
+        }
+        countFailed = failedNodes.size();
+        loop.quit();
+    });
+    loop.exec();
+    const auto end = std::chrono::steady_clock::now();
+
+    qDebug().noquote() << name << "dns" << countDns << "pings" << countPings << ":" << std::chrono::duration_cast<milliseconds>(end - begin).count() << "ms," << countNodes << "nodes," << countWorked << "worked," << countFailed << "dns failed";
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const int countTypes = argc > 1 ? QString(argv[1]).toInt() : 20;
+    const int countIps = argc > 2 ? QString(argv[2]).toInt() : 50;
+
+    FakeDns dns(countIps, 30ms);
+    FakeHttp http(20ms);
+
+    std::vector<NodeType> nodes;
+    for (int i = 0; i < countTypes; i++) {
+        NodeType node;
+        node.type = "type" + QString::number(i);
+        node.node = NodeType::Node("node" + QString::number(i) + ".test");
+        node.port = QString::number(http.serverPort());
+        nodes.emplace_back(node);
+    }
+
+    runTest("Sequential", 1, 1, nodes, dns.port());
+    runTest("Parallel", 4, 8, nodes, dns.port());
+    runTest("Parallel", 8, 32, nodes, dns.port());
+
+    qDebug() << "ok";
+    return 0;
+}
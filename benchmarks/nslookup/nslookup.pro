@@ -0,0 +1,37 @@
+QT -= gui
+QT += network
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/NsLookup/ParallelLookup.cpp \
+    ../../src/NsLookup/dns/datatransformer.cpp \
+    ../../src/NsLookup/dns/dnspacket.cpp \
+    ../../src/NsLookup/dns/resourcerecord.cpp \
+    ../../src/Network/UdpSocketClient.cpp \
+    ../../src/Network/SimpleClient.cpp \
+    ../../src/TypedException.cpp \
+    ../../src/qt_utilites/QRegister.cpp \
+    ../../tests/LogMock.cpp
+
+
+HEADERS += \
+    ../../src/NsLookup/ParallelLookup.h \
+    ../../src/NsLookup/NsLookupStructs.h \
+    ../../src/NsLookup/dns/datatransformer.h \
+    ../../src/NsLookup/dns/dnspacket.h \
+    ../../src/NsLookup/dns/resourcerecord.h \
+    ../../src/Network/UdpSocketClient.h \
+    ../../src/Network/SimpleClient.h \
+    ../../src/TypedException.h \
+    ../../src/qt_utilites/QRegister.h \
+    ../../src/Log.h
+
+QMAKE_LFLAGS += -rdynamic
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
@@ -0,0 +1,89 @@
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <string>
+
+#include "Wallets/ethtx/scrypt/libscrypt.h"
+#include "utilites/ThreadPool.h"
+
+// kdfparams of ethereum keystore files
+static const uint64_t N = 262144;
+static const uint32_t R = 8;
+static const uint32_t P = 1;
+
+static const size_t countKeys = 8;
+
+void calcTime(const QString &name, std::function<void()> func, size_t countKeys, int nmax = 1)
+{
+    qreal time = 0.0;
+    for (int n = 0; n < nmax; n++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        func();
+        std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+        time += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    }
+    time /= nmax;
+    time /= 1000000.0;
+
+    qDebug() << name << QString::number(time, 'f', 6) << "s" << QString::number(countKeys / time, 'f', 3) << "keys/s";
+}
+
+static std::string deriveKey(libscrypt_smix_t smix, const std::string &password, const std::string &salt)
+{
+    std::string result(32, 0);
+    const int res = libscrypt_scrypt_smix(smix, (const uint8_t*)password.data(), password.size(), (const uint8_t*)salt.data(), salt.size(), N, R, P, (uint8_t*)&result[0], result.size());
+    if (res != 0) {
+        qDebug() << "scrypt error";
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    std::vector<std::string> salts;
+    for (size_t i = 0; i < countKeys; i++) {
+        salts.emplace_back("salt of the key number " + std::to_string(i));
+    }
+    const std::string password = "password";
+
+    std::vector<libscrypt_smix_t> kernels = {libscrypt_smix_nosse};
+#ifdef LIBSCRYPT_HAVE_SSE
+    if (libscrypt_cpu_has_sse2()) {
+        kernels.emplace_back(libscrypt_smix_sse2);
+    }
+#endif
+
+    std::vector<std::string> serialResult;
+    for (const libscrypt_smix_t kernel: kernels) {
+        std::vector<std::string> result(salts.size());
+        calcTime(QString("serial ") + libscrypt_smix_name(kernel), [&]{
+            for (size_t i = 0; i < salts.size(); i++) {
+                result[i] = deriveKey(kernel, password, salts[i]);
+            }
+        }, salts.size());
+        if (serialResult.empty()) {
+            serialResult = result;
+        }
+        qDebug() << "equal" << (serialResult == result);
+    }
+
+    const libscrypt_smix_t selected = libscrypt_smix_select();
+    ThreadPool pool(ThreadPool::defaultCountThreads());
+    std::vector<std::string> parallelResult(salts.size());
+    calcTime(QString("parallel ") + libscrypt_smix_name(selected) + " " + QString::number(pool.size() + 1) + " threads", [&]{
+        pool.parallelFor(salts.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                parallelResult[i] = deriveKey(selected, password, salts[i]);
+            }
+        });
+    }, salts.size());
+
+    qDebug() << "equal" << (serialResult == parallelResult);
+
+    return 0;
+}
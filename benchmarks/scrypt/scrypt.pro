@@ -0,0 +1,22 @@
+QT -= gui
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/Wallets/ethtx/scrypt/crypto_scrypt-nosse.cpp \
+    ../../src/Wallets/ethtx/scrypt/crypto_scrypt-sse.cpp \
+    ../../src/Wallets/ethtx/scrypt/sha256.cpp \
+    ../../src/utilites/ThreadPool.cpp
+
+
+HEADERS += \
+    ../../src/Wallets/ethtx/scrypt/libscrypt.h \
+    ../../src/utilites/ThreadPool.h
+
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
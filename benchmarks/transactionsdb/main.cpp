@@ -6,7 +6,9 @@
 #include <iostream>
 
 #include "TransactionsDBStorage.h"
-#include "SlotWrapper.h"
+#include "dbwriter.h"
+#include "TypedException.h"
+
 const QString pragmaSyncOff = "PRAGMA synchronous=OFF";
 const QString pragmaSyncNormal = "PRAGMA synchronous=NORMAL";
 const QString pragmaSyncFull = "PRAGMA synchronous=FULL";
@@ -20,12 +22,11 @@ const QString pragmaJournalWAL = "PRAGMA journal_mode=WAL";
 
 using TestFunction = std::function<void(transactions::TransactionsDBStorage &)>;
 
-void calcTime(TestFunction func, TestFunction funcp, const QStringList &pragmas = QStringList())
+void calcTime(TestFunction func, TestFunction funcp, const QStringList &pragmas = QStringList(), int nmax = 20)
 {
     qDebug() << "Start test";
     for (const QString &sql: pragmas)
         qDebug() << sql;
-    const int nmax = 20;
     qreal time = 0.0;
     for (int n = 0; n < nmax; n++) {
         if (QFile::exists("payments.db"))
@@ -34,6 +35,7 @@ void calcTime(TestFunction func, TestFunction funcp, const QStringList &pragmas
         db.init();
         for (const QString &sql: pragmas)
             db.execPragma(sql);
+        funcp(db);
 
         std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
         func(db);
@@ -52,58 +54,282 @@ void emptyInit(transactions::TransactionsDBStorage &)
 {
 }
 
+static transactions::Transaction makeTransaction(qint64 n)
+{
+    transactions::Transaction trans;
+    trans.currency = "mh";
+    trans.tx = QString("gfklklkltrklklgfmjgfhg%1").arg(QString::number(n));
+    trans.address = "address100";
+    trans.blockIndex = 1;
+    trans.from = "user7";
+    trans.to = "user1";
+    trans.value = "9000000000000000000";
+    trans.timestamp = 1000 + 2 * n;
+    trans.data = "nvcmnjkdfjkgf";
+    trans.fee = "100";
+    trans.nonce = 8896865;
+    trans.isDelegate = false;
+    trans.delegateValue = "100";
+    trans.delegateHash = "kfkfgk";
+    trans.status = transactions::Transaction::OK;
+    trans.type = transactions::Transaction::FORGING;
+    trans.blockNumber = 10000 + n;
+    return trans;
+}
+
+static std::vector<transactions::Transaction> makeTransactions(qint64 count)
+{
+    std::vector<transactions::Transaction> transactions;
+    transactions.reserve(count);
+    for (qint64 n = 0; n < count; n++) {
+        transactions.push_back(makeTransaction(n));
+    }
+    return transactions;
+}
+
 void insertTransaction(transactions::TransactionsDBStorage &db)
 {
-    db.addPayment("mh", QString("gfklklkltrklklgfmjgfhg"), "address100", true, "user7", "user1", "9000000000000000000", 1000 + 2, "nvcmnjkdfjkgf", "100", 8896865, false, false, "100", "kfkfgk", transactions::Transaction::OK, transactions::Transaction::FORGING, 10000);
+    db.addPayment(makeTransaction(0));
 }
 
 void insert3000TransactionsT(transactions::TransactionsDBStorage &db)
 {
     auto transactionGuard = db.beginTransaction();
-    for (qint64 n = 0; n < 1000; n++) {
-        db.addPayment("mh", QString("gfklklkltrklklgfmjgfhg%1").arg(QString::number(n)), "address100", true, "user7", "user1", "9000000000000000000", 1000 + 2 * n, "nvcmnjkdfjkgf", "100", 8896865, false, false, "100", "kfkfgk", transactions::Transaction::OK, transactions::Transaction::FORGING, 10000 + n);
+    for (qint64 n = 0; n < 3000; n++) {
+        db.addPayment(makeTransaction(n));
     }
     transactionGuard.commit();
 }
 
 void insert3000Transactions(transactions::TransactionsDBStorage &db)
 {
-    for (qint64 n = 0; n < 1000; n++) {
-        db.addPayment("mh", QString("gfklklkltrklklgfmjgfhg%1").arg(QString::number(n)), "address100", true, "user7", "user1", "9000000000000000000", 1000 + 2 * n, "nvcmnjkdfjkgf", "100", 8896865, false, false, "100", "kfkfgk", transactions::Transaction::OK, transactions::Transaction::FORGING, 10000 + n);
+    for (qint64 n = 0; n < 3000; n++) {
+        db.addPayment(makeTransaction(n));
     }
 }
 
-void insert3000TransactionsV2(transactions::TransactionsDBStorage &db)
+void insert3000TransactionsV(transactions::TransactionsDBStorage &db)
 {
-    for (qint64 n = 0; n < 1000; n++) {
-        db.addPaymentV2("mh", QString("gfklklkltrklklgfmjgfhg%1").arg(QString::number(n)), "address100", true, "user7", "user1", "9000000000000000000", 1000 + 2 * n, "nvcmnjkdfjkgf", "100", 8896865, false, false, "100", "kfkfgk", transactions::Transaction::OK, transactions::Transaction::FORGING, 10000 + n);
+    static const std::vector<transactions::Transaction> transactions = makeTransactions(3000);
+    db.addPayments(transactions);
+}
+
+void insert100kTransactionsT(transactions::TransactionsDBStorage &db)
+{
+    static const std::vector<transactions::Transaction> transactions = makeTransactions(100000);
+    auto transactionGuard = db.beginTransaction();
+    for (const transactions::Transaction &trans: transactions) {
+        db.addPayment(trans);
     }
+    transactionGuard.commit();
 }
 
-void insert3000TransactionsV(transactions::TransactionsDBStorage &db)
+void insert100kTransactionsV(transactions::TransactionsDBStorage &db)
+{
+    static const std::vector<transactions::Transaction> transactions = makeTransactions(100000);
+    db.addPayments(transactions);
+}
+
+// Indexes dropped by payments_8to9.sql, used to reproduce the schema before migration
+static const QStringList legacyPaymentsIndexes = {
+    "CREATE INDEX paymentsIdx1 ON payments(address, currency, txid, blockNumber, ind)",
+    "CREATE INDEX paymentsIdx4 ON payments(address, currency, status, ts, txid)",
+    "CREATE INDEX paymentsIdx6 ON payments(address, currency, ufrom, uto, type, status, ts, txid)",
+    "CREATE INDEX paymentsIdx7 ON payments(address, currency, ufrom, type, status, ts, txid)"
+};
+
+void createLegacyIndexes(transactions::TransactionsDBStorage &db)
+{
+    for (const QString &sql: legacyPaymentsIndexes)
+        db.execPragma(sql);
+}
+
+static std::vector<transactions::Transaction> makeMixedTransactions(qint64 count)
 {
     std::vector<transactions::Transaction> transactions;
-    transactions.reserve(3100);
-    for (qint64 n = 0; n < 1000; n++) {
-        transactions::Transaction trans;
-        trans.currency = "mh";
-        trans.tx = QString("gfklklkltrklklgfmjgfhg%1").arg(QString::number(n));
-        trans.address = "address100";
-        trans.isInput = true;
-        trans.from = "user7";
-        trans.to = "user1";
-        trans.value = "9000000000000000000";
-        trans.timestamp = 1000 + 2 * n;
-        trans.data = "nvcmnjkdfjkgf";
-        trans.fee = "100";
-        trans.nonce = 8896865;
-        trans.isSetDelegate = false;
-        trans.isDelegate = false;
-        trans.delegateValue = "100";
-        trans.blockNumber = n + 100458;
+    transactions.reserve(count);
+    for (qint64 n = 0; n < count; n++) {
+        transactions::Transaction trans = makeTransaction(n);
+        trans.address = QString("address%1").arg(n % 10);
+        trans.from = n % 2 ? trans.address : "user7";
+        trans.type = static_cast<transactions::Transaction::Type>(n % 3);
+        trans.status = n % 100 ? transactions::Transaction::OK : transactions::Transaction::PENDING;
         transactions.push_back(trans);
     }
+    return transactions;
+}
+
+static qreal measureQuery(const std::function<void()> &func, int count)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int n = 0; n < count; n++)
+        func();
+    std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / qreal(count);
+}
+
+void calcIndexes(const QString &name, TestFunction initIndexes)
+{
+    qDebug() << "Indexes" << name;
+    if (QFile::exists("payments.db"))
+        QFile::remove("payments.db");
+    transactions::TransactionsDBStorage db;
+    db.init();
+    initIndexes(db);
+
+    const std::vector<transactions::Transaction> transactions = makeMixedTransactions(100000);
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
     db.addPayments(transactions);
+    std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+    const qreal insertTime = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1000000.0;
+    qDebug() << "insert" << QString::number(transactions.size() / insertTime, 'f', 0) << "rows/s";
+
+    const int nq = 100;
+    qDebug() << "getPaymentsForAddress" << measureQuery([&db]{ db.getPaymentsForAddress("address3", "mh", 5000, 100, true); }, nq) << "us";
+    qDebug() << "getPaymentsForAddressPending" << measureQuery([&db]{ db.getPaymentsForAddressPending("address3", "mh", true); }, nq) << "us";
+    qDebug() << "getForgingPaymentsForAddress" << measureQuery([&db]{ db.getForgingPaymentsForAddress("address3", "mh", 0, 100, false); }, nq) << "us";
+    qDebug() << "getDelegatePaymentsForAddress" << measureQuery([&db]{ db.getDelegatePaymentsForAddress("address3", "user1", "mh", 0, 100, true); }, nq) << "us";
+    qDebug() << "getLastTransaction" << measureQuery([&db]{ db.getLastTransaction("address3", "mh"); }, nq) << "us";
+    qDebug() << "getPaymentsCountForAddress" << measureQuery([&db]{ db.getPaymentsCountForAddress("address3", "mh"); }, nq) << "us";
+}
+
+void calcPages()
+{
+    qDebug() << "Deep pages, offset against cursor";
+    if (QFile::exists("payments.db"))
+        QFile::remove("payments.db");
+    transactions::TransactionsDBStorage db;
+    db.init();
+    db.addPayments(makeMixedTransactions(100000));
+
+    const qint64 pageSize = 20;
+    const int nq = 20;
+    transactions::TxsCursor cursor;
+    for (qint64 page = 0; page < 500; page++) {
+        if (page % 100 == 0) {
+            const qint64 offset = page * pageSize;
+            const transactions::TxsCursor pageCursor = cursor;
+            const qreal offsetTime = measureQuery([&db, offset, pageSize]{ db.getPaymentsForAddress("address3", "mh", offset, pageSize, true); }, nq);
+            const qreal cursorTime = measureQuery([&db, pageCursor, pageSize]{ db.getPaymentsForAddressCursor("address3", "mh", transactions::Filters(), pageCursor, pageSize, true); }, nq);
+            qDebug() << "page" << page << "offset" << offsetTime << "us" << "cursor" << cursorTime << "us";
+        }
+        const std::vector<transactions::Transaction> txs = db.getPaymentsForAddressCursor("address3", "mh", transactions::Filters(), cursor, pageSize, true);
+        if (txs.empty()) {
+            break;
+        }
+        cursor.isSet = true;
+        cursor.ts = txs.back().timestamp;
+        cursor.txid = txs.back().tx;
+        cursor.id = txs.back().id;
+    }
+}
+
+void calcFilters()
+{
+    qDebug() << "Filter combinations";
+    if (QFile::exists("payments.db"))
+        QFile::remove("payments.db");
+    transactions::TransactionsDBStorage db;
+    db.init();
+    db.addPayments(makeMixedTransactions(100000));
+
+    const std::vector<transactions::FilterType> values = {transactions::FilterType::None, transactions::FilterType::True, transactions::FilterType::False};
+    const int nq = 20;
+    for (const transactions::FilterType isInput: values) {
+        for (const transactions::FilterType isForging: values) {
+            for (const transactions::FilterType isDelegate: values) {
+                for (const transactions::FilterType isSuccess: values) {
+                    transactions::Filters filters;
+                    filters.isInput = isInput;
+                    filters.isForging = isForging;
+                    filters.isDelegate = isDelegate;
+                    filters.isSuccess = isSuccess;
+                    const qreal time = measureQuery([&db, &filters]{ db.getPaymentsForAddressFilter("address3", "mh", filters, 1000, 100, false); }, nq);
+                    qDebug() << "input" << int(isInput) << "forging" << int(isForging) << "delegate" << int(isDelegate) << "success" << int(isSuccess) << time << "us";
+                }
+            }
+        }
+    }
+}
+
+// Same writes as Transactions::newBalance for one balance callback
+static void writeBalanceCallback(transactions::TransactionsDBStorage &db, const std::vector<transactions::Transaction> &txs, qint64 n)
+{
+    auto transactionGuard = db.beginTransaction();
+    for (const transactions::Transaction &tx: txs) {
+        db.addPayment(tx);
+    }
+    transactions::BalanceInfo balance;
+    balance.countTxs = n;
+    db.setBalance("mh", txs.front().address, balance);
+    transactionGuard.commit();
+}
+
+static std::vector<std::vector<transactions::Transaction>> makeCallbacks(qint64 count, qint64 txsInCallback)
+{
+    const std::vector<transactions::Transaction> transactions = makeMixedTransactions(count * txsInCallback);
+    std::vector<std::vector<transactions::Transaction>> callbacks(count);
+    for (qint64 n = 0; n < count; n++) {
+        callbacks[n].assign(transactions.begin() + n * txsInCallback, transactions.begin() + (n + 1) * txsInCallback);
+        for (transactions::Transaction &tx: callbacks[n]) {
+            tx.address = callbacks[n].front().address;
+        }
+    }
+    return callbacks;
+}
+
+void calcWriter()
+{
+    qDebug() << "Balance callbacks under write load, direct writes against db writer";
+    const qint64 countCallbacks = 2000;
+    const std::vector<std::vector<transactions::Transaction>> callbacks = makeCallbacks(countCallbacks, 20);
+
+    {
+        if (QFile::exists("payments.db"))
+            QFile::remove("payments.db");
+        transactions::TransactionsDBStorage db;
+        db.init();
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for (qint64 n = 0; n < countCallbacks; n++) {
+            writeBalanceCallback(db, callbacks[n], n);
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        const qreal time = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1000000.0;
+        qDebug() << "direct" << QString::number(countCallbacks / time, 'f', 0) << "callbacks/s";
+    }
+
+    for (const milliseconds commitInterval: {10ms, 50ms, 200ms}) {
+        if (QFile::exists("payments.db"))
+            QFile::remove("payments.db");
+        transactions::TransactionsDBStorage db;
+        db.init();
+        const QString path = db.dbPath();
+        DBWriter writer([path]{
+            auto storage = std::make_unique<transactions::TransactionsDBStorage>(path, "payments_writer");
+            storage->initConnection();
+            return storage;
+        }, commitInterval, 200);
+
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for (qint64 n = 0; n < countCallbacks; n++) {
+            const std::vector<transactions::Transaction> &txs = callbacks[n];
+            writer.write([&txs, n](DBStorage &storage) {
+                writeBalanceCallback(static_cast<transactions::TransactionsDBStorage&>(storage), txs, n);
+            }, nullptr);
+            // Reads keep going on the main connection while writer commits
+            if (n % 10 == 0) {
+                db.getPaymentsForAddress(txs.front().address, "mh", 0, 20, false);
+            }
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        writer.flush();
+        std::chrono::steady_clock::time_point commited = std::chrono::steady_clock::now();
+        const qreal time = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1000000.0;
+        const qreal timeCommited = std::chrono::duration_cast<std::chrono::microseconds>(commited - begin).count() / 1000000.0;
+        const DBWriter::Stats stats = writer.getStats();
+        qDebug() << "writer" << commitInterval.count() << "ms" << QString::number(countCallbacks / time, 'f', 0) << "callbacks/s"
+                 << "commited in" << QString::number(timeCommited, 'f', 3) << "s" << "commits" << stats.countCommits << "max batch" << stats.maxBatch;
+    }
 }
 
 void selectTransactions(transactions::TransactionsDBStorage &db)
@@ -115,47 +341,46 @@ void selectTransactions(transactions::TransactionsDBStorage &db)
 int main(int argc, char *argv[])
 {
     //QCoreApplication a(argc, argv);
+    if (argc > 1 && QString(argv[1]) == QStringLiteral("indexes")) {
+        calcIndexes("before payments_8to9", createLegacyIndexes);
+        calcIndexes("after payments_8to9", emptyInit);
+        return 0;
+    }
+    if (argc > 1 && QString(argv[1]) == QStringLiteral("pages")) {
+        calcPages();
+        return 0;
+    }
+    if (argc > 1 && QString(argv[1]) == QStringLiteral("filters")) {
+        calcFilters();
+        return 0;
+    }
+    if (argc > 1 && QString(argv[1]) == QStringLiteral("writer")) {
+        calcWriter();
+        return 0;
+    }
+
     qDebug() << "Inserts 3000 transactions";
     calcTime(insert3000Transactions, emptyInit, QStringList{pragmaSyncFull, pragmaJournalDelete});
     qDebug() << "Inserts 3000 transactions";
     calcTime(insert3000Transactions, emptyInit, QStringList{pragmaSyncNormal, pragmaJournalWAL});
-    qDebug() << "Inserts 3000 transactions precompiled";
-    calcTime(insert3000TransactionsV2, emptyInit, QStringList{pragmaSyncFull, pragmaJournalDelete});
-    qDebug() << "Inserts 3000 transactions precompiled";
-    calcTime(insert3000TransactionsV2, emptyInit, QStringList{pragmaSyncNormal, pragmaJournalWAL});
-
-    /*
-    qDebug() << "Inserts 3000 transactions";
-    calcTime(insertTransaction, emptyInit, QStringList{pragmaSyncFull, pragmaJournalDelete});
-    qDebug() << "Inserts 3000 transactions V2";
-    calcTime(insertTransaction, emptyInit, QStringList{pragmaSyncNormal, pragmaJournalWAL});
-
-    qDebug() << "Inserts 3000 transactions";
-    calcTime(insert3000TransactionsT, emptyInit, QStringList{pragmaSyncFull, pragmaJournalDelete});
-    qDebug() << "Inserts 3000 transactions V2";
+    qDebug() << "Inserts 3000 transactions in transaction";
     calcTime(insert3000TransactionsT, emptyInit, QStringList{pragmaSyncNormal, pragmaJournalWAL});
     qDebug() << "Inserts 3000 transactions vector";
-    calcTime(insert3000TransactionsV, emptyInit, QStringList{pragmaSyncFull, pragmaJournalDelete});
-    qDebug() << "Inserts 3000 transactions vector";
     calcTime(insert3000TransactionsV, emptyInit, QStringList{pragmaSyncNormal, pragmaJournalWAL});
 
-    */
-    //calcTime(insert3000Transactions, emptyInit);
-
-    /*qDebug() << "Insert 2000 transactions";
-    calcTime(insert2000Transactions, emptyInit);
-    calcTime(insert2000Transactions, emptyInit, QStringList{pragmaSyncNormal});
-    calcTime(insert2000Transactions, emptyInit, QStringList{pragmaSyncNormal, pragmaJournalWAL});
-    calcTime(insert2000Transactions, emptyInit, QStringList{pragmaJournalWAL});
-
-    qDebug() << "Insert 2000 transactions Vector";
-    calcTime(insert2000TransactionsV, emptyInit);
-    calcTime(insert2000TransactionsV, emptyInit, QStringList{pragmaSyncNormal});
-    calcTime(insert2000TransactionsV, emptyInit, QStringList{pragmaSyncNormal, pragmaJournalWAL});
-    calcTime(insert2000TransactionsV, emptyInit, QStringList{pragmaJournalWAL});
+    qDebug() << "Inserts 100000 transactions in transaction";
+    calcTime(insert100kTransactionsT, emptyInit, QStringList{pragmaSyncNormal, pragmaJournalWAL}, 3);
+    qDebug() << "Inserts 100000 transactions vector (bulk)";
+    calcTime(insert100kTransactionsV, emptyInit, QStringList{pragmaSyncNormal, pragmaJournalWAL}, 3);
 
+    /*
+    qDebug() << "Inserts 1 transaction";
+    calcTime(insertTransaction, emptyInit, QStringList{pragmaSyncFull, pragmaJournalDelete});
+    qDebug() << "Inserts 1 transaction";
+    calcTime(insertTransaction, emptyInit, QStringList{pragmaSyncNormal, pragmaJournalWAL});
+    */
 
-    calcTime(selectTransactions, insert2000TransactionsV, QStringList{pragmaSyncNormal, pragmaJournalWAL});*/
+    //calcTime(selectTransactions, insert3000TransactionsV, QStringList{pragmaSyncNormal, pragmaJournalWAL});
 
     qDebug() << "ok";
 
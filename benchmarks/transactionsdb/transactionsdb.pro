@@ -9,21 +9,20 @@ INCLUDEPATH = ../../src ../../src/transactions
 SOURCES += \
     main.cpp \
     ../../src/dbstorage.cpp \
-    ../../src/BigNumber.cpp \
-    ../../src/Log.cpp \
-    ../../src/utils.cpp \
-    ../../src/Paths.cpp \
-    ../../src/btctx/Base58.cpp \
+    ../../src/dbwriter.cpp \
+    ../../src/TypedException.cpp \
+    ../../src/utilites/BigNumber256.cpp \
+    ../../tests/LogMock.cpp \
     ../../src/transactions/TransactionsDBStorage.cpp
 
 
 HEADERS += \
     ../../src/dbstorage.h \
-    ../../src/BigNumber.h \
+    ../../src/dbwriter.h \
+    ../../src/TypedException.h \
+    ../../src/utilites/BigNumber256.h \
     ../../src/Log.h \
-    ../../src/utils.h \
-    ../../src/Paths.h \
-    ../../src/btctx/Base58.h \
+    ../../src/utilites/utils.h \
     ../../src/transactions/TransactionsDBStorage.h
 
 QMAKE_LFLAGS += -rdynamic
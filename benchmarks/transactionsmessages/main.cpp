@@ -0,0 +1,209 @@
+#include <QCoreApplication>
+#include <QFile>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include <chrono>
+#include <functional>
+
+#include "TransactionsMessages.h"
+#include "Transaction.h"
+
+#include "check.h"
+
+// Usage: transactionsmessages [history_response.json [balances_response.json]]
+//        transactionsmessages --synthetic
+// Without arguments the recorded responses from tests/tst_transactions/data are used,
+// --synthetic generates large responses in fetch-history and fetch-balances format
+
+using TestFunction = std::function<size_t(const std::string &)>;
+
+void calcTime(const QString &name, const std::string &response, TestFunction func, int nmax = 20)
+{
+    qreal time = 0.0;
+    size_t count = 0;
+    for (int n = 0; n < nmax; n++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        count = func(response);
+        std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+        time += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    }
+    time /= nmax;
+    time /= 1000000.0;
+
+    const qreal mbPerSec = response.size() / time / 1024.0 / 1024.0;
+    qDebug() << name << count << "items" << QString::number(time, 'f', 6) << "s" << QString::number(mbPerSec, 'f', 2) << "MB/s";
+}
+
+static std::string makeHistoryFixture(int count)
+{
+    QJsonArray txs;
+    for (int i = 0; i < count; i++) {
+        QJsonObject tx;
+        tx.insert("from", "0x00fca67778165988703a302c1dfc34fd6036e209a20666969e");
+        tx.insert("to", "0x00d7a48ea4c1e3e5bd4b9c8d06e4bd2b5a3e03fd3c3e5d0e0a");
+        tx.insert("value", QString::number(1000000000000ULL + i * 7919ULL));
+        tx.insert("transaction", QString("4a5c5f21d4f57aaa63a3d8cc74ab8e6dc3e8d6e3a7b9c16a7d0c53d3aa0d%1").arg(i, 4, 10, QChar('0')));
+        tx.insert("data", "");
+        tx.insert("timestamp", 1550000000 + i);
+        tx.insert("type", i % 10 == 0 ? "forging" : "block");
+        tx.insert("blockNumber", 100000 + i / 10);
+        tx.insert("blockIndex", i % 10);
+        tx.insert("signature", "3046022100b6e5c3a7e8bf0a2b1a4b2d37c1e35b0d2b2b2fa0e1e2a3f5c8d1b3e7f9a0c1d2022100e0d1c2b3a4958677");
+        tx.insert("publickey", "3056301006072a8648ce3d020106052b8104000a034200042a3c8b7e9d0f1a2b3c4d5e6f708192a3b4c5d6e7f8091a2b3c4d5e6f708192a3b");
+        tx.insert("fee", 0);
+        tx.insert("realFee", 0);
+        tx.insert("nonce", i);
+        tx.insert("intStatus", 20);
+        tx.insert("status", "ok");
+        if (i % 7 == 0) {
+            QJsonObject delegate;
+            delegate.insert("isDelegate", true);
+            delegate.insert("delegate", QString::number(5000000 + i));
+            delegate.insert("delegateHash", QString("d%1").arg(i));
+            tx.insert("delegate_info", delegate);
+        }
+        txs.append(tx);
+    }
+    QJsonObject response;
+    response.insert("id", 1);
+    response.insert("result", txs);
+    return QJsonDocument(response).toJson(QJsonDocument::Compact).toStdString();
+}
+
+static std::string makeBalancesFixture(int count)
+{
+    QJsonArray balances;
+    for (int i = 0; i < count; i++) {
+        QJsonObject balance;
+        balance.insert("address", QString("0x00fca67778165988703a302c1dfc34fd6036e209a2066%1").arg(i, 4, 10, QChar('0')));
+        balance.insert("received", QString::number(1000000000000ULL + i));
+        balance.insert("spent", QString::number(100000000ULL + i));
+        balance.insert("count_received", 100 + i);
+        balance.insert("count_spent", 10 + i);
+        balance.insert("count_txs", 110 + 2 * i);
+        balance.insert("block_number", 100000);
+        balance.insert("currentBlock", 100010);
+        balance.insert("hash", "8b8e7bc3ae52c2b8d7e5d9d8a9a5e1f3c0b7d6a5e4f3c2b1a0987654321fedcb");
+        balance.insert("countDelegatedOps", 3);
+        balance.insert("delegate", "1000");
+        balance.insert("undelegate", "100");
+        balance.insert("delegated", "0");
+        balance.insert("undelegated", "0");
+        balance.insert("reserved", "0");
+        balance.insert("forged", "0");
+        balances.append(balance);
+    }
+    QJsonObject response;
+    response.insert("id", 1);
+    response.insert("result", balances);
+    return QJsonDocument(response).toJson(QJsonDocument::Compact).toStdString();
+}
+
+// Former implementation: response copied to QString, back to utf-8 and whole QJsonDocument built before first transaction
+static size_t parseHistoryLegacy(const std::string &response)
+{
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(QString::fromStdString(response).toUtf8());
+    CHECK(jsonResponse.isObject(), "Incorrect json ");
+    const QJsonArray json = jsonResponse.object().value("result").toArray();
+    std::vector<transactions::Transaction> result;
+    for (const QJsonValue &elementJson: json) {
+        const QJsonObject txJson = elementJson.toObject();
+        transactions::Transaction res;
+        res.from = txJson.value("from").toString();
+        res.to = txJson.value("to").toString();
+        res.value = txJson.value("value").toString();
+        res.tx = txJson.value("transaction").toString();
+        res.data = txJson.value("data").toString();
+        res.timestamp = uint64_t(txJson.value("timestamp").toDouble());
+        res.fee = QString::number(uint64_t(txJson.value("realFee").toDouble()));
+        res.nonce = int64_t(txJson.value("nonce").toDouble());
+        res.blockNumber = int64_t(txJson.value("blockNumber").toDouble());
+        res.blockIndex = int64_t(txJson.value("blockIndex").toDouble());
+        res.intStatus = txJson.value("intStatus").toInt();
+        result.emplace_back(res);
+    }
+    return result.size();
+}
+
+static size_t parseHistoryStream(const std::string &response)
+{
+    return transactions::parseHistoryResponse("address", "mh", response).size();
+}
+
+static size_t parseBalancesLegacy(const std::string &response)
+{
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(QString::fromStdString(response).toUtf8());
+    CHECK(jsonResponse.isObject(), "Incorrect json ");
+    const QJsonArray json = jsonResponse.object().value("result").toArray();
+    std::vector<transactions::BalanceInfo> result;
+    for (const QJsonValue &elementJson: json) {
+        const QJsonObject balanceJson = elementJson.toObject();
+        transactions::BalanceInfo info(balanceJson.value("address").toString());
+        info.received = balanceJson.value("received").toString();
+        info.spent = balanceJson.value("spent").toString();
+        info.countReceived = uint64_t(balanceJson.value("count_received").toDouble());
+        info.countSpent = uint64_t(balanceJson.value("count_spent").toDouble());
+        info.countTxs = uint64_t(balanceJson.value("count_txs").toDouble());
+        info.currBlockNum = uint64_t(balanceJson.value("currentBlock").toDouble());
+        info.delegate = balanceJson.value("delegate").toString();
+        info.undelegate = balanceJson.value("undelegate").toString();
+        result.emplace_back(info);
+    }
+    return result.size();
+}
+
+static size_t parseBalancesStream(const std::string &response)
+{
+    return transactions::parseBalancesResponse(response).size();
+}
+
+static std::string readFixture(const QString &path)
+{
+    QFile file(path);
+    CHECK(file.open(QIODevice::ReadOnly), "Cannot open " + path.toStdString());
+    return file.readAll().toStdString();
+}
+
+static void checkHistoryEqual(const std::string &response)
+{
+    const std::vector<transactions::Transaction> txs = transactions::parseHistoryResponse("address", "mh", response);
+    const QJsonArray json = QJsonDocument::fromJson(QByteArray::fromStdString(response)).object().value("result").toArray();
+    CHECK(txs.size() == static_cast<size_t>(json.size()), "Incorrect count transactions");
+    for (size_t i = 0; i < txs.size(); i++) {
+        const QJsonObject txJson = json.at(static_cast<int>(i)).toObject();
+        CHECK(txs[i].tx == txJson.value("transaction").toString(), "Transaction hash not equal");
+        CHECK(txs[i].from == txJson.value("from").toString(), "Transaction from not equal");
+        CHECK(txs[i].blockNumber == static_cast<int64_t>(txJson.value("blockNumber").toDouble()), "Transaction block not equal");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const bool isSynthetic = argc > 1 && QString(argv[1]) == QStringLiteral("--synthetic");
+    std::string history;
+    std::string balances;
+    if (isSynthetic) {
+        history = makeHistoryFixture(5000);
+        balances = makeBalancesFixture(1000);
+    } else {
+        history = readFixture(argc > 1 ? QString(argv[1]) : QStringLiteral(":/responses/fetch-history.json"));
+        balances = readFixture(argc > 2 ? QString(argv[2]) : QStringLiteral(":/responses/fetch-balances.json"));
+    }
+    qDebug() << "History response" << history.size() << "bytes";
+    qDebug() << "Balances response" << balances.size() << "bytes";
+
+    checkHistoryEqual(history);
+
+    calcTime("history QJsonDocument", history, parseHistoryLegacy);
+    calcTime("history stream", history, parseHistoryStream);
+
+    calcTime("balances QJsonDocument", balances, parseBalancesLegacy);
+    calcTime("balances stream", balances, parseBalancesStream);
+
+    return 0;
+}
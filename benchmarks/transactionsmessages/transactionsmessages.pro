@@ -0,0 +1,30 @@
+QT -= gui
+QT += sql widgets
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+INCLUDEPATH = ../../src ../../src/transactions
+
+SOURCES += \
+    main.cpp \
+    ../../src/TypedException.cpp \
+    ../../src/utilites/BigNumber256.cpp \
+    ../../src/utilites/JsonStreamReader.cpp \
+    ../../tests/LogMock.cpp \
+    ../../src/transactions/TransactionsMessages.cpp
+
+
+HEADERS += \
+    ../../src/TypedException.h \
+    ../../src/utilites/BigNumber256.h \
+    ../../src/utilites/JsonStreamReader.h \
+    ../../src/Log.h \
+    ../../src/transactions/TransactionsMessages.h
+
+RESOURCES += ../../tests/tst_transactions/data/responses.qrc
+
+QMAKE_LFLAGS += -rdynamic
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
@@ -0,0 +1,82 @@
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <string>
+
+#include "Wallets/Wallet.h"
+#include "Wallets/SignSessions.h"
+#include "Wallets/openssl_wrapper/openssl_wrapper.h"
+#include "utilites/utils.h"
+
+static const size_t countSigns = 200;
+
+static const std::string password = "password";
+
+void calcTime(const QString &name, std::function<void()> func, int nmax = 3)
+{
+    qreal time = 0.0;
+    for (int n = 0; n < nmax; n++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        func();
+        std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+        time += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    }
+    time /= nmax;
+    time /= 1000000.0;
+
+    qDebug() << name << QString::number(time, 'f', 6) << "s" << QString::number(countSigns / time, 'f', 1) << "signs/s";
+}
+
+static void signOne(const Wallet &wallet, const std::string &toAddress, size_t nonce)
+{
+    std::string tx;
+    std::string signature;
+    std::string publicKey;
+    wallet.sign(toAddress, 1000 + nonce, 0, nonce, "", tx, signature, publicKey);
+    const std::string hash = Wallet::calcHash(tx, signature, publicKey);
+    Q_UNUSED(hash);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    if (!isInitOpenSSL()) {
+        InitOpenSSL();
+    }
+
+    std::string publicKey;
+    std::string address;
+    createFolder("./mhc");
+    Wallet::createWallet("./", true, password, publicKey, address);
+
+    // As onSignMessage2 before sessions: key file read and decrypted for every transaction
+    calcTime("load per sign", [&]{
+        for (size_t i = 0; i < countSigns; i++) {
+            const Wallet wallet("./", true, address, password);
+            signOne(wallet, address, i);
+        }
+    });
+
+    wallets::SignSessions sessions;
+    sessions.unlock("./", true, address, password, 60s, ::now());
+    calcTime("session per sign", [&]{
+        for (size_t i = 0; i < countSigns; i++) {
+            const auto wallet = sessions.getWallet("./", true, address, password, ::now());
+            signOne(*wallet, address, i);
+        }
+    });
+
+    // As onSignMessages2: one lookup for all transactions
+    calcTime("batch", [&]{
+        const auto wallet = sessions.getWallet("./", true, address, password, ::now());
+        for (size_t i = 0; i < countSigns; i++) {
+            signOne(*wallet, address, i);
+        }
+    });
+
+    return 0;
+}
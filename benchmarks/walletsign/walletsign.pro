@@ -0,0 +1,46 @@
+QT -= gui
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/Wallets/Wallet.cpp \
+    ../../src/Wallets/SignSessions.cpp \
+    ../../src/Wallets/EthWallet.cpp \
+    ../../src/Wallets/ethtx/scrypt/crypto_scrypt-nosse.cpp \
+    ../../src/Wallets/ethtx/scrypt/crypto_scrypt-sse.cpp \
+    ../../src/Wallets/ethtx/scrypt/sha256.cpp \
+    ../../src/Wallets/ethtx/cert.cpp \
+    ../../src/Wallets/ethtx/rlp.cpp \
+    ../../src/Wallets/ethtx/ethtx.cpp \
+    ../../src/Wallets/ethtx/cert2.cpp \
+    ../../src/Wallets/ethtx/scrypt/crypto_scrypt_saltgen.cpp \
+    ../../src/Wallets/ethtx/crossguid/Guid.cpp \
+    ../../src/Wallets/btctx/Base58.cpp \
+    ../../src/Wallets/btctx/btctx.cpp \
+    ../../src/Wallets/btctx/wif.cpp \
+    ../../src/Wallets/BtcWallet.cpp \
+    ../../src/Wallets/BtcCoinSelection.cpp \
+    ../../src/Wallets/openssl_wrapper/openssl_wrapper.cpp \
+    ../../src/utilites/utils.cpp \
+    ../../src/Wallets/ethtx/utils2.cpp \
+    ../../src/Wallets/WalletInfo.cpp \
+    ../../tests/LogMock.cpp
+
+
+HEADERS += \
+    ../../src/Wallets/Wallet.h \
+    ../../src/Wallets/SignSessions.h \
+    ../../src/Wallets/openssl_wrapper/openssl_wrapper.h \
+    ../../src/utilites/utils.h
+
+DEFINES += CRYPTOPP_IMPORTS
+DEFINES += QUAZIP_STATIC
+
+QMAKE_LFLAGS += -rdynamic
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
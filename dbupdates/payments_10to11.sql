@@ -0,0 +1,2 @@
+ALTER TABLE balance ADD backfillTarget INT8 NOT NULL DEFAULT 0;
+ALTER TABLE balance ADD backfillSaved INT8 NOT NULL DEFAULT 0;
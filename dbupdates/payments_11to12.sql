@@ -0,0 +1,2 @@
+CREATE TABLE paymentsStat ( id INTEGER PRIMARY KEY NOT NULL, currency VARCHAR(100) NOT NULL, address TEXT NOT NULL, countTxs INT8 NOT NULL DEFAULT 0, countPending INT8 NOT NULL DEFAULT 0, received BLOB NOT NULL DEFAULT '0', spent BLOB NOT NULL DEFAULT '0' );
+CREATE UNIQUE INDEX paymentsStatUniqueIdx ON paymentsStat ( address ASC, currency ASC);
@@ -0,0 +1,4 @@
+ALTER TABLE payments ADD flags INTEGER NOT NULL DEFAULT 0;
+UPDATE payments SET flags = (CASE WHEN ufrom = address THEN 1 ELSE 0 END) | (CASE WHEN uto = address THEN 2 ELSE 0 END) | (CASE WHEN type = 1 THEN 4 ELSE 0 END) | (CASE WHEN type = 2 THEN 8 ELSE 0 END) | (CASE WHEN intStatus = 4353 THEN 16 ELSE 0 END) | (CASE WHEN status = 0 THEN 32 ELSE 0 END);
+DROP INDEX IF EXISTS paymentsIdx2;
+CREATE INDEX paymentsIdx9 ON payments(address, currency, ts, txid, flags);
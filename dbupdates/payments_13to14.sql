@@ -0,0 +1,2 @@
+DROP INDEX IF EXISTS paymentsIdx9;
+CREATE INDEX paymentsIdx10 ON payments(address, currency, ts, txid, id, flags);
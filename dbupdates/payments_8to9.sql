@@ -0,0 +1,4 @@
+DROP INDEX IF EXISTS paymentsIdx1;
+DROP INDEX IF EXISTS paymentsIdx4;
+DROP INDEX IF EXISTS paymentsIdx6;
+DROP INDEX IF EXISTS paymentsIdx7;
@@ -0,0 +1 @@
+UPDATE balance SET received = CAST(received AS TEXT), spent = CAST(spent AS TEXT), delegate = CAST(delegate AS TEXT), undelegate = CAST(undelegate AS TEXT), delegated = CAST(delegated AS TEXT), undelegated = CAST(undelegated AS TEXT), reserved = CAST(reserved AS TEXT), forged = CAST(forged AS TEXT);
@@ -1414,7 +1414,7 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
-static QJsonDocument makeNetworkStatusResponse(const std::vector<NetworkTestingTestResult> &networkTestsResults, const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError) {
+static QJsonDocument makeNetworkStatusResponse(const std::vector<NetworkTestingTestResult> &networkTestsResults, const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError, const DnsCacheStats &dnsCacheStats) {
     QJsonObject result;
     QJsonArray networkTestsJson;
     for (const NetworkTestingTestResult &r: networkTestsResults) {
@@ -1432,6 +1432,14 @@ static QJsonDocument makeNetworkStatusResponse(const std::vector<NetworkTestingT
     }
     result.insert("dnsErrors", dnsErrorJson);
 
+    QJsonObject dnsCacheJson;
+    dnsCacheJson.insert("countRecords", (int)dnsCacheStats.countRecords);
+    dnsCacheJson.insert("hits", (int)dnsCacheStats.hits);
+    dnsCacheJson.insert("negativeHits", (int)dnsCacheStats.negativeHits);
+    dnsCacheJson.insert("misses", (int)dnsCacheStats.misses);
+    dnsCacheJson.insert("prefetches", (int)dnsCacheStats.prefetches);
+    result.insert("dnsCache", dnsCacheJson);
+
     QJsonArray nodesStatusesJson;
     for (const NodeTypeStatus &st: nodeStatuses) {
         QJsonObject stJson;
@@ -1449,8 +1457,8 @@ void JavascriptWrapper::getNetworkStatus() {
 BEGIN_SLOT_WRAPPER
     const QString JS_NAME_RESULT = "getNetworkStatusResultJs";
 
-    emit metagate.getNetworkStatus(metagate::MetaGate::GetNetworkStatusCallback([this, JS_NAME_RESULT](const std::vector<NetworkTestingTestResult> &networkTestsResults, const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError){
-        makeAndRunJsFuncParams(JS_NAME_RESULT, TypedException(), Opt<QJsonDocument>(makeNetworkStatusResponse(networkTestsResults, nodeStatuses, dnsError)));
+    emit metagate.getNetworkStatus(metagate::MetaGate::GetNetworkStatusCallback([this, JS_NAME_RESULT](const std::vector<NetworkTestingTestResult> &networkTestsResults, const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError, const DnsCacheStats &dnsCacheStats){
+        makeAndRunJsFuncParams(JS_NAME_RESULT, TypedException(), Opt<QJsonDocument>(makeNetworkStatusResponse(networkTestsResults, nodeStatuses, dnsError, dnsCacheStats)));
     }, [this, JS_NAME_RESULT](const TypedException &e) {
         makeAndRunJsFuncParams(JS_NAME_RESULT, e, Opt<QJsonDocument>());
     }, signalFunc));
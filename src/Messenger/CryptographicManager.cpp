@@ -9,6 +9,9 @@
 #include "utilites/utils.h"
 #include "qt_utilites/QRegister.h"
 #include "qt_utilites/ManagerWrapperImpl.h"
+#include "utilites/ThreadPool.h"
+
+#include "DecryptMessages.h"
 
 SET_LOG_NAMESPACE("MSG");
 
@@ -17,6 +20,7 @@ namespace messenger {
 CryptographicManager::CryptographicManager(QObject *parent)
     : TimerClass(1s, parent)
     , isSaveDecrypted_(false)
+    , decryptPool(std::make_unique<ThreadPool>(ThreadPool::defaultCountThreads()))
 {
     Q_CONNECT(this, &CryptographicManager::decryptMessages, this, &CryptographicManager::onDecryptMessages);
     Q_CONNECT(this, &CryptographicManager::tryDecryptMessages, this, &CryptographicManager::onTryDecryptMessages);
@@ -110,42 +114,10 @@ void CryptographicManager::timerMethod() {
     }
 }
 
-static std::vector<Message> decryptMsg(const std::vector<Message> &messages, const WalletRsa *walletRsa, bool isThrow) {
-    std::vector<Message> result;
-    result.reserve(messages.size());
-    std::transform(messages.begin(), messages.end(), std::back_inserter(result), [walletRsa, isThrow](const Message &message) {
-        if (message.isDecrypted) {
-            return message;
-        }
-        Message result = message;
-        const bool isEncrypted = !result.isChannel;
-        if (!isEncrypted) {
-            result.decryptedDataHex = result.dataHex;
-            result.isDecrypted = true;
-        } else {
-            if (result.isCanDecrypted) {
-                if (walletRsa == nullptr) {
-                    if (isThrow) {
-                        throwErrTyped(TypeErrors::WALLET_NOT_UNLOCK, "Wallet rsa not unlock");
-                    } else {
-                        return result;
-                    }
-                }
-                CHECK_TYPED(walletRsa != nullptr, TypeErrors::WALLET_NOT_UNLOCK, "Wallet rsa not unlock");
-                const std::string decryptedData = toHex(walletRsa->decryptMessage(result.dataHex.toStdString()));
-                result.decryptedDataHex = QString::fromStdString(decryptedData);
-                result.isDecrypted = true;
-            }
-        }
-        return result;
-    });
-    return result;
-}
-
 void CryptographicManager::onDecryptMessages(const std::vector<Message> &messages, const QString &address, const DecryptMessagesCallback &callback) {
 BEGIN_SLOT_WRAPPER
     runAndEmitCallback([&, this] {
-        return decryptMsg(messages, getWalletRsaWithoutCheck(address.toStdString()), true);
+        return decryptMsg(*decryptPool, messages, getWalletRsaWithoutCheck(address.toStdString()), true);
     }, callback);
 END_SLOT_WRAPPER
 }
@@ -153,7 +125,7 @@ END_SLOT_WRAPPER
 void CryptographicManager::onTryDecryptMessages(const std::vector<Message> &messages, const QString &address, const DecryptMessagesCallback &callback) {
 BEGIN_SLOT_WRAPPER
     runAndEmitCallback([&, this] {
-        return decryptMsg(messages, getWalletRsaWithoutCheck(address.toStdString()), false);
+        return decryptMsg(*decryptPool, messages, getWalletRsaWithoutCheck(address.toStdString()), false);
     }, callback);
 END_SLOT_WRAPPER
 }
@@ -10,6 +10,7 @@
 
 class Wallet;
 class WalletRsa;
+class ThreadPool;
 
 struct TypedException;
 
@@ -119,6 +120,8 @@ private:
 
     const bool isSaveDecrypted_;
 
+    std::unique_ptr<ThreadPool> decryptPool;
+
     std::unique_ptr<Wallet> wallet;
     std::unique_ptr<WalletRsa> walletRsa;
 
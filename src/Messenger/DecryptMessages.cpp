@@ -0,0 +1,60 @@
+#include "DecryptMessages.h"
+
+#include <algorithm>
+
+#include "Wallets/WalletRsa.h"
+
+#include "check.h"
+#include "TypedException.h"
+#include "utilites/utils.h"
+#include "utilites/ThreadPool.h"
+
+namespace messenger {
+
+static const size_t MIN_PARALLEL_DECRYPT = 16;
+
+Message decryptOneMsg(const Message &message, const WalletRsa *walletRsa, bool isThrow) {
+    if (message.isDecrypted) {
+        return message;
+    }
+    Message result = message;
+    const bool isEncrypted = !result.isChannel;
+    if (!isEncrypted) {
+        result.decryptedDataHex = result.dataHex;
+        result.isDecrypted = true;
+    } else {
+        if (result.isCanDecrypted) {
+            if (walletRsa == nullptr) {
+                if (isThrow) {
+                    throwErrTyped(TypeErrors::WALLET_NOT_UNLOCK, "Wallet rsa not unlock");
+                } else {
+                    return result;
+                }
+            }
+            CHECK_TYPED(walletRsa != nullptr, TypeErrors::WALLET_NOT_UNLOCK, "Wallet rsa not unlock");
+            const std::string decryptedData = toHex(walletRsa->decryptMessage(result.dataHex.toStdString()));
+            result.decryptedDataHex = QString::fromStdString(decryptedData);
+            result.isDecrypted = true;
+        }
+    }
+    return result;
+}
+
+std::vector<Message> decryptMsg(ThreadPool &pool, const std::vector<Message> &messages, const WalletRsa *walletRsa, bool isThrow) {
+    std::vector<Message> result(messages.size());
+    if (messages.size() < MIN_PARALLEL_DECRYPT) {
+        std::transform(messages.begin(), messages.end(), result.begin(), [walletRsa, isThrow](const Message &message) {
+            return decryptOneMsg(message, walletRsa, isThrow);
+        });
+        return result;
+    }
+    // Private key is only read here, so each chunk writes its own part of result
+    pool.parallelFor(messages.size(), [&messages, &result, walletRsa, isThrow](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            result[i] = decryptOneMsg(messages[i], walletRsa, isThrow);
+        }
+    });
+    return result;
+}
+
+}
@@ -0,0 +1,21 @@
+#ifndef DECRYPTMESSAGES_H
+#define DECRYPTMESSAGES_H
+
+#include <vector>
+
+#include "Message.h"
+
+class WalletRsa;
+class ThreadPool;
+
+namespace messenger {
+
+// Messages of channels are copied to decryptedDataHex. Without walletRsa throws if isThrow, otherwise message stays not decrypted
+Message decryptOneMsg(const Message &message, const WalletRsa *walletRsa, bool isThrow);
+
+// Result is in order of messages. Large batches are decrypted on pool
+std::vector<Message> decryptMsg(ThreadPool &pool, const std::vector<Message> &messages, const WalletRsa *walletRsa, bool isThrow);
+
+}
+
+#endif // DECRYPTMESSAGES_H
@@ -32,6 +32,8 @@ SET_LOG_NAMESPACE("MSG");
 
 namespace messenger {
 
+static const size_t DECRYPT_PAGE_SIZE = 1000;
+
 static QString createHashMessage(const QString &message) {
     return QString(QCryptographicHash::hash(message.toUtf8(), QCryptographicHash::Sha512).toHex());
 }
@@ -923,28 +925,45 @@ BEGIN_SLOT_WRAPPER
         return;
     }
     runAndEmitErrorCallback([&, this] {
-        const auto notDecryptedMessagesPair = db.getNotDecryptedMessage(address);
-        CHECK(notDecryptedMessagesPair.first.size() == notDecryptedMessagesPair.second.size(), "Incorrect db.getNotDecryptedMessage");
-        const std::vector<Message> &notDecryptedMessages = notDecryptedMessagesPair.second;
-        cryptManager.tryDecryptMessages(notDecryptedMessages, address, CryptographicManager::DecryptMessagesCallback([this, ids=notDecryptedMessagesPair.first, callback](const std::vector<Message> &answer) {
-            CHECK(ids.size() == answer.size(), "Incorrect tryDecryptMessages");
-            std::vector<std::tuple<MessengerDBStorage::DbId, bool, QString>> result;
-            result.reserve(ids.size());
-            for (size_t i = 0; i < ids.size(); i++) {
-                result.emplace_back(ids[i], answer[i].isDecrypted, answer[i].decryptedDataHex);
-            }
-            db.updateDecryptedMessage(result);
-
-            LOG << "Decrypted " << result.size() << " messages";
-
-            callback.emitCallback();
-        }, [callback](const TypedException &exception) {
-            callback.emitException(exception);
-        }, std::bind(&Messenger::callbackCall, this, _1), true));
+        decryptMessagesPage(address, false, -1, 0, callback);
     }, callback);
 END_SLOT_WRAPPER
 }
 
+void Messenger::decryptMessagesPage(const QString &address, bool isChannel, qint64 afterId, size_t countDecrypted, const DecryptUserMessagesCallback &callback) {
+    const auto notDecryptedMessagesPair = db.getNotDecryptedMessagePage(address, isChannel, afterId, DECRYPT_PAGE_SIZE);
+    CHECK(notDecryptedMessagesPair.first.size() == notDecryptedMessagesPair.second.size(), "Incorrect db.getNotDecryptedMessagePage");
+    if (notDecryptedMessagesPair.first.empty()) {
+        if (!isChannel) {
+            decryptMessagesPage(address, true, -1, countDecrypted, callback);
+        } else {
+            LOG << "Decrypted " << countDecrypted << " messages";
+            callback.emitCallback();
+        }
+        return;
+    }
+
+    const std::vector<Message> &notDecryptedMessages = notDecryptedMessagesPair.second;
+    cryptManager.tryDecryptMessages(notDecryptedMessages, address, CryptographicManager::DecryptMessagesCallback([this, address, isChannel, countDecrypted, ids=notDecryptedMessagesPair.first, callback](const std::vector<Message> &answer) {
+        CHECK(ids.size() == answer.size(), "Incorrect tryDecryptMessages");
+        std::vector<std::tuple<MessengerDBStorage::DbId, bool, QString>> result;
+        result.reserve(ids.size());
+        size_t countDecryptedPage = 0;
+        for (size_t i = 0; i < ids.size(); i++) {
+            result.emplace_back(ids[i], answer[i].isDecrypted, answer[i].decryptedDataHex);
+            if (answer[i].isDecrypted) {
+                countDecryptedPage++;
+            }
+        }
+        db.updateDecryptedMessage(result);
+
+        // Not decrypted messages stay in the table, so the next page starts after the last id
+        decryptMessagesPage(address, isChannel, ids.back(), countDecrypted + countDecryptedPage, callback);
+    }, [callback](const TypedException &exception) {
+        callback.emitException(exception);
+    }, std::bind(&Messenger::callbackCall, this, _1), true));
+}
+
 void Messenger::onIsCompleteUser(const QString &address, const CompleteUserCallback &callback) {
 BEGIN_SLOT_WRAPPER
     runAndEmitCallback([&, this] {
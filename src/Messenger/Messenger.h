@@ -367,6 +367,8 @@ private:
 
     void processAddOrDeleteInChannel(const QString &address, const ChannelInfo &channel, bool isAdd);
 
+    void decryptMessagesPage(const QString &address, bool isChannel, qint64 afterId, size_t countDecrypted, const DecryptUserMessagesCallback &callback);
+
 private:
 
     bool isDecryptDataSave = false;
@@ -343,6 +343,30 @@ static const QString selectNotDecryptedMessagesChannelsQuery = "SELECT m.id, u.u
                                                         "AND u.username = :user "
                                                         "ORDER BY m.morder ASC";
 
+static const QString selectNotDecryptedMessagesContactsPageQuery = "SELECT m.id, u.username AS user, c.username AS dest, m.isIncoming, m.text, m.decryptedText, m.isDecrypted, "
+                                                  "m.morder, m.dt, m.fee, m.canDecrypted, m.isConfirmed, m.hash "
+                                                        "FROM messages m "
+                                                        "INNER JOIN users u ON u.id = m.userid "
+                                                        "INNER JOIN contacts c ON c.id = m.contactid "
+                                                        "WHERE m.isDecrypted = 0 "
+                                                        "AND m.canDecrypted = 1 "
+                                                        "AND u.username = :user "
+                                                        "AND m.id > :afterId "
+                                                        "ORDER BY m.id ASC "
+                                                        "LIMIT :count";
+
+static const QString selectNotDecryptedMessagesChannelsPageQuery = "SELECT m.id, u.username AS user, c.shaName AS dest, m.isIncoming, m.text, m.decryptedText, m.isDecrypted, "
+                                                  "m.morder, m.dt, m.fee, m.canDecrypted, m.isConfirmed, m.hash "
+                                                        "FROM messages m "
+                                                        "INNER JOIN users u ON u.id = m.userid "
+                                                        "INNER JOIN channels c ON c.id = m.channelid "
+                                                        "WHERE m.isDecrypted = 0 "
+                                                        "AND m.canDecrypted = 1 "
+                                                        "AND u.username = :user "
+                                                        "AND m.id > :afterId "
+                                                        "ORDER BY m.id ASC "
+                                                        "LIMIT :count";
+
 static const QString updateDecryptedMessageQuery = "UPDATE messages "
                                         "SET isDecrypted = :isDecrypted, decryptedText = :decryptedText "
                                         "WHERE id = :id";
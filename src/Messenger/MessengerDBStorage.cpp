@@ -602,15 +602,33 @@ std::pair<std::vector<MessengerDBStorage::DbId>, std::vector<Message>> Messenger
     return std::make_pair(ids, result);
 }
 
+std::pair<std::vector<MessengerDBStorage::DbId>, std::vector<Message>> MessengerDBStorage::getNotDecryptedMessagePage(const QString &user, bool isChannel, DbId afterId, size_t count) {
+    std::vector<Message> messages;
+    std::vector<DbId> ids;
+    QSqlQuery query(database());
+    query.setForwardOnly(true);
+    CHECK(query.prepare(isChannel ? selectNotDecryptedMessagesChannelsPageQuery : selectNotDecryptedMessagesContactsPageQuery), query.lastError().text().toStdString());
+    query.bindValue(":user", user);
+    query.bindValue(":afterId", afterId);
+    query.bindValue(":count", static_cast<qint64>(count));
+    CHECK(query.exec(), query.lastError().text().toStdString());
+    messages.reserve(count);
+    ids.reserve(count);
+    createMessagesList(query, messages, ids, true, isChannel, false);
+
+    CHECK(messages.size() == ids.size(), "Incorrect result");
+    return std::make_pair(ids, messages);
+}
+
 void MessengerDBStorage::updateDecryptedMessage(const std::vector<std::tuple<DbId, bool, QString>> &messages) {
     auto transactionGuard = beginTransaction();
+    QSqlQuery query(database());
+    CHECK(query.prepare(updateDecryptedMessageQuery), query.lastError().text().toStdString());
     for (const auto &messageTuple: messages) {
-        QSqlQuery query(database());
-        CHECK(query.prepare(updateDecryptedMessageQuery), query.lastError().text().toStdString());
         query.bindValue(":id", std::get<0>(messageTuple));
         query.bindValue(":isDecrypted", std::get<1>(messageTuple));
         query.bindValue(":decryptedText", std::get<2>(messageTuple));
-        query.exec();
+        CHECK(query.exec(), query.lastError().text().toStdString());
     }
     transactionGuard.commit();
 }
@@ -78,6 +78,9 @@ public:
 
     std::pair<std::vector<DbId>, std::vector<Message>> getNotDecryptedMessage(const QString &user);
 
+    // Keyset page by message id. Pass the last id of the previous page as afterId, -1 for the first page
+    std::pair<std::vector<DbId>, std::vector<Message>> getNotDecryptedMessagePage(const QString &user, bool isChannel, DbId afterId, size_t count);
+
     void updateDecryptedMessage(const std::vector<std::tuple<DbId, bool, QString>> &messages);
 
 protected:
@@ -184,8 +184,8 @@ void MetaGate::onGetNetworkStatus(const GetNetworkStatusCallback &callback) {
 BEGIN_SLOT_WRAPPER
     runAndEmitErrorCallback([&]{
         networkTesting.getTestResults(NetwrokTesting::GetTestResultsCallback([this, callback](const std::vector<NetworkTestingTestResult> &networkTestsResults) {
-            nsLookup.getStatus(NsLookup::GetStatusCallback([networkTestsResults, callback](const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError) {
-                callback.emitCallback(networkTestsResults, nodeStatuses, dnsError);
+            nsLookup.getStatus(NsLookup::GetStatusCallback([networkTestsResults, callback](const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError, const DnsCacheStats &dnsCacheStats) {
+                callback.emitCallback(networkTestsResults, nodeStatuses, dnsError, dnsCacheStats);
             }, callback, signalFunc));
         }, callback, signalFunc));
     }, callback);
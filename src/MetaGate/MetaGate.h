@@ -28,6 +28,7 @@ class Uploader;
 
 struct NodeTypeStatus;
 struct DnsErrorDetails;
+struct DnsCacheStats;
 struct NetworkTestingTestResult;
 
 namespace metagate {
@@ -50,7 +51,7 @@ public:
 
     using GetForgingActiveCallback = CallbackWrapper<void(bool result)>;
 
-    using GetNetworkStatusCallback = CallbackWrapper<void(const std::vector<NetworkTestingTestResult> &networkTestsResults, const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError)>;
+    using GetNetworkStatusCallback = CallbackWrapper<void(const std::vector<NetworkTestingTestResult> &networkTestsResults, const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError, const DnsCacheStats &dnsCacheStats)>;
 
 public:
 
@@ -27,7 +27,7 @@ MetaGateJavascript::MetaGateJavascript(MetaGate &metagate)
     Q_CONNECT(&metagate, &MetaGate::showExchangePopup, this, &MetaGateJavascript::onShowExchangePopup);
 }
 
-static QJsonDocument makeNetworkStatusResponse(const std::vector<NetworkTestingTestResult> &networkTestsResults, const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError) {
+static QJsonDocument makeNetworkStatusResponse(const std::vector<NetworkTestingTestResult> &networkTestsResults, const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError, const DnsCacheStats &dnsCacheStats) {
     QJsonObject result;
     QJsonArray networkTestsJson;
     for (const NetworkTestingTestResult &r: networkTestsResults) {
@@ -45,6 +45,14 @@ static QJsonDocument makeNetworkStatusResponse(const std::vector<NetworkTestingT
     }
     result.insert("dnsErrors", dnsErrorJson);
 
+    QJsonObject dnsCacheJson;
+    dnsCacheJson.insert("countRecords", (int)dnsCacheStats.countRecords);
+    dnsCacheJson.insert("hits", (int)dnsCacheStats.hits);
+    dnsCacheJson.insert("negativeHits", (int)dnsCacheStats.negativeHits);
+    dnsCacheJson.insert("misses", (int)dnsCacheStats.misses);
+    dnsCacheJson.insert("prefetches", (int)dnsCacheStats.prefetches);
+    result.insert("dnsCache", dnsCacheJson);
+
     QJsonArray nodesStatusesJson;
     for (const NodeTypeStatus &st: nodeStatuses) {
         QJsonObject stJson;
@@ -181,8 +189,8 @@ BEGIN_SLOT_WRAPPER
     LOG << "Get network status";
 
     wrapOperation([&, this](){
-        emit metagate.getNetworkStatus(metagate::MetaGate::GetNetworkStatusCallback([makeFunc](const std::vector<NetworkTestingTestResult> &networkTestsResults, const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError){
-            makeFunc.func(TypedException(), makeNetworkStatusResponse(networkTestsResults, nodeStatuses, dnsError));
+        emit metagate.getNetworkStatus(metagate::MetaGate::GetNetworkStatusCallback([makeFunc](const std::vector<NetworkTestingTestResult> &networkTestsResults, const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError, const DnsCacheStats &dnsCacheStats){
+            makeFunc.func(TypedException(), makeNetworkStatusResponse(networkTestsResults, nodeStatuses, dnsError, dnsCacheStats));
         }, makeFunc.error, signalFunc));
     }, makeFunc.error);
 END_SLOT_WRAPPER
@@ -10,6 +10,8 @@ using namespace std::placeholders;
 
 #include <QThread>
 
+#include <algorithm>
+
 QT_USE_NAMESPACE
 
 HttpSimpleClient::HttpSimpleClient() {
@@ -22,6 +24,13 @@ void HttpSimpleClient::moveToThread(QThread *thread)
     QObject::moveToThread(thread);
 }
 
+void HttpSimpleClient::setPoolParameters(bool isKeepAlive, size_t maxConnectionsPerHost, milliseconds idleTimeout)
+{
+    this->isKeepAlive = isKeepAlive;
+    this->maxConnectionsPerHost = maxConnectionsPerHost;
+    this->idleTimeout = idleTimeout;
+}
+
 void HttpSimpleClient::startTimer1()
 {
     if (timer == nullptr) {
@@ -65,6 +74,11 @@ static milliseconds getTimeout(AbstractSocket *socket)
     return  socket->timeOut();
 }
 
+static QString getHostKey(const QUrl &url)
+{
+    return url.host() + QStringLiteral(":") + QString::number(url.port(80));
+}
+
 void HttpSimpleClient::onTimerEvent()
 {
 BEGIN_SLOT_WRAPPER
@@ -86,6 +100,36 @@ BEGIN_SLOT_WRAPPER
     for (AbstractSocket *socket: toStop) {
         socket->stop();
     }
+
+    std::vector<int> toTimeout;
+    for (auto &pair: pendingRequests) {
+        std::deque<PendingRequest> &requests = pair.second;
+        const auto removeBegin = std::remove_if(requests.begin(), requests.end(), [&toTimeout, timeEnd](const PendingRequest &request) {
+            if (request.isTimeout && timeEnd - request.beginTime >= request.timeout) {
+                toTimeout.push_back(request.id);
+                return true;
+            }
+            return false;
+        });
+        requests.erase(removeBegin, requests.end());
+    }
+
+    for (const int requestId: toTimeout) {
+        LOG << "Timeout request in queue";
+        runCallback(callbacks, requestId, "", TypedException(TypeErrors::CLIENT_ERROR, "Timeout while waiting for connection"));
+    }
+
+    for (auto &pair: idleSockets) {
+        auto &idle = pair.second;
+        const auto removeBegin = std::remove_if(idle.begin(), idle.end(), [this, timeEnd](const std::pair<HttpSocket *, time_point> &element) {
+            if (timeEnd - element.second >= idleTimeout || !element.first->isReusable()) {
+                element.first->deleteLater();
+                return true;
+            }
+            return false;
+        });
+        idle.erase(removeBegin, idle.end());
+    }
     END_SLOT_WRAPPER
 }
 
@@ -93,18 +137,70 @@ void HttpSimpleClient::sendMessagePost(const QUrl &url, const QString &message,
 {
     startTimer1();
 
-    std::unique_ptr<HttpSocket> socket(new HttpSocket(url, message));
+    PendingRequest request;
+    request.id = id;
+    request.url = url;
+    request.message = message;
+    request.isTimeout = isTimeout;
+    request.beginTime = ::now();
+    request.timeout = timeout;
     callbacks[id] = callback;
-    sockets[id] = socket.get();
-    addRequestId(socket.get(), id);
     id++;
-    if (isTimeout) {
-        const time_point time = ::now();
-        addBeginTime(socket.get(), time);
-        addTimeout(socket.get(), timeout);
+
+    const QString host = getHostKey(url);
+    if (maxConnectionsPerHost != 0 && countActiveSockets[host] >= maxConnectionsPerHost) {
+        pendingRequests[host].emplace_back(request);
+        return;
+    }
+    startRequest(request, false);
+}
+
+void HttpSimpleClient::startRequest(const PendingRequest &request, bool isNewConnection)
+{
+    const QString host = getHostKey(request.url);
+
+    HttpSocket *socket = nullptr;
+    auto &idle = idleSockets[host];
+    while (!isNewConnection && socket == nullptr && !idle.empty()) {
+        HttpSocket *candidate = idle.back().first;
+        idle.pop_back();
+        if (candidate->isReusable()) {
+            socket = candidate;
+        } else {
+            candidate->deleteLater();
+        }
+    }
+
+    const bool isReused = socket != nullptr;
+    if (!isReused) {
+        socket = new HttpSocket(request.url, request.message, isKeepAlive);
+        Q_CONNECT(socket, &HttpSocket::finished, this, &HttpSimpleClient::onSocketFinished);
+    }
+    countActiveSockets[host]++;
+    sockets[request.id] = socket;
+    addRequestId(socket, request.id);
+    // Pooled socket keeps the timeout of its previous request, so it is assigned on every start
+    if (request.isTimeout) {
+        addBeginTime(socket, request.beginTime);
+        addTimeout(socket, request.timeout);
+    } else {
+        socket->resetTimeOut();
+    }
+    if (isReused) {
+        socket->restart(request.message);
+    } else {
+        socket->start();
+    }
+}
+
+void HttpSimpleClient::startPendingRequests(const QString &host)
+{
+    auto found = pendingRequests.find(host);
+    while (found != pendingRequests.end() && !found->second.empty() && (maxConnectionsPerHost == 0 || countActiveSockets[host] < maxConnectionsPerHost)) {
+        const PendingRequest request = found->second.front();
+        found->second.pop_front();
+        startRequest(request, false);
     }
-    Q_CONNECT(socket.get(), &HttpSocket::finished, this, &HttpSimpleClient::onSocketFinished);
-    socket.release()->start();
 }
 
 void HttpSimpleClient::sendMessagePost(const QUrl &url, const QString &message, const ClientCallback &callback)
@@ -149,6 +245,35 @@ BEGIN_SLOT_WRAPPER
     AbstractSocket *socket = qobject_cast<AbstractSocket *>(sender());
     CHECK(socket, "Not socket object");
     const int requestId = getRequestId(socket);
+
+    HttpSocket *httpSocket = qobject_cast<HttpSocket *>(socket);
+    QString host;
+    if (httpSocket != nullptr) {
+        host = getHostKey(httpSocket->url());
+        countActiveSockets[host]--;
+
+        // Server could close idle connection right before it was reused. Request is repeated once over new connection
+        if (socket->hasError() && httpSocket->isReused() && socket->errorC() == QAbstractSocket::RemoteHostClosedError && !httpSocket->hasResponseData()) {
+            PendingRequest request;
+            request.id = requestId;
+            request.url = httpSocket->url();
+            request.message = httpSocket->message();
+            request.isTimeout = socket->hasTimeOut();
+            request.beginTime = getBeginTime(socket);
+            request.timeout = getTimeout(socket);
+            socket->deleteLater();
+            startRequest(request, true);
+            return;
+        }
+    }
+
+    // Socket returns to pool before callback, so request sent from callback can reuse it
+    if (httpSocket != nullptr && httpSocket->isReusable()) {
+        idleSockets[host].emplace_back(httpSocket, ::now());
+    } else {
+        socket->deleteLater();
+    }
+
     if (socket->hasError()) {
         runCallback(callbacks, requestId, "", TypedException(TypeErrors::CLIENT_ERROR, std::to_string(socket->errorC()) + " " + socket->errorString().toStdString()));
     } else {
@@ -156,7 +281,9 @@ BEGIN_SLOT_WRAPPER
         runCallback(callbacks, requestId, std::string(content.data(), content.size()), TypedException());
     }
 
-    socket->deleteLater();
+    if (httpSocket != nullptr) {
+        startPendingRequests(host);
+    }
 
 END_SLOT_WRAPPER
 }
@@ -199,6 +326,11 @@ void AbstractSocket::setTimePoint(time_point s)
     m_hasTimeOut = true;
 }
 
+void AbstractSocket::resetTimeOut()
+{
+    m_hasTimeOut = false;
+}
+
 milliseconds AbstractSocket::timeOut() const
 {
     return m_timeOut;
@@ -226,9 +358,14 @@ END_SLOT_WRAPPER
 void HttpSocket::onError(QAbstractSocket::SocketError socketError)
 {
 BEGIN_SLOT_WRAPPER
+    if (!m_isActive) {
+        // Idle connection closed by server
+        m_isBroken = true;
+        return;
+    }
     errorCode = socketError;
     m_error = true;
-    emit finished();
+    finish();
 END_SLOT_WRAPPER
 }
 
@@ -236,32 +373,47 @@ void HttpSocket::onReadyRead()
 {
 BEGIN_SLOT_WRAPPER
     QByteArray d = readAll();
+    if (!m_isActive) {
+        m_isBroken = true;
+        return;
+    }
     m_data += d;
     parseResponseHeader();
     if (m_error) {
         abort();
-        emit finished();
+        finish();
+        return;
     }
     if (m_headerParsed) {
         if (m_contentLength != -1) {
             if (m_data.length() >= m_contentLength) {
                 m_reply = m_data.left(m_contentLength);
-                emit finished();
+                if (m_data.length() > m_contentLength) {
+                    m_isBroken = true;
+                }
+                finish();
             }
         } else {
             m_error = true;
             abort();
-            emit finished();
+            finish();
         }
 
     }
 END_SLOT_WRAPPER
 }
 
-HttpSocket::HttpSocket(const QUrl &url, const QString &message, QObject *parent)
+void HttpSocket::finish()
+{
+    m_isActive = false;
+    emit finished();
+}
+
+HttpSocket::HttpSocket(const QUrl &url, const QString &message, bool isKeepAlive, QObject *parent)
     : AbstractSocket(parent)
     , m_url(url)
     , m_message(message)
+    , m_isKeepAlive(isKeepAlive)
 {
     Q_CONNECT(this, &QAbstractSocket::connected, this, &HttpSocket::onConnected);
     Q_CONNECT(this, static_cast<void (QTcpSocket::*)(QAbstractSocket::SocketError)>(&QAbstractSocket::error), this, &HttpSocket::onError);
@@ -273,6 +425,29 @@ void HttpSocket::start()
     connectToHost(m_url.host(), m_url.port(80));
 }
 
+void HttpSocket::restart(const QString &message)
+{
+    CHECK(!m_isActive, "Socket is busy");
+    m_message = message;
+    m_data.clear();
+    m_reply.clear();
+    m_headerParsed = false;
+    m_contentLength = -1;
+    m_firstHeaderStringParsed = false;
+    m_serverKeepAlive = false;
+    m_error = false;
+    errorCode = 0;
+    m_isActive = true;
+    m_isReused = true;
+
+    onConnected();
+}
+
+bool HttpSocket::isReusable() const
+{
+    return m_isKeepAlive && m_serverKeepAlive && !m_isActive && !m_error && !m_isBroken && state() == QAbstractSocket::ConnectedState;
+}
+
 QByteArray HttpSocket::getHttpPostHeader() const
 {
     QString data;
@@ -283,6 +458,9 @@ QByteArray HttpSocket::getHttpPostHeader() const
     data += QStringLiteral("Accept: */*\r\n");
     data += QStringLiteral("Accept-Encoding: identity\r\n");
     data += QStringLiteral("Content-Length: %1\r\n").arg(m_message.toLatin1().length());
+    if (!m_isKeepAlive) {
+        data += QStringLiteral("Connection: close\r\n");
+    }
     data += QStringLiteral("\r\n");
 
     return data.toLatin1();
@@ -303,6 +481,8 @@ void HttpSocket::parseResponseHeader()
                 m_error = true;
                 return;
             }
+            // HTTP/1.1 keeps connection open unless server says otherwise
+            m_serverKeepAlive = s.startsWith("HTTP/1.1");
             m_firstHeaderStringParsed = true;
         }
         m_data = m_data.mid(index + 1);
@@ -310,6 +490,14 @@ void HttpSocket::parseResponseHeader()
             m_headerParsed = true;
             return;
         }
+        const QByteArray lower = s.toLower();
+        if (lower.startsWith("connection:")) {
+            if (lower.contains("close")) {
+                m_serverKeepAlive = false;
+            } else if (lower.contains("keep-alive")) {
+                m_serverKeepAlive = true;
+            }
+        }
         if (s.startsWith("Content-Length: ")) {
             s = s.mid(16);
             if (s.endsWith('\r'))
@@ -9,6 +9,8 @@
 #include <memory>
 #include <functional>
 #include <map>
+#include <deque>
+#include <vector>
 #include <string>
 
 #include "duration.h"
@@ -44,6 +46,8 @@ public:
     milliseconds timeOut() const;
     void setTimeOut(milliseconds s);
 
+    void resetTimeOut();
+
     QByteArray getReply() const;
 
     int errorC() const {
@@ -68,10 +72,32 @@ class HttpSocket : public AbstractSocket
 {
     Q_OBJECT
 public:
-    explicit HttpSocket(const QUrl &url, const QString &message, QObject *parent = nullptr);
+    explicit HttpSocket(const QUrl &url, const QString &message, bool isKeepAlive, QObject *parent = nullptr);
 
     void start();
 
+    // Sends next request over the connection left open by previous one
+    void restart(const QString &message);
+
+    // Both sides agreed to keep connection open and previous response was read completely
+    bool isReusable() const;
+
+    bool isReused() const {
+        return m_isReused;
+    }
+
+    bool hasResponseData() const {
+        return !m_data.isEmpty() || m_firstHeaderStringParsed;
+    }
+
+    const QUrl& url() const {
+        return m_url;
+    }
+
+    const QString& message() const {
+        return m_message;
+    }
+
 private slots:
     void onConnected();
     void onError(QAbstractSocket::SocketError socketError);
@@ -80,6 +106,7 @@ private slots:
 private:
     QByteArray getHttpPostHeader() const;
     void parseResponseHeader();
+    void finish();
 
     QUrl m_url;
     QString m_message;
@@ -87,6 +114,12 @@ private:
     bool m_headerParsed = false;
     int m_contentLength = -1;
     bool m_firstHeaderStringParsed = false;
+
+    const bool m_isKeepAlive;
+    bool m_serverKeepAlive = false;
+    bool m_isActive = true;
+    bool m_isReused = false;
+    bool m_isBroken = false;
 };
 
 class PingSocket : public AbstractSocket
@@ -130,6 +163,9 @@ public:
 
     void moveToThread(QThread *thread);
 
+    // maxConnectionsPerHost == 0 removes the limit. Requests above the limit wait for a free connection
+    void setPoolParameters(bool isKeepAlive, size_t maxConnectionsPerHost, milliseconds idleTimeout);
+
 Q_SIGNALS:
 
     void callbackCall(HttpSimpleClient::ReturnCallback callback);
@@ -141,9 +177,24 @@ private slots:
     void onSocketFinished();
     void onTimerEvent();
 
+private:
+
+    struct PendingRequest {
+        int id;
+        QUrl url;
+        QString message;
+        bool isTimeout;
+        time_point beginTime;
+        milliseconds timeout;
+    };
+
 private:
     void sendMessagePost(const QUrl &url, const QString &message, const ClientCallback &callback, bool isTimeout, milliseconds timeout);
 
+    void startRequest(const PendingRequest &request, bool isNewConnection);
+
+    void startPendingRequests(const QString &host);
+
     template<class Callbacks, typename... Message>
     void runCallback(Callbacks &callbacks, const int id, Message&&... messages);
 
@@ -153,6 +204,15 @@ private:
     std::map<int, ClientCallback> callbacks;
     std::map<int, AbstractSocket *> sockets;
 
+    bool isKeepAlive = true;
+    size_t maxConnectionsPerHost = 8;
+    milliseconds idleTimeout = 30s;
+
+    // Key is host:port
+    std::map<QString, std::vector<std::pair<HttpSocket *, time_point>>> idleSockets;
+    std::map<QString, size_t> countActiveSockets;
+    std::map<QString, std::deque<PendingRequest>> pendingRequests;
+
     QTimer* timer = nullptr;
     QThread *thread1 = nullptr;
 
@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include <memory>
+#include <algorithm>
+#include <map>
 using namespace std::placeholders;
 
 #include "check.h"
@@ -20,6 +22,13 @@ const int SimpleClient::ServerException::BAD_REQUEST_ERROR = QNetworkReply::Prot
 
 const int SimpleClient::ServerException::TIMEOUT_REQUEST_ERROR = QNetworkReply::TimeoutError;
 
+const int SimpleClient::ServerException::CANCELED_REQUEST_ERROR = -1;
+
+static const size_t HEDGE_LATENCIES_SIZE = 200;
+static const size_t HEDGE_MIN_LATENCIES = 20;
+static const milliseconds HEDGE_DEFAULT_DELAY = 500ms;
+static const milliseconds HEDGE_MIN_DELAY = 20ms;
+
 template<class Callback>
 class CallbackWrapImpl {
 public:
@@ -101,6 +110,23 @@ private:
     const size_t index;
 };
 
+struct SimpleClient::HedgedRequest {
+    std::string printedName;
+    std::vector<QUrl> urls;
+    QString message;
+    ClientCallbacks callback;
+    milliseconds timeout;
+    time_point beginTime;
+    size_t countAnswers = 0;
+
+    std::vector<Response> responses;
+    // request id -> url index
+    std::map<size_t, size_t> inFlight;
+    size_t nextUrl = 0;
+    size_t countSuccess = 0;
+    bool emitted = false;
+};
+
 bool SimpleClient::ServerException::isTimeout() const {
     return code == QNetworkReply::OperationCanceledError || code == QNetworkReply::TimeoutError;
 }
@@ -113,6 +139,10 @@ SimpleClient::SimpleClient()
 
 SimpleClient::~SimpleClient() = default;
 
+void SimpleClient::setResponseObserver(const ResponseObserver &observer) {
+    responseObserver = observer;
+}
+
 void SimpleClient::setParent(QObject *obj) {
     manager->setParent(obj);
 }
@@ -136,7 +166,7 @@ void SimpleClient::startTimer1() {
 
 void SimpleClient::onTimerEvent() {
 BEGIN_SLOT_WRAPPER
-    std::vector<std::reference_wrapper<Request>> toDelete;
+    std::vector<size_t> toDelete;
     const time_point timeEnd = ::now();
     for (auto &iter: requests) {
         Request &request = iter.second;
@@ -147,20 +177,25 @@ BEGIN_SLOT_WRAPPER
             const milliseconds duration = std::chrono::duration_cast<milliseconds>(timeEnd - timeBegin);
             if (duration >= timeout) {
                 LOG << PeriodicLog::make("cl_tm") << "Timeout request";
-                toDelete.emplace_back(request);
+                toDelete.emplace_back(iter.first);
             }
         }
     }
 
-    for (Request& reply: toDelete) {
-        reply.isTimeout = true;
-        reply.reply->abort();
+    // Callbacks of hedged requests can cancel other requests
+    for (const size_t requestId: toDelete) {
+        const auto found = requests.find(requestId);
+        if (found == requests.end()) {
+            continue;
+        }
+        found->second.isTimeout = true;
+        found->second.reply->abort();
     }
 END_SLOT_WRAPPER
 }
 
 template<typename Callback>
-void SimpleClient::sendMessageInternal(
+size_t SimpleClient::sendMessageInternal(
     bool isPost,
     const QUrl &url,
     const QString &message,
@@ -168,7 +203,8 @@ void SimpleClient::sendMessageInternal(
     bool isTimeout,
     milliseconds timeout,
     bool isClearCache,
-    bool isQueuedConnection
+    bool isQueuedConnection,
+    bool isInternal
 ) {
     const size_t requestId = id++;
 
@@ -182,6 +218,7 @@ void SimpleClient::sendMessageInternal(
     r.isSetTimeout = isTimeout;
     r.timeout = timeout;
     r.callback = callback;
+    r.isInternal = isInternal;
     if (isClearCache) {
         manager->clearAccessCache();
         manager->clearConnectionCache();
@@ -199,6 +236,19 @@ void SimpleClient::sendMessageInternal(
     }
     Q_CONNECT2(reply, &QNetworkReply::finished, this, std::bind(&SimpleClient::onTextMessageReceived, this, requestId), connType);
     requests[requestId] = r;
+    return requestId;
+}
+
+void SimpleClient::cancelRequest(size_t id) {
+    const auto found = requests.find(id);
+    if (found == requests.end()) {
+        return;
+    }
+    QNetworkReply *reply = found->second.reply;
+    requests.erase(found);
+    QObject::disconnect(reply, nullptr, this, nullptr);
+    reply->abort();
+    reply->deleteLater();
 }
 
 void SimpleClient::sendMessagePost(const QUrl &url, const QString &message, const ClientCallback &callback, bool isTimeout, milliseconds timeout, bool isClearCache) {
@@ -227,6 +277,113 @@ void SimpleClient::sendMessagesPost(const std::string printedName, const std::ve
     }
 }
 
+void SimpleClient::sendMessagesPostHedged(const std::string printedName, const std::vector<QUrl> &urls, const QString &message, const ClientCallbacks &callback, milliseconds timeout, size_t countAnswers) {
+    if (urls.empty()) {
+        callback({});
+        return;
+    }
+    const auto hedged = std::make_shared<HedgedRequest>();
+    hedged->printedName = printedName;
+    hedged->urls = urls;
+    hedged->message = message;
+    hedged->callback = callback;
+    hedged->timeout = timeout;
+    hedged->beginTime = ::now();
+    hedged->countAnswers = std::min(std::max(countAnswers, size_t(1)), urls.size());
+    hedged->responses.resize(urls.size());
+    for (size_t i = 0; i < urls.size(); i++) {
+        hedged->responses[i].exception = ServerException(urls[i].toString().toStdString(), ServerException::CANCELED_REQUEST_ERROR, "Canceled", "");
+    }
+
+    for (size_t i = 0; i < hedged->countAnswers; i++) {
+        sendHedged(hedged);
+    }
+    startHedgeTimer(hedged);
+}
+
+bool SimpleClient::sendHedged(const std::shared_ptr<HedgedRequest> &hedged) {
+    const milliseconds elapsed = std::chrono::duration_cast<milliseconds>(::now() - hedged->beginTime);
+    if (hedged->nextUrl >= hedged->urls.size() || elapsed >= hedged->timeout) {
+        return false;
+    }
+    const size_t index = hedged->nextUrl++;
+    const ClientCallback callback = [this, hedged, index](const Response &response) {
+        processHedged(hedged, index, response);
+    };
+    const size_t requestId = sendMessageInternal(true, hedged->urls[index], hedged->message, callback, true, hedged->timeout - elapsed, false, false, true);
+    hedged->inFlight.emplace(requestId, index);
+    return true;
+}
+
+void SimpleClient::processHedged(const std::shared_ptr<HedgedRequest> &hedged, size_t index, const Response &response) {
+    const auto found = std::find_if(hedged->inFlight.begin(), hedged->inFlight.end(), [index](const auto &pair) {
+        return pair.second == index;
+    });
+    CHECK(found != hedged->inFlight.end(), "Hedged request not found " + hedged->printedName);
+    hedged->inFlight.erase(found);
+    if (hedged->emitted) {
+        return;
+    }
+
+    hedged->responses[index] = response;
+    if (!response.exception.isSet()) {
+        hedged->countSuccess++;
+        hedgeLatencies.emplace_back(response.time);
+        if (hedgeLatencies.size() > HEDGE_LATENCIES_SIZE) {
+            hedgeLatencies.pop_front();
+        }
+        if (hedged->countSuccess >= hedged->countAnswers) {
+            finishHedged(hedged);
+            return;
+        }
+    } else {
+        sendHedged(hedged);
+    }
+
+    if (hedged->inFlight.empty()) {
+        finishHedged(hedged);
+    }
+}
+
+void SimpleClient::finishHedged(const std::shared_ptr<HedgedRequest> &hedged) {
+    hedged->emitted = true;
+    for (const auto &pair: hedged->inFlight) {
+        cancelRequest(pair.first);
+    }
+    hedged->inFlight.clear();
+    emit callbackCall(std::bind(hedged->callback, hedged->responses));
+}
+
+void SimpleClient::startHedgeTimer(const std::shared_ptr<HedgedRequest> &hedged) {
+    if (hedged->emitted || hedged->nextUrl >= hedged->urls.size()) {
+        return;
+    }
+    QTimer::singleShot(getHedgeDelay(hedged->timeout).count(), this, [this, hedged]{
+        BEGIN_SLOT_WRAPPER
+        if (hedged->emitted) {
+            return;
+        }
+        sendHedged(hedged);
+        startHedgeTimer(hedged);
+        END_SLOT_WRAPPER
+    });
+}
+
+milliseconds SimpleClient::calcHedgeDelay(const std::deque<milliseconds> &latencies, milliseconds timeout) {
+    milliseconds delay = HEDGE_DEFAULT_DELAY;
+    if (latencies.size() >= HEDGE_MIN_LATENCIES) {
+        std::vector<milliseconds> sorted(latencies.begin(), latencies.end());
+        const auto p95 = sorted.begin() + sorted.size() * 95 / 100;
+        std::nth_element(sorted.begin(), p95, sorted.end());
+        delay = *p95;
+    }
+    return std::min(std::max(delay, HEDGE_MIN_DELAY), timeout);
+}
+
+milliseconds SimpleClient::getHedgeDelay(milliseconds timeout) const {
+    return calcHedgeDelay(hedgeLatencies, timeout);
+}
+
 void SimpleClient::sendMessageGet(const QUrl &url, const ClientCallback &callback, bool isTimeout, milliseconds timeout) {
     sendMessageInternal(false, url, "", callback, isTimeout, timeout, false, false);
 }
@@ -244,8 +401,13 @@ void SimpleClient::runCallback(size_t id, Message&&... messages) {
     const auto foundCallback = requests.find(id);
     CHECK(foundCallback != requests.end(), "not found callback on id " + std::to_string(id));
     const auto callback = std::bind(foundCallback->second.callback, std::forward<Message>(messages)...);
-    emit callbackCall(callback);
-    requests.erase(foundCallback);
+    if (foundCallback->second.isInternal) {
+        requests.erase(foundCallback);
+        callback();
+    } else {
+        emit callbackCall(callback);
+        requests.erase(foundCallback);
+    }
 }
 
 void SimpleClient::onTextMessageReceived(size_t id) {
@@ -265,6 +427,9 @@ BEGIN_SLOT_WRAPPER
         Response resp;
         resp.response = std::string(content.data(), content.size());
         resp.time = duration;
+        if (responseObserver) {
+            responseObserver(reply->url(), resp);
+        }
         runCallback(id, resp);
     } else {
         std::string errorStr;
@@ -279,6 +444,9 @@ BEGIN_SLOT_WRAPPER
         } else {
             resp.exception = ServerException(reply->url().toString().toStdString(), reply->error(), reply->errorString().toStdString(), errorStr);
         }
+        if (responseObserver) {
+            responseObserver(reply->url(), resp);
+        }
         runCallback(id, resp);
     }
 
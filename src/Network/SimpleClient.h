@@ -7,6 +7,7 @@
 #include <memory>
 #include <functional>
 #include <unordered_map>
+#include <deque>
 #include <string>
 
 #include "duration.h"
@@ -53,6 +54,9 @@ public:
 
         const static int TIMEOUT_REQUEST_ERROR;
 
+        // Request was not sent or was cancelled after enough answers received
+        const static int CANCELED_REQUEST_ERROR;
+
         int code = 0;
     };
 
@@ -70,6 +74,9 @@ public:
 
     using ReturnCallback = std::function<void()>;
 
+    // Called in client thread for each finished request, cancelled requests are skipped
+    using ResponseObserver = std::function<void(const QUrl &url, const Response &response)>;
+
 public:
 
     explicit SimpleClient();
@@ -79,9 +86,18 @@ public:
     void sendMessagePost(const QUrl &url, const QString &message, const ClientCallback &callback);
     void sendMessagePost(const QUrl &url, const QString &message, const ClientCallback &callback, milliseconds timeout, bool isClearCache=false);
     void sendMessagesPost(const std::string printedName, const std::vector<QUrl> &urls, const QString &message, const ClientCallbacks &callback, milliseconds timeout);
+    // urls should be sorted from the best node. Request is sent to the first countAnswers urls, next urls are added
+    // after p95 latency of previous answers or immediately after an error. Callback is called after countAnswers successful answers,
+    // other requests are cancelled and their responses have CANCELED_REQUEST_ERROR
+    void sendMessagesPostHedged(const std::string printedName, const std::vector<QUrl> &urls, const QString &message, const ClientCallbacks &callback, milliseconds timeout, size_t countAnswers);
     void sendMessageGet(const QUrl &url, const ClientCallback &callback);
     void sendMessageGet(const QUrl &url, const ClientCallback &callback, milliseconds timeout);
 
+    void setResponseObserver(const ResponseObserver &observer);
+
+    // p95 of latencies, default delay while there are few of them. Result is limited by timeout
+    static milliseconds calcHedgeDelay(const std::deque<milliseconds> &latencies, milliseconds timeout);
+
     void setParent(QObject *obj);
 
     void moveToThread(QThread *thread);
@@ -107,12 +123,16 @@ private:
         milliseconds timeout;
         time_point beginTime;
         bool isTimeout = false;
+        // Callback is called directly instead of callbackCall
+        bool isInternal = false;
     };
 
+    struct HedgedRequest;
+
 private:
 
     template<typename Callback>
-    void sendMessageInternal(
+    size_t sendMessageInternal(
         bool isPost,
         const QUrl &url,
         const QString &message,
@@ -120,9 +140,22 @@ private:
         bool isTimeout,
         milliseconds timeout,
         bool isClearCache,
-        bool isQueuedConnection
+        bool isQueuedConnection,
+        bool isInternal = false
     );
 
+    void cancelRequest(size_t id);
+
+    bool sendHedged(const std::shared_ptr<HedgedRequest> &hedged);
+
+    void processHedged(const std::shared_ptr<HedgedRequest> &hedged, size_t index, const Response &response);
+
+    void finishHedged(const std::shared_ptr<HedgedRequest> &hedged);
+
+    void startHedgeTimer(const std::shared_ptr<HedgedRequest> &hedged);
+
+    milliseconds getHedgeDelay(milliseconds timeout) const;
+
     void sendMessagePost(const QUrl &url, const QString &message, const ClientCallback &callback, bool isTimeout, milliseconds timeout, bool isClearCache);
     void sendMessageGet(const QUrl &url, const ClientCallback &callback, bool isTimeout, milliseconds timeout);
 
@@ -141,6 +174,11 @@ private:
     QThread *thread1 = nullptr;
 
     size_t id = 0;
+
+    ResponseObserver responseObserver;
+
+    // Latencies of the last successful hedged answers
+    std::deque<milliseconds> hedgeLatencies;
 };
 
 #endif // CLIENT_H
@@ -0,0 +1,81 @@
+#include "DnsCache.h"
+
+#include <algorithm>
+
+namespace nslookup {
+
+static const seconds MIN_TTL = 1min;
+static const seconds MAX_TTL = 1h;
+
+static const seconds NEGATIVE_TTL = 30s;
+
+static const size_t PREFETCH_MIN_HITS = 2;
+
+bool DnsCache::find(const QString &name, const time_point &now, std::vector<QString> &ips) {
+    const auto found = records.find(name);
+    if (found == records.end() || now >= found->second.expire) {
+        stats.misses++;
+        return false;
+    }
+    Record &record = found->second;
+    record.countHits++;
+    if (record.ips.empty()) {
+        stats.negativeHits++;
+    } else {
+        stats.hits++;
+    }
+    ips = record.ips;
+    return true;
+}
+
+void DnsCache::add(const QString &name, const std::vector<QString> &ips, seconds ttl, const time_point &now) {
+    if (ips.empty()) {
+        addNegative(name, now);
+        return;
+    }
+    Record &record = records[name];
+    record.ips = ips;
+    record.ttl = std::min(std::max(ttl, MIN_TTL), MAX_TTL);
+    record.expire = now + record.ttl;
+    record.countHits = 0;
+    record.isPrefetch = false;
+    stats.countRecords = records.size();
+}
+
+void DnsCache::addNegative(const QString &name, const time_point &now) {
+    Record &record = records[name];
+    if (!record.ips.empty() && now < record.expire) {
+        // Failed prefetch does not replace valid record and is not repeated
+        record.isPrefetch = false;
+        record.countHits = 0;
+        return;
+    }
+    record.ips.clear();
+    record.ttl = NEGATIVE_TTL;
+    record.expire = now + NEGATIVE_TTL;
+    record.countHits = 0;
+    record.isPrefetch = false;
+    stats.countRecords = records.size();
+}
+
+std::vector<QString> DnsCache::getPrefetch(const time_point &now) {
+    std::vector<QString> result;
+    for (auto &pair: records) {
+        Record &record = pair.second;
+        if (record.ips.empty() || record.isPrefetch || record.countHits < PREFETCH_MIN_HITS || now >= record.expire) {
+            continue;
+        }
+        if (record.expire - now <= record.ttl / 10) {
+            record.isPrefetch = true;
+            stats.prefetches++;
+            result.emplace_back(pair.first);
+        }
+    }
+    return result;
+}
+
+DnsCacheStats DnsCache::getStats() const {
+    return stats;
+}
+
+} // namespace nslookup
@@ -0,0 +1,51 @@
+#ifndef DNSCACHE_H
+#define DNSCACHE_H
+
+#include <QString>
+
+#include <map>
+#include <vector>
+
+#include "duration.h"
+
+#include "NsLookupStructs.h"
+
+namespace nslookup {
+
+// Dns records with their own ttl. Failed lookups are cached for a short time.
+// Records that were used several times are returned for prefetch shortly before expiration
+class DnsCache {
+public:
+
+    // Returns false if name is not cached. Empty ips mean the negative record
+    bool find(const QString &name, const time_point &now, std::vector<QString> &ips);
+
+    void add(const QString &name, const std::vector<QString> &ips, seconds ttl, const time_point &now);
+
+    void addNegative(const QString &name, const time_point &now);
+
+    // Prefetch is not returned again until the record is updated
+    std::vector<QString> getPrefetch(const time_point &now);
+
+    DnsCacheStats getStats() const;
+
+private:
+
+    struct Record {
+        std::vector<QString> ips;
+        seconds ttl;
+        time_point expire;
+        size_t countHits = 0;
+        bool isPrefetch = false;
+    };
+
+private:
+
+    std::map<QString, Record> records;
+
+    DnsCacheStats stats;
+};
+
+} // namespace nslookup
+
+#endif // DNSCACHE_H
@@ -0,0 +1,158 @@
+#include "NodeHealth.h"
+
+#include <QUrl>
+
+#include <algorithm>
+
+#include "check.h"
+
+namespace nslookup {
+
+static const double EWMA_ALPHA = 0.2;
+
+static const size_t MIN_RESULTS_FOR_ERROR_RATE = 5;
+static const double MAX_ERROR_RATE = 0.5;
+static const size_t MAX_FAILURES_IN_ROW = 3;
+
+static const milliseconds MIN_OPEN_PERIOD = 10s;
+static const milliseconds MAX_OPEN_PERIOD = 2min;
+// Probe result can be lost if caller did not use the node
+static const milliseconds PROBE_TIMEOUT = 30s;
+
+NodeHealth::NodeHealth()
+    : random(std::random_device{}())
+{}
+
+QString NodeHealth::makeKey(const QString &address) {
+    if (!address.startsWith("http")) {
+        return address;
+    }
+    const QUrl url(address);
+    return url.host() + ":" + QString::number(url.port());
+}
+
+void NodeHealth::success(const QString &address, milliseconds latency, const time_point &now) {
+    Q_UNUSED(now);
+    Health &h = health[makeKey(address)];
+    if (h.countSuccess == 0) {
+        h.latency = latency;
+    } else {
+        h.latency = milliseconds(static_cast<milliseconds::rep>(EWMA_ALPHA * latency.count() + (1. - EWMA_ALPHA) * h.latency.count()));
+    }
+    h.errorRate = (1. - EWMA_ALPHA) * h.errorRate;
+    h.countSuccess++;
+    h.countResults++;
+    h.countFailuresInRow = 0;
+    if (h.state != State::Closed) {
+        h.state = State::Closed;
+        h.openPeriod = MIN_OPEN_PERIOD;
+        h.isProbe = false;
+    }
+}
+
+void NodeHealth::failure(const QString &address, const time_point &now) {
+    Health &h = health[makeKey(address)];
+    h.errorRate = EWMA_ALPHA + (1. - EWMA_ALPHA) * h.errorRate;
+    h.countResults++;
+    h.countFailuresInRow++;
+    if (h.state == State::HalfOpen) {
+        h.openPeriod = std::min(h.openPeriod * 2, MAX_OPEN_PERIOD);
+        open(h, now);
+    } else if (h.state == State::Closed) {
+        if (h.countFailuresInRow >= MAX_FAILURES_IN_ROW || (h.countResults >= MIN_RESULTS_FOR_ERROR_RATE && h.errorRate > MAX_ERROR_RATE)) {
+            h.openPeriod = MIN_OPEN_PERIOD;
+            open(h, now);
+        }
+    }
+}
+
+void NodeHealth::open(Health &h, const time_point &now) {
+    h.state = State::Open;
+    h.openUntil = now + h.openPeriod;
+    h.isProbe = false;
+}
+
+bool NodeHealth::isAllowed(const QString &address, const time_point &now) const {
+    const auto found = health.find(makeKey(address));
+    if (found == health.end()) {
+        return true;
+    }
+    const Health &h = found->second;
+    switch (h.state) {
+    case State::Closed:
+        return true;
+    case State::Open:
+        return now >= h.openUntil;
+    case State::HalfOpen:
+        return !h.isProbe || now - h.probeTime >= PROBE_TIMEOUT;
+    }
+    return true;
+}
+
+void NodeHealth::choosed(const QString &address, const time_point &now) {
+    const auto found = health.find(makeKey(address));
+    if (found == health.end()) {
+        return;
+    }
+    Health &h = found->second;
+    if (h.state == State::Open || h.state == State::HalfOpen) {
+        h.state = State::HalfOpen;
+        h.isProbe = true;
+        h.probeTime = now;
+    }
+}
+
+double NodeHealth::score(const NodeInfo &node) const {
+    const auto found = health.find(makeKey(node.address));
+    if (found == health.end()) {
+        return node.ping.count();
+    }
+    const Health &h = found->second;
+    const milliseconds latency = h.countSuccess == 0 ? node.ping : h.latency;
+    return latency.count() / std::max(1. - h.errorRate, 0.05);
+}
+
+NodeHealth::State NodeHealth::getState(const QString &address) const {
+    const auto found = health.find(makeKey(address));
+    if (found == health.end()) {
+        return State::Closed;
+    }
+    return found->second.state;
+}
+
+std::vector<size_t> NodeHealth::choose(const std::vector<NodeInfo> &nodes, size_t limit, size_t count, const time_point &now) {
+    CHECK(count <= limit, "Incorrect count value");
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < nodes.size() && candidates.size() < limit; i++) {
+        if (isAllowed(nodes[i].address, now)) {
+            candidates.emplace_back(i);
+        }
+    }
+
+    std::vector<size_t> result;
+    while (result.size() < count && !candidates.empty()) {
+        std::uniform_int_distribution<size_t> dist(0, candidates.size() - 1);
+        size_t pos = dist(random);
+        if (candidates.size() > 1) {
+            size_t second = dist(random);
+            while (second == pos) {
+                second = dist(random);
+            }
+            if (score(nodes[candidates[second]]) < score(nodes[candidates[pos]])) {
+                pos = second;
+            }
+        }
+        result.emplace_back(candidates[pos]);
+        candidates.erase(candidates.begin() + pos);
+    }
+
+    std::stable_sort(result.begin(), result.end(), [this, &nodes](size_t first, size_t second) {
+        return score(nodes[first]) < score(nodes[second]);
+    });
+    for (const size_t index: result) {
+        choosed(nodes[index].address, now);
+    }
+    return result;
+}
+
+} // namespace nslookup
@@ -0,0 +1,76 @@
+#ifndef NODEHEALTH_H
+#define NODEHEALTH_H
+
+#include <QString>
+
+#include <map>
+#include <vector>
+#include <random>
+
+#include "duration.h"
+
+#include "NsLookupStructs.h"
+
+namespace nslookup {
+
+// Health of nodes by results of real requests.
+// Latency and error rate are exponentially weighted, failing node is excluded by circuit breaker
+// and after a pause is returned by one probe request (half-open state)
+class NodeHealth {
+public:
+
+    enum class State {
+        Closed, Open, HalfOpen
+    };
+
+    struct Health {
+        milliseconds latency{0};
+        size_t countSuccess = 0;
+        double errorRate = 0.;
+        size_t countResults = 0;
+        size_t countFailuresInRow = 0;
+
+        State state = State::Closed;
+        time_point openUntil;
+        milliseconds openPeriod{0};
+        time_point probeTime;
+        bool isProbe = false;
+    };
+
+public:
+
+    NodeHealth();
+
+    void success(const QString &address, milliseconds latency, const time_point &now);
+
+    void failure(const QString &address, const time_point &now);
+
+    // Power of two choices over the first limit nodes allowed by circuit breaker. Nodes are returned from the best.
+    // Nodes without results are estimated by ping
+    std::vector<size_t> choose(const std::vector<NodeInfo> &nodes, size_t limit, size_t count, const time_point &now);
+
+    // Expected time of successful response
+    double score(const NodeInfo &node) const;
+
+    State getState(const QString &address) const;
+
+private:
+
+    bool isAllowed(const QString &address, const time_point &now) const;
+
+    void choosed(const QString &address, const time_point &now);
+
+    void open(Health &health, const time_point &now);
+
+    static QString makeKey(const QString &address);
+
+private:
+
+    std::map<QString, Health> health;
+
+    std::mt19937 random;
+};
+
+} // namespace nslookup
+
+#endif // NODEHEALTH_H
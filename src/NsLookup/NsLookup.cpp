@@ -9,6 +9,8 @@
 #include <QJsonObject>
 
 #include <QSettings>
+#include <QDataStream>
+#include <QTimer>
 
 #include "dns/dnspacket.h"
 #include "check.h"
@@ -42,12 +44,27 @@ const static QString FILL_NODES_PATH = "fill_nodes.txt";
 
 const static std::string CURRENT_VERSION = "v3";
 
+const static QString SNAPSHOT_PATH = "nodes_snapshot.dat";
+
+const static quint32 SNAPSHOT_MAGIC = 0x4E534E50;
+
+const static quint32 SNAPSHOT_VERSION = 1;
+
+const static size_t PING_HISTORY_SIZE = 8;
+
+// Full refresh is postponed while nodes of stale snapshot are revalidated one by one
+const static seconds FULL_REFRESH_AFTER_REVALIDATE = 5min;
+
 const static milliseconds MAX_PING = 100s;
 
 const static milliseconds UPDATE_PERIOD = days(1);
 
 const static size_t ACCEPTABLE_COUNT_ADDRESSES = 3;
 
+const static size_t COUNT_DNS_IN_FLIGHT = 4;
+
+const static size_t COUNT_PINGS_IN_FLIGHT = 8;
+
 static QString makeAddress(const QString &ipAndPort) {
     return "http://" + ipAndPort;
 }
@@ -69,11 +86,13 @@ NsLookup::NsLookup(InfrastructureNsLookup &infrastructureNsl)
 {
     Q_CONNECT(this, &NsLookup::getStatus, this, &NsLookup::onGetStatus);
     Q_CONNECT(this, &NsLookup::rejectServer, this, &NsLookup::onRejectServer);
+    Q_CONNECT(this, &NsLookup::serverResponse, this, &NsLookup::onServerResponse);
     Q_CONNECT(this, &NsLookup::getRandomServersWithoutHttp, this, &NsLookup::onGetRandomServersWithoutHttp);
     Q_CONNECT(this, &NsLookup::getRandomServers, this, &NsLookup::onGetRandomServers);
 
     Q_REG(GetStatusCallback, "GetStatusCallback");
     Q_REG(GetServersCallback, "GetServersCallback");
+    Q_REG2(milliseconds, "milliseconds", false);
 
     QSettings settings(getSettingsPath(), QSettings::IniFormat);
     const int size = settings.beginReadArray("nodes");
@@ -109,7 +128,12 @@ NsLookup::NsLookup(InfrastructureNsLookup &infrastructureNsl)
     dnsServerPort = settings.value("ns_lookup/dns_server_port").toInt();
 
     savedNodesPath = makePath(getNsLookupPath(), FILL_NODES_PATH);
-    const system_time_point lastFill = fillNodesFromFile(savedNodesPath, nodes);
+    snapshotPath = makePath(getNsLookupPath(), SNAPSHOT_PATH);
+    system_time_point lastFill = fillNodesFromSnapshot(snapshotPath, nodes);
+    const bool isSnapshot = !allNodesForTypes.empty();
+    if (!isSnapshot) {
+        lastFill = fillNodesFromFile(savedNodesPath, nodes);
+    }
     filledFileTp = lastFill;
     const system_time_point now = system_now();
     milliseconds passedTime = std::chrono::duration_cast<milliseconds>(now - lastFill);
@@ -118,7 +142,13 @@ NsLookup::NsLookup(InfrastructureNsLookup &infrastructureNsl)
         passedTime = UPDATE_PERIOD;
     }
 
-    if (passedTime >= UPDATE_PERIOD) {
+    if (passedTime >= UPDATE_PERIOD && isSnapshot) {
+        // Snapshot nodes are served at once, refresh them in background
+        for (const auto &pair: allNodesForTypes) {
+            taskManager.addTask(RefreshNodeWorker::makeTask(0s, pair.first.str(), true));
+        }
+        taskManager.addTask(FullWorker::makeTask(FULL_REFRESH_AFTER_REVALIDATE));
+    } else if (passedTime >= UPDATE_PERIOD) {
         taskManager.addTask(FullWorker::makeTask(0s));
     } else {
         taskManager.addTask(SimpleWorker::makeTask(0s));
@@ -130,6 +160,11 @@ NsLookup::NsLookup(InfrastructureNsLookup &infrastructureNsl)
     taskManager.addTask(PrintNodesWorker::makeTask(0s));
 
     Q_CONNECT(&udpClient, &UdpSocketClient::callbackCall, this, &NsLookup::callbackCall);
+    for (size_t i = 0; i < COUNT_DNS_IN_FLIGHT; i++) {
+        dnsClients.emplace_back(std::make_unique<UdpSocketClient>());
+        Q_CONNECT(dnsClients.back().get(), &UdpSocketClient::callbackCall, this, &NsLookup::callbackCall);
+    }
+    Q_CONNECT(&dnsPrefetchClient, &UdpSocketClient::callbackCall, this, &NsLookup::callbackCall);
 
     client.setParent(this);
     Q_CONNECT(&client, &SimpleClient::callbackCall, this, &NsLookup::callbackCall);
@@ -139,6 +174,12 @@ NsLookup::NsLookup(InfrastructureNsLookup &infrastructureNsl)
     moveToThread(TimerClass::getThread());
 
     udpClient.startTm();
+    for (const auto &dnsClient: dnsClients) {
+        dnsClient->mvToThread(TimerClass::getThread());
+        dnsClient->startTm();
+    }
+    dnsPrefetchClient.mvToThread(TimerClass::getThread());
+    dnsPrefetchClient.startTm();
 }
 
 NsLookup::~NsLookup() {
@@ -146,6 +187,7 @@ NsLookup::~NsLookup() {
 
     if (isResetFilledFile.load()) {
         removeFile(savedNodesPath);
+        removeFile(snapshotPath);
     }
 }
 
@@ -212,6 +254,8 @@ void NsLookup::findAndRefreshEmptyNodes() {
 }
 
 void NsLookup::process() {
+    prefetchDns();
+
     if (taskManager.isCurrentWork()) {
         return;
     }
@@ -227,12 +271,57 @@ void NsLookup::process() {
     }
 }
 
+void NsLookup::prefetchDns() {
+    const time_point now = ::now();
+    const std::vector<QString> names = dnsCache.getPrefetch(now);
+    dnsPrefetchQueue.insert(dnsPrefetchQueue.end(), names.begin(), names.end());
+    if (isDnsPrefetchRunning || dnsPrefetchQueue.empty()) {
+        return;
+    }
+
+    const QString name = dnsPrefetchQueue.front();
+    dnsPrefetchQueue.pop_front();
+    const auto foundNode = std::find_if(nodes.begin(), nodes.end(), [&name](const auto &pair) {
+        return pair.second.node.str() == name;
+    });
+    if (foundNode == nodes.end()) {
+        return;
+    }
+    const QString port = foundNode->second.port;
+
+    DnsPacket requestPacket;
+    requestPacket.addQuestion(DnsQuestion::getIp(name));
+    requestPacket.setFlags(DnsFlag::MyFlag);
+    const auto byteArray = requestPacket.toByteArray();
+    LOG << "Dns prefetch " << name;
+    isDnsPrefetchRunning = true;
+    const TypedException exception = apiVrapper2([&]{
+        dnsPrefetchClient.sendRequest(QHostAddress(dnsServerName), dnsServerPort, std::vector<char>(byteArray.begin(), byteArray.end()), [this, name, port](const std::vector<char> &response, const UdpSocketClient::SocketException &exception) {
+            isDnsPrefetchRunning = false;
+            std::vector<QString> ips;
+            seconds ttl;
+            const TypedException except = apiVrapper2([&](){
+                CHECK(!exception.isSet(), "Dns exception: " + exception.toString());
+                ips = nslookup::parseDnsResponse(response, port, ttl);
+            });
+            if (except.isSet()) {
+                dnsCache.addNegative(name, ::now());
+            } else {
+                dnsCache.add(name, ips, ttl, ::now());
+            }
+        }, timeoutRequestNodes);
+    });
+    if (exception.isSet()) {
+        isDnsPrefetchRunning = false;
+    }
+}
+
 void NsLookup::saveAll(bool isFullFill) {
     sortAll();
     if (isFullFill) {
         filledFileTp = system_now();
     }
-    saveToFile(savedNodesPath, filledFileTp, nodes);
+    saveSnapshot(snapshotPath, filledFileTp);
 }
 
 void NsLookup::finalizeLookup(bool isFullFill) {
@@ -242,6 +331,9 @@ void NsLookup::finalizeLookup(bool isFullFill) {
 }
 
 void NsLookup::finalizeLookup(bool isFullFill, std::map<NodeType::Node, std::vector<NodeInfo>> &allNodesForTypesNew) {
+    for (auto &pair: allNodesForTypesNew) {
+        mergePingHistory(pair.first, pair.second);
+    }
     allNodesForTypes.swap(allNodesForTypesNew);
 
     emit serversFlushed(TypedException());
@@ -252,7 +344,9 @@ void NsLookup::finalizeLookup(bool isFullFill, std::map<NodeType::Node, std::vec
 }
 
 void NsLookup::finalizeLookup(const NodeType::Node &node, const std::vector<NodeInfo> &allNodesForTypesNew) {
-    allNodesForTypes[node] = allNodesForTypesNew;
+    std::vector<NodeInfo> newNodes = allNodesForTypesNew;
+    mergePingHistory(node, newNodes);
+    allNodesForTypes[node] = newNodes;
     saveAll(false);
 
     defectiveTorrents.clear();
@@ -272,33 +366,32 @@ bool NsLookup::repeatResolveDns(
         return false;
     }
     udpClient.sendRequest(QHostAddress(dnsServerName), dnsServerPort, std::vector<char>(byteArray.begin(), byteArray.end()), [this, &ipsTemp, beginPing, node, now, dnsServerName, dnsServerPort, byteArray, countRepeat](const std::vector<char> &response, const UdpSocketClient::SocketException &exception) {
-        DnsPacket packet;
+        std::vector<QString> ips;
+        seconds ttl;
         const TypedException except = apiVrapper2([&](){
             CHECK(!exception.isSet(), "Dns exception: " + exception.toString());
-            CHECK(response.size() > 0, "Incorrect response dns " + node->second.type.toStdString());
-            packet = DnsPacket::fromBytesArary(QByteArray(response.data(), response.size()));
-            CHECK(!packet.answers().empty(), "Empty dns response " + toHex(std::string(response.begin(), response.end())));
-            LOG << "Dns ok " << node->second.type << ". " << packet.answers().size();
+            ips = nslookup::parseDnsResponse(response, node->second.port, ttl);
+            LOG << "Dns ok " << node->second.type << ". " << ips.size();
         });
 
         if (except.isSet()) {
-            LOG << "Dns repeat number " << countRepeat - 1;
-            const bool res = repeatResolveDns(dnsServerName, dnsServerPort, byteArray, node, now, countRepeat - 1, ipsTemp, beginPing);
-            if (!res) {
+            if (countRepeat <= 1) {
                 dnsErrorDetails.dnsName = dnsServerName;
+                dnsCache.addNegative(node->second.node.str(), ::now());
                 throw except;
-            } else {
-                return;
             }
+            LOG << "Dns repeat number " << countRepeat - 1;
+            const milliseconds delay = getDnsRepeatDelay(countRepeat);
+            QTimer::singleShot(delay.count(), this, [this, &ipsTemp, beginPing, node, now, dnsServerName, dnsServerPort, byteArray, countRepeat]{
+BEGIN_SLOT_WRAPPER
+                repeatResolveDns(dnsServerName, dnsServerPort, byteArray, node, now, countRepeat - 1, ipsTemp, beginPing);
+END_SLOT_WRAPPER
+            });
+            return;
         }
 
-        ipsTemp.clear();
-        for (const auto &record : packet.answers()) {
-            ipsTemp.emplace_back(::makeAddress(record.toString(), node->second.port));
-        }
-
-        cacheDns.cache[node->second.node.str()] = ipsTemp;
-        cacheDns.lastUpdate = now;
+        ipsTemp = ips;
+        dnsCache.add(node->second.node.str(), ips, ttl, ::now());
 
         beginPing();
     }, timeoutRequestNodes);
@@ -306,6 +399,106 @@ bool NsLookup::repeatResolveDns(
     return true;
 }
 
+static NodeInfo preParseNodeInfo(const QString &address, const SimpleClient::Response &response, size_t updateNumber) {
+    NodeInfo info;
+    info.address = address;
+    info.ping = response.time;
+    if (info.ping >= MAX_PING) {
+        info.isTimeout = true;
+    }
+    info.countUpdated = updateNumber;
+
+    if (response.exception.isTimeout()) {
+        info.ping = MAX_PING;
+        info.isTimeout = true;
+    }
+
+    return info;
+}
+
+static NodeResponse defaultResponseParser(const std::string &response, const std::string &error) {
+    if (response.empty() && error.empty()) {
+        return NodeResponse(false);
+    } else {
+        return NodeResponse(true);
+    }
+}
+
+void NsLookup::beginParallelResolve(std::map<NodeType::Node, std::vector<NodeInfo>> &allNodesForTypesNew, const std::function<void()> &finalizeLookup) {
+    const time_point now = ::now();
+    std::map<QString, std::vector<QString>> cachedIps;
+    std::set<QString> negativeNodes;
+    for (const auto &pair: nodes) {
+        const QString &name = pair.second.node.str();
+        std::vector<QString> ips;
+        if (cachedIps.find(name) == cachedIps.end() && negativeNodes.find(name) == negativeNodes.end() && dnsCache.find(name, now, ips)) {
+            if (ips.empty()) {
+                negativeNodes.insert(name);
+            } else {
+                cachedIps[name] = ips;
+            }
+        }
+    }
+
+    const auto makePingRequest = [this](bool found, const QString &get, const QString &post, const std::function<NodeResponse(const std::string &response, const std::string &error)> &processResponse) {
+        const std::function<NodeResponse(const std::string &response, const std::string &error)> pResponse = found ? processResponse : defaultResponseParser;
+        nslookup::ParallelLookup::PingRequest request;
+        request.get = get;
+        request.post = post;
+        request.parse = [this, pResponse](const QString &address, const SimpleClient::Response &response) {
+            NodeInfo nodeInfo = preParseNodeInfo(address, response, updateNumber);
+            const NodeResponse r = pResponse(response.response, response.exception.content);
+            if (!r.isSuccess) {
+                nodeInfo.isTimeout = true;
+                nodeInfo.ping = MAX_PING;
+            }
+            return nodeInfo;
+        };
+        return request;
+    };
+
+    const auto getPingRequest = [this, makePingRequest](const NodeType &node, const std::function<void(const nslookup::ParallelLookup::PingRequest &request)> &callback) {
+        emit infrastructureNsl.getRequestFornode(node.type, InfrastructureNsLookup::GetFormatRequestCallback([callback, makePingRequest](bool found, const QString &get, const QString &post, const std::function<NodeResponse(const std::string &response, const std::string &error)> &processResponse){
+            callback(makePingRequest(found, get, post, processResponse));
+        }, [callback, makePingRequest](const TypedException &exception) {
+            LOG << "Error: " << exception.description;
+            callback(makePingRequest(false, "", "", nullptr));
+        }, signalFunc));
+    };
+
+    const auto resolved = [this](const NodeType &node, const std::vector<QString> &ips, seconds ttl) {
+        dnsCache.add(node.node.str(), ips, ttl, ::now());
+    };
+
+    const auto finish = [this, &allNodesForTypesNew, finalizeLookup, negativeNodes](std::map<NodeType::Node, std::vector<NodeInfo>> &result, const std::set<NodeType::Node> &failedNodes) {
+        for (const NodeType::Node &node: failedNodes) {
+            if (negativeNodes.find(node.str()) == negativeNodes.end()) {
+                dnsCache.addNegative(node.str(), ::now());
+            }
+            const auto found = allNodesForTypes.find(node);
+            if (found != allNodesForTypes.end()) {
+                result[node] = found->second;
+            }
+        }
+        if (!failedNodes.empty()) {
+            dnsErrorDetails.dnsName = dnsServerName;
+        }
+        allNodesForTypesNew.swap(result);
+        finalizeLookup();
+    };
+
+    std::vector<UdpSocketClient*> clients;
+    for (const auto &dnsClient: dnsClients) {
+        clients.emplace_back(dnsClient.get());
+    }
+    std::vector<NodeType> nodeTypes;
+    for (const auto &pair: nodes) {
+        nodeTypes.emplace_back(pair.second);
+    }
+    const auto lookup = std::make_shared<nslookup::ParallelLookup>(clients, client, dnsServerName, dnsServerPort, timeoutRequestNodes, COUNT_PINGS_IN_FLIGHT);
+    lookup->start(nodeTypes, cachedIps, negativeNodes, getPingRequest, resolved, finish);
+}
+
 void NsLookup::beginResolve(std::map<NodeType::Node, std::vector<NodeInfo>> &allNodesForTypesNew, std::vector<QString> &ipsTemp, const std::function<void()> &finalizeLookup, const std::function<void(std::map<QString, NodeType>::const_iterator node)> &beginPing) {
     continueResolve(std::begin(nodes), allNodesForTypesNew, ipsTemp, finalizeLookup, beginPing);
 }
@@ -322,48 +515,21 @@ void NsLookup::continueResolve(std::map<QString, NodeType>::const_iterator node,
     }
 
     const time_point now = ::now();
-    if (now - cacheDns.lastUpdate >= 1h) {
-        cacheDns.cache.clear();
-    }
-    ipsTemp = cacheDns.cache[node->second.node.str()];
+    ipsTemp.clear();
+    const bool isCached = dnsCache.find(node->second.node.str(), now, ipsTemp);
     const auto bPing = std::bind(beginPing, node);
-    if (ipsTemp.empty()) {
+    if (!isCached) {
         DnsPacket requestPacket;
         requestPacket.addQuestion(DnsQuestion::getIp(node->second.node.str()));
         requestPacket.setFlags(DnsFlag::MyFlag);
         const auto byteArray = requestPacket.toByteArray();
         LOG << "Dns " << node->second.type << ".";
-        repeatResolveDns(dnsServerName, dnsServerPort, byteArray, node, now, 3, ipsTemp, bPing);
+        repeatResolveDns(dnsServerName, dnsServerPort, byteArray, node, now, DNS_REPEAT_COUNT, ipsTemp, bPing);
     } else {
         bPing();
     }
 }
 
-static NodeInfo preParseNodeInfo(const QString &address, const SimpleClient::Response &response, size_t updateNumber) {
-    NodeInfo info;
-    info.address = address;
-    info.ping = response.time;
-    if (info.ping >= MAX_PING) {
-        info.isTimeout = true;
-    }
-    info.countUpdated = updateNumber;
-
-    if (response.exception.isTimeout()) {
-        info.ping = MAX_PING;
-        info.isTimeout = true;
-    }
-
-    return info;
-}
-
-static NodeResponse defaultResponseParser(const std::string &response, const std::string &error) {
-    if (response.empty() && error.empty()) {
-        return NodeResponse(false);
-    } else {
-        return NodeResponse(true);
-    }
-}
-
 void NsLookup::continuePing(std::vector<QString>::const_iterator ipsIter, const NodeType &node, std::map<NodeType::Node, std::vector<NodeInfo>> &allNodesForTypesNew, const std::vector<QString> &ipsTemp, const std::function<void()> &continueResolve) {
     if (ipsIter == ipsTemp.end()) {
         continueResolve();
@@ -497,7 +663,9 @@ void NsLookup::finalizeRefreshIp(const NodeType::Node &node, const std::map<Node
 
     LOG << "Updated ip status. Left " << defectiveTorrents.size();
 
-    allNodesForTypes[node] = allNodesForTypesNew.at(node);
+    std::vector<NodeInfo> newNodes = allNodesForTypesNew.at(node);
+    mergePingHistory(node, newNodes);
+    allNodesForTypes[node] = newNodes;
     saveAll(false);
 }
 
@@ -636,38 +804,116 @@ system_time_point NsLookup::fillNodesFromFile(const QString &file, const std::ma
     return timePoint;
 }
 
-void NsLookup::saveToFile(const QString &file, const system_time_point &tp, const std::map<QString, NodeType> &expectedNodes) {
-    std::string content;
-    content += CURRENT_VERSION + "\n";
-    content += calcHashNodes(expectedNodes) + "\n";
-    content += std::to_string(systemTimePointToInt(tp)) + "\n";
+system_time_point NsLookup::fillNodesFromSnapshot(const QString &file, const std::map<QString, NodeType> &expectedNodes) {
+    if (!isExistFile(file)) {
+        return intToSystemTimePoint(0);
+    }
+    const std::string content = readFileBinary(file);
+    QByteArray data = QByteArray::fromStdString(content);
+    QDataStream in(&data, QIODevice::ReadOnly);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic;
+    quint32 version;
+    qint64 timePoint;
+    quint32 countTypes;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+        LOG << "Snapshot version not supported";
+        return intToSystemTimePoint(0);
+    }
+    in >> timePoint >> countTypes;
+
+    // Types changed in settings are skipped, other types are still usable
+    std::map<NodeType::Node, std::vector<NodeInfo>> result;
+    size_t count = 0;
+    for (quint32 i = 0; i < countTypes && in.status() == QDataStream::Ok; i++) {
+        QString type;
+        QString node;
+        QString port;
+        quint32 countNodes;
+        in >> type >> node >> port >> countNodes;
+        const auto found = expectedNodes.find(type);
+        const bool isExpected = found != expectedNodes.end() && found->second.node.str() == node && found->second.port == port;
+        for (quint32 j = 0; j < countNodes && in.status() == QDataStream::Ok; j++) {
+            NodeInfo info;
+            qint64 ping;
+            quint32 historySize;
+            in >> info.address >> ping >> info.isTimeout >> historySize;
+            info.ping = milliseconds(ping);
+            for (quint32 k = 0; k < historySize && in.status() == QDataStream::Ok; k++) {
+                qint64 historyPing;
+                in >> historyPing;
+                info.pingHistory.emplace_back(historyPing);
+            }
+            if (isExpected) {
+                result[found->second.node].emplace_back(info);
+                count++;
+            }
+        }
+    }
+    if (in.status() != QDataStream::Ok) {
+        LOG << "Incorrect snapshot " << file;
+        return intToSystemTimePoint(0);
+    }
+
+    LOG << "Filled nodes from snapshot: " << count;
+
+    allNodesForTypes.swap(result);
+
+    sortAll();
+
+    allNodesForTypesBackup = allNodesForTypes;
+
+    return intToSystemTimePoint(timePoint);
+}
+
+void NsLookup::saveSnapshot(const QString &file, const system_time_point &tp) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+
+    out << SNAPSHOT_MAGIC << SNAPSHOT_VERSION << qint64(systemTimePointToInt(tp)) << quint32(nodes.size());
     for (const auto &nodeTypeIter: nodes) {
         const NodeType &nodeType = nodeTypeIter.second;
-        const auto processOneNode = [](const NodeInfo &node, const NodeType &nodeType) {
-            std::string content;
-            content += nodeType.type.toStdString() + " ";
-            content += node.address.toStdString() + " ";
-            content += std::to_string(node.ping.count()) + " ";
-            content += (node.isTimeout ? "1" : "0") + std::string(" ");
-            content += "\n";
-            return content;
-        };
         if (countWorkedNodes(allNodesForTypes[nodeType.node]) != 0 || allNodesForTypesBackup[nodeType.node].empty()) {
-            for (const NodeInfo &node: allNodesForTypes[nodeType.node]) {
-                content += processOneNode(node, nodeType);
-            }
             allNodesForTypesBackup[nodeType.node] = allNodesForTypes[nodeType.node];
-        } else {
-            for (const NodeInfo &node: allNodesForTypesBackup[nodeType.node]) {
-                content += processOneNode(node, nodeType);
+        }
+        const std::vector<NodeInfo> &nodesForSave = allNodesForTypesBackup[nodeType.node];
+
+        out << nodeType.type << nodeType.node.str() << nodeType.port << quint32(nodesForSave.size());
+        for (const NodeInfo &node: nodesForSave) {
+            out << node.address << qint64(node.ping.count()) << node.isTimeout << quint32(node.pingHistory.size());
+            for (const milliseconds &ping: node.pingHistory) {
+                out << qint64(ping.count());
             }
         }
     }
 
-    writeToFile(file, content, false);
+    writeToFileBinary(file, data.toStdString(), false);
+}
+
+void NsLookup::mergePingHistory(const NodeType::Node &node, std::vector<NodeInfo> &newNodes) const {
+    const auto found = allNodesForTypes.find(node);
+    for (NodeInfo &info: newNodes) {
+        if (found != allNodesForTypes.end() && info.pingHistory.empty()) {
+            const auto oldInfo = std::find_if(found->second.begin(), found->second.end(), [&info](const NodeInfo &old) {
+                return old.address == info.address;
+            });
+            if (oldInfo != found->second.end()) {
+                info.pingHistory = oldInfo->pingHistory;
+            }
+        }
+        if (!info.isTimeout && (info.pingHistory.empty() || info.pingHistory.back() != info.ping)) {
+            info.pingHistory.emplace_back(info.ping);
+        }
+        if (info.pingHistory.size() > PING_HISTORY_SIZE) {
+            info.pingHistory.erase(info.pingHistory.begin(), info.pingHistory.end() - PING_HISTORY_SIZE);
+        }
+    }
 }
 
-std::vector<QString> NsLookup::getRandom(const QString &type, size_t limit, size_t count, const std::function<QString(const NodeInfo &node)> &process) const {
+std::vector<QString> NsLookup::getRandom(const QString &type, size_t limit, size_t count, const std::function<QString(const NodeInfo &node)> &process) {
     CHECK(count <= limit, "Incorrect count value");
 
     const auto foundType = nodes.find(type);
@@ -686,7 +932,16 @@ std::vector<QString> NsLookup::getRandom(const QString &type, size_t limit, size
     std::copy_if(nodes.begin(), nodes.end(), std::back_inserter(filterNodes), [](const NodeInfo &node) {
         return !node.isTimeout;
     });
-    return ::getRandom<QString>(filterNodes, limit, count, process);
+    const std::vector<size_t> choosed = nodeHealth.choose(filterNodes, limit, count, ::now());
+    if (choosed.empty()) {
+        // All circuit breakers are open
+        return ::getRandom<QString>(filterNodes, limit, count, process);
+    }
+    std::vector<QString> result;
+    for (const size_t index: choosed) {
+        result.emplace_back(process(filterNodes[index]));
+    }
+    return result;
 }
 
 void NsLookup::resetFile() {
@@ -696,7 +951,7 @@ void NsLookup::resetFile() {
 void NsLookup::onGetStatus(const GetStatusCallback &callback) {
 BEGIN_SLOT_WRAPPER
     runAndEmitCallback([&, this]{
-        return std::make_tuple(getNodesStatus(), dnsErrorDetails);
+        return std::make_tuple(getNodesStatus(), dnsErrorDetails, dnsCache.getStats());
     }, callback);
 END_SLOT_WRAPPER
 }
@@ -717,6 +972,16 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void NsLookup::onServerResponse(const QString &server, milliseconds time, bool isSuccess) {
+BEGIN_SLOT_WRAPPER
+    if (isSuccess) {
+        nodeHealth.success(server, time, ::now());
+    } else {
+        nodeHealth.failure(server, ::now());
+    }
+END_SLOT_WRAPPER
+}
+
 void NsLookup::onRejectServer(const QString &server) {
 BEGIN_SLOT_WRAPPER
     bool isFound = false;
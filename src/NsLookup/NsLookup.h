@@ -6,6 +6,7 @@
 #include <vector>
 #include <map>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <atomic>
 
@@ -22,6 +23,9 @@
 #include "TaskManager.h"
 
 #include "NsLookupStructs.h"
+#include "NodeHealth.h"
+#include "ParallelLookup.h"
+#include "DnsCache.h"
 
 struct TypedException;
 
@@ -46,16 +50,9 @@ friend class nslookup::FindEmptyNodesWorker;
 friend class nslookup::PrintNodesWorker;
 friend class nslookup::MiddleWorker;
     Q_OBJECT
-private:
-
-    struct CacheDns {
-        std::map<QString, std::vector<QString>> cache;
-        time_point lastUpdate;
-    };
-
 public:
 
-    using GetStatusCallback = CallbackWrapper<void(const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError)>;
+    using GetStatusCallback = CallbackWrapper<void(const std::vector<NodeTypeStatus> &nodeStatuses, const DnsErrorDetails &dnsError, const DnsCacheStats &dnsCacheStats)>;
 
     using GetServersCallback = CallbackWrapper<void(const std::vector<QString> &servers)>;
 
@@ -98,6 +95,15 @@ public slots:
 
     void onRejectServer(const QString &server);
 
+signals:
+
+    // Result of real request to node, updates node health
+    void serverResponse(const QString &server, milliseconds time, bool isSuccess);
+
+public slots:
+
+    void onServerResponse(const QString &server, milliseconds time, bool isSuccess);
+
 signals:
 
     void finished();
@@ -106,6 +112,9 @@ signals:
 
 protected:
 
+    // Resolves and pings all node types in parallel. Nodes whose dns is not resolved keep old ips
+    void beginParallelResolve(std::map<NodeType::Node, std::vector<NodeInfo>> &allNodesForTypesNew, const std::function<void()> &finalizeLookup);
+
     void beginResolve(std::map<NodeType::Node, std::vector<NodeInfo>> &allNodesForTypesNew, std::vector<QString> &ipsTemp, const std::function<void()> &finalizeLookup, const std::function<void(std::map<QString, NodeType>::const_iterator node)> &beginPing);
 
     void continueResolve(std::map<QString, NodeType>::const_iterator node, std::map<NodeType::Node, std::vector<NodeInfo>> &allNodesForTypesNew, std::vector<QString> &ipsTemp, const std::function<void()> &finalizeLookup, const std::function<void(std::map<QString, NodeType>::const_iterator node)> &beginPing);
@@ -151,13 +160,19 @@ private:
 
     void process();
 
+    void prefetchDns();
+
     void sortAll();
 
     system_time_point fillNodesFromFile(const QString &file, const std::map<QString, NodeType> &expectedNodes);
 
-    void saveToFile(const QString &file, const system_time_point &tp, const std::map<QString, NodeType> &expectedNodes);
+    system_time_point fillNodesFromSnapshot(const QString &file, const std::map<QString, NodeType> &expectedNodes);
+
+    void saveSnapshot(const QString &file, const system_time_point &tp);
+
+    void mergePingHistory(const NodeType::Node &node, std::vector<NodeInfo> &newNodes) const;
 
-    std::vector<QString> getRandom(const QString &type, size_t limit, size_t count, const std::function<QString(const NodeInfo &node)> &process) const;
+    std::vector<QString> getRandom(const QString &type, size_t limit, size_t count, const std::function<QString(const NodeInfo &node)> &process);
 
     bool repeatResolveDns(
         const QString &dnsServerName,
@@ -180,8 +195,18 @@ private:
 
     UdpSocketClient udpClient;
 
+    std::vector<std::unique_ptr<UdpSocketClient>> dnsClients;
+
+    UdpSocketClient dnsPrefetchClient;
+
+    std::deque<QString> dnsPrefetchQueue;
+
+    bool isDnsPrefetchRunning = false;
+
     QString savedNodesPath;
 
+    QString snapshotPath;
+
     system_time_point filledFileTp;
 
     std::map<QString, NodeType> nodes;
@@ -194,7 +219,7 @@ private:
 
     std::atomic<bool> isResetFilledFile{false};
 
-    CacheDns cacheDns;
+    nslookup::DnsCache dnsCache;
 
     seconds timeoutRequestNodes;
 
@@ -204,6 +229,8 @@ private:
 
     std::vector<std::pair<QString, size_t>> defectiveTorrents;
 
+    nslookup::NodeHealth nodeHealth;
+
     DnsErrorDetails dnsErrorDetails;
 
     size_t updateNumber = 0;
@@ -3,6 +3,8 @@
 
 #include <QString>
 
+#include <vector>
+
 #include "duration.h"
 
 struct NodeType {
@@ -43,6 +45,9 @@ struct NodeInfo {
     size_t countUpdated = 1;
     bool isTimeout = false;
 
+    // Last successful pings, the oldest first
+    std::vector<milliseconds> pingHistory;
+
     bool operator< (const NodeInfo &second) const {
         if (this->isTimeout) {
             return false;
@@ -67,6 +72,14 @@ struct DnsErrorDetails {
     }
 };
 
+struct DnsCacheStats {
+    size_t countRecords = 0;
+    size_t hits = 0;
+    size_t negativeHits = 0;
+    size_t misses = 0;
+    size_t prefetches = 0;
+};
+
 struct NodeTypeStatus {
     QString node;
     size_t countWorked;
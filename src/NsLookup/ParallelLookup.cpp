@@ -0,0 +1,236 @@
+#include "ParallelLookup.h"
+
+#include <QHostAddress>
+#include <QTimer>
+
+#include <algorithm>
+
+#include "dns/dnspacket.h"
+
+#include "Network/UdpSocketClient.h"
+
+#include "check.h"
+#include "Log.h"
+#include "TypedException.h"
+#include "qt_utilites/SlotWrapper.h"
+
+SET_LOG_NAMESPACE("NSL");
+
+namespace nslookup {
+
+static const milliseconds DNS_REPEAT_DELAY = 200ms;
+
+static const size_t COUNT_IPS_IN_PING = 10;
+
+static const milliseconds PING_TIMEOUT = 2s;
+
+static QString makeAddress(const QString &ip, const QString &port) {
+    return "http://" + ip + ":" + port;
+}
+
+milliseconds getDnsRepeatDelay(size_t countRepeat) {
+    CHECK(countRepeat >= 1 && countRepeat <= DNS_REPEAT_COUNT, "Incorrect dns repeat number");
+    return DNS_REPEAT_DELAY * (1 << (DNS_REPEAT_COUNT - countRepeat));
+}
+
+std::vector<QString> parseDnsResponse(const std::vector<char> &response, const QString &port, seconds &ttl) {
+    CHECK(!response.empty(), "Empty dns response");
+    const DnsPacket packet = DnsPacket::fromBytesArary(QByteArray(response.data(), response.size()));
+    CHECK(!packet.answers().empty(), "Dns response without answers");
+    std::vector<QString> ips;
+    ttl = hours(1);
+    for (const auto &record : packet.answers()) {
+        ips.emplace_back(makeAddress(record.toString(), port));
+        ttl = std::min(ttl, seconds(record.ttl()));
+    }
+    return ips;
+}
+
+ParallelLookup::ParallelLookup(const std::vector<UdpSocketClient*> &udpClients, SimpleClient &client, const QString &dnsServerName, int dnsServerPort, milliseconds dnsTimeout, size_t maxPingsInFlight)
+    : udpClients(udpClients)
+    , client(client)
+    , dnsServerName(dnsServerName)
+    , dnsServerPort(dnsServerPort)
+    , dnsTimeout(dnsTimeout)
+    , maxPingsInFlight(maxPingsInFlight)
+{
+    CHECK(!udpClients.empty(), "Udp clients empty");
+    CHECK(maxPingsInFlight != 0, "Incorrect max pings");
+}
+
+void ParallelLookup::start(const std::vector<NodeType> &nodes, const std::map<QString, std::vector<QString>> &cachedIps, const std::set<QString> &skipNodes, const GetPingRequest &getPingRequest, const ResolvedCallback &resolved, const FinishCallback &finish) {
+    this->getPingRequest = getPingRequest;
+    this->resolved = resolved;
+    this->finish = finish;
+
+    std::set<NodeType::Node> added;
+    for (const NodeType &node: nodes) {
+        if (added.insert(node.node).second) {
+            this->nodes.emplace_back(node);
+        }
+    }
+    pingRequests.resize(this->nodes.size());
+
+    for (size_t i = 0; i < udpClients.size(); i++) {
+        freeDnsSlots.emplace_back(i);
+    }
+
+    for (size_t i = 0; i < this->nodes.size(); i++) {
+        if (skipNodes.find(this->nodes[i].node.str()) != skipNodes.end()) {
+            failedNodes.insert(this->nodes[i].node);
+            continue;
+        }
+        const auto found = cachedIps.find(this->nodes[i].node.str());
+        if (found != cachedIps.end() && !found->second.empty()) {
+            addPings(i, found->second);
+        } else {
+            dnsQueue.emplace_back(i);
+        }
+    }
+
+    isStarted = true;
+    startDns();
+    checkFinished();
+}
+
+void ParallelLookup::startDns() {
+    while (!dnsQueue.empty() && !freeDnsSlots.empty()) {
+        const size_t slot = freeDnsSlots.back();
+        freeDnsSlots.pop_back();
+        const size_t nodeIndex = dnsQueue.front();
+        dnsQueue.pop_front();
+        resolve(slot, nodeIndex, DNS_REPEAT_COUNT);
+    }
+}
+
+void ParallelLookup::resolve(size_t slot, size_t nodeIndex, size_t countRepeat) {
+    const NodeType &node = nodes[nodeIndex];
+    if (countRepeat == 0) {
+        LOG << "Dns error " << node.type << ". Server " << dnsServerName;
+        failedNodes.insert(node.node);
+        dnsFinished(slot, nodeIndex, {});
+        return;
+    }
+
+    DnsPacket requestPacket;
+    requestPacket.addQuestion(DnsQuestion::getIp(node.node.str()));
+    requestPacket.setFlags(DnsFlag::MyFlag);
+    const QByteArray byteArray = requestPacket.toByteArray();
+
+    const auto self = shared_from_this();
+    const TypedException exception = apiVrapper2([&]{
+        udpClients[slot]->sendRequest(QHostAddress(dnsServerName), dnsServerPort, std::vector<char>(byteArray.begin(), byteArray.end()), [self, slot, nodeIndex, countRepeat](const std::vector<char> &response, const UdpSocketClient::SocketException &exception) {
+            const NodeType &node = self->nodes[nodeIndex];
+            std::vector<QString> ips;
+            seconds ttl;
+            const TypedException except = apiVrapper2([&](){
+                CHECK(!exception.isSet(), "Dns exception: " + exception.toString());
+                ips = parseDnsResponse(response, node.port, ttl);
+            });
+
+            if (except.isSet()) {
+                LOG << "Dns repeat number " << countRepeat - 1;
+                self->repeatResolve(slot, nodeIndex, countRepeat);
+                return;
+            }
+
+            LOG << "Dns ok " << node.type << ". " << ips.size();
+            self->resolved(node, ips, ttl);
+            self->dnsFinished(slot, nodeIndex, ips);
+        }, dnsTimeout);
+    });
+    if (exception.isSet()) {
+        repeatResolve(slot, nodeIndex, countRepeat);
+    }
+}
+
+void ParallelLookup::repeatResolve(size_t slot, size_t nodeIndex, size_t countRepeat) {
+    if (countRepeat <= 1) {
+        resolve(slot, nodeIndex, 0);
+        return;
+    }
+    const milliseconds delay = getDnsRepeatDelay(countRepeat);
+    const auto self = shared_from_this();
+    QTimer::singleShot(delay.count(), &client, [self, slot, nodeIndex, countRepeat]{
+BEGIN_SLOT_WRAPPER
+        self->resolve(slot, nodeIndex, countRepeat - 1);
+END_SLOT_WRAPPER
+    });
+}
+
+void ParallelLookup::dnsFinished(size_t slot, size_t nodeIndex, const std::vector<QString> &ips) {
+    freeDnsSlots.emplace_back(slot);
+    if (!ips.empty()) {
+        addPings(nodeIndex, ips);
+    }
+    startDns();
+    checkFinished();
+}
+
+void ParallelLookup::addPings(size_t nodeIndex, const std::vector<QString> &ips) {
+    countWaitPingRequest++;
+    const auto self = shared_from_this();
+    getPingRequest(nodes[nodeIndex], [self, nodeIndex, ips](const PingRequest &request) {
+        self->countWaitPingRequest--;
+        self->pingRequests[nodeIndex] = request;
+        for (size_t i = 0; i < ips.size(); i += COUNT_IPS_IN_PING) {
+            PingBatch batch;
+            batch.nodeIndex = nodeIndex;
+            batch.ips.assign(ips.begin() + i, ips.begin() + std::min(i + COUNT_IPS_IN_PING, ips.size()));
+            self->pingQueue.emplace_back(batch);
+        }
+        self->startPings();
+        self->checkFinished();
+    });
+}
+
+void ParallelLookup::startPings() {
+    while (!pingQueue.empty() && countPingsInFlight < maxPingsInFlight) {
+        const PingBatch batch = pingQueue.front();
+        pingQueue.pop_front();
+        const PingRequest &request = pingRequests[batch.nodeIndex];
+
+        std::vector<QUrl> getRequests;
+        getRequests.reserve(batch.ips.size());
+        std::transform(batch.ips.begin(), batch.ips.end(), std::back_inserter(getRequests), [&request](const QString &ip) {
+            QUrl getRequest = ip;
+            getRequest.setPath(request.get);
+            return getRequest;
+        });
+        countPingsInFlight++;
+        const auto self = shared_from_this();
+        client.sendMessagesPost(nodes[batch.nodeIndex].node.str().toStdString(), getRequests, request.post, [self, batch](const std::vector<SimpleClient::Response> &responses) {
+            self->pingFinished(batch, responses);
+        }, PING_TIMEOUT);
+    }
+}
+
+void ParallelLookup::pingFinished(const PingBatch &batch, const std::vector<SimpleClient::Response> &responses) {
+    countPingsInFlight--;
+    const TypedException exception = apiVrapper2([&]{
+        CHECK(batch.ips.size() == responses.size(), "Incorrect results");
+        const PingRequest &request = pingRequests[batch.nodeIndex];
+        std::vector<NodeInfo> &infos = result[nodes[batch.nodeIndex].node];
+        for (size_t i = 0; i < responses.size(); i++) {
+            infos.emplace_back(request.parse(batch.ips[i], responses[i]));
+        }
+    });
+    if (exception.isSet()) {
+        LOG << "Exception"; // Ошибка логгируется внутри apiVrapper2;
+    }
+    startPings();
+    checkFinished();
+}
+
+void ParallelLookup::checkFinished() {
+    if (!isStarted || isFinished) {
+        return;
+    }
+    if (!dnsQueue.empty() || freeDnsSlots.size() != udpClients.size() || countWaitPingRequest != 0 || !pingQueue.empty() || countPingsInFlight != 0) {
+        return;
+    }
+    isFinished = true;
+    finish(result, failedNodes);
+}
+
+} // namespace nslookup
@@ -0,0 +1,130 @@
+#ifndef PARALLELLOOKUP_H
+#define PARALLELLOOKUP_H
+
+#include <QString>
+
+#include <map>
+#include <set>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+
+#include "duration.h"
+
+#include "Network/SimpleClient.h"
+
+#include "NsLookupStructs.h"
+
+class UdpSocketClient;
+
+namespace nslookup {
+
+// Attempts of one dns request
+const static size_t DNS_REPEAT_COUNT = 3;
+
+// Delay before repeat of dns request failed with countRepeat attempts left. It doubles with every failed attempt
+milliseconds getDnsRepeatDelay(size_t countRepeat);
+
+// Returns addresses of A records with port and minimal ttl of records. Throws on incorrect or empty response
+std::vector<QString> parseDnsResponse(const std::vector<char> &response, const QString &port, seconds &ttl);
+
+// Resolves dns names of all node types and pings received ips.
+// Up to udpClients.size() dns requests and maxPingsInFlight ping batches are running at the same time.
+// Must be used from the thread of the clients and kept in shared_ptr until finish callback is called
+class ParallelLookup: public std::enable_shared_from_this<ParallelLookup> {
+public:
+
+    struct PingRequest {
+        QString get;
+        QString post;
+        std::function<NodeInfo(const QString &address, const SimpleClient::Response &response)> parse;
+    };
+
+    using GetPingRequest = std::function<void(const NodeType &node, const std::function<void(const PingRequest &request)> &callback)>;
+
+    // ttl - minimal ttl of dns records
+    using ResolvedCallback = std::function<void(const NodeType &node, const std::vector<QString> &ips, seconds ttl)>;
+
+    // failedNodes - nodes whose dns name is not resolved
+    using FinishCallback = std::function<void(std::map<NodeType::Node, std::vector<NodeInfo>> &result, const std::set<NodeType::Node> &failedNodes)>;
+
+public:
+
+    ParallelLookup(const std::vector<UdpSocketClient*> &udpClients, SimpleClient &client, const QString &dnsServerName, int dnsServerPort, milliseconds dnsTimeout, size_t maxPingsInFlight);
+
+    // Nodes from cachedIps are not resolved, nodes from skipNodes are not resolved and not pinged
+    void start(const std::vector<NodeType> &nodes, const std::map<QString, std::vector<QString>> &cachedIps, const std::set<QString> &skipNodes, const GetPingRequest &getPingRequest, const ResolvedCallback &resolved, const FinishCallback &finish);
+
+private:
+
+    struct PingBatch {
+        size_t nodeIndex;
+        std::vector<QString> ips;
+    };
+
+private:
+
+    void startDns();
+
+    void resolve(size_t slot, size_t nodeIndex, size_t countRepeat);
+
+    // countRepeat - attempts left including the failed one
+    void repeatResolve(size_t slot, size_t nodeIndex, size_t countRepeat);
+
+    void dnsFinished(size_t slot, size_t nodeIndex, const std::vector<QString> &ips);
+
+    void addPings(size_t nodeIndex, const std::vector<QString> &ips);
+
+    void startPings();
+
+    void pingFinished(const PingBatch &batch, const std::vector<SimpleClient::Response> &responses);
+
+    void checkFinished();
+
+private:
+
+    const std::vector<UdpSocketClient*> udpClients;
+
+    SimpleClient &client;
+
+    const QString dnsServerName;
+
+    const int dnsServerPort;
+
+    const milliseconds dnsTimeout;
+
+    const size_t maxPingsInFlight;
+
+    std::vector<NodeType> nodes;
+
+    std::vector<PingRequest> pingRequests;
+
+    GetPingRequest getPingRequest;
+
+    ResolvedCallback resolved;
+
+    FinishCallback finish;
+
+    std::deque<size_t> dnsQueue;
+
+    std::vector<size_t> freeDnsSlots;
+
+    size_t countWaitPingRequest = 0;
+
+    std::deque<PingBatch> pingQueue;
+
+    size_t countPingsInFlight = 0;
+
+    std::map<NodeType::Node, std::vector<NodeInfo>> result;
+
+    std::set<NodeType::Node> failedNodes;
+
+    bool isStarted = false;
+
+    bool isFinished = false;
+};
+
+} // namespace nslookup
+
+#endif // PARALLELLOOKUP_H
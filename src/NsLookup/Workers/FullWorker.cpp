@@ -9,8 +9,6 @@
 #include "check.h"
 #include "Log.h"
 
-using namespace std::placeholders;
-
 SET_LOG_NAMESPACE("NSL");
 
 namespace nslookup {
@@ -63,22 +61,8 @@ void FullWorker::beginWork(const WorkerGuard &workerGuard) {
     addNewTask(makeTask(CONTROL_CHECK));
 
     const auto finLookup = std::bind(&FullWorker::finalizeLookup, this, workerGuard);
-    const auto beginPing = std::bind(&FullWorker::beginPing, this, workerGuard, _1);
-
-    ns.beginResolve(allNodesForTypes, ipsTemp, finLookup, beginPing);
-}
-
-void FullWorker::beginPing(const WorkerGuard &workerGuard, std::map<QString, NodeType>::const_iterator node) {
-    const auto continueResolve = std::bind(&FullWorker::continueResolve, this, workerGuard, node);
-
-    ns.continuePing(std::begin(ipsTemp), node->second, allNodesForTypes, ipsTemp, continueResolve);
-}
-
-void FullWorker::continueResolve(const WorkerGuard &workerGuard, std::map<QString, NodeType>::const_iterator node) {
-    const auto finalizeLookup = std::bind(&FullWorker::finalizeLookup, this, workerGuard);
-    const auto beginPing = std::bind(&FullWorker::beginPing, this, workerGuard, _1);
 
-    ns.continueResolve(std::next(node), allNodesForTypes, ipsTemp, finalizeLookup, beginPing);
+    ns.beginParallelResolve(allNodesForTypes, finLookup);
 }
 
 void FullWorker::finalizeLookup(const WorkerGuard &workerGuard) {
@@ -37,10 +37,6 @@ private:
 
     void beginWork(const WorkerGuard &workerGuard);
 
-    void beginPing(const WorkerGuard &workerGuard, std::map<QString, NodeType>::const_iterator node);
-
-    void continueResolve(const WorkerGuard &workerGuard, std::map<QString, NodeType>::const_iterator node);
-
     void finalizeLookup(const WorkerGuard &workerGuard);
 
     void endWork(const WorkerGuard &workerGuard);
@@ -51,8 +47,6 @@ private:
 
     std::map<NodeType::Node, std::vector<NodeInfo>> allNodesForTypes;
 
-    std::vector<QString> ipsTemp;
-
     Timer tt;
 
 };
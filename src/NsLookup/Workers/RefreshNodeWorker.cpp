@@ -40,8 +40,8 @@ std::string RefreshNodeWorker::getSubType() const {
     return t.node.toStdString();
 }
 
-Task RefreshNodeWorker::makeTask(const seconds &remaining, const QString &node) {
-    return Task(TYPE, QVariant::fromValue(NsLookupRefreshNodeWorkerTask(node)), remaining);
+Task RefreshNodeWorker::makeTask(const seconds &remaining, const QString &node, bool isRevalidate) {
+    return Task(TYPE, QVariant::fromValue(NsLookupRefreshNodeWorkerTask(node, isRevalidate)), remaining);
 }
 
 bool RefreshNodeWorker::checkIsActual() const {
@@ -51,6 +51,10 @@ bool RefreshNodeWorker::checkIsActual() const {
         return false;
     }
 
+    if (t.isRevalidate) {
+        return true;
+    }
+
     const size_t countWorked = ns.countWorkedNodes(t.node);
     const bool actual = countWorked == 0;
     if (!actual) {
@@ -17,10 +17,14 @@ class NsLookup;
 struct NsLookupRefreshNodeWorkerTask {
     QString node;
 
+    // Refresh node even if it has worked ips
+    bool isRevalidate = false;
+
     NsLookupRefreshNodeWorkerTask() = default;
 
-    NsLookupRefreshNodeWorkerTask(const QString &node)
+    NsLookupRefreshNodeWorkerTask(const QString &node, bool isRevalidate)
         : node(node)
+        , isRevalidate(isRevalidate)
     {}
 };
 
@@ -36,7 +40,7 @@ public:
 
     static bool isThisWorker(const std::string &taskName);
 
-    static Task makeTask(const seconds &remaining, const QString &node);
+    static Task makeTask(const seconds &remaining, const QString &node, bool isRevalidate = false);
 
 protected:
 
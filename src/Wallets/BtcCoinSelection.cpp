@@ -0,0 +1,300 @@
+#include "BtcCoinSelection.h"
+
+#include <algorithm>
+#include <random>
+#include <limits>
+
+#include "BtcWallet.h"
+
+namespace wallets {
+
+const static size_t BNB_MAX_TRIES = 100000;
+
+const static size_t KNAPSACK_ITERATIONS = 1000;
+
+static std::vector<uint64_t> calcEffectiveValues(const std::vector<BtcInput> &utxos, uint64_t feePerInput) {
+    std::vector<uint64_t> values;
+    values.reserve(utxos.size());
+    for (const BtcInput &utxo: utxos) {
+        values.emplace_back(utxo.outBalance > feePerInput ? utxo.outBalance - feePerInput : 0);
+    }
+    return values;
+}
+
+// Indexes of the inputs with non zero effective value, the largest first
+static std::vector<size_t> sortByValueDesc(const std::vector<uint64_t> &values, uint64_t &sum) {
+    std::vector<size_t> indexes;
+    indexes.reserve(values.size());
+    sum = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (values[i] != 0) {
+            indexes.emplace_back(i);
+            sum += values[i];
+        }
+    }
+    std::sort(indexes.begin(), indexes.end(), [&values](size_t first, size_t second) {
+        if (values[first] != values[second]) {
+            return values[first] > values[second];
+        }
+        return first < second;
+    });
+    return indexes;
+}
+
+static void fillResult(const std::vector<BtcInput> &utxos, const std::vector<uint64_t> &values, const CoinSelectionParams &params, std::vector<size_t> indexes, CoinSelectionAlgorithm algorithm, CoinSelectionResult &result) {
+    std::sort(indexes.begin(), indexes.end());
+    result.value = 0;
+    result.effectiveValue = 0;
+    for (const size_t index: indexes) {
+        result.value += utxos[index].outBalance;
+        result.effectiveValue += values[index];
+    }
+    const uint64_t excess = result.effectiveValue - params.target;
+    result.waste = params.feePerInput * indexes.size() + std::min(excess, params.costOfChange);
+    result.indexes = std::move(indexes);
+    result.algorithm = algorithm;
+}
+
+bool selectCoinsBranchAndBound(const std::vector<BtcInput> &utxos, const CoinSelectionParams &params, CoinSelectionResult &result) {
+    const std::vector<uint64_t> values = calcEffectiveValues(utxos, params.feePerInput);
+    uint64_t available;
+    const std::vector<size_t> pool = sortByValueDesc(values, available);
+    if (available < params.target) {
+        return false;
+    }
+    const uint64_t upperBound = params.target + params.costOfChange;
+
+    // Positions in pool of the included inputs. The inputs between them are excluded
+    std::vector<size_t> selection;
+    std::vector<size_t> best;
+    bool isFound = false;
+    uint64_t bestExcess = std::numeric_limits<uint64_t>::max();
+    uint64_t value = 0;
+
+    size_t pos = 0;
+    for (size_t tries = 0; tries < BNB_MAX_TRIES; tries++, pos++) {
+        bool backtrack = false;
+        if (value + available < params.target || value > upperBound) {
+            backtrack = true;
+        } else if (value >= params.target) {
+            const uint64_t excess = value - params.target;
+            if (!isFound || excess < bestExcess || (excess == bestExcess && selection.size() < best.size())) {
+                best = selection;
+                bestExcess = excess;
+                isFound = true;
+            }
+            if (bestExcess == 0) {
+                break;
+            }
+            backtrack = true;
+        }
+
+        if (backtrack) {
+            if (selection.empty()) {
+                break;
+            }
+            // Return the inputs after the last included to available and try the branch without it
+            for (pos--; pos > selection.back(); pos--) {
+                available += values[pool[pos]];
+            }
+            value -= values[pool[pos]];
+            selection.pop_back();
+        } else {
+            const uint64_t current = values[pool[pos]];
+            available -= current;
+            // If the previous input of the same value is excluded, including this one repeats the checked sums
+            if (selection.empty() || selection.back() + 1 == pos || values[pool[pos - 1]] != current) {
+                selection.emplace_back(pos);
+                value += current;
+            }
+        }
+    }
+
+    if (!isFound) {
+        return false;
+    }
+
+    std::vector<size_t> indexes;
+    indexes.reserve(best.size());
+    for (const size_t p: best) {
+        indexes.emplace_back(pool[p]);
+    }
+    fillResult(utxos, values, params, std::move(indexes), CoinSelectionAlgorithm::BranchAndBound, result);
+    return true;
+}
+
+// values sorted descending, sum of them is total and not less than target
+static std::vector<bool> approximateBestSubset(const std::vector<uint64_t> &values, uint64_t total, uint64_t target, uint64_t &bestValue) {
+    std::mt19937_64 random(values.size());
+
+    std::vector<bool> best(values.size(), true);
+    bestValue = total;
+
+    std::vector<bool> included(values.size());
+    for (size_t rep = 0; rep < KNAPSACK_ITERATIONS && bestValue != target; rep++) {
+        std::fill(included.begin(), included.end(), false);
+        uint64_t sum = 0;
+        bool isReached = false;
+        for (int pass = 0; pass < 2 && !isReached; pass++) {
+            uint64_t bits = 0;
+            for (size_t i = 0; i < values.size(); i++) {
+                bool include;
+                if (pass == 0) {
+                    if (i % 64 == 0) {
+                        bits = random();
+                    }
+                    include = (bits & 1) != 0;
+                    bits >>= 1;
+                } else {
+                    include = !included[i];
+                }
+                if (!include) {
+                    continue;
+                }
+                sum += values[i];
+                included[i] = true;
+                if (sum >= target) {
+                    isReached = true;
+                    if (sum < bestValue) {
+                        bestValue = sum;
+                        best = included;
+                    }
+                    sum -= values[i];
+                    included[i] = false;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+bool selectCoinsKnapsack(const std::vector<BtcInput> &utxos, const CoinSelectionParams &params, CoinSelectionResult &result) {
+    const std::vector<uint64_t> values = calcEffectiveValues(utxos, params.feePerInput);
+
+    const uint64_t largerBound = params.target + params.costOfChange;
+    std::vector<size_t> smaller;
+    uint64_t smallerTotal = 0;
+    bool isLarger = false;
+    size_t lowestLarger = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        const uint64_t value = values[i];
+        if (value == 0) {
+            continue;
+        }
+        if (value == params.target) {
+            fillResult(utxos, values, params, {i}, CoinSelectionAlgorithm::Knapsack, result);
+            return true;
+        }
+        if (value < largerBound) {
+            smaller.emplace_back(i);
+            smallerTotal += value;
+        } else if (!isLarger || value < values[lowestLarger]) {
+            isLarger = true;
+            lowestLarger = i;
+        }
+    }
+
+    if (smallerTotal == params.target) {
+        fillResult(utxos, values, params, std::move(smaller), CoinSelectionAlgorithm::Knapsack, result);
+        return true;
+    }
+    if (smallerTotal < params.target) {
+        if (!isLarger) {
+            return false;
+        }
+        fillResult(utxos, values, params, {lowestLarger}, CoinSelectionAlgorithm::Knapsack, result);
+        return true;
+    }
+
+    std::sort(smaller.begin(), smaller.end(), [&values](size_t first, size_t second) {
+        if (values[first] != values[second]) {
+            return values[first] > values[second];
+        }
+        return first < second;
+    });
+    std::vector<uint64_t> smallerValues;
+    smallerValues.reserve(smaller.size());
+    for (const size_t index: smaller) {
+        smallerValues.emplace_back(values[index]);
+    }
+
+    uint64_t bestValue;
+    const std::vector<bool> best = approximateBestSubset(smallerValues, smallerTotal, params.target, bestValue);
+
+    if (isLarger && ((bestValue != params.target && bestValue < largerBound) || values[lowestLarger] <= bestValue)) {
+        fillResult(utxos, values, params, {lowestLarger}, CoinSelectionAlgorithm::Knapsack, result);
+        return true;
+    }
+
+    std::vector<size_t> indexes;
+    for (size_t i = 0; i < smaller.size(); i++) {
+        if (best[i]) {
+            indexes.emplace_back(smaller[i]);
+        }
+    }
+    fillResult(utxos, values, params, std::move(indexes), CoinSelectionAlgorithm::Knapsack, result);
+    return true;
+}
+
+bool selectCoinsLargestFirst(const std::vector<BtcInput> &utxos, const CoinSelectionParams &params, CoinSelectionResult &result) {
+    const std::vector<uint64_t> values = calcEffectiveValues(utxos, params.feePerInput);
+    uint64_t available;
+    const std::vector<size_t> pool = sortByValueDesc(values, available);
+    if (available < params.target) {
+        return false;
+    }
+
+    std::vector<size_t> indexes;
+    uint64_t value = 0;
+    for (size_t i = 0; i < pool.size() && value < params.target; i++) {
+        indexes.emplace_back(pool[i]);
+        value += values[pool[i]];
+    }
+    fillResult(utxos, values, params, std::move(indexes), CoinSelectionAlgorithm::LargestFirst, result);
+    return true;
+}
+
+bool selectCoins(const std::vector<BtcInput> &utxos, const CoinSelectionParams &params, CoinSelectionAlgorithm algorithm, CoinSelectionResult &result) {
+    switch (algorithm) {
+    case CoinSelectionAlgorithm::BranchAndBound:
+        return selectCoinsBranchAndBound(utxos, params, result);
+    case CoinSelectionAlgorithm::Knapsack:
+        return selectCoinsKnapsack(utxos, params, result);
+    case CoinSelectionAlgorithm::LargestFirst:
+        return selectCoinsLargestFirst(utxos, params, result);
+    case CoinSelectionAlgorithm::Auto:
+    default: {
+        if (selectCoinsBranchAndBound(utxos, params, result)) {
+            return true;
+        }
+        // The knapsack aims at the smallest excess and may take many small inputs, which costs more than the change output
+        CoinSelectionResult largestFirst;
+        if (!selectCoinsLargestFirst(utxos, params, largestFirst)) {
+            return false;
+        }
+        CoinSelectionResult knapsack;
+        if (selectCoinsKnapsack(utxos, params, knapsack) && (knapsack.waste < largestFirst.waste || (knapsack.waste == largestFirst.waste && knapsack.indexes.size() < largestFirst.indexes.size()))) {
+            result = std::move(knapsack);
+        } else {
+            result = std::move(largestFirst);
+        }
+        return true;
+    }
+    }
+}
+
+const char* coinSelectionAlgorithmName(CoinSelectionAlgorithm algorithm) {
+    switch (algorithm) {
+    case CoinSelectionAlgorithm::BranchAndBound:
+        return "branch and bound";
+    case CoinSelectionAlgorithm::Knapsack:
+        return "knapsack";
+    case CoinSelectionAlgorithm::LargestFirst:
+        return "largest first";
+    case CoinSelectionAlgorithm::Auto:
+    default:
+        return "auto";
+    }
+}
+
+} // namespace wallets
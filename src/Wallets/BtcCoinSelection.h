@@ -0,0 +1,56 @@
+#ifndef BTCCOINSELECTION_H
+#define BTCCOINSELECTION_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct BtcInput;
+
+namespace wallets {
+
+enum class CoinSelectionAlgorithm {
+    Auto, // BranchAndBound, then Knapsack or LargestFirst with less waste
+    BranchAndBound,
+    Knapsack,
+    LargestFirst
+};
+
+struct CoinSelectionParams {
+    // Value to send plus the fee of the transaction without inputs
+    uint64_t target = 0;
+    // Fee of one input. An input is counted by its effective value outBalance - feePerInput, inputs that do not pay for themselves are skipped
+    uint64_t feePerInput = 0;
+    // Fee of the change output. A selection that exceeds the target by less than this is taken without change
+    uint64_t costOfChange = 0;
+};
+
+struct CoinSelectionResult {
+    // Indexes of the selected inputs, ascending
+    std::vector<size_t> indexes;
+    // Sum of outBalance of the selected inputs
+    uint64_t value = 0;
+    // Sum of effective values of the selected inputs, not less than target
+    uint64_t effectiveValue = 0;
+    // Fees of the inputs plus the fee of the change output, or plus the excess if it is less than costOfChange and goes to fees
+    uint64_t waste = 0;
+    CoinSelectionAlgorithm algorithm = CoinSelectionAlgorithm::Auto;
+};
+
+// Depth-first search of the subset with effective value in [target, target + costOfChange]. Returns false if it is not found in a bounded number of tries
+bool selectCoinsBranchAndBound(const std::vector<BtcInput> &utxos, const CoinSelectionParams &params, CoinSelectionResult &result);
+
+// Random approximation of the smallest subset sum not less than target, compared with the smallest input larger than target
+bool selectCoinsKnapsack(const std::vector<BtcInput> &utxos, const CoinSelectionParams &params, CoinSelectionResult &result);
+
+// The largest inputs until the target is reached. O(n log n)
+bool selectCoinsLargestFirst(const std::vector<BtcInput> &utxos, const CoinSelectionParams &params, CoinSelectionResult &result);
+
+// Returns false if the effective value of all inputs is less than target
+bool selectCoins(const std::vector<BtcInput> &utxos, const CoinSelectionParams &params, CoinSelectionAlgorithm algorithm, CoinSelectionResult &result);
+
+const char* coinSelectionAlgorithmName(CoinSelectionAlgorithm algorithm);
+
+} // namespace wallets
+
+#endif // BTCCOINSELECTION_H
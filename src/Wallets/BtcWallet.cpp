@@ -143,26 +143,38 @@ static size_t calcSizeTransaction(const std::string& transaction) {
     return transaction.size() / 2;
 }
 
+// Sizes of P2PKH transaction parts for the estimate of fees before the transaction is built
+const static uint64_t TX_BASE_SIZE = 10 + 2 * 34;
+const static uint64_t TX_INPUT_SIZE = 148;
+const static uint64_t TX_OUTPUT_SIZE = 34;
+
+// Outputs of P2PKH below this are dust and are not relayed by nodes
+const static uint64_t DUST_LIMIT = 546;
+
+static uint64_t sumBalance(const std::vector<BtcInput> &inputs) {
+    uint64_t result = 0;
+    for (const BtcInput &input: inputs) {
+        result += input.outBalance;
+    }
+    return result;
+}
+
 /**
- * Пытается набрать как можно меньше элементов на заданную сумму
- * Может вернуть меньшую сумму, если элементов не достаточно.
+ * Возвращает все utxos, если их не хватает на заданную сумму
  */
-template<class Element, typename Value>
-static std::vector<Element> greedyAlg(const std::vector<Element> &elements, const Value &allValue) {
-    std::vector<Element> sortedVect(elements.begin(), elements.end());
-    std::sort(sortedVect.begin(), sortedVect.end());
-    std::vector<Element> result;
-    Value currValue = 0;
-    while (currValue < allValue && !sortedVect.empty()) {
-        auto foundIter = std::lower_bound(sortedVect.begin(), sortedVect.end(), Element(allValue - currValue));
-        if (foundIter == sortedVect.end()) {
-            foundIter--;
-        }
-        currValue += foundIter->outBalance;
-        result.emplace_back(*foundIter);
-        sortedVect.erase(foundIter);
+std::vector<BtcInput> BtcWallet::selectInputs(const std::vector<BtcInput> &utxos, const wallets::CoinSelectionParams &params, wallets::CoinSelectionAlgorithm algorithm) {
+    wallets::CoinSelectionResult selection;
+    if (!wallets::selectCoins(utxos, params, algorithm, selection)) {
+        LOG << "Coin selection not found. Target " << params.target;
+        return utxos;
     }
 
+    std::vector<BtcInput> result;
+    result.reserve(selection.indexes.size());
+    for (const size_t index: selection.indexes) {
+        result.emplace_back(utxos[index]);
+    }
+    LOG << "Utxos size2 " << result.size() << " " << wallets::coinSelectionAlgorithmName(selection.algorithm) << ". Excess " << (selection.effectiveValue - params.target);
     return result;
 }
 
@@ -171,21 +183,7 @@ std::pair<std::string, std::set<std::string>> BtcWallet::encode(
     const std::string &toAddress,
     const std::vector<BtcInput> &utxos
 ) {
-    LOG << "Utxos size " + std::to_string(utxos.size());
-
-    std::vector<BtcInput> newUtxos;
-    if (!allMoney) {
-        const int64_t allValue = value + fees;
-        newUtxos = greedyAlg(utxos, allValue);
-        LOG << "Utxos size2 " + std::to_string(newUtxos.size());
-    } else {
-        newUtxos = utxos;
-    }
-
-    int64_t allUtxoValue = 0;
-    for (const BtcInput &utxo: newUtxos) {
-        allUtxoValue += utxo.outBalance;
-    }
+    const int64_t allUtxoValue = sumBalance(utxos);
 
     CHECK_TYPED(allUtxoValue >= value + fees, TypeErrors::INCORRECT_USER_DATA, "Not enough money. Balance " + std::to_string(allUtxoValue) + ". Value to send " + std::to_string(value) + ". Fees " + std::to_string(fees));
 
@@ -200,10 +198,10 @@ std::pair<std::string, std::set<std::string>> BtcWallet::encode(
     CHECK_TYPED(valueToSend > 0, TypeErrors::INCORRECT_USER_DATA, "Not enough money. Balance " + std::to_string(allUtxoValue) + ". Value to send " + std::to_string(valueToSend) + ". Fees " + std::to_string(fees));
     CHECK_TYPED(valueToSend >= fees, TypeErrors::INCORRECT_VALUE_OR_FEE, "Value it should be large than fees. Value " + std::to_string(valueToSend) + ". Fees " + std::to_string(fees));
 
-    const std::string encodedTransaction = genTransaction(newUtxos, valueToSend, feesValue, toAddress, false);
+    const std::string encodedTransaction = genTransaction(utxos, valueToSend, feesValue, toAddress, false);
 
     std::set<std::string> usedUtxos;
-    std::transform(newUtxos.begin(), newUtxos.end(), std::inserter(usedUtxos, usedUtxos.begin()), [](const BtcInput &input){return input.spendtxid;});
+    std::transform(utxos.begin(), utxos.end(), std::inserter(usedUtxos, usedUtxos.begin()), [](const BtcInput &input){return input.spendtxid;});
 
     return std::make_pair(encodedTransaction, usedUtxos);
 }
@@ -221,7 +219,8 @@ std::pair<std::string, std::set<std::string>> BtcWallet::buildTransaction(
     size_t estimateComissionInSatoshi,
     const std::string &valueStr,
     const std::string &feesStr,
-    const std::string &receiveAddress
+    const std::string &receiveAddress,
+    wallets::CoinSelectionAlgorithm algorithm
 ) {
     bool allMoney = false;
     int64_t value = 0;
@@ -244,6 +243,23 @@ std::pair<std::string, std::set<std::string>> BtcWallet::buildTransaction(
         feesEstimate = estimateComissionInSatoshi;
         LOG << "estimated fees1 " + std::to_string(feesEstimate);
     }
+
+    LOG << "Utxos size " + std::to_string(utxos.size());
+    wallets::CoinSelectionParams selectionParams;
+    std::vector<BtcInput> inputs = utxos;
+    if (!allMoney) {
+        if (feesStr == "auto") {
+            // Не меньше 1 сатоши за байт, как и в рассчете fees ниже
+            const uint64_t feePerKb = std::max<uint64_t>(feesEstimate, 1024);
+            selectionParams.target = value + (feePerKb * TX_BASE_SIZE) / 1024 + 30;
+            selectionParams.feePerInput = (feePerKb * TX_INPUT_SIZE) / 1024;
+            selectionParams.costOfChange = (feePerKb * TX_OUTPUT_SIZE) / 1024;
+        } else {
+            selectionParams.target = value + fees;
+        }
+        inputs = selectInputs(utxos, selectionParams, algorithm);
+    }
+
     int maxIterations = 10;
     std::string oldTransaction;
     std::set<std::string> oldUsedTransactions;
@@ -256,7 +272,23 @@ std::pair<std::string, std::set<std::string>> BtcWallet::buildTransaction(
             fees = oldTransactionSize + 30;
         }
 
-        const auto tmpTransactionPair = encode(allMoney, value, fees, receiveAddress, utxos);
+        if (!allMoney) {
+            uint64_t inputsValue = sumBalance(inputs);
+            if (inputsValue < (uint64_t)(value + fees) && inputs.size() < utxos.size()) { // Оценка fees при выборе utxos оказалась меньше
+                selectionParams.target += (uint64_t)(value + fees) - inputsValue;
+                inputs = selectInputs(utxos, selectionParams, algorithm);
+                inputsValue = sumBalance(inputs);
+            }
+            if (inputsValue > (uint64_t)(value + fees)) {
+                const uint64_t change = inputsValue - (value + fees);
+                // Сдача дешевле выхода для нее или пыль, отдаем ее в fees. Если fees станут больше value, оставляем выход сдачи
+                if (change <= std::max(selectionParams.costOfChange, DUST_LIMIT) && inputsValue - value <= (uint64_t)value) {
+                    fees = inputsValue - value;
+                }
+            }
+        }
+
+        const auto tmpTransactionPair = encode(allMoney, value, fees, receiveAddress, inputs);
         const std::string &tmpTransaction = tmpTransactionPair.first;
         const std::set<std::string> &tmpUsedUtxos = tmpTransactionPair.second;
         if (tmpTransaction.empty()) {
@@ -298,27 +330,36 @@ std::vector<std::pair<QString, QString>> BtcWallet::getAllWalletsInFolder(const
     const QDir dir(makePath(folder, FOLDER));
     const QStringList allFiles = dir.entryList(QDir::NoDotAndDotDot | QDir::System | QDir::Hidden  | QDir::AllDirs | QDir::Files, QDir::DirsFirst);
     for (const QString &file: allFiles) {
-        try {
-            const std::string address = getWifAndAddress(folder, file.toStdString(), true).second;
-            if (address.empty()) {
-                continue;
-            }
-            if (!isAddressBase56(address)) {
-                continue;
-            }
-            result.emplace_back(QString::fromStdString(address), getFullPath(folder, address));
-        } catch (const TypedException &error) {
-            LOG << "Error: " << file << " " << error.description;
-        } catch (const Exception &e) {
-            LOG << "Error: " << file << " " << e;
-        } catch (...) {
-            LOG << "Error: " << file << " " << " Unknown error";
+        std::pair<QString, QString> wallet;
+        if (parseWalletFileName(folder, file, wallet)) {
+            result.emplace_back(wallet);
         }
     }
 
     return result;
 }
 
+bool BtcWallet::parseWalletFileName(const QString &folder, const QString &fileName, std::pair<QString, QString> &wallet) {
+    try {
+        const std::string address = getWifAndAddress(folder, fileName.toStdString(), true).second;
+        if (address.empty()) {
+            return false;
+        }
+        if (!isAddressBase56(address)) {
+            return false;
+        }
+        wallet = std::make_pair(QString::fromStdString(address), getFullPath(folder, address));
+        return true;
+    } catch (const TypedException &error) {
+        LOG << "Error: " << fileName << " " << error.description;
+    } catch (const Exception &e) {
+        LOG << "Error: " << fileName << " " << e;
+    } catch (...) {
+        LOG << "Error: " << fileName << " " << " Unknown error";
+    }
+    return false;
+}
+
 std::string BtcWallet::getOneKey(const QString &folder, const std::string &address) {
     const QString filePath = getFullPath(folder, address);
     return readFile(filePath);
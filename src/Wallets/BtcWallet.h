@@ -7,6 +7,8 @@
 
 #include <QString>
 
+#include "BtcCoinSelection.h"
+
 struct BtcInput {
     std::string spendtxid;
     uint32_t spendoutnum;
@@ -51,13 +53,17 @@ public:
         size_t estimateComissionInSatoshi,
         const std::string &valueStr,
         const std::string &feesStr,
-        const std::string &receiveAddress
+        const std::string &receiveAddress,
+        wallets::CoinSelectionAlgorithm algorithm = wallets::CoinSelectionAlgorithm::Auto
     );
 
     static std::string calcHashNotWitness(const std::string &txHex);
 
     static std::vector<std::pair<QString, QString>> getAllWalletsInFolder(const QString &folder);
 
+    // Fills address and full path. Reads the file. Returns false if the file of the wallet folder is not a key
+    static bool parseWalletFileName(const QString &folder, const QString &fileName, std::pair<QString, QString> &wallet);
+
     const std::string& getAddress() const;
 
     static std::string getOneKey(const QString &folder, const std::string &address);
@@ -76,6 +82,8 @@ private:
 
 private:
 
+    static std::vector<BtcInput> selectInputs(const std::vector<BtcInput> &utxos, const wallets::CoinSelectionParams &params, wallets::CoinSelectionAlgorithm algorithm);
+
     std::pair<std::string, std::set<std::string>> encode(
         bool allMoney, const int64_t &value, const int64_t &fees,
         const std::string &toAddress,
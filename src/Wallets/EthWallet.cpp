@@ -88,25 +88,34 @@ std::vector<std::pair<QString, QString>> EthWallet::getAllWalletsInFolder(const
     const QDir dir(makePath(folder, ::FOLDER));
     const QStringList allFiles = dir.entryList(QDir::NoDotAndDotDot | QDir::System | QDir::Hidden  | QDir::AllDirs | QDir::Files, QDir::DirsFirst);
     for (const QString &file: allFiles) {
-        try {
-            const std::string fileName = file.toStdString();
-            if (isHex(fileName)) {
-                const std::string addressPart = fileName.substr(2);
-                const std::string address = "0x" + MixedCaseEncoding(HexStringToDump(addressPart));
-                result.emplace_back(QString::fromStdString(address), getFullPath(folder, address));
-            }
-        } catch (const TypedException &error) {
-            LOG << "Error: " << file << " " << error.description;
-        } catch (const Exception &e) {
-            LOG << "Error: " << file << " " << e;
-        } catch (...) {
-            LOG << "Error: " << file << " " << " Unknown error";
+        std::pair<QString, QString> wallet;
+        if (parseWalletFileName(folder, file, wallet)) {
+            result.emplace_back(wallet);
         }
     }
 
     return result;
 }
 
+bool EthWallet::parseWalletFileName(const QString &folder, const QString &fileName, std::pair<QString, QString> &wallet) {
+    try {
+        const std::string fileNameStr = fileName.toStdString();
+        if (isHex(fileNameStr)) {
+            const std::string addressPart = fileNameStr.substr(2);
+            const std::string address = "0x" + MixedCaseEncoding(HexStringToDump(addressPart));
+            wallet = std::make_pair(QString::fromStdString(address), getFullPath(folder, address));
+            return true;
+        }
+    } catch (const TypedException &error) {
+        LOG << "Error: " << fileName << " " << error.description;
+    } catch (const Exception &e) {
+        LOG << "Error: " << fileName << " " << e;
+    } catch (...) {
+        LOG << "Error: " << fileName << " " << " Unknown error";
+    }
+    return false;
+}
+
 std::string EthWallet::makeErc20Data(const std::string &valueHex, const std::string &address) {
     std::string result = "0xa9059cbb";
 
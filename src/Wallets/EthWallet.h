@@ -48,6 +48,9 @@ public:
 
     static std::vector<std::pair<QString, QString>> getAllWalletsInFolder(const QString &folder);
 
+    // Fills address and full path. Returns false if the file of the wallet folder is not a key
+    static bool parseWalletFileName(const QString &folder, const QString &fileName, std::pair<QString, QString> &wallet);
+
     static std::string makeErc20Data(const std::string &valueHex, const std::string &address);
 
     static std::string getOneKey(const QString &folder, const std::string &address);
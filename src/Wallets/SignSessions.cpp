@@ -0,0 +1,91 @@
+#include "SignSessions.h"
+
+#include <cryptopp/osrng.h>
+#include <cryptopp/sha.h>
+#include <cryptopp/misc.h>
+
+#include "Wallet.h"
+
+#include "check.h"
+#include "Log.h"
+
+SET_LOG_NAMESPACE("WLTS");
+
+namespace wallets {
+
+const seconds SignSessions::MAX_SESSION_TIME = 1h;
+
+static const size_t SALT_SIZE = 16;
+
+CryptoPP::SecByteBlock SignSessions::hashPassword(const CryptoPP::SecByteBlock &salt, const std::string &password) {
+    CryptoPP::SHA256 sha256;
+    sha256.Update(salt.data(), salt.size());
+    sha256.Update((const byte*)password.data(), password.size());
+    CryptoPP::SecByteBlock result(CryptoPP::SHA256::DIGESTSIZE);
+    sha256.Final(result.data());
+    return result;
+}
+
+void SignSessions::unlock(const QString &folder, bool isMhc, const std::string &address, const std::string &password, const seconds &time, const time_point &now) {
+    CHECK_TYPED(time.count() > 0, TypeErrors::INCORRECT_USER_DATA, "Incorrect session time");
+    CHECK_TYPED(time <= MAX_SESSION_TIME, TypeErrors::INCORRECT_USER_DATA, "Session time too long");
+
+    // Throws on incorrect password
+    const auto wallet = std::make_shared<const Wallet>(folder, isMhc, address, password);
+
+    Session session;
+    session.wallet = wallet;
+    session.salt.resize(SALT_SIZE);
+    CryptoPP::AutoSeededRandomPool prng;
+    prng.GenerateBlock(session.salt.data(), session.salt.size());
+    session.passwordHash = hashPassword(session.salt, password);
+    session.expired = now + time;
+
+    sessions[std::make_tuple(folder, isMhc, address)] = std::move(session);
+    LOG << "Wallet unlocked " << address << " " << time.count();
+}
+
+std::shared_ptr<const Wallet> SignSessions::getWallet(const QString &folder, bool isMhc, const std::string &address, const std::string &password, const time_point &now) const {
+    const auto found = sessions.find(std::make_tuple(folder, isMhc, address));
+    if (found != sessions.end() && found->second.expired > now) {
+        const Session &session = found->second;
+        const CryptoPP::SecByteBlock passwordHash = hashPassword(session.salt, password);
+        if (CryptoPP::VerifyBufsEqual(passwordHash.data(), session.passwordHash.data(), passwordHash.size())) {
+            return session.wallet;
+        }
+    }
+    return std::make_shared<const Wallet>(folder, isMhc, address, password);
+}
+
+bool SignSessions::isUnlocked(const QString &folder, bool isMhc, const std::string &address, const time_point &now) const {
+    const auto found = sessions.find(std::make_tuple(folder, isMhc, address));
+    return found != sessions.end() && found->second.expired > now;
+}
+
+void SignSessions::lock(const QString &folder, bool isMhc, const std::string &address) {
+    sessions.erase(std::make_tuple(folder, isMhc, address));
+}
+
+void SignSessions::lockAll() {
+    if (!sessions.empty()) {
+        LOG << "Wallets locked " << sessions.size();
+    }
+    sessions.clear();
+}
+
+void SignSessions::removeExpired(const time_point &now) {
+    for (auto iter = sessions.begin(); iter != sessions.end();) {
+        if (iter->second.expired <= now) {
+            LOG << "Wallet session expired " << std::get<2>(iter->first);
+            iter = sessions.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+}
+
+size_t SignSessions::size() const {
+    return sessions.size();
+}
+
+} // namespace wallets
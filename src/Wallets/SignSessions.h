@@ -0,0 +1,66 @@
+#ifndef SIGNSESSIONS_H
+#define SIGNSESSIONS_H
+
+#include <QString>
+
+#include <string>
+#include <map>
+#include <memory>
+#include <tuple>
+
+#include <cryptopp/secblock.h>
+
+#include "duration.h"
+
+class Wallet;
+
+namespace wallets {
+
+// Unlocked mhc keys. The key is read from file and decrypted once, later signs with the same password reuse it until the session is expired.
+// The password itself is not stored, only its salted hash
+class SignSessions {
+public:
+
+    static const seconds MAX_SESSION_TIME;
+
+public:
+
+    void unlock(const QString &folder, bool isMhc, const std::string &address, const std::string &password, const seconds &time, const time_point &now);
+
+    // Session wallet if password matches, otherwise the wallet is loaded from file and not saved
+    std::shared_ptr<const Wallet> getWallet(const QString &folder, bool isMhc, const std::string &address, const std::string &password, const time_point &now) const;
+
+    bool isUnlocked(const QString &folder, bool isMhc, const std::string &address, const time_point &now) const;
+
+    void lock(const QString &folder, bool isMhc, const std::string &address);
+
+    void lockAll();
+
+    void removeExpired(const time_point &now);
+
+    size_t size() const;
+
+private:
+
+    struct Session {
+        std::shared_ptr<const Wallet> wallet;
+        CryptoPP::SecByteBlock salt;
+        CryptoPP::SecByteBlock passwordHash;
+        time_point expired;
+    };
+
+    using Key = std::tuple<QString, bool, std::string>;
+
+private:
+
+    static CryptoPP::SecByteBlock hashPassword(const CryptoPP::SecByteBlock &salt, const std::string &password);
+
+private:
+
+    std::map<Key, Session> sessions;
+
+};
+
+} // namespace wallets
+
+#endif // SIGNSESSIONS_H
@@ -401,24 +401,7 @@ std::vector<wallets::WalletInfo> Wallet::getAllWalletsInfoInFolder(const QString
     const QStringList allFiles = dir.entryList(QDir::NoDotAndDotDot | QDir::System | QDir::Hidden  | QDir::AllDirs | QDir::Files, QDir::DirsFirst);
     for (const QString &file: allFiles) {
         wallets::WalletInfo info;
-        if (file.endsWith(FILE_METAHASH_PRIV_KEY_SUFFIX)) {
-            info.address = file.split(FILE_METAHASH_PRIV_KEY_SUFFIX).first();
-            const std::string address = info.address.toStdString();
-            if (address.size() != 52 || !isHex(address)) {
-                continue;
-            }
-            info.type = wallets::WalletInfo::Type::Key;
-            info.path = makeFullWalletPath(folder, isMhc, address);
-            result.emplace_back(info);
-        }
-        if (file.endsWith(FILE_METAHASH_WATCH_SUFFIX)) {
-            info.address = file.split(FILE_METAHASH_WATCH_SUFFIX).first();
-            const std::string address = info.address.toStdString();
-            if (address.size() != 52 || !isHex(address)) {
-                continue;
-            }
-            info.type = wallets::WalletInfo::Type::Watch;
-            info.path = makeFullWalletPath(folder, isMhc, address); // ??? Watch?
+        if (parseWalletFileName(folder, isMhc, file, info)) {
             result.emplace_back(info);
         }
     }
@@ -426,6 +409,30 @@ std::vector<wallets::WalletInfo> Wallet::getAllWalletsInfoInFolder(const QString
     return result;
 }
 
+bool Wallet::parseWalletFileName(const QString &folder, bool isMhc, const QString &fileName, wallets::WalletInfo &info) {
+    if (fileName.endsWith(FILE_METAHASH_PRIV_KEY_SUFFIX)) {
+        info.address = fileName.split(FILE_METAHASH_PRIV_KEY_SUFFIX).first();
+        const std::string address = info.address.toStdString();
+        if (address.size() != 52 || !isHex(address)) {
+            return false;
+        }
+        info.type = wallets::WalletInfo::Type::Key;
+        info.path = makeFullWalletPath(folder, isMhc, address);
+        return true;
+    }
+    if (fileName.endsWith(FILE_METAHASH_WATCH_SUFFIX)) {
+        info.address = fileName.split(FILE_METAHASH_WATCH_SUFFIX).first();
+        const std::string address = info.address.toStdString();
+        if (address.size() != 52 || !isHex(address)) {
+            return false;
+        }
+        info.type = wallets::WalletInfo::Type::Watch;
+        info.path = makeFullWalletPath(folder, isMhc, address); // ??? Watch?
+        return true;
+    }
+    return false;
+}
+
 Wallet::Wallet(const QString &folder, bool isMhc, const std::string &name, const std::string &password)
     : type(wallets::WalletInfo::Type::Key)
     , name(name)
@@ -456,6 +463,8 @@ Wallet::Wallet(const QString &folder, bool isMhc, const std::string &name, const
     const std::string pubKeyBinary = fromHex(pubKeyElements);
     const std::string hexAddr = createAddress(pubKeyBinary);
     CHECK_TYPED(hexAddr == name, TypeErrors::PRIVATE_KEY_ERROR, "Private key error: incorrect address. Possibly renamed wallet ." + hexAddr + "." + name + ".");
+
+    publicKeyHex = getPublicKey(privateKey);
 }
 
 Wallet::Wallet(const QString &folder, bool isMhc, const std::string &name)
@@ -485,7 +494,7 @@ std::string Wallet::sign(const std::string &message, std::string &publicKey) con
         );
         signature2.resize(resultSize);
 
-        publicKey = getPublicKey(privateKey);
+        publicKey = publicKeyHex;
 
         return toHex(signature2);
     } catch (const std::exception &e) {
@@ -537,7 +546,7 @@ std::string Wallet::genTx(const std::string &toAddress, uint64_t value, uint64_t
     return result;
 }
 
-void Wallet::sign(const std::string &toAddress, uint64_t value, uint64_t fee, uint64_t nonce, const std::string &data, std::string &txHex, std::string &signature, std::string &publicKey, bool isCheckHash) {
+void Wallet::sign(const std::string &toAddress, uint64_t value, uint64_t fee, uint64_t nonce, const std::string &data, std::string &txHex, std::string &signature, std::string &publicKey, bool isCheckHash) const {
     CHECK(type == wallets::WalletInfo::Type::Key, "Possible for wallet with key");
     const std::string txBinary = genTx(toAddress, value, fee, nonce, data, isCheckHash);
     signature = sign(txBinary, publicKey);
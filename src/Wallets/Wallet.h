@@ -38,6 +38,9 @@ public:
 
     static std::vector<wallets::WalletInfo> getAllWalletsInfoInFolder(const QString &folder, bool isMhc);
 
+    // Returns false if the file of the wallet folder is not a key or a watch wallet
+    static bool parseWalletFileName(const QString &folder, bool isMhc, const QString &fileName, wallets::WalletInfo &info);
+
     static std::string getPrivateKey(const QString &folder, bool isMhc, const std::string &addr, bool isCompact);
 
     static std::string savePrivateKey(const QString &folder, bool isMhc, const std::string &data, const std::string &password);
@@ -64,7 +67,7 @@ public:
 
     static std::string genTx(const std::string &toAddress, uint64_t value, uint64_t fee, uint64_t nonce, const std::string &dataHex, bool isCheckHash);
 
-    void sign(const std::string &toAddress, uint64_t value, uint64_t fee, uint64_t nonce, const std::string &data, std::string &txHex, std::string &signature, std::string &publicKey, bool isCheckHash=true);
+    void sign(const std::string &toAddress, uint64_t value, uint64_t fee, uint64_t nonce, const std::string &data, std::string &txHex, std::string &signature, std::string &publicKey, bool isCheckHash=true) const;
 
     std::string getNotProtectedKeyHex() const;
 
@@ -94,6 +97,9 @@ private:
     wallets::WalletInfo::Type type;
     CryptoPP::ECDSA<CryptoPP::ECP, CryptoPP::SHA256>::PrivateKey privateKey;
 
+    // Derived from privateKey once on load, point multiplication costs as much as a signature
+    std::string publicKeyHex;
+
     std::string name;
 
     QString fullPath;
@@ -1,6 +1,7 @@
 #include "Wallets.h"
 
 #include <QStandardPaths>
+#include <QTimer>
 
 #include "qt_utilites/SlotWrapper.h"
 #include "qt_utilites/QRegister.h"
@@ -13,6 +14,7 @@
 #include "utilites/unzip.h"
 
 #include "Wallet.h"
+#include "SignSessions.h"
 #include "BtcWallet.h"
 #include "EthWallet.h"
 #include "WalletRsa.h"
@@ -29,6 +31,9 @@
 
 SET_LOG_NAMESPACE("WLTS");
 
+// Watcher fires for every file, a bulk copy of keys is synced once
+static const milliseconds DIR_CHANGED_DELAY = 100ms;
+
 namespace wallets {
 
 Wallets::Wallets(auth::Auth &auth, utils::Utils &utils, QObject *parent)
@@ -41,6 +46,7 @@ Wallets::Wallets(auth::Auth &auth, utils::Utils &utils, QObject *parent)
 
     Q_CONNECT(this, &Wallets::getListWallets, this, &Wallets::onGetListWallets);
     Q_CONNECT(this, &Wallets::getListWallets2, this, &Wallets::onGetListWallets2);
+    Q_CONNECT(this, &Wallets::getListWalletsPage, this, &Wallets::onGetListWalletsPage);
     Q_CONNECT(this, &Wallets::createWatchWalletsList, this, &Wallets::onCreateWatchWalletsList);
     Q_CONNECT(this, &Wallets::createWallet, this, &Wallets::onCreateWallet);
     Q_CONNECT(this, &Wallets::createWatchWallet, this, &Wallets::onCreateWatchWallet);
@@ -52,8 +58,12 @@ Wallets::Wallets(auth::Auth &auth, utils::Utils &utils, QObject *parent)
     Q_CONNECT(this, &Wallets::createTokenAddress, this, &Wallets::onCreateTokenAddress);
     Q_CONNECT(this, &Wallets::signMessage, this, &Wallets::onSignMessage);
     Q_CONNECT(this, &Wallets::signMessage2, this, &Wallets::onSignMessage2);
+    Q_CONNECT(this, &Wallets::signMessages2, this, &Wallets::onSignMessages2);
+    Q_CONNECT(this, &Wallets::unlockWallet, this, &Wallets::onUnlockWallet);
+    Q_CONNECT(this, &Wallets::lockWallets, this, &Wallets::onLockWallets);
     Q_CONNECT(this, &Wallets::signAndSendMessage, this, &Wallets::onSignAndSendMessage);
     Q_CONNECT(this, &Wallets::signAndSendMessageDelegate, this, &Wallets::onSignAndSendMessageDelegate);
+    Q_CONNECT(this, &Wallets::signAndSendMessages, this, &Wallets::onSignAndSendMessages);
     Q_CONNECT(this, &Wallets::getOnePrivateKey, this, &Wallets::onGetOnePrivateKey);
     Q_CONNECT(this, &Wallets::savePrivateKey, this, &Wallets::onSavePrivateKey);
     Q_CONNECT(this, &Wallets::saveRawPrivateKey, this, &Wallets::onSaveRawPrivateKey);
@@ -84,6 +94,8 @@ Wallets::Wallets(auth::Auth &auth, utils::Utils &utils, QObject *parent)
     Q_CONNECT(this, &Wallets::calkKeysBtc, this, &Wallets::onCalkKeysBtc);
 
     Q_REG(WalletsListCallback, "WalletsListCallback");
+    Q_REG(WalletsListPageCallback, "WalletsListPageCallback");
+    Q_REG2(size_t, "size_t", false);
     Q_REG(wallets::WalletCurrency, "wallets::WalletCurrency");
     Q_REG2(std::vector<QString>, "std::vector<QString>", false);
     Q_REG(CreateWatchsCallback, "CreateWatchsCallback");
@@ -97,8 +109,14 @@ Wallets::Wallets(auth::Auth &auth, utils::Utils &utils, QObject *parent)
     Q_REG(CreateTokenAddressCallback, "CreateTokenAddressCallback");
     Q_REG(wallets::Wallets::SignMessageCallback, "wallets::Wallets::SignMessageCallback");
     Q_REG(SignMessage2Callback, "SignMessage2Callback");
+    Q_REG(SignMessages2Callback, "SignMessages2Callback");
+    Q_REG(UnlockWalletCallback, "UnlockWalletCallback");
+    Q_REG(LockWalletsCallback, "LockWalletsCallback");
+    Q_REG2(std::vector<MhcTxToSign>, "std::vector<MhcTxToSign>", false);
+    Q_REG2(seconds, "seconds", false);
     Q_REG(GettedNonceCallback, "GettedNonceCallback");
     Q_REG(SignAndSendMessageCallback, "SignAndSendMessageCallback");
+    Q_REG(SignAndSendMessagesCallback, "SignAndSendMessagesCallback");
     Q_REG(GetPrivateKeyCallback, "GetPrivateKeyCallback");
     Q_REG(SavePrivateKeyCallback, "SavePrivateKeyCallback");
     Q_REG(SaveRawPrivateKeyCallback, "SaveRawPrivateKeyCallback");
@@ -151,7 +169,7 @@ BEGIN_SLOT_WRAPPER
             const QString walletFullPath = wallet.getFullPath();
             created.emplace_back(addr, walletFullPath);
 
-            walletsList[isMhc ? WalletCurrency::Mth : WalletCurrency::Tmh][addr] = WalletInfo(addr, walletFullPath, WalletInfo::Type::Watch);
+            walletsIndex.add(isMhc ? WalletCurrency::Mth : WalletCurrency::Tmh, WalletInfo(addr, walletFullPath, WalletInfo::Type::Watch));
         }
 
         if (!created.empty()) {
@@ -179,7 +197,7 @@ BEGIN_SLOT_WRAPPER
 
         const QString walletFullPath = wallet.getFullPath();
 
-        walletsList[isMhc ? WalletCurrency::Mth : WalletCurrency::Tmh][QString::fromStdString(addr)] = WalletInfo(QString::fromStdString(addr), walletFullPath, WalletInfo::Type::Key);
+        walletsIndex.add(isMhc ? WalletCurrency::Mth : WalletCurrency::Tmh, WalletInfo(QString::fromStdString(addr), walletFullPath, WalletInfo::Type::Key));
 
         emit mhcWalletCreated(isMhc, QString::fromStdString(addr), userName);
 
@@ -198,7 +216,7 @@ BEGIN_SLOT_WRAPPER
 
         const QString walletFullPath = wallet.getFullPath();
 
-        walletsList[isMhc ? WalletCurrency::Mth : WalletCurrency::Tmh][address] = WalletInfo(address, walletFullPath, WalletInfo::Type::Watch);
+        walletsIndex.add(isMhc ? WalletCurrency::Mth : WalletCurrency::Tmh, WalletInfo(address, walletFullPath, WalletInfo::Type::Watch));
 
         emit mhcWatchWalletCreated(isMhc, address, userName);
 
@@ -213,7 +231,7 @@ BEGIN_SLOT_WRAPPER
         CHECK(!walletPath.isEmpty(), "Incorrect path to wallet: empty");
         Wallet::removeWalletWatch(walletPath, isMhc, address.toStdString());
 
-        walletsList[isMhc ? WalletCurrency::Mth : WalletCurrency::Tmh].erase(address);
+        walletsIndex.remove(isMhc ? WalletCurrency::Mth : WalletCurrency::Tmh, address, WalletInfo::Type::Watch);
 
         emit mhcWatchWalletRemoved(isMhc, address, userName);
     }, callback);
@@ -280,9 +298,9 @@ void Wallets::onSignMessage(bool isMhc, const QString &address, const QString &t
 BEGIN_SLOT_WRAPPER
     runAndEmitCallback([&]{
         CHECK(!walletPath.isEmpty(), "Incorrect path to wallet: empty");
-        Wallet wallet(walletPath, isMhc, address.toStdString(), password.toStdString());
+        const std::shared_ptr<const Wallet> wallet = signSessions.getWallet(walletPath, isMhc, address.toStdString(), password.toStdString(), ::now());
         std::string pubKey;
-        const QString signature = QString::fromStdString(wallet.sign(text.toStdString(), pubKey));
+        const QString signature = QString::fromStdString(wallet->sign(text.toStdString(), pubKey));
         const QString publicKey = QString::fromStdString(pubKey);
         return std::make_tuple(signature, publicKey);
     }, callback);
@@ -299,7 +317,7 @@ BEGIN_SLOT_WRAPPER
             realFee = "0";
         }
 
-        Wallet wallet(walletPath, isMhc, address.toStdString(), password.toStdString());
+        const std::shared_ptr<const Wallet> wallet = signSessions.getWallet(walletPath, isMhc, address.toStdString(), password.toStdString(), ::now());
         std::string publicKey;
         std::string tx;
         std::string signature;
@@ -310,7 +328,7 @@ BEGIN_SLOT_WRAPPER
         CHECK(tmp, "Fee not valid");
         const uint64_t nonceInt = nonce.toULongLong(&tmp, 10);
         CHECK(tmp, "Nonce not valid");
-        wallet.sign(toAddress.toStdString(), valueInt, feeInt, nonceInt, dataHex.toStdString(), tx, signature, publicKey);
+        wallet->sign(toAddress.toStdString(), valueInt, feeInt, nonceInt, dataHex.toStdString(), tx, signature, publicKey);
         const QString publicKey2 = QString::fromStdString(publicKey);
         const QString tx2 = QString::fromStdString(tx);
         const QString signature2 = QString::fromStdString(signature);
@@ -322,6 +340,60 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void Wallets::onSignMessages2(bool isMhc, const QString &address, const QString &password, const std::vector<MhcTxToSign> &txs, const SignMessages2Callback &callback) {
+BEGIN_SLOT_WRAPPER
+    runAndEmitCallback([&]{
+        CHECK(!walletPath.isEmpty(), "Incorrect path to wallet: empty");
+
+        const std::shared_ptr<const Wallet> wallet = signSessions.getWallet(walletPath, isMhc, address.toStdString(), password.toStdString(), ::now());
+
+        std::vector<MhcSignedTx> result;
+        result.reserve(txs.size());
+        for (const MhcTxToSign &txToSign: txs) {
+            bool tmp;
+            const uint64_t valueInt = txToSign.value.toULongLong(&tmp, 10);
+            CHECK_TYPED(tmp, TypeErrors::INCORRECT_USER_DATA, "Value not valid");
+            const uint64_t feeInt = txToSign.fee.isEmpty() ? 0 : txToSign.fee.toULongLong(&tmp, 10);
+            CHECK_TYPED(tmp, TypeErrors::INCORRECT_USER_DATA, "Fee not valid");
+            const uint64_t nonceInt = txToSign.nonce.toULongLong(&tmp, 10);
+            CHECK_TYPED(tmp, TypeErrors::INCORRECT_USER_DATA, "Nonce not valid");
+
+            std::string publicKey;
+            std::string tx;
+            std::string signature;
+            wallet->sign(txToSign.toAddress.toStdString(), valueInt, feeInt, nonceInt, txToSign.dataHex.toStdString(), tx, signature, publicKey);
+
+            MhcSignedTx signedTx;
+            signedTx.nonce = nonceInt;
+            signedTx.signature = QString::fromStdString(signature);
+            signedTx.pubkey = QString::fromStdString(publicKey);
+            signedTx.tx = QString::fromStdString(tx);
+            signedTx.hash = QString::fromStdString(Wallet::calcHash(tx, signature, publicKey));
+            result.emplace_back(signedTx);
+        }
+
+        return result;
+    }, callback);
+END_SLOT_WRAPPER
+}
+
+void Wallets::onUnlockWallet(bool isMhc, const QString &address, const QString &password, const seconds &time, const UnlockWalletCallback &callback) {
+BEGIN_SLOT_WRAPPER
+    runAndEmitCallback([&]{
+        CHECK(!walletPath.isEmpty(), "Incorrect path to wallet: empty");
+        signSessions.unlock(walletPath, isMhc, address.toStdString(), password.toStdString(), time, ::now());
+    }, callback);
+END_SLOT_WRAPPER
+}
+
+void Wallets::onLockWallets(const LockWalletsCallback &callback) {
+BEGIN_SLOT_WRAPPER
+    runAndEmitCallback([&]{
+        signSessions.lockAll();
+    }, callback);
+END_SLOT_WRAPPER
+}
+
 void Wallets::findNonceAndProcessWithTxManager(const QString &address, const QString &nonce, const transactions::SendParameters &sendParams, const GettedNonceCallback &callback) {
     const bool isNonce = !nonce.isEmpty();
     if (!isNonce) {
@@ -344,17 +416,14 @@ BEGIN_SLOT_WRAPPER
         CHECK(!walletPath.isEmpty(), "Incorrect path to wallet: empty");
         const transactions::SendParameters sendParams = transactions::parseSendParams(paramsJson);
 
-        Wallet wallet(walletPath, isMhc, address.toStdString(), password.toStdString()); // Проверяем пароль кошелька
+        const std::shared_ptr<const Wallet> wallet = signSessions.getWallet(walletPath, isMhc, address.toStdString(), password.toStdString(), ::now()); // Проверяем пароль кошелька
 
         QString realFee = fee;
         if (realFee.isEmpty()) {
             realFee = "0";
         }
 
-        const QString walletPathCopy = walletPath;
-
-        const auto signTransaction = [this, walletPathCopy, isMhc, address, password, toAddress, value, realFee, dataHex, sendParams, callback](size_t nonce) {
-            Wallet wallet(walletPathCopy, isMhc, address.toStdString(), password.toStdString());
+        const auto signTransaction = [this, wallet, address, toAddress, value, realFee, dataHex, sendParams, callback](size_t nonce) {
             std::string publicKey;
             std::string tx;
             std::string signature;
@@ -363,7 +432,7 @@ BEGIN_SLOT_WRAPPER
             CHECK(tmp, "Value not valid");
             const uint64_t feeInt = realFee.toULongLong(&tmp, 10);
             CHECK(tmp, "Fee not valid");
-            wallet.sign(toAddress.toStdString(), valueInt, feeInt, nonce, dataHex.toStdString(), tx, signature, publicKey);
+            wallet->sign(toAddress.toStdString(), valueInt, feeInt, nonce, dataHex.toStdString(), tx, signature, publicKey);
 
             CHECK(txs != nullptr, "Transactions manager not setted");
             const QString txHash = QString::fromStdString(Wallet::calcHash(tx, signature, publicKey));
@@ -383,17 +452,14 @@ BEGIN_SLOT_WRAPPER
         CHECK(!walletPath.isEmpty(), "Incorrect path to wallet: empty");
         const transactions::SendParameters sendParams = transactions::parseSendParams(paramsJson);
 
-        Wallet wallet(walletPath, isMhc, address.toStdString(), password.toStdString()); // Проверяем пароль кошелька
+        const std::shared_ptr<const Wallet> wallet = signSessions.getWallet(walletPath, isMhc, address.toStdString(), password.toStdString(), ::now()); // Проверяем пароль кошелька
 
         QString realFee = fee;
         if (realFee.isEmpty()) {
             realFee = "0";
         }
 
-        const QString walletPathCopy = walletPath;
-
-        const auto signTransaction = [this, walletPathCopy, isMhc, address, password, toAddress, value, realFee, valueDelegate, isDelegate, sendParams, callback](size_t nonce) {
-            Wallet wallet(walletPathCopy, isMhc, address.toStdString(), password.toStdString());
+        const auto signTransaction = [this, wallet, address, toAddress, value, realFee, valueDelegate, isDelegate, sendParams, callback](size_t nonce) {
 
             bool isValid;
             const uint64_t delegValue = valueDelegate.toULongLong(&isValid);
@@ -408,7 +474,7 @@ BEGIN_SLOT_WRAPPER
             CHECK(tmp, "Value not valid");
             const uint64_t feeInt = realFee.toULongLong(&tmp, 10);
             CHECK(tmp, "Fee not valid");
-            wallet.sign(toAddress.toStdString(), valueInt, feeInt, nonce, dataHex, tx, signature, publicKey, false);
+            wallet->sign(toAddress.toStdString(), valueInt, feeInt, nonce, dataHex, tx, signature, publicKey, false);
 
             CHECK(txs != nullptr, "Transactions manager not setted");
             const QString txHash = QString::fromStdString(Wallet::calcHash(tx, signature, publicKey));
@@ -422,6 +488,76 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void Wallets::onSignAndSendMessages(bool isMhc, const QString &address, const QString &password, const QString &requestId, const std::vector<MhcTxToSign> &txsToSign, const QString &paramsJson, const SignAndSendMessagesCallback &callback) {
+BEGIN_SLOT_WRAPPER
+    runAndEmitErrorCallback([&]{
+        CHECK(!walletPath.isEmpty(), "Incorrect path to wallet: empty");
+        CHECK_TYPED(!txsToSign.empty(), TypeErrors::INCORRECT_USER_DATA, "Empty transactions list");
+        const transactions::SendParameters sendParams = transactions::parseSendParams(paramsJson);
+
+        const std::shared_ptr<const Wallet> wallet = signSessions.getWallet(walletPath, isMhc, address.toStdString(), password.toStdString(), ::now()); // Проверяем пароль кошелька
+
+        // Checked before the nonces are reserved
+        std::vector<std::pair<uint64_t, uint64_t>> valuesFees;
+        valuesFees.reserve(txsToSign.size());
+        for (const MhcTxToSign &txToSign: txsToSign) {
+            bool tmp;
+            const uint64_t valueInt = txToSign.value.toULongLong(&tmp, 10);
+            CHECK_TYPED(tmp, TypeErrors::INCORRECT_USER_DATA, "Value not valid");
+            const uint64_t feeInt = txToSign.fee.isEmpty() ? 0 : txToSign.fee.toULongLong(&tmp, 10);
+            CHECK_TYPED(tmp, TypeErrors::INCORRECT_USER_DATA, "Fee not valid");
+            Wallet::checkAddress(txToSign.toAddress.toStdString());
+            valuesFees.emplace_back(valueInt, feeInt);
+        }
+
+        const auto signTransactions = [this, wallet, address, requestId, txsToSign, valuesFees, sendParams, callback](size_t firstNonce, const QString &/*serverError*/) {
+            std::vector<transactions::BatchTransaction> batch;
+            std::vector<MhcSignedTx> result;
+            batch.reserve(txsToSign.size());
+            result.reserve(txsToSign.size());
+            for (size_t i = 0; i < txsToSign.size(); i++) {
+                const MhcTxToSign &txToSign = txsToSign[i];
+                const size_t nonce = firstNonce + i;
+
+                std::string publicKey;
+                std::string tx;
+                std::string signature;
+                // Address hash is checked as in onSignAndSendMessage. Only delegation in onSignAndSendMessageDelegate skips the check
+                wallet->sign(txToSign.toAddress.toStdString(), valuesFees[i].first, valuesFees[i].second, nonce, txToSign.dataHex.toStdString(), tx, signature, publicKey, true);
+
+                transactions::BatchTransaction batchTx;
+                batchTx.to = txToSign.toAddress;
+                batchTx.value = QString::number(valuesFees[i].first);
+                batchTx.nonce = nonce;
+                batchTx.data = txToSign.dataHex;
+                batchTx.fee = QString::number(valuesFees[i].second);
+                batchTx.pubkey = QString::fromStdString(publicKey);
+                batchTx.sign = QString::fromStdString(signature);
+                batch.emplace_back(batchTx);
+
+                MhcSignedTx signedTx;
+                signedTx.nonce = nonce;
+                signedTx.signature = batchTx.sign;
+                signedTx.pubkey = batchTx.pubkey;
+                signedTx.tx = QString::fromStdString(tx);
+                signedTx.hash = QString::fromStdString(Wallet::calcHash(tx, signature, publicKey));
+                result.emplace_back(signedTx);
+            }
+
+            LOG << "Batch signed " << requestId << " " << address << " " << firstNonce << " " << result.size();
+
+            CHECK(txs != nullptr, "Transactions manager not setted");
+            emit txs->sendTransactions(requestId, address, batch, sendParams, transactions::Transactions::SendTransactionsCallback([callback, result](){
+                callback.emitCallback(result);
+            }, callback, signalFunc));
+        };
+
+        CHECK(txs != nullptr, "Transactions manager not setted");
+        emit txs->reserveNonces(address, txsToSign.size(), sendParams, transactions::Transactions::ReserveNoncesCallback(signTransactions, callback, signalFunc));
+    }, callback);
+END_SLOT_WRAPPER
+}
+
 void Wallets::onGetOnePrivateKey(bool isMhc, const QString &address, bool isCompact, const GetPrivateKeyCallback &callback) {
 BEGIN_SLOT_WRAPPER
     runAndEmitCallback([&]{
@@ -570,7 +706,7 @@ BEGIN_SLOT_WRAPPER
 
         const QString fullPath = EthWallet::getFullPath(walletPath, address.toStdString());
 
-        walletsList[WalletCurrency::Eth][address] = WalletInfo(address, fullPath, WalletInfo::Type::Key);
+        walletsIndex.add(WalletCurrency::Eth, WalletInfo(address, fullPath, WalletInfo::Type::Key));
 
         return std::make_tuple(address, fullPath);
     }, callback);
@@ -676,7 +812,7 @@ BEGIN_SLOT_WRAPPER
 
         const QString fullPath = BtcWallet::getFullPath(walletPath, address);
 
-        walletsList[WalletCurrency::Btc][QString::fromStdString(address)] = WalletInfo(QString::fromStdString(address), fullPath, WalletInfo::Type::Key);
+        walletsIndex.add(WalletCurrency::Btc, WalletInfo(QString::fromStdString(address), fullPath, WalletInfo::Type::Key));
 
         return std::make_tuple(QString::fromStdString(address), fullPath);
     }, callback);
@@ -792,16 +928,7 @@ void Wallets::onGetListWallets(const WalletCurrency &type, const WalletsListCall
 BEGIN_SLOT_WRAPPER
     runAndEmitCallback([&]{
         CHECK(!walletPath.isEmpty(), "Wallet path not set");
-        const auto found = walletsList.find(type);
-        if (found == walletsList.end()) {
-            throwErr("Incorrect type or not found wallets");
-        }
-        std::vector<WalletInfo> result;
-        result.reserve(found->second.size());
-        std::transform(found->second.begin(), found->second.end(), std::back_inserter(result), [](const auto &pair) {
-            return pair.second;
-        });
-        return std::make_tuple(userName, result);
+        return std::make_tuple(userName, walletsIndex.getAll(type));
     }, callback);
 END_SLOT_WRAPPER
 }
@@ -822,6 +949,18 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void Wallets::onGetListWalletsPage(const WalletCurrency &type, const QString &afterAddress, size_t count, const WalletsListPageCallback &callback) {
+BEGIN_SLOT_WRAPPER
+    runAndEmitCallback([&]{
+        CHECK(!walletPath.isEmpty(), "Wallet path not set");
+        CHECK_TYPED(count > 0, TypeErrors::INCORRECT_USER_DATA, "Incorrect count");
+        QString nextAddress;
+        const std::vector<WalletInfo> result = walletsIndex.getPage(type, afterAddress, count, nextAddress);
+        return std::make_tuple(userName, result, walletsIndex.size(type), nextAddress);
+    }, callback);
+END_SLOT_WRAPPER
+}
+
 void Wallets::onGetWalletFolders(const GetWalletFoldersCallback &callback) {
 BEGIN_SLOT_WRAPPER
     runAndEmitCallback([&]{
@@ -890,34 +1029,31 @@ void Wallets::startMethod() {
 
 void Wallets::timerMethod() {
     eventWatcher.checkEvents();
+    signSessions.removeExpired(::now());
 }
 
 void Wallets::finishMethod() {
 
 }
 
-std::vector<WalletInfo> Wallets::readAllWallets(const WalletCurrency &type) {
+WalletsIndex::Changes Wallets::syncWallets(const WalletCurrency &type) {
     CHECK(!walletPath.isEmpty(), "Wallet path not set");
-    if (type == WalletCurrency::Tmh) {
-        return Wallet::getAllWalletsInfoInFolder(walletPath, false);
-    } else if (type == WalletCurrency::Mth) {
-        return Wallet::getAllWalletsInfoInFolder(walletPath, true);
-    } else if (type == WalletCurrency::Btc) {
-        const WalletsList res = BtcWallet::getAllWalletsInFolder(walletPath);
-        std::vector<WalletInfo> result;
-        result.reserve(res.size());
-        std::transform(res.begin(), res.end(), std::back_inserter(result), [](const auto &pair) {
-            return WalletInfo(pair.first, pair.second, WalletInfo::Type::Key);
+    const QString folder = walletPath;
+    if (type == WalletCurrency::Tmh || type == WalletCurrency::Mth) {
+        const bool isMhc = type == WalletCurrency::Mth;
+        return walletsIndex.sync(type, makePath(folder, Wallet::chooseSubfolder(isMhc)), [folder, isMhc](const QString &fileName, WalletInfo &info) {
+            return Wallet::parseWalletFileName(folder, isMhc, fileName, info);
         });
-        return result;
-    } else if (type == WalletCurrency::Eth) {
-        const WalletsList res = EthWallet::getAllWalletsInFolder(walletPath);
-        std::vector<WalletInfo> result;
-        result.reserve(res.size());
-        std::transform(res.begin(), res.end(), std::back_inserter(result), [](const auto &pair) {
-            return WalletInfo(pair.first, pair.second, WalletInfo::Type::Key);
+    } else if (type == WalletCurrency::Btc || type == WalletCurrency::Eth) {
+        const bool isBtc = type == WalletCurrency::Btc;
+        return walletsIndex.sync(type, makePath(folder, isBtc ? BtcWallet::subfolder() : EthWallet::subfolder()), [folder, isBtc](const QString &fileName, WalletInfo &info) {
+            std::pair<QString, QString> wallet;
+            const bool isWallet = isBtc ? BtcWallet::parseWalletFileName(folder, fileName, wallet) : EthWallet::parseWalletFileName(folder, fileName, wallet);
+            if (isWallet) {
+                info = WalletInfo(wallet.first, wallet.second, WalletInfo::Type::Key);
+            }
+            return isWallet;
         });
-        return result;
     } else {
         throwErr("Incorrect type");
     }
@@ -947,14 +1083,6 @@ int Wallets::importKeysImpl(const QString &path, const std::function<bool(const
     }
 }
 
-static std::map<QString, WalletInfo> walletsToMap(const std::vector<WalletInfo> &wallets) {
-    std::map<QString, WalletInfo> wallets2;
-    std::transform(wallets.begin(), wallets.end(), std::inserter(wallets2, wallets2.begin()), [](const WalletInfo &info) {
-        return std::make_pair(info.address, info);
-    });
-    return wallets2;
-}
-
 void Wallets::setPathsImpl(QString newPatch, QString newUserName) {
     userName = newUserName;
 
@@ -963,6 +1091,7 @@ void Wallets::setPathsImpl(QString newPatch, QString newUserName) {
     }
 
     walletPath = newPatch;
+    signSessions.lockAll();
     CHECK(!walletPath.isNull() && !walletPath.isEmpty(), "Incorrect path to wallet: empty");
     createFolder(walletPath);
 
@@ -977,11 +1106,11 @@ void Wallets::setPathsImpl(QString newPatch, QString newUserName) {
         folderWalletsInfos.emplace_back(curPath, name);
         fileSystemWatcher.addPath(curPath);
 
-        const std::vector<WalletInfo> wallets = readAllWallets(type);
-        walletsList[type] = walletsToMap(wallets);
+        syncWallets(type);
     };
 
-    walletsList.clear();
+    walletsIndex.clear();
+    changedDirs.clear();
 
     setPathToWallet(EthWallet::subfolder(), "eth", WalletCurrency::Eth);
     setPathToWallet(BtcWallet::subfolder(), "btc", WalletCurrency::Btc);
@@ -1006,57 +1135,60 @@ END_SLOT_WRAPPER
 
 void Wallets::onDirChanged(const QString &dir) {
 BEGIN_SLOT_WRAPPER
-    const QDir changedPath = dir;
-    WalletCurrency currency;
-    if (changedPath == QDir(makePath(walletPath, EthWallet::subfolder()))) {
-        currency = WalletCurrency::Eth;
-    } else if (changedPath == QDir(makePath(walletPath, BtcWallet::subfolder()))) {
-        currency = WalletCurrency::Btc;
-    } else if (changedPath == QDir(makePath(walletPath, Wallet::chooseSubfolder(true)))) {
-        currency = WalletCurrency::Mth;
-    } else if (changedPath == QDir(makePath(walletPath, Wallet::chooseSubfolder(false)))) {
-        currency = WalletCurrency::Tmh;
-    } else {
-        return;
+    const bool isFirst = changedDirs.empty();
+    changedDirs.insert(dir);
+    if (isFirst) {
+        QTimer::singleShot(DIR_CHANGED_DELAY.count(), this, [this]{
+            BEGIN_SLOT_WRAPPER
+            processChangedDirs();
+            END_SLOT_WRAPPER
+        });
     }
+END_SLOT_WRAPPER
+}
 
-    const std::vector<WalletInfo> currentWallets = readAllWallets(currency);
-    const std::map<QString, WalletInfo> currentWallets2 = walletsToMap(currentWallets);
+void Wallets::processChangedDirs() {
+    const std::set<QString> dirs = std::move(changedDirs);
+    changedDirs.clear();
+    for (const QString &dir: dirs) {
+        const QDir changedPath = dir;
+        WalletCurrency currency;
+        if (changedPath == QDir(makePath(walletPath, EthWallet::subfolder()))) {
+            currency = WalletCurrency::Eth;
+        } else if (changedPath == QDir(makePath(walletPath, BtcWallet::subfolder()))) {
+            currency = WalletCurrency::Btc;
+        } else if (changedPath == QDir(makePath(walletPath, Wallet::chooseSubfolder(true)))) {
+            currency = WalletCurrency::Mth;
+        } else if (changedPath == QDir(makePath(walletPath, Wallet::chooseSubfolder(false)))) {
+            currency = WalletCurrency::Tmh;
+        } else {
+            continue;
+        }
+
+        const WalletsIndex::Changes changes = syncWallets(currency);
 
-    const auto &walletsL = walletsList[currency];
-    for (const auto &pair: currentWallets2) {
-        if (walletsL.find(pair.first) == walletsL.end()) {
-            if (currency == WalletCurrency::Mth || currency == WalletCurrency::Tmh) {
-                const bool isMhc = currency == WalletCurrency::Mth;
-                if (pair.second.type == WalletInfo::Type::Watch) {
-                    emit mhcWatchWalletCreated(isMhc, pair.first, userName);
+        if (currency == WalletCurrency::Mth || currency == WalletCurrency::Tmh) {
+            const bool isMhc = currency == WalletCurrency::Mth;
+            for (const WalletInfo &info: changes.added) {
+                if (info.type == WalletInfo::Type::Watch) {
+                    emit mhcWatchWalletCreated(isMhc, info.address, userName);
                 } else {
-                    emit mhcWalletCreated(isMhc, pair.first, userName);
+                    emit mhcWalletCreated(isMhc, info.address, userName);
                 }
             }
-        }
-    }
-
-    for (const auto &pair: walletsL) {
-        if (currentWallets2.find(pair.first) == currentWallets2.end()) {
-            if (currency == WalletCurrency::Mth || currency == WalletCurrency::Tmh) {
-                const bool isMhc = currency == WalletCurrency::Mth;
-                if (pair.second.type == WalletInfo::Type::Watch) {
-                    emit mhcWatchWalletRemoved(isMhc, pair.first, userName);
+            for (const WalletInfo &info: changes.removed) {
+                if (info.type == WalletInfo::Type::Watch) {
+                    emit mhcWatchWalletRemoved(isMhc, info.address, userName);
                 }
             }
         }
-    }
-
-    walletsList[currency] = currentWallets2;
 
-    const QDir d(dir);
-    for (const FolderWalletInfo &folderInfo: folderWalletsInfos) {
-        if (folderInfo.walletPath == d) {
-            emit dirChanged(d.absolutePath(), folderInfo.nameWallet);
+        for (const FolderWalletInfo &folderInfo: folderWalletsInfos) {
+            if (folderInfo.walletPath == changedPath) {
+                emit dirChanged(changedPath.absolutePath(), folderInfo.nameWallet);
+            }
         }
     }
-END_SLOT_WRAPPER
 }
 
 } // namespace wallets
@@ -7,6 +7,8 @@
 #include "qt_utilites/ManagerWrapper.h"
 
 #include "WalletInfo.h"
+#include "WalletsIndex.h"
+#include "SignSessions.h"
 
 #include <QDir>
 #include <QFileSystemWatcher>
@@ -33,6 +35,22 @@ struct BtcInput;
 
 namespace wallets {
 
+struct MhcTxToSign {
+    QString toAddress;
+    QString value;
+    QString fee;
+    QString nonce;
+    QString dataHex;
+};
+
+struct MhcSignedTx {
+    size_t nonce = 0;
+    QString signature;
+    QString pubkey;
+    QString tx;
+    QString hash;
+};
+
 class Wallets: public ManagerWrapper, public TimerClass {
     Q_OBJECT
 public:
@@ -41,6 +59,8 @@ public:
 
     using WalletsListCallback = CallbackWrapper<void(const QString &userName, const std::vector<WalletInfo> &walletAddresses)>;
 
+    using WalletsListPageCallback = CallbackWrapper<void(const QString &userName, const std::vector<WalletInfo> &walletAddresses, size_t total, const QString &nextAddress)>;
+
     using CreateWatchsCallback = CallbackWrapper<void(const WalletsList &created)>;
 
     using CreateWalletCallback = CallbackWrapper<void(const QString &fullPath, const std::string &pubkey, const std::string &address, const std::string &exampleMessage, const std::string &sign)>;
@@ -63,10 +83,18 @@ public:
 
     using SignMessage2Callback = CallbackWrapper<void(const QString &signature, const QString &pubkey, const QString &tx, const QString &hash)>;
 
+    using SignMessages2Callback = CallbackWrapper<void(const std::vector<MhcSignedTx> &txs)>;
+
+    using UnlockWalletCallback = CallbackWrapper<void()>;
+
+    using LockWalletsCallback = CallbackWrapper<void()>;
+
     using GettedNonceCallback = CallbackWrapper<void(size_t nonce)>;
 
     using SignAndSendMessageCallback = CallbackWrapper<void(bool success, const QString &hash)>;
 
+    using SignAndSendMessagesCallback = CallbackWrapper<void(const std::vector<MhcSignedTx> &txs)>;
+
     using GetPrivateKeyCallback = CallbackWrapper<void(const QString &result)>;
 
     using SavePrivateKeyCallback = CallbackWrapper<void(bool success, const QString &address)>;
@@ -151,10 +179,19 @@ signals:
 
     void signMessage2(bool isMhc, const QString &address, const QString &password, const QString &toAddress, const QString &value, const QString &fee, const QString &nonce, const QString &dataHex, const SignMessage2Callback &callback);
 
+    void signMessages2(bool isMhc, const QString &address, const QString &password, const std::vector<MhcTxToSign> &txs, const SignMessages2Callback &callback);
+
+    void unlockWallet(bool isMhc, const QString &address, const QString &password, const seconds &time, const UnlockWalletCallback &callback);
+
+    void lockWallets(const LockWalletsCallback &callback);
+
     void signAndSendMessage(bool isMhc, const QString &address, const QString &password, const QString &toAddress, const QString &value, const QString &fee, const QString &nonce, const QString &dataHex, const QString &paramsJson, const SignAndSendMessageCallback &callback);
 
     void signAndSendMessageDelegate(bool isMhc, const QString &address, const QString &password, const QString &toAddress, const QString &value, const QString &fee, const QString &valueDelegate, const QString &nonce, bool isDelegate, const QString &paramsJson, const SignAndSendMessageCallback &callback);
 
+    // Nonces of txs are ignored, a range is reserved for the whole batch
+    void signAndSendMessages(bool isMhc, const QString &address, const QString &password, const QString &requestId, const std::vector<MhcTxToSign> &txs, const QString &paramsJson, const SignAndSendMessagesCallback &callback);
+
     void getOnePrivateKey(bool isMhc, const QString &address, bool isCompact, const GetPrivateKeyCallback &callback);
 
     void savePrivateKey(bool isMhc, const QString &privateKey, const QString &password, const SavePrivateKeyCallback &callback);
@@ -191,10 +228,18 @@ private slots:
 
     void onSignMessage2(bool isMhc, const QString &address, const QString &password, const QString &toAddress, const QString &value, const QString &fee, const QString &nonce, const QString &dataHex, const SignMessage2Callback &callback);
 
+    void onSignMessages2(bool isMhc, const QString &address, const QString &password, const std::vector<MhcTxToSign> &txs, const SignMessages2Callback &callback);
+
+    void onUnlockWallet(bool isMhc, const QString &address, const QString &password, const seconds &time, const UnlockWalletCallback &callback);
+
+    void onLockWallets(const LockWalletsCallback &callback);
+
     void onSignAndSendMessage(bool isMhc, const QString &address, const QString &password, const QString &toAddress, const QString &value, const QString &fee, const QString &nonce, const QString &dataHex, const QString &paramsJson, const SignAndSendMessageCallback &callback);
 
     void onSignAndSendMessageDelegate(bool isMhc, const QString &address, const QString &password, const QString &toAddress, const QString &value, const QString &fee, const QString &valueDelegate, const QString &nonce, bool isDelegate, const QString &paramsJson, const SignAndSendMessageCallback &callback);
 
+    void onSignAndSendMessages(bool isMhc, const QString &address, const QString &password, const QString &requestId, const std::vector<MhcTxToSign> &txs, const QString &paramsJson, const SignAndSendMessagesCallback &callback);
+
     void onGetOnePrivateKey(bool isMhc, const QString &address, bool isCompact, const GetPrivateKeyCallback &callback);
 
     void onSavePrivateKey(bool isMhc, const QString &privateKey, const QString &password, const SavePrivateKeyCallback &callback);
@@ -315,6 +360,8 @@ signals:
 
     void getListWallets2(const wallets::WalletCurrency &type, const QString &expectedUsername, const WalletsListCallback &callback);
 
+    void getListWalletsPage(const wallets::WalletCurrency &type, const QString &afterAddress, size_t count, const WalletsListPageCallback &callback);
+
     void getWalletFolders(const GetWalletFoldersCallback &callback);
 
     void backupKeys(const QString &caption, const BackupKeysCallback &callback);
@@ -329,6 +376,8 @@ private slots:
 
     void onGetListWallets2(const wallets::WalletCurrency &type, const QString &expectedUsername, const WalletsListCallback &callback);
 
+    void onGetListWalletsPage(const wallets::WalletCurrency &type, const QString &afterAddress, size_t count, const WalletsListPageCallback &callback);
+
     void onGetWalletFolders(const GetWalletFoldersCallback &callback);
 
     void onBackupKeys(const QString &caption, const BackupKeysCallback &callback);
@@ -371,7 +420,9 @@ private:
 
     void setPathsImpl(QString newPatch, QString newUserName);
 
-    std::vector<WalletInfo> readAllWallets(const WalletCurrency &type);
+    WalletsIndex::Changes syncWallets(const WalletCurrency &type);
+
+    void processChangedDirs();
 
     int importKeysImpl(const QString &path, const std::function<bool(const QString &filePath)> &checkFileName, const std::function<void(const QString &path)> &processFile);
 
@@ -397,7 +448,12 @@ private:
 
     transactions::Transactions *txs = nullptr;
 
-    std::map<WalletCurrency, std::map<QString, WalletInfo>> walletsList;
+    WalletsIndex walletsIndex;
+
+    // Directories changed since the last sync, the watcher fires once per file
+    std::set<QString> changedDirs;
+
+    SignSessions signSessions;
 
 };
 
@@ -0,0 +1,146 @@
+#include "WalletsIndex.h"
+
+#include <QDir>
+
+#include <set>
+
+#include "check.h"
+
+namespace wallets {
+
+void WalletsIndex::clear() {
+    folders.clear();
+}
+
+bool WalletsIndex::contains(const WalletCurrency &currency) const {
+    return folders.find(currency) != folders.end();
+}
+
+const WalletsIndex::Folder& WalletsIndex::getFolder(const WalletCurrency &currency) const {
+    const auto found = folders.find(currency);
+    CHECK(found != folders.end(), "Incorrect type or not found wallets");
+    return found->second;
+}
+
+WalletsIndex::Changes WalletsIndex::sync(const WalletCurrency &currency, const QString &folder, const ParseFileName &parse) {
+    Folder &f = folders[currency];
+    Changes changes;
+
+    const QDir dir(folder);
+    const QStringList names = dir.entryList(QDir::NoDotAndDotDot | QDir::System | QDir::Hidden  | QDir::AllDirs | QDir::Files, QDir::Name);
+    const std::set<QString> current(names.begin(), names.end());
+
+    // Files are dropped first, so a removed wallet is restored only from the files still present
+    std::vector<WalletInfo> removedFiles;
+    for (auto iter = f.files.begin(); iter != f.files.end();) {
+        if (current.find(iter->first) != current.end()) {
+            ++iter;
+            continue;
+        }
+        const WalletInfo &info = iter->second;
+        if (!info.address.isEmpty()) {
+            std::set<QString> &addressNames = f.addressFiles[info.address];
+            addressNames.erase(iter->first);
+            if (addressNames.empty()) {
+                f.addressFiles.erase(info.address);
+            }
+            removedFiles.emplace_back(info);
+        }
+        iter = f.files.erase(iter);
+    }
+
+    for (const WalletInfo &info: removedFiles) {
+        const auto found = f.wallets.find(info.address);
+        if (found != f.wallets.end() && found->second.type == info.type) {
+            changes.removed.emplace_back(found->second);
+            f.wallets.erase(found);
+            WalletInfo restored;
+            if (restoreWallet(f, info.address, nullptr, restored)) {
+                changes.added.emplace_back(restored);
+            }
+        }
+    }
+
+    for (const QString &name: current) {
+        if (f.files.find(name) != f.files.end()) {
+            continue;
+        }
+        WalletInfo info;
+        if (!parse(name, info)) {
+            info = WalletInfo();
+        }
+        f.files.emplace(name, info);
+        if (info.address.isEmpty()) {
+            continue;
+        }
+        f.addressFiles[info.address].insert(name);
+        if (f.wallets.find(info.address) == f.wallets.end()) {
+            f.wallets.emplace(info.address, info);
+            changes.added.emplace_back(info);
+        }
+    }
+
+    return changes;
+}
+
+void WalletsIndex::add(const WalletCurrency &currency, const WalletInfo &info) {
+    folders[currency].wallets[info.address] = info;
+}
+
+void WalletsIndex::remove(const WalletCurrency &currency, const QString &address, const WalletInfo::Type &type) {
+    Folder &f = folders[currency];
+    const auto found = f.wallets.find(address);
+    if (found == f.wallets.end() || found->second.type != type) {
+        return;
+    }
+    f.wallets.erase(found);
+    // The removed file is still listed until the next sync
+    WalletInfo restored;
+    restoreWallet(f, address, &type, restored);
+}
+
+bool WalletsIndex::restoreWallet(Folder &f, const QString &address, const WalletInfo::Type *skipType, WalletInfo &restored) {
+    const auto found = f.addressFiles.find(address);
+    if (found == f.addressFiles.end()) {
+        return false;
+    }
+    for (const QString &name: found->second) {
+        const WalletInfo &info = f.files.at(name);
+        if (skipType == nullptr || info.type != *skipType) {
+            restored = info;
+            f.wallets.emplace(address, info);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<WalletInfo> WalletsIndex::getAll(const WalletCurrency &currency) const {
+    const Folder &f = getFolder(currency);
+    std::vector<WalletInfo> result;
+    result.reserve(f.wallets.size());
+    for (const auto &pair: f.wallets) {
+        result.emplace_back(pair.second);
+    }
+    return result;
+}
+
+std::vector<WalletInfo> WalletsIndex::getPage(const WalletCurrency &currency, const QString &afterAddress, size_t count, QString &nextAddress) const {
+    const Folder &f = getFolder(currency);
+    auto iter = afterAddress.isEmpty() ? f.wallets.begin() : f.wallets.upper_bound(afterAddress);
+    nextAddress.clear();
+    std::vector<WalletInfo> result;
+    for (; iter != f.wallets.end() && result.size() < count; ++iter) {
+        result.emplace_back(iter->second);
+    }
+    if (iter != f.wallets.end() && !result.empty()) {
+        nextAddress = result.back().address;
+    }
+    return result;
+}
+
+size_t WalletsIndex::size(const WalletCurrency &currency) const {
+    return getFolder(currency).wallets.size();
+}
+
+} // namespace wallets
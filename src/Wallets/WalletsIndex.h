@@ -0,0 +1,77 @@
+#ifndef WALLETSINDEX_H
+#define WALLETSINDEX_H
+
+#include <QString>
+
+#include <map>
+#include <set>
+#include <vector>
+#include <functional>
+
+#include "WalletInfo.h"
+
+namespace wallets {
+
+// Wallets of the current folders by currency and address.
+// A folder is parsed once, later syncs list only the file names and parse the new ones
+class WalletsIndex {
+public:
+
+    // Returns false if the file is not a wallet
+    using ParseFileName = std::function<bool(const QString &fileName, WalletInfo &info)>;
+
+    struct Changes {
+        std::vector<WalletInfo> added;
+        std::vector<WalletInfo> removed;
+    };
+
+public:
+
+    void clear();
+
+    bool contains(const WalletCurrency &currency) const;
+
+    Changes sync(const WalletCurrency &currency, const QString &folder, const ParseFileName &parse);
+
+    // For the wallets created or removed by ourselves, the next sync does not report them
+    void add(const WalletCurrency &currency, const WalletInfo &info);
+
+    // Another file of the same address takes place of the removed wallet
+    void remove(const WalletCurrency &currency, const QString &address, const WalletInfo::Type &type);
+
+    std::vector<WalletInfo> getAll(const WalletCurrency &currency) const;
+
+    // At most count wallets ordered by address, starting after afterAddress (from the beginning if empty).
+    // nextAddress is the afterAddress of the next page, empty on the last page
+    std::vector<WalletInfo> getPage(const WalletCurrency &currency, const QString &afterAddress, size_t count, QString &nextAddress) const;
+
+    size_t size(const WalletCurrency &currency) const;
+
+private:
+
+    struct Folder {
+        // Every name of the folder with its parsed wallet. Empty address if the file is not a wallet
+        std::map<QString, WalletInfo> files;
+
+        // Key and watch files may have the same address
+        std::map<QString, std::set<QString>> addressFiles;
+
+        std::map<QString, WalletInfo> wallets;
+    };
+
+private:
+
+    const Folder& getFolder(const WalletCurrency &currency) const;
+
+    // Returns false if the address has no files except of the type skipType
+    static bool restoreWallet(Folder &f, const QString &address, const WalletInfo::Type *skipType, WalletInfo &restored);
+
+private:
+
+    std::map<WalletCurrency, Folder> folders;
+
+};
+
+} // namespace wallets
+
+#endif // WALLETSINDEX_H
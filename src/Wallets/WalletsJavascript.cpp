@@ -36,6 +36,71 @@ static QJsonDocument makeWalletsList(const std::vector<QString> &wallets) {
     return json;
 }
 
+static WalletCurrency parseCurrency(const QString &currency) {
+    if (currency == "mhc") {
+        return WalletCurrency::Mth;
+    } else if (currency == "tmh") {
+        return WalletCurrency::Tmh;
+    } else if (currency == "btc") {
+        return WalletCurrency::Btc;
+    } else if (currency == "eth") {
+        return WalletCurrency::Eth;
+    } else {
+        throwErrTyped(TypeErrors::INCORRECT_USER_DATA, "Incorrect currency: " + currency.toStdString());
+    }
+}
+
+static QJsonDocument walletsInfoToJson(const std::vector<WalletInfo> &wallets) {
+    QJsonArray jsonArray;
+    for (const WalletInfo &info: wallets) {
+        QJsonObject val;
+        val.insert("address", info.address);
+        val.insert("type", info.type == WalletInfo::Type::Key ? 1 : 2);
+        val.insert("path", info.path);
+        jsonArray.push_back(val);
+    }
+    return QJsonDocument(jsonArray);
+}
+
+static std::vector<MhcTxToSign> parseTxsToSign(const QString &jsonTxs, bool isNonce) {
+    const QJsonDocument document = QJsonDocument::fromJson(jsonTxs.toUtf8());
+    CHECK_TYPED(document.isArray(), TypeErrors::INCORRECT_USER_DATA, "jsonTxs not array");
+    const QJsonArray root = document.array();
+    std::vector<MhcTxToSign> txs;
+    txs.reserve(root.size());
+    for (const auto &jsonObj2: root) {
+        CHECK_TYPED(jsonObj2.isObject(), TypeErrors::INCORRECT_USER_DATA, "tx not object");
+        const QJsonObject jsonObj = jsonObj2.toObject();
+        MhcTxToSign tx;
+        CHECK_TYPED(jsonObj.contains("to") && jsonObj.value("to").isString(), TypeErrors::INCORRECT_USER_DATA, "to field not found");
+        tx.toAddress = jsonObj.value("to").toString();
+        CHECK_TYPED(jsonObj.contains("value") && jsonObj.value("value").isString(), TypeErrors::INCORRECT_USER_DATA, "value field not found");
+        tx.value = jsonObj.value("value").toString();
+        tx.fee = jsonObj.value("fee").toString();
+        if (isNonce) {
+            CHECK_TYPED(jsonObj.contains("nonce") && jsonObj.value("nonce").isString(), TypeErrors::INCORRECT_USER_DATA, "nonce field not found");
+            tx.nonce = jsonObj.value("nonce").toString();
+        }
+        tx.dataHex = jsonObj.value("data").toString();
+        txs.emplace_back(tx);
+    }
+    return txs;
+}
+
+static QJsonDocument signedTxsToJson(const std::vector<MhcSignedTx> &txs) {
+    QJsonArray jsonArray;
+    for (const MhcSignedTx &tx: txs) {
+        QJsonObject txJson;
+        txJson.insert("nonce", QString::number(tx.nonce));
+        txJson.insert("signature", tx.signature);
+        txJson.insert("pubkey", tx.pubkey);
+        txJson.insert("tx", tx.tx);
+        txJson.insert("hash", tx.hash);
+        jsonArray.push_back(txJson);
+    }
+    return QJsonDocument(jsonArray);
+}
+
 WalletsJavascript::WalletsJavascript(Wallets &wallets)
     : WrapperJavascript(false, LOG_FILE)
     , wallets(wallets)
@@ -200,6 +265,52 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void WalletsJavascript::signMessages2(bool isMhc, const QString &address, const QString &password, const QString &jsonTxs, const QString &callback) {
+BEGIN_SLOT_WRAPPER
+    LOG << "Sign messages2 " << isMhc << " " << address;
+
+    const auto makeFunc = makeJavascriptReturnAndErrorFuncs(callback, JsTypeReturn<QJsonDocument>(QJsonDocument()));
+
+    wrapOperation([&, this](){
+        const std::vector<MhcTxToSign> txs = parseTxsToSign(jsonTxs, true);
+
+        emit wallets.signMessages2(isMhc, address, password, txs, wallets::Wallets::SignMessages2Callback([makeFunc, isMhc, address](const std::vector<MhcSignedTx> &txs){
+            LOG << "Sign messages2 ok " << isMhc << " " << address << " " << txs.size();
+            makeFunc.func(TypedException(), signedTxsToJson(txs));
+        }, makeFunc.error, signalFunc));
+    }, makeFunc.error);
+END_SLOT_WRAPPER
+}
+
+void WalletsJavascript::unlockWallet(bool isMhc, const QString &address, const QString &password, int timeSeconds, const QString &callback) {
+BEGIN_SLOT_WRAPPER
+    LOG << "Unlock wallet " << isMhc << " " << address << " " << timeSeconds;
+
+    const auto makeFunc = makeJavascriptReturnAndErrorFuncs(callback, JsTypeReturn<bool>(false));
+
+    wrapOperation([&, this](){
+        emit wallets.unlockWallet(isMhc, address, password, seconds(timeSeconds), wallets::Wallets::UnlockWalletCallback([makeFunc, isMhc, address](){
+            LOG << "Unlock wallet ok " << isMhc << " " << address;
+            makeFunc.func(TypedException(), true);
+        }, makeFunc.error, signalFunc));
+    }, makeFunc.error);
+END_SLOT_WRAPPER
+}
+
+void WalletsJavascript::lockWallets(const QString &callback) {
+BEGIN_SLOT_WRAPPER
+    LOG << "Lock wallets";
+
+    const auto makeFunc = makeJavascriptReturnAndErrorFuncs(callback, JsTypeReturn<bool>(false));
+
+    wrapOperation([&, this](){
+        emit wallets.lockWallets(wallets::Wallets::LockWalletsCallback([makeFunc](){
+            makeFunc.func(TypedException(), true);
+        }, makeFunc.error, signalFunc));
+    }, makeFunc.error);
+END_SLOT_WRAPPER
+}
+
 void WalletsJavascript::signAndSendMessage(bool isMhc, const QString &address, const QString &password, const QString &toAddress, const QString &value, const QString &fee, const QString &nonce, const QString &dataHex, const QString &paramsJson, const QString &callback) {
 BEGIN_SLOT_WRAPPER
     LOG << "Sign message3 " << isMhc << " " << address << " " << toAddress << " " << value << " " << fee << " " << nonce << " " << dataHex << " " << paramsJson;
@@ -238,6 +349,23 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void WalletsJavascript::signAndSendMessages(bool isMhc, const QString &address, const QString &password, const QString &requestId, const QString &jsonTxs, const QString &paramsJson, const QString &callback) {
+BEGIN_SLOT_WRAPPER
+    LOG << "Sign messages batch " << isMhc << " " << address << " " << requestId << " " << paramsJson;
+
+    const auto makeFunc = makeJavascriptReturnAndErrorFuncs(callback, JsTypeReturn<QJsonDocument>(QJsonDocument()));
+
+    wrapOperation([&, this](){
+        const std::vector<MhcTxToSign> txs = parseTxsToSign(jsonTxs, false);
+
+        emit wallets.signAndSendMessages(isMhc, address, password, requestId, txs, paramsJson, wallets::Wallets::SignAndSendMessagesCallback([makeFunc, isMhc, address, requestId](const std::vector<MhcSignedTx> &txs){
+            LOG << "Sign messages batch ok " << isMhc << " " << address << " " << requestId << " " << txs.size();
+            makeFunc.func(TypedException(), signedTxsToJson(txs));
+        }, makeFunc.error, signalFunc));
+    }, makeFunc.error);
+END_SLOT_WRAPPER
+}
+
 void WalletsJavascript::getOnePrivateKey(bool isMhc, const QString &address, bool isCompact, const QString &callback) {
 BEGIN_SLOT_WRAPPER
     LOG << "Get private key " << isMhc << " " << address << " " << isCompact;
@@ -664,6 +792,22 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void WalletsJavascript::getListWallets(const QString &currency, const QString &afterAddress, int count, const QString &callback) {
+BEGIN_SLOT_WRAPPER
+    const auto makeFunc = makeJavascriptReturnAndErrorFuncs(callback, JsTypeReturn<QJsonDocument>(QJsonDocument()), JsTypeReturn<size_t>(0), JsTypeReturn<QString>(""));
+
+    LOG << "Get list wallets " << currency << " " << afterAddress << " " << count;
+
+    wrapOperation([&, this](){
+        CHECK_TYPED(count > 0, TypeErrors::INCORRECT_USER_DATA, "Incorrect count");
+        emit wallets.getListWalletsPage(parseCurrency(currency), afterAddress, count, wallets::Wallets::WalletsListPageCallback([makeFunc, currency](const QString &/*userName*/, const std::vector<WalletInfo> &walletAddresses, size_t total, const QString &nextAddress){
+            LOG << "Get list wallets ok " << currency << " " << walletAddresses.size() << " " << total;
+            makeFunc.func(TypedException(), walletsInfoToJson(walletAddresses), total, nextAddress);
+        }, makeFunc.error, signalFunc));
+    }, makeFunc.error);
+END_SLOT_WRAPPER
+}
+
 void WalletsJavascript::backupKeys(const QString &caption, const QString &callback) {
 BEGIN_SLOT_WRAPPER
     const auto makeFunc = makeJavascriptReturnAndErrorFuncs(callback, JsTypeReturn<QString>(""));
@@ -39,10 +39,18 @@ public:
 
     Q_INVOKABLE void signMessage2(bool isMhc, const QString &address, const QString &password, const QString &toAddress, const QString &value, const QString &fee, const QString &nonce, const QString &dataHex, const QString &callback);
 
+    Q_INVOKABLE void signMessages2(bool isMhc, const QString &address, const QString &password, const QString &jsonTxs, const QString &callback);
+
+    Q_INVOKABLE void unlockWallet(bool isMhc, const QString &address, const QString &password, int timeSeconds, const QString &callback);
+
+    Q_INVOKABLE void lockWallets(const QString &callback);
+
     Q_INVOKABLE void signAndSendMessage(bool isMhc, const QString &address, const QString &password, const QString &toAddress, const QString &value, const QString &fee, const QString &nonce, const QString &dataHex, const QString &paramsJson, const QString &callback);
 
     Q_INVOKABLE void signAndSendMessageDelegate(bool isMhc, const QString &address, const QString &password, const QString &toAddress, const QString &value, const QString &fee, const QString &valueDelegate, const QString &nonce, bool isDelegate, const QString &paramsJson, const QString &callback);
 
+    Q_INVOKABLE void signAndSendMessages(bool isMhc, const QString &address, const QString &password, const QString &requestId, const QString &jsonTxs, const QString &paramsJson, const QString &callback);
+
     Q_INVOKABLE void getOnePrivateKey(bool isMhc, const QString &address, bool isCompact, const QString &callback);
 
     Q_INVOKABLE void savePrivateKey(bool isMhc, const QString &privateKey, const QString &password, const QString &callback);
@@ -121,6 +129,8 @@ public:
 
     Q_INVOKABLE void getWalletFolders(const QString &callback);
 
+    Q_INVOKABLE void getListWallets(const QString &currency, const QString &afterAddress, int count, const QString &callback);
+
     Q_INVOKABLE void backupKeys(const QString &caption, const QString &callback);
 
     Q_INVOKABLE void restoreKeys(const QString &caption, const QString &callback);
@@ -46,7 +46,6 @@ static void blkxor(void *, void *, size_t);
 static void salsa20_8(uint32_t[16]);
 static void blockmix_salsa8(uint32_t *, uint32_t *, uint32_t *, size_t);
 static uint64_t integerify(void *, size_t);
-static void smix(uint8_t *, size_t, uint64_t, uint32_t *, uint32_t *);
 
 static void
 blkcpy(void * dest, void * src, size_t len)
@@ -162,16 +161,18 @@ integerify(void * B, size_t r)
 }
 
 /**
- * smix(B, r, N, V, XY):
+ * libscrypt_smix_nosse(B, r, N, V, XY):
  * Compute B = SMix_r(B, N).  The input B must be 128r bytes in length;
  * the temporary storage V must be 128rN bytes in length; the temporary
  * storage XY must be 256r + 64 bytes in length.  The value N must be a
  * power of 2 greater than 1.  The arrays B, V, and XY must be aligned to a
  * multiple of 64 bytes.
  */
-static void
-smix(uint8_t * B, size_t r, uint64_t N, uint32_t * V, uint32_t * XY)
+void
+libscrypt_smix_nosse(uint8_t * B, size_t r, uint64_t N, void * V0, void * XY0)
 {
+	uint32_t * V = (uint32_t *)V0;
+	uint32_t * XY = (uint32_t *)XY0;
 	uint32_t * X = XY;
 	uint32_t * Y = &XY[32 * r];
 	uint32_t * Z = &XY[64 * r];
@@ -221,16 +222,19 @@ smix(uint8_t * B, size_t r, uint64_t N, uint32_t * V, uint32_t * XY)
 }
 
 /**
- * crypto_scrypt(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen):
+ * libscrypt_scrypt_smix(smix, passwd, passwdlen, salt, saltlen, N, r, p,
+ *     buf, buflen):
  * Compute scrypt(passwd[0 .. passwdlen - 1], salt[0 .. saltlen - 1], N, r,
- * p, buflen) and write the result into buf.  The parameters r, p, and buflen
- * must satisfy r * p < 2^30 and buflen <= (2^32 - 1) * 32.  The parameter N
- * must be a power of 2 greater than 1.
+ * p, buflen) with the given SMix kernel and write the result into buf.  The
+ * parameters r, p, and buflen must satisfy r * p < 2^30 and
+ * buflen <= (2^32 - 1) * 32.  The parameter N must be a power of 2 greater
+ * than 1.
  *
  * Return 0 on success; or -1 on error
  */
 int
-libscrypt_scrypt(const uint8_t * passwd, size_t passwdlen,
+libscrypt_scrypt_smix(libscrypt_smix_t smix,
+    const uint8_t * passwd, size_t passwdlen,
     const uint8_t * salt, size_t saltlen, uint64_t N, uint32_t r, uint32_t p,
     uint8_t * buf, size_t buflen)
 {
@@ -339,3 +343,17 @@ err0:
 	/* Failure! */
 	return (-1);
 }
+
+/**
+ * crypto_scrypt(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen):
+ * Same as libscrypt_scrypt_smix with the fastest kernel supported by the
+ * cpu.
+ */
+int
+libscrypt_scrypt(const uint8_t * passwd, size_t passwdlen,
+    const uint8_t * salt, size_t saltlen, uint64_t N, uint32_t r, uint32_t p,
+    uint8_t * buf, size_t buflen)
+{
+	return (libscrypt_scrypt_smix(libscrypt_smix_select(), passwd, passwdlen,
+	    salt, saltlen, N, r, p, buf, buflen));
+}
@@ -0,0 +1,303 @@
+/*-
+ * Copyright 2009 Colin Percival
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file was originally written by Colin Percival as part of the Tarsnap
+ * online backup system.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "sysendian.h"
+
+#include "libscrypt.h"
+
+#ifdef LIBSCRYPT_HAVE_SSE
+
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SCRYPT_INLINE static __forceinline
+#else
+#define SCRYPT_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Inside the kernels every 64-byte block is kept in the diagonal order of
+ * the salsa20 core: position i holds the word i * 5 % 16.  The rows of the
+ * core then map onto four 128-bit registers and the whole core needs only
+ * three shuffles per round.
+ */
+
+/**
+ * salsa20_8(X0, X1, X2, X3):
+ * Apply the salsa20/8 core to the block held in four registers.
+ */
+SCRYPT_INLINE void
+salsa20_8(__m128i & X0, __m128i & X1, __m128i & X2, __m128i & X3)
+{
+	const __m128i B0 = X0, B1 = X1, B2 = X2, B3 = X3;
+	__m128i T;
+	size_t i;
+
+	for (i = 0; i < 8; i += 2) {
+#define R(x, t, b) \
+	(x) = _mm_xor_si128((x), _mm_slli_epi32((t), (b))); \
+	(x) = _mm_xor_si128((x), _mm_srli_epi32((t), 32 - (b)))
+		/* Operate on "columns". */
+		T = _mm_add_epi32(X0, X3);
+		R(X1, T, 7);
+		T = _mm_add_epi32(X1, X0);
+		R(X2, T, 9);
+		T = _mm_add_epi32(X2, X1);
+		R(X3, T, 13);
+		T = _mm_add_epi32(X3, X2);
+		R(X0, T, 18);
+
+		/* Rearrange data. */
+		X1 = _mm_shuffle_epi32(X1, 0x93);
+		X2 = _mm_shuffle_epi32(X2, 0x4E);
+		X3 = _mm_shuffle_epi32(X3, 0x39);
+
+		/* Operate on "rows". */
+		T = _mm_add_epi32(X0, X1);
+		R(X3, T, 7);
+		T = _mm_add_epi32(X3, X0);
+		R(X2, T, 9);
+		T = _mm_add_epi32(X2, X3);
+		R(X1, T, 13);
+		T = _mm_add_epi32(X1, X2);
+		R(X0, T, 18);
+
+		/* Rearrange data. */
+		X1 = _mm_shuffle_epi32(X1, 0x39);
+		X2 = _mm_shuffle_epi32(X2, 0x4E);
+		X3 = _mm_shuffle_epi32(X3, 0x93);
+#undef R
+	}
+
+	X0 = _mm_add_epi32(X0, B0);
+	X1 = _mm_add_epi32(X1, B1);
+	X2 = _mm_add_epi32(X2, B2);
+	X3 = _mm_add_epi32(X3, B3);
+}
+
+/**
+ * blockmix_salsa8(Bin, Bin2, Bout, r):
+ * Compute Bout = BlockMix_{salsa20/8, r}(Bin \xor Bin2), or
+ * BlockMix_{salsa20/8, r}(Bin) if Bin2 is NULL.  Both inputs and the output
+ * are 128r bytes in length.  X stays in registers for the whole pass.
+ */
+SCRYPT_INLINE void
+blockmix_salsa8(const __m128i * Bin, const __m128i * Bin2, __m128i * Bout,
+    size_t r)
+{
+	__m128i X0, X1, X2, X3;
+	size_t i;
+
+#define XOR_IN(k) do { \
+	X0 = _mm_xor_si128(X0, Bin[(k) + 0]); \
+	X1 = _mm_xor_si128(X1, Bin[(k) + 1]); \
+	X2 = _mm_xor_si128(X2, Bin[(k) + 2]); \
+	X3 = _mm_xor_si128(X3, Bin[(k) + 3]); \
+	if (Bin2 != NULL) { \
+		X0 = _mm_xor_si128(X0, Bin2[(k) + 0]); \
+		X1 = _mm_xor_si128(X1, Bin2[(k) + 1]); \
+		X2 = _mm_xor_si128(X2, Bin2[(k) + 2]); \
+		X3 = _mm_xor_si128(X3, Bin2[(k) + 3]); \
+	} \
+} while (0)
+#define STORE_OUT(k) do { \
+	Bout[(k) + 0] = X0; \
+	Bout[(k) + 1] = X1; \
+	Bout[(k) + 2] = X2; \
+	Bout[(k) + 3] = X3; \
+} while (0)
+
+	/* 1: X <-- B_{2r - 1} */
+	X0 = X1 = X2 = X3 = _mm_setzero_si128();
+	XOR_IN(8 * r - 4);
+
+	/* 2: for i = 0 to 2r - 1 do */
+	for (i = 0; i < r; i++) {
+		/* 3: X <-- H(X \xor B_i) */
+		XOR_IN(i * 8);
+		salsa20_8(X0, X1, X2, X3);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		STORE_OUT(i * 4);
+
+		/* 3: X <-- H(X \xor B_i) */
+		XOR_IN(i * 8 + 4);
+		salsa20_8(X0, X1, X2, X3);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		STORE_OUT((r + i) * 4);
+	}
+#undef XOR_IN
+#undef STORE_OUT
+}
+
+/**
+ * integerify(B, r):
+ * Return the result of parsing B_{2r-1} as a little-endian integer.  In the
+ * diagonal order the words 0 and 1 of the block are at positions 0 and 13.
+ */
+SCRYPT_INLINE uint64_t
+integerify(const __m128i * B, size_t r)
+{
+	const uint32_t * X = (const uint32_t *)(&B[(2 * r - 1) * 4]);
+	return (((uint64_t)(X[13]) << 32) + X[0]);
+}
+
+/**
+ * smix(B, r, N, V, XY):
+ * Compute B = SMix_r(B, N), see libscrypt_smix_nosse for the requirements.
+ */
+SCRYPT_INLINE void
+smix(uint8_t * B, size_t r, uint64_t N, void * V0, void * XY)
+{
+	__m128i * X = (__m128i *)XY;
+	__m128i * Y = &X[8 * r];
+	__m128i * V = (__m128i *)V0;
+	uint32_t * X32 = (uint32_t *)X;
+	uint64_t i, j;
+	size_t k, l;
+
+	/* 1: X <-- B */
+	for (k = 0; k < 2 * r; k++) {
+		for (l = 0; l < 16; l++) {
+			X32[k * 16 + l] =
+			    le32dec(&B[(k * 16 + (l * 5 % 16)) * 4]);
+		}
+	}
+
+	/* 2: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* 3: V_i <-- X */
+		memcpy(&V[i * (8 * r)], X, 128 * r);
+
+		/* 4: X <-- H(X) */
+		blockmix_salsa8(X, NULL, Y, r);
+
+		/* 3: V_i <-- X */
+		memcpy(&V[(i + 1) * (8 * r)], Y, 128 * r);
+
+		/* 4: X <-- H(X) */
+		blockmix_salsa8(Y, NULL, X, r);
+	}
+
+	/* 6: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* 7: j <-- Integerify(X) mod N */
+		j = integerify(X, r) & (N - 1);
+
+		/* 8: X <-- H(X \xor V_j) */
+		blockmix_salsa8(X, &V[j * (8 * r)], Y, r);
+
+		/* 7: j <-- Integerify(X) mod N */
+		j = integerify(Y, r) & (N - 1);
+
+		/* 8: X <-- H(X \xor V_j) */
+		blockmix_salsa8(Y, &V[j * (8 * r)], X, r);
+	}
+
+	/* 10: B' <-- X */
+	for (k = 0; k < 2 * r; k++) {
+		for (l = 0; l < 16; l++) {
+			le32enc(&B[(k * 16 + (l * 5 % 16)) * 4],
+			    X32[k * 16 + l]);
+		}
+	}
+}
+
+void
+libscrypt_smix_sse2(uint8_t * B, size_t r, uint64_t N, void * V, void * XY)
+{
+	smix(B, r, N, V, XY);
+}
+
+int
+libscrypt_cpu_has_sse2(void)
+{
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+	return (1);
+#elif defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return ((info[3] >> 26) & 1);
+#else
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("sse2") != 0);
+#endif
+}
+
+static libscrypt_smix_t
+detect_smix(void)
+{
+	if (libscrypt_cpu_has_sse2())
+		return (libscrypt_smix_sse2);
+	return (libscrypt_smix_nosse);
+}
+
+#else /* !LIBSCRYPT_HAVE_SSE */
+
+int
+libscrypt_cpu_has_sse2(void)
+{
+	return (0);
+}
+
+static libscrypt_smix_t
+detect_smix(void)
+{
+	return (libscrypt_smix_nosse);
+}
+
+#endif /* LIBSCRYPT_HAVE_SSE */
+
+libscrypt_smix_t
+libscrypt_smix_select(void)
+{
+	/* Function-local static: initialized once even with concurrent callers */
+	static const libscrypt_smix_t smix = detect_smix();
+	return (smix);
+}
+
+const char *
+libscrypt_smix_name(libscrypt_smix_t smix)
+{
+#ifdef LIBSCRYPT_HAVE_SSE
+	if (smix == libscrypt_smix_sse2)
+		return ("sse2");
+#endif
+	if (smix == libscrypt_smix_nosse)
+		return ("nosse");
+	return ("unknown");
+}
@@ -29,6 +29,35 @@ extern "C"{
 int libscrypt_scrypt(const uint8_t *, size_t, const uint8_t *, size_t, uint64_t,
     uint32_t, uint32_t, /*@out@*/ uint8_t *, size_t);
 
+/**
+ * SMix kernel: B <-- SMix_r(B, N).  B is 128r bytes, V is 128rN bytes, XY is
+ * 256r + 64 bytes, all of them aligned to 64 bytes.
+ */
+typedef void (*libscrypt_smix_t)(uint8_t *, size_t, uint64_t, void *, void *);
+
+/* Portable scalar kernel, works everywhere */
+void libscrypt_smix_nosse(uint8_t *, size_t, uint64_t, void *, void *);
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIBSCRYPT_HAVE_SSE 1
+/* x86 kernels. Call them only if libscrypt_cpu_has_* returns nonzero */
+void libscrypt_smix_sse2(uint8_t *, size_t, uint64_t, void *, void *);
+#endif
+
+int libscrypt_cpu_has_sse2(void);
+
+/* Fastest kernel supported by the cpu. Detected once, thread safe */
+libscrypt_smix_t libscrypt_smix_select(void);
+
+/* "sse2" or "nosse" */
+const char *libscrypt_smix_name(libscrypt_smix_t);
+
+/* libscrypt_scrypt with the given kernel */
+int libscrypt_scrypt_smix(libscrypt_smix_t, const uint8_t *, size_t,
+    const uint8_t *, size_t, uint64_t, uint32_t, uint32_t,
+    /*@out@*/ uint8_t *, size_t);
+
 /* Converts a series of input parameters to a MCF form for storage */
 int libscrypt_mcf(uint32_t N, uint32_t r, uint32_t p, const char *salt,
 	const char *hash, char *mcf);
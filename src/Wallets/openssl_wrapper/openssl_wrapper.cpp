@@ -5,18 +5,33 @@
 #include <string>
 #include <memory>
 #include <array>
+#include <mutex>
 
 #include <openssl/rsa.h>
 #include <openssl/pem.h>
 #include <openssl/aes.h>
 #include <openssl/rand.h>
 #include <openssl/err.h>
+#include <openssl/crypto.h>
 
 #include "check.h"
 #include "utilites/utils.h"
 
 static bool isInitialized = false;
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+// OpenSSL 1.0 is thread safe only with locking callbacks. Rsa decryption runs on several threads
+static std::unique_ptr<std::mutex[]> opensslMutexes;
+
+static void opensslLockingCallback(int mode, int n, const char */*file*/, int /*line*/) {
+    if (mode & CRYPTO_LOCK) {
+        opensslMutexes[n].lock();
+    } else {
+        opensslMutexes[n].unlock();
+    }
+}
+#endif
+
 #define CHECK_SSL(v, message) { \
     if (!(v)) { \
         std::vector<char> buffer(270); \
@@ -32,6 +47,12 @@ void InitOpenSSL() {
     /*SSL_load_error_strings();
     SSL_library_init();*/
     OpenSSL_add_all_algorithms();
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+    if (CRYPTO_get_locking_callback() == nullptr) {
+        opensslMutexes.reset(new std::mutex[CRYPTO_num_locks()]);
+        CRYPTO_set_locking_callback(opensslLockingCallback);
+    }
+#endif
     isInitialized = true;
 }
 
@@ -29,19 +29,21 @@ static const QString updatesLocationPrefix = ":/";
 
 const DBStorage::DbId DBStorage::not_found = -1;
 
-DBStorage::DBStorage(const QString &dbpath, const QString &dbname)
+DBStorage::DBStorage(const QString &dbpath, const QString &dbname, const QString &connectionName)
     : m_dbExist(false)
     , m_dbPath(dbpath)
     , m_dbName(dbname)
+    , m_connectionName(connectionName.isEmpty() ? dbname : connectionName)
 {
     openDB();
 }
 
 DBStorage::~DBStorage()
 {
+    m_cachedQueries.clear();
     m_db.close();
     m_db = QSqlDatabase();
-    QSqlDatabase::removeDatabase(m_dbName);
+    QSqlDatabase::removeDatabase(m_connectionName);
 }
 
 QString DBStorage::dbName() const
@@ -54,6 +56,11 @@ QString DBStorage::dbFileName() const
     return QString("%1.%2").arg(m_dbName).arg(dbFileNameSuffix);
 }
 
+QString DBStorage::dbPath() const
+{
+    return m_dbPath;
+}
+
 bool DBStorage::init()
 {
     if (dbExist()) {
@@ -73,6 +80,12 @@ bool DBStorage::init()
     return true;
 }
 
+void DBStorage::initConnection()
+{
+    execPragma(sqliteSettings);
+    execPragma(sqliteSettings1);
+}
+
 QVariant DBStorage::getSettings(const QString &key)
 {
     QSqlQuery query(m_db);
@@ -115,7 +128,7 @@ void DBStorage::openDB()
     const QString pathToDB = makePath(m_dbPath, dbFileName());
 
     m_dbExist = QFile::exists(pathToDB);
-    m_db = QSqlDatabase::addDatabase("QSQLITE", m_dbName);
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
     m_db.setDatabaseName(pathToDB);
     CHECK(m_db.open(), "DB open error");
 }
@@ -138,6 +151,19 @@ void DBStorage::createIndex(const QString &createQuery)
     CHECK(query.exec(), query.lastError().text().toStdString());
 }
 
+// Statement is prepared once per connection and reused on subsequent calls.
+// Caller must rebind all values before exec() and call finish() after reading a select
+QSqlQuery &DBStorage::cachedQuery(const QString &sql)
+{
+    auto found = m_cachedQueries.find(sql);
+    if (found == m_cachedQueries.end()) {
+        QSqlQuery query(m_db);
+        CHECK(query.prepare(sql), query.lastError().text().toStdString());
+        found = m_cachedQueries.emplace(sql, query).first;
+    }
+    return found->second;
+}
+
 QSqlDatabase DBStorage::database() const
 {
     return m_db;
@@ -161,11 +187,17 @@ bool DBStorage::updateDB()
     for (int v = ver; v < nver; v++) {
         updateToNewVersion(v, v + 1);
     }
+    updatedDatabase(ver);
     setSettings(settingsDBVersion, nver);
     transactionGuard.commit();
     return true;
 }
 
+void DBStorage::updatedDatabase(int oldVersion)
+{
+    Q_UNUSED(oldVersion);
+}
+
 void DBStorage::updateToNewVersion(int vcur, int vnew)
 {
     CHECK(vcur + 1 == vnew, "possible update to incremented version");
@@ -194,22 +226,39 @@ void DBStorage::execFromFile(const QString &filename)
 
 DBStorage::TransactionGuard::TransactionGuard(const DBStorage &storage)
     : storage(storage)
+    , level(storage.m_transactionLevel)
 {
-    CHECK(storage.database().transaction(), "Transaction not open");
+    if (level == 0) {
+        CHECK(storage.database().transaction(), "Transaction not open");
+    } else {
+        execSavepoint(QStringLiteral("SAVEPOINT sp%1").arg(level));
+    }
 
+    storage.m_transactionLevel++;
     isClose = true;
 }
 
 DBStorage::TransactionGuard::~TransactionGuard() {
     if (isClose) {
-        if (!storage.database().rollback()) {
-            LOG << "Error while rollback db commit";
+        storage.m_transactionLevel--;
+        if (level == 0) {
+            if (!storage.database().rollback()) {
+                LOG << "Error while rollback db commit";
+            }
+        } else {
+            try {
+                execSavepoint(QStringLiteral("ROLLBACK TO sp%1").arg(level));
+                execSavepoint(QStringLiteral("RELEASE sp%1").arg(level));
+            } catch (...) {
+                LOG << "Error while rollback db savepoint";
+            }
         }
     }
 }
 
 DBStorage::TransactionGuard::TransactionGuard(DBStorage::TransactionGuard &&second)
     : storage(second.storage)
+    , level(second.level)
     , isClose(second.isClose)
     , isCommited(second.isCommited)
 {
@@ -219,7 +268,18 @@ DBStorage::TransactionGuard::TransactionGuard(DBStorage::TransactionGuard &&seco
 
 void DBStorage::TransactionGuard::commit() {
     CHECK(!isCommited, "already commited");
-    CHECK(storage.database().commit(), "Transaction not commit");
+    CHECK(storage.m_transactionLevel == level + 1, "nested transaction not closed");
+    if (level == 0) {
+        CHECK(storage.database().commit(), "Transaction not commit");
+    } else {
+        execSavepoint(QStringLiteral("RELEASE sp%1").arg(level));
+    }
+    storage.m_transactionLevel--;
     isCommited = true;
     isClose = false;
 }
+
+void DBStorage::TransactionGuard::execSavepoint(const QString &sql) const {
+    QSqlQuery query(storage.database());
+    CHECK(query.exec(sql), query.lastError().text().toStdString());
+}
@@ -2,11 +2,15 @@
 #define DBSTORAGE_H
 
 #include <QSqlDatabase>
+#include <QSqlQuery>
 #include <QVariant>
 
+#include <map>
+
 class DBStorage {
 public:
 
+    // Outermost guard opens a transaction, nested guards open savepoints inside it
     class TransactionGuard {
     public:
 
@@ -24,7 +28,10 @@ public:
 
     private:
 
+        void execSavepoint(const QString &sql) const;
+
         const DBStorage &storage;
+        int level = 0;
         bool isClose = false;
         bool isCommited = false;
     };
@@ -34,15 +41,20 @@ public:
 
     const static DbId not_found;
 
-    explicit DBStorage(const QString &dbpath, const QString &dbname);
+    // Several connections to one database need different connectionName, by default it is dbname
+    explicit DBStorage(const QString &dbpath, const QString &dbname, const QString &connectionName = QString());
     virtual ~DBStorage();
 
     QString dbName() const;
     QString dbFileName() const;
+    QString dbPath() const;
     virtual int currentVersion() const = 0;
 
     bool init();
 
+    // Settings of additional connection to the database already initialized by init()
+    void initConnection();
+
     QVariant getSettings(const QString &key);
     void setSettings(const QString &key, const QVariant &value);
 
@@ -54,8 +66,11 @@ protected:
     void openDB();
 
     virtual void createDatabase() = 0;
+    // Called in the update transaction after the sql files, for updates that can not be done in sql
+    virtual void updatedDatabase(int oldVersion);
     void createTable(const QString &table, const QString &createQuery);
     void createIndex(const QString &createQuery);
+    QSqlQuery &cachedQuery(const QString &sql);
     QSqlDatabase database() const;
     bool dbExist() const;
 
@@ -65,9 +80,12 @@ private:
     void execFromFile(const QString &filename);
 
     QSqlDatabase m_db;
+    std::map<QString, QSqlQuery> m_cachedQueries;
     bool m_dbExist;
     QString m_dbPath;
     QString m_dbName;
+    QString m_connectionName;
+    mutable int m_transactionLevel = 0;
 };
 
 #endif // DBSTORAGE_H
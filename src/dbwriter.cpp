@@ -0,0 +1,129 @@
+#include "dbwriter.h"
+
+#include <algorithm>
+
+#include "dbstorage.h"
+#include "TypedException.h"
+#include "check.h"
+
+DBWriter::DBWriter(const CreateStorage &createStorage, const milliseconds &commitInterval, size_t maxBatch)
+    : createStorage(createStorage)
+    , commitInterval(commitInterval)
+    , maxBatch(std::max(maxBatch, size_t(1)))
+{
+    thread = std::thread(&DBWriter::work, this);
+}
+
+DBWriter::~DBWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mut);
+        isStop = true;
+    }
+    cond.notify_all();
+    thread.join();
+}
+
+void DBWriter::write(const WriteFunc &func, const CommitedFunc &commited) {
+    {
+        std::lock_guard<std::mutex> lock(mut);
+        CHECK(!isStop, "DB writer stopped");
+        tasks.push_back(Task{func, commited});
+        countQueued++;
+    }
+    cond.notify_all();
+}
+
+void DBWriter::flush() {
+    std::unique_lock<std::mutex> lock(mut);
+    const uint64_t target = countQueued;
+    countFlushWaiters++;
+    cond.notify_all();
+    condCommited.wait(lock, [this, target]{
+        return countDone >= target;
+    });
+    countFlushWaiters--;
+}
+
+void DBWriter::dropCommitedCallbacks() {
+    std::lock_guard<std::mutex> lock(commitedMut);
+    isDropCommited = true;
+}
+
+DBWriter::Stats DBWriter::getStats() const {
+    std::lock_guard<std::mutex> lock(mut);
+    Stats result = stats;
+    result.queued = tasks.size();
+    return result;
+}
+
+void DBWriter::work() {
+    std::unique_ptr<DBStorage> storage;
+    const TypedException storageException = apiVrapper2([this, &storage]{
+        storage = createStorage();
+        CHECK(storage != nullptr, "DB writer storage not created");
+    });
+
+    while (true) {
+        std::vector<Task> batch;
+        {
+            std::unique_lock<std::mutex> lock(mut);
+            cond.wait(lock, [this]{
+                return isStop || !tasks.empty();
+            });
+            if (tasks.empty()) {
+                break;
+            }
+            // Wait for more writes to share one commit
+            cond.wait_for(lock, commitInterval, [this]{
+                return isStop || countFlushWaiters != 0 || tasks.size() >= maxBatch;
+            });
+            const size_t count = std::min(tasks.size(), maxBatch);
+            batch.reserve(count);
+            std::move(tasks.begin(), tasks.begin() + count, std::back_inserter(batch));
+            tasks.erase(tasks.begin(), tasks.begin() + count);
+        }
+
+        writeBatch(storage.get(), storageException, batch);
+
+        {
+            std::lock_guard<std::mutex> lock(mut);
+            countDone += batch.size();
+            stats.countWrites += batch.size();
+            stats.countCommits++;
+            stats.maxBatch = std::max(stats.maxBatch, batch.size());
+        }
+        condCommited.notify_all();
+    }
+
+    // Connection is removed on the thread it was used
+    storage.reset();
+}
+
+void DBWriter::writeBatch(DBStorage *storage, const TypedException &storageException, const std::vector<Task> &batch) {
+    std::vector<TypedException> exceptions(batch.size());
+    const TypedException commitException = apiVrapper2(storageException, [storage, &batch, &exceptions]{
+        auto transactionGuard = storage->beginTransaction();
+        for (size_t i = 0; i < batch.size(); i++) {
+            exceptions[i] = apiVrapper2([storage, &task=batch[i]]{
+                auto savepointGuard = storage->beginTransaction();
+                task.func(*storage);
+                savepointGuard.commit();
+            });
+        }
+        transactionGuard.commit();
+    });
+
+    std::lock_guard<std::mutex> lock(commitedMut);
+    if (isDropCommited) {
+        return;
+    }
+    for (size_t i = 0; i < batch.size(); i++) {
+        if (batch[i].commited) {
+            const TypedException &exception = commitException.isSet() ? commitException : exceptions[i];
+            // Errors of callback are logged by apiVrapper2 and do not affect other writes
+            apiVrapper2([&task=batch[i], &exception]{
+                task.commited(exception);
+            });
+        }
+    }
+}
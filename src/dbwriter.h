@@ -0,0 +1,105 @@
+#ifndef DBWRITER_H
+#define DBWRITER_H
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "duration.h"
+
+class DBStorage;
+struct TypedException;
+
+// Dedicated thread with its own connection to the database.
+// Writes are queued and applied in group commits: one transaction per commitInterval, each write in its own savepoint
+class DBWriter {
+public:
+
+    using CreateStorage = std::function<std::unique_ptr<DBStorage>()>;
+
+    using WriteFunc = std::function<void(DBStorage &storage)>;
+
+    // Called on the writer thread after the transaction with the write is commited or rolled back
+    using CommitedFunc = std::function<void(const TypedException &exception)>;
+
+    struct Stats {
+        size_t countWrites = 0;
+        size_t countCommits = 0;
+        size_t maxBatch = 0;
+        size_t queued = 0;
+    };
+
+public:
+
+    // createStorage is called on the writer thread
+    DBWriter(const CreateStorage &createStorage, const milliseconds &commitInterval, size_t maxBatch);
+
+    // Commits all queued writes before exit
+    ~DBWriter();
+
+    DBWriter(const DBWriter &) = delete;
+    DBWriter& operator=(const DBWriter &) = delete;
+
+    void write(const WriteFunc &func, const CommitedFunc &commited);
+
+    // Blocks until all writes queued before the call are commited
+    void flush();
+
+    // Writes are still commited, but commited callbacks are not called after return. For the owner being destroyed
+    void dropCommitedCallbacks();
+
+    Stats getStats() const;
+
+private:
+
+    struct Task {
+        WriteFunc func;
+        CommitedFunc commited;
+    };
+
+private:
+
+    void work();
+
+    void writeBatch(DBStorage *storage, const TypedException &storageException, const std::vector<Task> &batch);
+
+private:
+
+    const CreateStorage createStorage;
+
+    const milliseconds commitInterval;
+
+    const size_t maxBatch;
+
+    mutable std::mutex mut;
+
+    std::condition_variable cond;
+
+    std::condition_variable condCommited;
+
+    std::deque<Task> tasks;
+
+    uint64_t countQueued = 0;
+
+    uint64_t countDone = 0;
+
+    size_t countFlushWaiters = 0;
+
+    // Held while commited callbacks run
+    std::mutex commitedMut;
+
+    bool isDropCommited = false;
+
+    Stats stats;
+
+    bool isStop = false;
+
+    std::thread thread;
+
+};
+
+#endif // DBWRITER_H
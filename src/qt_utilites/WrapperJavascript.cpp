@@ -23,6 +23,20 @@ void WrapperJavascript::runJs(const QString &script) {
     emit jsRunSig(script);
 }
 
+void WrapperJavascript::runJsResult(const QString &function, const QJsonArray &args) {
+    if (printJs) {
+        LOG2(cppFileName) << "Javascript result " << function << " " << args.size();
+    }
+    emit jsResultSig(function, args);
+}
+
+void WrapperJavascript::setStructuredResults(bool isStructured) {
+BEGIN_SLOT_WRAPPER
+    LOG2(cppFileName) << "Structured results " << isStructured;
+    isStructuredResults = isStructured;
+END_SLOT_WRAPPER
+}
+
 void WrapperJavascript::wrapOperation(const std::function<void()> &f, const std::function<void(const TypedException &e)> &errorFunc) {
     const TypedException exception = apiVrapper2(f);
 
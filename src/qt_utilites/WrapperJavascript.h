@@ -2,6 +2,7 @@
 #define WRAPPERJAVASCRIPT_H
 
 #include <QObject>
+#include <QJsonArray>
 
 #include <functional>
 
@@ -65,6 +66,13 @@ signals:
 
     void jsRunSig(QString jsString);
 
+    // Result for page that called setStructuredResults(true). Goes through QWebChannel as json, without javascript source
+    void jsResultSig(const QString &function, const QJsonArray &args);
+
+public slots:
+
+    Q_INVOKABLE void setStructuredResults(bool isStructured);
+
 protected:
 
     template<typename ...Args>
@@ -81,12 +89,18 @@ private:
 
     void runJs(const QString &script);
 
+    void runJsResult(const QString &function, const QJsonArray &args);
+
 protected:
 
     const bool printJs;
 
     const std::string cppFileName;
 
+private:
+
+    bool isStructuredResults = false;
+
 };
 
 #endif // WRAPPERJAVASCRIPT_H
@@ -16,6 +16,10 @@ auto WrapperJavascript::makeJavascriptReturnAndErrorFuncs(const QString &jsNameR
 
 template<typename... Args>
 void WrapperJavascript::makeAndRunJsFuncParams(const QString &function, const TypedException &exception, Args&& ...args) {
+    if (isStructuredResults) {
+        runJsResult(function, makeJsArgs3(exception, std::forward<Args>(args)...));
+        return;
+    }
     const QString res = makeJsFunc3<false>(function, "", exception, std::forward<Args>(args)...);
     runJs(res);
 }
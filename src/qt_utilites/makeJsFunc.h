@@ -3,6 +3,9 @@
 
 #include <QString>
 #include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
 
 #include <string>
 
@@ -127,4 +130,61 @@ inline QString makeJsFunc3(const QString &function, const QString &lastArg, cons
     return jScript;
 }
 
+inline QJsonValue toJsValue(const QString &arg) {
+    return QJsonValue(arg);
+}
+
+// Document goes to javascript as object, not as json string
+inline QJsonValue toJsValue(const QJsonDocument &arg) {
+    if (arg.isArray()) {
+        return QJsonValue(arg.array());
+    } else if (arg.isObject()) {
+        return QJsonValue(arg.object());
+    } else {
+        return QJsonValue();
+    }
+}
+
+inline QJsonValue toJsValue(const std::string &arg) {
+    return QJsonValue(QString::fromStdString(arg));
+}
+
+inline QJsonValue toJsValue(const int &arg) {
+    return QJsonValue(arg);
+}
+
+inline QJsonValue toJsValue(const long int &arg) {
+    return QJsonValue(static_cast<qint64>(arg));
+}
+
+inline QJsonValue toJsValue(const long long int &arg) {
+    return QJsonValue(static_cast<qint64>(arg));
+}
+
+inline QJsonValue toJsValue(bool arg) {
+    return QJsonValue(arg);
+}
+
+inline QJsonValue toJsValue(const size_t &arg) {
+    return QJsonValue(static_cast<qint64>(arg));
+}
+
+inline void appendValues(QJsonArray &/*result*/) {
+}
+
+template<typename Arg, typename... Args>
+inline void appendValues(QJsonArray &result, const Arg &arg, Args&& ...args) {
+    static_assert(!std::is_same<typename std::decay<decltype(arg)>::type, char const*>::value, "const char* not allowed");
+    result.append(toJsValue(arg));
+    appendValues(result, std::forward<Args>(args)...);
+}
+
+// Same arguments as makeJsFunc3, but without building javascript source
+template<typename... Args>
+inline QJsonArray makeJsArgs3(const TypedException &exception, Args&& ...args) {
+    QJsonArray result;
+    appendValues(result, std::forward<Args>(args)..., (int)exception.numError, exception.description);
+    return result;
+}
+
 #endif // MAKEJSFUNCPARAMETERS_H
@@ -19,6 +19,7 @@ SOURCES += main.cpp MainWindow.cpp \
     TorProxy.cpp \
     Uploader.cpp \
     Wallets/ethtx/scrypt/crypto_scrypt-nosse.cpp \
+    Wallets/ethtx/scrypt/crypto_scrypt-sse.cpp \
     Wallets/ethtx/scrypt/sha256.cpp \
     Wallets/ethtx/cert.cpp \
     Wallets/ethtx/rlp.cpp \
@@ -47,12 +48,17 @@ SOURCES += main.cpp MainWindow.cpp \
     Messenger/MessengerMessages.cpp \
     Messenger/MessengerJavascript.cpp \
     Messenger/CryptographicManager.cpp \
+    Messenger/DecryptMessages.cpp \
     dbstorage.cpp \
+    dbwriter.cpp \
     Messenger/MessengerDBStorage.cpp \
     transactions/Transactions.cpp \
     transactions/TransactionsMessages.cpp \
     transactions/TransactionsDBStorage.cpp \
     transactions/TransactionsJavascript.cpp \
+    transactions/HistoryBackfill.cpp \
+    transactions/BalancePollScheduler.cpp \
+    transactions/SendBatchState.cpp \
     auth/Auth.cpp \
     auth/AuthJavascript.cpp \
     Initializer/Initializer.cpp \
@@ -85,6 +91,8 @@ SOURCES += main.cpp MainWindow.cpp \
     NsLookup/Workers/PrintNodesWorker.cpp \
     NsLookup/Workers/MiddleWorker.cpp \
     utilites/BigNumber.cpp \
+    utilites/BigNumber256.cpp \
+    utilites/JsonStreamReader.cpp \
     utilites/machine_uid.cpp \
     utilites/machine_uid_unix.cpp \
     utilites/machine_uid_win.cpp \
@@ -92,6 +100,7 @@ SOURCES += main.cpp MainWindow.cpp \
     utilites/unzip.cpp \
     utilites/utils.cpp \
     utilites/VersionWrapper.cpp \
+    utilites/ThreadPool.cpp \
     Log.cpp \
     TypedException.cpp \
     qt_utilites/CallbackCallWrapper.cpp \
@@ -106,8 +115,11 @@ SOURCES += main.cpp MainWindow.cpp \
     Network/UdpSocketClient.cpp \
     Network/WebSocketClient.cpp \
     Wallets/BtcWallet.cpp \
+    Wallets/BtcCoinSelection.cpp \
     Wallets/EthWallet.cpp \
     Wallets/Wallet.cpp \
+    Wallets/SignSessions.cpp \
+    Wallets/WalletsIndex.cpp \
     Wallets/WalletRsa.cpp \
     Wallets/Wallets.cpp \
     Wallets/WalletsJavascript.cpp \
@@ -116,6 +128,9 @@ SOURCES += main.cpp MainWindow.cpp \
     qt_utilites/EventWatcher.cpp \
     Wallets/GetActualWalletsEvent.cpp \
     NsLookup/InfrastructureNsLookup.cpp \
+    NsLookup/NodeHealth.cpp \
+    NsLookup/ParallelLookup.cpp \
+    NsLookup/DnsCache.cpp \
     MetaGate/MetaGate.cpp \
     MetaGate/MetaGateJavascript.cpp \
     Initializer/Inits/InitMetaGate.cpp \
@@ -169,12 +184,16 @@ HEADERS += MainWindow.h \
     Messenger/MessengerJavascript.h \
     Messenger/Message.h \
     dbstorage.h \
+    dbwriter.h \
     Messenger/MessengerDBStorage.h \
     transactions/Transactions.h \
     transactions/TransactionsMessages.h \
     transactions/Transaction.h \
     transactions/TransactionsDBStorage.h \
     transactions/TransactionsJavascript.h \
+    transactions/HistoryBackfill.h \
+    transactions/BalancePollScheduler.h \
+    transactions/SendBatchState.h \
     auth/Auth.h \
     auth/AuthJavascript.h \
     Initializer/Initializer.h \
@@ -188,6 +207,7 @@ HEADERS += MainWindow.h \
     Initializer/Inits/InitJavascriptWrapper.h \
     Initializer/Inits/InitUploader.h \
     Messenger/CryptographicManager.h \
+    Messenger/DecryptMessages.h \
     Initializer/Inits/InitMessenger.h \
     MhPayEventHandler.h \
     WalletNames/WalletNamesDbStorage.h \
@@ -212,6 +232,8 @@ HEADERS += MainWindow.h \
     NsLookup/Workers/MiddleWorker.h \
     utilites/algorithms.h \
     utilites/BigNumber.h \
+    utilites/BigNumber256.h \
+    utilites/JsonStreamReader.h \
     utilites/machine_uid.h \
     utilites/platform.h \
     utilites/qrcoder.h \
@@ -219,6 +241,7 @@ HEADERS += MainWindow.h \
     utilites/unzip.h \
     utilites/utils.h \
     utilites/VersionWrapper.h \
+    utilites/ThreadPool.h \
     check.h \
     Log.h \
     duration.h \
@@ -239,8 +262,11 @@ HEADERS += MainWindow.h \
     Network/UdpSocketClient.h \
     Network/WebSocketClient.h \
     Wallets/BtcWallet.h \
+    Wallets/BtcCoinSelection.h \
     Wallets/EthWallet.h \
     Wallets/Wallet.h \
+    Wallets/SignSessions.h \
+    Wallets/WalletsIndex.h \
     Wallets/WalletRsa.h \
     Wallets/Wallets.h \
     Wallets/WalletsJavascript.h \
@@ -250,6 +276,9 @@ HEADERS += MainWindow.h \
     Wallets/GetActualWalletsEvent.h \
     transactions/TransactionsFilter.h \
     NsLookup/InfrastructureNsLookup.h \
+    NsLookup/NodeHealth.h \
+    NsLookup/ParallelLookup.h \
+    NsLookup/DnsCache.h \
     MetaGate/MetaGate.h \
     MetaGate/MetaGateJavascript.h \
     Initializer/Inits/InitMetaGate.h \
@@ -0,0 +1,106 @@
+#include "BalancePollScheduler.h"
+
+#include <algorithm>
+
+#include "check.h"
+
+#include "Transaction.h"
+
+namespace transactions {
+
+BalancePollScheduler::BalancePollScheduler(const milliseconds &minInterval, const milliseconds &maxInterval)
+    : minInterval(minInterval)
+    , maxInterval(maxInterval)
+{
+    CHECK(minInterval <= maxInterval, "Incorrect poll intervals");
+}
+
+void BalancePollScheduler::setAddresses(const std::vector<AddressInfo> &infos, const time_point &now) {
+    std::set<Key> tracked;
+    for (const AddressInfo &info: infos) {
+        const Key key(info.currency, info.address);
+        tracked.insert(key);
+        if (polls.find(key) == polls.end()) {
+            AddressPoll &poll = polls[key];
+            poll.currency = info.currency;
+            poll.address = info.address;
+            poll.interval = minInterval;
+            poll.nextPoll = now;
+            queue.emplace(poll.nextPoll, poll.currency, poll.address);
+        }
+    }
+
+    for (auto iter = polls.begin(); iter != polls.end();) {
+        if (tracked.find(iter->first) == tracked.end()) {
+            queue.erase(std::make_tuple(iter->second.nextPoll, iter->second.currency, iter->second.address));
+            iter = polls.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+void BalancePollScheduler::reschedule(AddressPoll &poll, const time_point &nextPoll) {
+    queue.erase(std::make_tuple(poll.nextPoll, poll.currency, poll.address));
+    poll.nextPoll = nextPoll;
+    queue.emplace(poll.nextPoll, poll.currency, poll.address);
+}
+
+std::vector<std::pair<QString, QString>> BalancePollScheduler::takeDue(const time_point &now, size_t maxCount) {
+    std::vector<std::pair<QString, QString>> result;
+    while (!queue.empty() && result.size() < maxCount && std::get<0>(*queue.begin()) <= now) {
+        const auto first = *queue.begin();
+        const Key key(std::get<1>(first), std::get<2>(first));
+        AddressPoll &poll = polls.at(key);
+        reschedule(poll, now + poll.interval);
+        poll.countPolls++;
+        countPolls++;
+        result.emplace_back(key);
+    }
+    return result;
+}
+
+void BalancePollScheduler::polled(const QString &currency, const QString &address, bool isChanged, const time_point &now) {
+    const auto found = polls.find(Key(currency, address));
+    if (found == polls.end()) {
+        return;
+    }
+    AddressPoll &poll = found->second;
+    if (isChanged) {
+        poll.countChanges++;
+        poll.interval = minInterval;
+    } else {
+        poll.interval = std::min(poll.interval * 2, maxInterval);
+    }
+    reschedule(poll, now + poll.interval);
+}
+
+void BalancePollScheduler::wakeUp(const QString &currency, const QString &address, const time_point &now) {
+    const auto found = polls.find(Key(currency, address));
+    if (found == polls.end()) {
+        return;
+    }
+    found->second.interval = minInterval;
+    reschedule(found->second, now);
+}
+
+BalancePollScheduler::Stats BalancePollScheduler::getStats(const time_point &now) const {
+    Stats stats;
+    stats.now = now;
+    stats.countAddresses = polls.size();
+    stats.countPolls = countPolls;
+    stats.countBatches = countBatches;
+    for (const auto &element: queue) {
+        if (std::get<0>(element) > now) {
+            break;
+        }
+        stats.queueDepth++;
+    }
+    stats.addresses.reserve(polls.size());
+    for (const auto &pair: polls) {
+        stats.addresses.emplace_back(pair.second);
+    }
+    return stats;
+}
+
+} // namespace transactions
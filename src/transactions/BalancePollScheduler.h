@@ -0,0 +1,85 @@
+#ifndef BALANCEPOLLSCHEDULER_H
+#define BALANCEPOLLSCHEDULER_H
+
+#include <QString>
+
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "duration.h"
+
+namespace transactions {
+
+struct AddressInfo;
+
+// Decides when balance of tracked address should be requested again.
+// Address whose balance changed is polled with minimum interval, each poll without changes doubles interval up to maximum
+class BalancePollScheduler {
+public:
+
+    struct AddressPoll {
+        QString currency;
+        QString address;
+        milliseconds interval;
+        time_point nextPoll;
+        size_t countPolls = 0;
+        size_t countChanges = 0;
+    };
+
+    struct Stats {
+        time_point now;
+        size_t countAddresses = 0;
+        // Addresses whose poll time has come
+        size_t queueDepth = 0;
+        size_t countPolls = 0;
+        size_t countBatches = 0;
+        std::vector<AddressPoll> addresses;
+    };
+
+public:
+
+    BalancePollScheduler(const milliseconds &minInterval, const milliseconds &maxInterval);
+
+    // Adds new addresses with poll time now and forgets addresses that are not tracked anymore
+    void setAddresses(const std::vector<AddressInfo> &infos, const time_point &now);
+
+    // Returns at most maxCount due addresses ordered by poll time. Next poll of returned address is postponed by its interval
+    std::vector<std::pair<QString, QString>> takeDue(const time_point &now, size_t maxCount);
+
+    void polled(const QString &currency, const QString &address, bool isChanged, const time_point &now);
+
+    // Address is polled on next timer with minimum interval
+    void wakeUp(const QString &currency, const QString &address, const time_point &now);
+
+    void addBatches(size_t count) {
+        countBatches += count;
+    }
+
+    Stats getStats(const time_point &now) const;
+
+private:
+
+    using Key = std::pair<QString, QString>;
+
+    void reschedule(AddressPoll &poll, const time_point &nextPoll);
+
+private:
+
+    const milliseconds minInterval;
+
+    const milliseconds maxInterval;
+
+    std::map<Key, AddressPoll> polls;
+
+    std::set<std::tuple<time_point, QString, QString>> queue;
+
+    size_t countPolls = 0;
+
+    size_t countBatches = 0;
+};
+
+} // namespace transactions
+
+#endif // BALANCEPOLLSCHEDULER_H
@@ -0,0 +1,76 @@
+#include "HistoryBackfill.h"
+
+#include <algorithm>
+
+#include "check.h"
+
+namespace transactions {
+
+const uint64_t HistoryBackfill::MIN_PAGE_SIZE;
+const uint64_t HistoryBackfill::MAX_PAGE_SIZE;
+
+HistoryBackfill::HistoryBackfill(uint64_t savedTxs, uint64_t targetTxs, uint64_t pageSize, milliseconds targetLatency)
+    : saved(savedTxs)
+    , target(targetTxs)
+    , nextPosition(savedTxs)
+    , currentPageSize(std::min(std::max(pageSize, MIN_PAGE_SIZE), MAX_PAGE_SIZE))
+    , targetLatency(targetLatency)
+{
+    CHECK(saved <= target, "Incorrect backfill range");
+}
+
+bool HistoryBackfill::isFinished() const {
+    return saved >= target;
+}
+
+bool HistoryBackfill::nextPage(Page &page) {
+    if (!retry.empty()) {
+        page = retry.back();
+        retry.pop_back();
+    } else if (nextPosition < target) {
+        page.from = nextPosition;
+        page.count = std::min(currentPageSize, target - nextPosition);
+        nextPosition += page.count;
+    } else {
+        return false;
+    }
+    inFlight[page.from] = page.count;
+    return true;
+}
+
+void HistoryBackfill::pageDone(const Page &page, milliseconds latency) {
+    const auto found = inFlight.find(page.from);
+    CHECK(found != inFlight.end() && found->second == page.count, "Page not requested");
+    inFlight.erase(found);
+
+    done[page.from] = page.count;
+    for (auto iter = done.begin(); iter != done.end() && iter->first <= saved; iter = done.erase(iter)) {
+        saved = std::max(saved, iter->first + iter->second);
+    }
+
+    if (latency * 2 < targetLatency) {
+        currentPageSize = std::min(currentPageSize * 2, MAX_PAGE_SIZE);
+    } else if (latency > targetLatency) {
+        currentPageSize = std::max(currentPageSize / 2, MIN_PAGE_SIZE);
+    }
+}
+
+void HistoryBackfill::pageFailed(const Page &page) {
+    const auto found = inFlight.find(page.from);
+    CHECK(found != inFlight.end() && found->second == page.count, "Page not requested");
+    inFlight.erase(found);
+
+    currentPageSize = std::max(currentPageSize / 2, MIN_PAGE_SIZE);
+    // Failed page is requested again by parts of the new size, the oldest part first
+    const uint64_t pageEnd = page.from + page.count;
+    std::vector<Page> parts;
+    for (uint64_t from = page.from; from < pageEnd; from += currentPageSize) {
+        Page part;
+        part.from = from;
+        part.count = std::min(currentPageSize, pageEnd - from);
+        parts.emplace_back(part);
+    }
+    retry.insert(retry.end(), parts.rbegin(), parts.rend());
+}
+
+} // namespace transactions
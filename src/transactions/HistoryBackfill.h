@@ -0,0 +1,80 @@
+#ifndef HISTORYBACKFILL_H
+#define HISTORYBACKFILL_H
+
+#include <map>
+#include <vector>
+
+#include "duration.h"
+
+namespace transactions {
+
+// Splits missing history of one address into pages that can be downloaded in parallel.
+// Positions are counted from the oldest transaction, so they do not shift when new transactions arrive.
+// Page size grows while server answers fast and shrinks on slow answers and errors
+class HistoryBackfill {
+public:
+
+    struct Page {
+        uint64_t from = 0;
+        uint64_t count = 0;
+    };
+
+public:
+
+    static const uint64_t MIN_PAGE_SIZE = 250;
+    static const uint64_t MAX_PAGE_SIZE = 10000;
+
+public:
+
+    HistoryBackfill(uint64_t savedTxs, uint64_t targetTxs, uint64_t pageSize, milliseconds targetLatency);
+
+    bool isFinished() const;
+
+    // Returns false if all remaining pages are already requested
+    bool nextPage(Page &page);
+
+    void pageDone(const Page &page, milliseconds latency);
+
+    // Page will be returned by nextPage again
+    void pageFailed(const Page &page);
+
+    // All transactions before this position are saved
+    uint64_t savedTxs() const {
+        return saved;
+    }
+
+    uint64_t targetTxs() const {
+        return target;
+    }
+
+    size_t countInFlight() const {
+        return inFlight.size();
+    }
+
+    uint64_t pageSize() const {
+        return currentPageSize;
+    }
+
+private:
+
+    uint64_t saved;
+
+    const uint64_t target;
+
+    uint64_t nextPosition;
+
+    uint64_t currentPageSize;
+
+    const milliseconds targetLatency;
+
+    std::map<uint64_t, uint64_t> inFlight;
+
+    // Saved pages after the first gap
+    std::map<uint64_t, uint64_t> done;
+
+    std::vector<Page> retry;
+};
+
+} // namespace transactions
+
+#endif // HISTORYBACKFILL_H
@@ -0,0 +1,208 @@
+#include "SendBatchState.h"
+
+#include <algorithm>
+
+#include "check.h"
+
+namespace transactions {
+
+SendBatchState::SendBatchState(const std::vector<BatchTransaction> &batch, size_t countServersSend, size_t sendWindow, size_t checkWindow, const milliseconds &checkPeriod, const milliseconds &timeout, const time_point &now)
+    : countServersSend(countServersSend)
+    , sendWindow(sendWindow)
+    , checkWindow(checkWindow)
+    , checkPeriod(checkPeriod)
+    , timeout(timeout)
+    , txs(batch.begin(), batch.end())
+    , lastSendTime(now)
+{
+    CHECK(countServersSend != 0, "Not enough servers send");
+    CHECK(sendWindow != 0 && checkWindow != 0, "Incorrect batch windows");
+}
+
+std::vector<size_t> SendBatchState::takeToSend() {
+    std::vector<size_t> result;
+    while (!isSendFailed && countSending < sendWindow && nextSend < txs.size()) {
+        result.emplace_back(nextSend);
+        nextSend++;
+        countSending++;
+    }
+    return result;
+}
+
+void SendBatchState::sendAnswered(size_t index, bool isOk, const QString &hash, const QString &error, const time_point &now) {
+    Tx &tx = txs.at(index);
+    tx.countResponses++;
+    if (tx.status == BatchProgress::Status::QUEUED) {
+        if (isOk) {
+            tx.hash = hash;
+            tx.nextCheck = now + checkPeriod;
+            lastSendTime = now;
+            setStatus(index, BatchProgress::Status::SENDED, "");
+        } else {
+            tx.error = error;
+        }
+    }
+
+    if (tx.countResponses != countServersSend) {
+        return;
+    }
+    countSending--;
+    if (tx.status != BatchProgress::Status::QUEUED) {
+        return;
+    }
+    setStatus(index, BatchProgress::Status::SEND_ERROR, tx.error);
+    if (!isSendFailed) {
+        isSendFailed = true;
+        // Transactions already in flight are left to finish
+        for (size_t i = nextSend; i < txs.size(); i++) {
+            setStatus(i, BatchProgress::Status::NOT_SENT, "Not sent after error of transaction " + QString::number(index));
+        }
+    }
+}
+
+bool SendBatchState::checkFinished(const time_point &now, std::vector<size_t> &pendingAfterTimeout) {
+    const bool isAllSended = (nextSend == txs.size() || isSendFailed) && countSending == 0;
+    const bool isTimeout = isAllSended && now - lastSendTime >= timeout;
+
+    bool isFinished = isAllSended;
+    for (size_t index = 0; index < txs.size(); index++) {
+        const Tx &tx = txs[index];
+        const bool isWaitConfirm = tx.status == BatchProgress::Status::SENDED || tx.status == BatchProgress::Status::PENDING;
+        if (!isWaitConfirm) {
+            continue;
+        }
+
+        if (!isTimeout) {
+            isFinished = false;
+        } else if (tx.status == BatchProgress::Status::PENDING) {
+            pendingAfterTimeout.emplace_back(index);
+        } else {
+            setStatus(index, BatchProgress::Status::NOT_FOUND, "Transaction not found");
+        }
+    }
+    return isFinished;
+}
+
+std::vector<size_t> SendBatchState::takeToCheck(const time_point &now) {
+    std::vector<size_t> result;
+    for (size_t index = 0; index < txs.size() && countChecking < checkWindow; index++) {
+        Tx &tx = txs[index];
+        const bool isWaitConfirm = tx.status == BatchProgress::Status::SENDED || tx.status == BatchProgress::Status::PENDING;
+        if (!isWaitConfirm || tx.isChecking || tx.nextCheck > now) {
+            continue;
+        }
+        tx.isChecking = true;
+        countChecking++;
+        result.emplace_back(index);
+    }
+    return result;
+}
+
+bool SendBatchState::checkAnswered(size_t index, const time_point &now) {
+    Tx &tx = txs.at(index);
+    tx.isChecking = false;
+    countChecking--;
+    tx.nextCheck = now + checkPeriod;
+    return tx.status == BatchProgress::Status::SENDED || tx.status == BatchProgress::Status::PENDING;
+}
+
+void SendBatchState::checkFound(size_t index, const Transaction::Status &status) {
+    const Tx &tx = txs.at(index);
+    if (status == Transaction::Status::PENDING) {
+        if (tx.status != BatchProgress::Status::PENDING) {
+            setStatus(index, BatchProgress::Status::PENDING, "");
+        }
+    } else if (status == Transaction::Status::OK) {
+        setStatus(index, BatchProgress::Status::CONFIRMED, "");
+    } else {
+        setStatus(index, BatchProgress::Status::REJECTED, "Transaction status " + QString::number(status));
+    }
+}
+
+BatchProgress SendBatchState::takeProgress(bool isFinished) {
+    BatchProgress progress;
+    progress.count = txs.size();
+    progress.isFinished = isFinished;
+    for (const Tx &tx: txs) {
+        switch (tx.status) {
+        case BatchProgress::Status::QUEUED:
+            break;
+        case BatchProgress::Status::SEND_ERROR:
+            progress.countSendErrors++;
+            break;
+        case BatchProgress::Status::NOT_SENT:
+            progress.countNotSent++;
+            break;
+        case BatchProgress::Status::SENDED:
+            progress.countSended++;
+            break;
+        case BatchProgress::Status::PENDING:
+            progress.countSended++;
+            progress.countPending++;
+            break;
+        case BatchProgress::Status::CONFIRMED:
+            progress.countSended++;
+            progress.countConfirmed++;
+            break;
+        case BatchProgress::Status::REJECTED:
+            progress.countSended++;
+            progress.countRejected++;
+            break;
+        case BatchProgress::Status::NOT_FOUND:
+            progress.countSended++;
+            progress.countNotFound++;
+            break;
+        }
+    }
+
+    progress.changed.reserve(changed.size());
+    for (const size_t index: changed) {
+        const Tx &tx = txs[index];
+        progress.changed.push_back(BatchProgress::TxStatus{index, tx.tx.nonce, tx.hash, tx.status, tx.error});
+    }
+    changed.clear();
+    return progress;
+}
+
+bool SendBatchState::getFailedNonce(size_t &nonce) const {
+    bool isFound = false;
+    for (const Tx &tx: txs) {
+        const bool isFailed = tx.status == BatchProgress::Status::SEND_ERROR || tx.status == BatchProgress::Status::NOT_SENT || tx.status == BatchProgress::Status::NOT_FOUND;
+        if (isFailed && (!isFound || tx.tx.nonce < nonce)) {
+            nonce = tx.tx.nonce;
+            isFound = true;
+        }
+    }
+    return isFound;
+}
+
+void SendBatchState::setStatus(size_t index, const BatchProgress::Status &status, const QString &error) {
+    Tx &tx = txs.at(index);
+    tx.status = status;
+    tx.error = error;
+    changed.insert(index);
+}
+
+NonceReservations::NonceReservations(const milliseconds &timeout)
+    : timeout(timeout)
+{}
+
+size_t NonceReservations::reserve(const QString &from, size_t nonce, size_t count, const time_point &now) {
+    CHECK(count != 0, "Incorrect count nonces");
+    size_t firstNonce = nonce;
+    const auto found = reserved.find(from);
+    if (found != reserved.end() && now - found->second.time < timeout) {
+        firstNonce = std::max(firstNonce, found->second.next);
+    }
+    reserved[from] = ReservedNonce{firstNonce + count, now};
+    return firstNonce;
+}
+
+void NonceReservations::release(const QString &from, size_t failedNonce) {
+    const auto found = reserved.find(from);
+    if (found != reserved.end()) {
+        found->second.next = std::min(found->second.next, failedNonce);
+    }
+}
+
+} // namespace transactions
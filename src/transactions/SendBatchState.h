@@ -0,0 +1,130 @@
+#ifndef SENDBATCHSTATE_H
+#define SENDBATCHSTATE_H
+
+#include <QString>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "duration.h"
+
+#include "Transaction.h"
+
+namespace transactions {
+
+// Statuses of transactions of one batch send. Transactions sends requests, this class decides what to send and check.
+// Nonces of a batch go in a row, so after the first send error the rest transactions are not sent
+class SendBatchState {
+public:
+
+    struct Tx {
+        BatchTransaction tx;
+        QString hash;
+        BatchProgress::Status status = BatchProgress::Status::QUEUED;
+        QString error;
+        size_t countResponses = 0;
+        bool isChecking = false;
+        time_point nextCheck;
+
+        Tx(const BatchTransaction &tx)
+            : tx(tx)
+        {}
+    };
+
+public:
+
+    SendBatchState(const std::vector<BatchTransaction> &batch, size_t countServersSend, size_t sendWindow, size_t checkWindow, const milliseconds &checkPeriod, const milliseconds &timeout, const time_point &now);
+
+    // Indexes of transactions to send now. Nothing is returned after a send error
+    std::vector<size_t> takeToSend();
+
+    // Answer of one server on send. Transaction without hash after answers of all servers is failed
+    void sendAnswered(size_t index, bool isOk, const QString &hash, const QString &error, const time_point &now);
+
+    // Timeout after the last send marks not found transactions. Pending ones are returned in pendingAfterTimeout,
+    // their final status comes with status signals of transactions
+    bool checkFinished(const time_point &now, std::vector<size_t> &pendingAfterTimeout);
+
+    // Indexes of transactions to request from the torrent now
+    std::vector<size_t> takeToCheck(const time_point &now);
+
+    // Returns false if status of transaction is final already
+    bool checkAnswered(size_t index, const time_point &now);
+
+    void checkFound(size_t index, const Transaction::Status &status);
+
+    BatchProgress takeProgress(bool isFinished);
+
+    // Nonce of the first failed transaction
+    bool getFailedNonce(size_t &nonce) const;
+
+    const Tx& getTx(size_t index) const {
+        return txs.at(index);
+    }
+
+    size_t size() const {
+        return txs.size();
+    }
+
+    bool isChanged() const {
+        return !changed.empty();
+    }
+
+private:
+
+    void setStatus(size_t index, const BatchProgress::Status &status, const QString &error);
+
+private:
+
+    const size_t countServersSend;
+
+    const size_t sendWindow;
+
+    const size_t checkWindow;
+
+    const milliseconds checkPeriod;
+
+    const milliseconds timeout;
+
+    std::vector<Tx> txs;
+
+    size_t nextSend = 0;
+    size_t countSending = 0;
+    size_t countChecking = 0;
+    time_point lastSendTime;
+    bool isSendFailed = false;
+
+    std::set<size_t> changed;
+};
+
+// Nonces reserved for batch sends of each address. Reservation expires after timeout
+class NonceReservations {
+public:
+
+    explicit NonceReservations(const milliseconds &timeout);
+
+    // nonce is the next nonce by the node. Returns the first reserved nonce
+    size_t reserve(const QString &from, size_t nonce, size_t count, const time_point &now);
+
+    // Nonces from the failed one are free again. Later reservations of the address fail after the gap anyway
+    void release(const QString &from, size_t failedNonce);
+
+private:
+
+    struct ReservedNonce {
+        size_t next;
+        time_point time;
+    };
+
+private:
+
+    const milliseconds timeout;
+
+    // Key is address
+    std::map<QString, ReservedNonce> reserved;
+};
+
+} // namespace transactions
+
+#endif // SENDBATCHSTATE_H
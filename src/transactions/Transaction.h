@@ -3,7 +3,9 @@
 
 #include <QString>
 
-#include "utilites/BigNumber.h"
+#include <vector>
+
+#include "utilites/BigNumber256.h"
 #include "dbstorage.h"
 #include "duration.h"
 
@@ -53,8 +55,8 @@ struct Transaction {
 
 struct BalanceInfo {
     QString address;
-    BigNumber received = QString("0");
-    BigNumber spent = QString("0");
+    BigNumber256 received;
+    BigNumber256 spent;
     uint64_t countReceived = 0;
     uint64_t countSpent = 0;
     uint64_t countTxs = 0;
@@ -62,12 +64,12 @@ struct BalanceInfo {
     uint64_t savedTxs = 0;
 
     uint64_t countDelegated = 0;
-    BigNumber delegate = QString("0");
-    BigNumber undelegate = QString("0");
-    BigNumber delegated = QString("0");
-    BigNumber undelegated = QString("0");
-    BigNumber reserved = QString("0");
-    BigNumber forged = QString("0");
+    BigNumber256 delegate;
+    BigNumber256 undelegate;
+    BigNumber256 delegated;
+    BigNumber256 undelegated;
+    BigNumber256 reserved;
+    BigNumber256 forged;
 
     uint64_t tokenBlockNum = 0;
 
@@ -76,11 +78,17 @@ struct BalanceInfo {
     {
     }
 
-    BigNumber calcBalance() const {
+    BigNumber256 calcBalance() const {
         return received - spent - reserved;
     }
 };
 
+// Progress of history download stored with balance. targetTxs is zero when download not in progress
+struct HistoryBackfillInfo {
+    uint64_t targetTxs = 0;
+    uint64_t savedTxs = 0;
+};
+
 struct AddressInfo {
     QString currency;
     QString address;
@@ -111,11 +119,50 @@ struct SendParameters {
     seconds timeout;
 };
 
+// Signed transaction of the batch send
+struct BatchTransaction {
+    QString to;
+    QString value;
+    size_t nonce = 0;
+    QString data;
+    QString fee;
+    QString pubkey;
+    QString sign;
+};
+
+struct BatchProgress {
+    enum class Status {
+        QUEUED, SENDED, SEND_ERROR, NOT_SENT, PENDING, CONFIRMED, REJECTED, NOT_FOUND
+    };
+
+    struct TxStatus {
+        size_t index;
+        size_t nonce;
+        QString hash;
+        Status status;
+        QString error;
+    };
+
+    size_t count = 0;
+    size_t countSended = 0;
+    size_t countSendErrors = 0;
+    // Transactions after the first send error
+    size_t countNotSent = 0;
+    size_t countPending = 0;
+    size_t countConfirmed = 0;
+    size_t countRejected = 0;
+    size_t countNotFound = 0;
+    bool isFinished = false;
+
+    // Transactions with status changed since previous progress
+    std::vector<TxStatus> changed;
+};
+
 struct TokenBalance {
     QString address;
     QString tokenAddress;
-    BigNumber received = QString("0");
-    BigNumber spent = QString("0");
+    BigNumber256 received;
+    BigNumber256 spent;
     QString value;
     uint64_t countReceived = 0;
     uint64_t countSpent = 0;
@@ -135,8 +182,8 @@ struct Token {
 struct TokenInfo {
     QString address;
     QString tokenAddress;
-    BigNumber received = QString("0");
-    BigNumber spent = QString("0");
+    BigNumber256 received;
+    BigNumber256 spent;
     QString value;
     uint64_t countReceived = 0;
     uint64_t countSpent = 0;
@@ -148,7 +195,7 @@ struct TokenInfo {
     uint64_t emission;
     QString owner;
 
-    BigNumber calcBalance() const
+    BigNumber256 calcBalance() const
     {
         return received - spent;
     }
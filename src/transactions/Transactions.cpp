@@ -22,10 +22,13 @@ using namespace std::placeholders;
 #include "TransactionsJavascript.h"
 #include "TransactionsDBStorage.h"
 
+#include "dbwriter.h"
+
 #include "Wallets/Wallets.h"
 #include "Wallets/WalletInfo.h"
 
 #include <memory>
+#include <algorithm>
 
 SET_LOG_NAMESPACE("TXS");
 
@@ -34,6 +37,24 @@ namespace transactions {
 static const uint64_t ADD_TO_COUNT_TXS = 10;
 static const uint64_t MAX_TXS_IN_RESPONSE = 2000;
 
+static const size_t HISTORY_BACKFILL_PAGES_IN_FLIGHT = 4;
+static const milliseconds HISTORY_BACKFILL_TARGET_LATENCY = 2s;
+
+// Balance is compared between several nodes to skip lagging ones
+static const size_t BALANCE_HEDGE_ANSWERS = 2;
+
+static const QString DB_WRITER_CONNECTION = "payments_writer";
+static const milliseconds DB_WRITER_COMMIT_INTERVAL = 50ms;
+static const size_t DB_WRITER_MAX_BATCH = 200;
+
+// Batch send keeps so many transactions in flight to the proxies, the rest wait in the batch
+static const size_t BATCH_SEND_WINDOW = 16;
+static const size_t BATCH_CHECK_WINDOW = 16;
+static const milliseconds BATCH_CHECK_PERIOD = 1s;
+
+// Reserved nonces are not trusted after this time, the server nonce is used instead
+static const seconds NONCE_RESERVATION_TIMEOUT = 5min;
+
 static QString makeGroupName(const QString &userName) {
     if (userName.isEmpty()) {
         return "_unregistered";
@@ -41,6 +62,32 @@ static QString makeGroupName(const QString &userName) {
     return userName;
 }
 
+// Cursor is opaque for javascript: hex of "ts:id:txid"
+static QString cursorToString(const Transaction &lastTx) {
+    const QString cursor = QString::number(lastTx.timestamp) + ":" + QString::number(lastTx.id) + ":" + lastTx.tx;
+    return QString(cursor.toUtf8().toHex());
+}
+
+static TxsCursor cursorFromString(const QString &cursorStr) {
+    TxsCursor cursor;
+    if (cursorStr.isEmpty()) {
+        return cursor;
+    }
+    const QString decoded = QString::fromUtf8(QByteArray::fromHex(cursorStr.toUtf8()));
+    const int pos1 = decoded.indexOf(':');
+    CHECK(pos1 != -1, "Incorrect cursor");
+    const int pos2 = decoded.indexOf(':', pos1 + 1);
+    CHECK(pos2 != -1, "Incorrect cursor");
+    bool isOk1 = false;
+    bool isOk2 = false;
+    cursor.ts = decoded.left(pos1).toLongLong(&isOk1);
+    cursor.id = decoded.mid(pos1 + 1, pos2 - pos1 - 1).toLongLong(&isOk2);
+    CHECK(isOk1 && isOk2, "Incorrect cursor");
+    cursor.txid = decoded.mid(pos2 + 1);
+    cursor.isSet = true;
+    return cursor;
+}
+
 // Small hack to convert different currencies names
 QString Transactions::convertCurrency(const QString &currency) const {
     return currency.toLower();
@@ -53,6 +100,8 @@ Transactions::Transactions(NsLookup &nsLookup, InfrastructureNsLookup &infrastru
     , wallets(wallets)
     , javascriptWrapper(javascriptWrapper)
     , db(db)
+    , reservedNonces(NONCE_RESERVATION_TIMEOUT)
+    , pollScheduler(5s, 3min)
 {
     wallets.setTransactions(this);
 
@@ -64,6 +113,7 @@ Transactions::Transactions(NsLookup &nsLookup, InfrastructureNsLookup &infrastru
     Q_CONNECT(this, &Transactions::getTxs2, this, &Transactions::onGetTxs2);
     Q_CONNECT(this, &Transactions::getTxsFilters, this, &Transactions::onGetTxsFilters);
     Q_CONNECT(this, &Transactions::getTxsAll2, this, &Transactions::onGetTxsAll2);
+    Q_CONNECT(this, &Transactions::getTxsCursor, this, &Transactions::onGetTxsCursor);
     Q_CONNECT(this, &Transactions::getForgingTxs, this, &Transactions::onGetForgingTxs);
     Q_CONNECT(this, &Transactions::getDelegateTxs, this, &Transactions::onGetDelegateTxs);
     Q_CONNECT(this, &Transactions::getDelegateTxs2, this, &Transactions::onGetDelegateTxs2);
@@ -72,7 +122,10 @@ Transactions::Transactions(NsLookup &nsLookup, InfrastructureNsLookup &infrastru
     Q_CONNECT(this, &Transactions::sendTransaction, this, &Transactions::onSendTransaction);
     Q_CONNECT(this, &Transactions::getTxFromServer, this, &Transactions::onGetTxFromServer);
     Q_CONNECT(this, &Transactions::getLastUpdateBalance, this, &Transactions::onGetLastUpdateBalance);
+    Q_CONNECT(this, &Transactions::getBalancePollStats, this, &Transactions::onGetBalancePollStats);
     Q_CONNECT(this, &Transactions::getNonce, this, &Transactions::onGetNonce);
+    Q_CONNECT(this, &Transactions::reserveNonces, this, &Transactions::onReserveNonces);
+    Q_CONNECT(this, &Transactions::sendTransactions, this, &Transactions::onSendTransactions);
     Q_CONNECT(this, &Transactions::getTokensAddress, this, &Transactions::onGetTokensAddress);
     Q_CONNECT(this, &Transactions::clearDb, this, &Transactions::onClearDb);
     Q_CONNECT(this, &Transactions::addCurrencyConformity, this, &Transactions::onAddCurrencyConformity);
@@ -84,13 +137,17 @@ Transactions::Transactions(NsLookup &nsLookup, InfrastructureNsLookup &infrastru
 
     Q_REG(RegisterAddressCallback, "RegisterAddressCallback");
     Q_REG(GetTxsCallback, "GetTxsCallback");
+    Q_REG(GetTxsCursorCallback, "GetTxsCursorCallback");
     Q_REG(CalcBalanceCallback, "CalcBalanceCallback");
     Q_REG(SetCurrentGroupCallback, "SetCurrentGroupCallback");
     Q_REG(GetAddressesCallback, "GetAddressesCallback");
     Q_REG(GetTxCallback, "GetTxCallback");
     Q_REG(GetLastUpdateCallback, "GetLastUpdateCallback");
+    Q_REG(GetBalancePollStatsCallback, "GetBalancePollStatsCallback");
     Q_REG(GetNonceCallback, "GetNonceCallback");
     Q_REG(SendTransactionCallback, "SendTransactionCallback");
+    Q_REG(ReserveNoncesCallback, "ReserveNoncesCallback");
+    Q_REG(SendTransactionsCallback, "SendTransactionsCallback");
     Q_REG(GetTokensCallback, "GetTokensCallback");
     Q_REG(ClearDbCallback, "ClearDbCallback");
     Q_REG(AddCurrencyConformity, "AddCurrencyConformity");
@@ -103,6 +160,7 @@ Transactions::Transactions(NsLookup &nsLookup, InfrastructureNsLookup &infrastru
 
     Q_REG(std::vector<AddressInfo>, "std::vector<AddressInfo>");
     Q_REG(std::vector<IdBalancePair>, "std::vector<IdBalancePair>");
+    Q_REG(std::vector<BatchTransaction>, "std::vector<BatchTransaction>");
 
     QSettings settings(getSettingsPath(), QSettings::IniFormat);
     CHECK(settings.contains("timeouts_sec/transactions"), "settings timeout not found");
@@ -110,6 +168,9 @@ Transactions::Transactions(NsLookup &nsLookup, InfrastructureNsLookup &infrastru
 
     client.setParent(this);
     Q_CONNECT(&client, &SimpleClient::callbackCall, this, &Transactions::callbackCall);
+    client.setResponseObserver([this](const QUrl &url, const SimpleClient::Response &response) {
+        emit nsLookup.serverResponse(url.toString(), response.time, !response.exception.isSet());
+    });
     client.moveToThread(TimerClass::getThread());
 
     Q_CONNECT(&tcpClient, &HttpSimpleClient::callbackCall, this, &Transactions::callbackCall);
@@ -129,6 +190,19 @@ Transactions::Transactions(NsLookup &nsLookup, InfrastructureNsLookup &infrastru
     }
     settings.endArray();
 
+    // "text" or "binary". Stored amounts are rewritten when it is changed
+    db.setAmountsEncoding(settings.value("transactions/amounts_encoding", QStringLiteral("text")).toString() == QStringLiteral("binary"));
+
+    if (settings.value("transactions/db_writer", true).toBool()) {
+        const QString dbPath = db.dbPath();
+        const milliseconds commitInterval(settings.value("transactions/db_commit_interval_ms", qint64(DB_WRITER_COMMIT_INTERVAL.count())).toLongLong());
+        dbWriter = std::make_unique<DBWriter>([dbPath]{
+            auto storage = std::make_unique<TransactionsDBStorage>(dbPath, DB_WRITER_CONNECTION);
+            storage->initConnection();
+            return storage;
+        }, commitInterval, DB_WRITER_MAX_BATCH);
+    }
+
     javascriptWrapper.setTransactions(*this);
 
     moveToThread(TimerClass::getThread()); // TODO вызывать в TimerClass
@@ -136,6 +210,11 @@ Transactions::Transactions(NsLookup &nsLookup, InfrastructureNsLookup &infrastru
 
 Transactions::~Transactions() {
     TimerClass::exit();
+    // Remaining writes are commited. Their callbacks would emit on this object, so they are dropped first
+    if (dbWriter != nullptr) {
+        dbWriter->dropCommitedCallbacks();
+    }
+    dbWriter.reset();
 }
 
 void Transactions::startMethod() {
@@ -150,20 +229,64 @@ uint64_t Transactions::calcCountTxs(const QString &address, const QString &curre
     return static_cast<uint64_t>(db.getPaymentsCountForAddress(address, currency));
 }
 
+void Transactions::writeDb(const QString &currency, const QString &address, const std::function<void(TransactionsDBStorage &db)> &func, const std::function<void()> &commited) {
+    if (dbWriter == nullptr) {
+        func(db);
+        commited();
+        return;
+    }
+
+    const auto key = std::make_pair(currency, address);
+    pendingDbWrites[key]++;
+    dbWriter->write([func](DBStorage &storage) {
+        func(static_cast<TransactionsDBStorage&>(storage));
+    }, [this, key, commited](const TypedException &exception) {
+        emit callbackCall([this, key, commited, exception] {
+            const auto found = pendingDbWrites.find(key);
+            CHECK(found != pendingDbWrites.end(), "Pending db write not found");
+            found->second--;
+            if (found->second == 0) {
+                pendingDbWrites.erase(found);
+            }
+            if (exception.isSet()) {
+                // Saved backfill progress can not be trusted anymore, it is restarted from the db state
+                historyBackfills.erase(key);
+                throwErr("Db write error " + key.second.toStdString() + " " + key.first.toStdString() + ": " + exception.description);
+            }
+            commited();
+        });
+    });
+}
+
+bool Transactions::isDbWritePending(const QString &currency, const QString &address) const {
+    return pendingDbWrites.find(std::make_pair(currency, address)) != pendingDbWrites.end();
+}
+
+void Transactions::flushDb() {
+    if (dbWriter != nullptr) {
+        dbWriter->flush();
+    }
+}
+
 void Transactions::newBalance(const QString &address, const QString &currency, uint64_t savedCountTxs, uint64_t confirmedCountTxsInThisLoop, const BalanceInfo &balance, const BalanceInfo &curBalance, const std::vector<Transaction> &txs, const std::shared_ptr<ServersStruct> &servStruct) {
+    CHECK(!isDbWritePending(currency, address), "Trancastions in db on address " + address.toStdString() + " " + currency.toStdString() + " are being written");
     const uint64_t currCountTxs = calcCountTxs(address, currency);
     CHECK(savedCountTxs == currCountTxs, "Trancastions in db on address " + address.toStdString() + " " + currency.toStdString() + " changed");
-    auto transactionGuard = db.beginTransaction();
-    for (const Transaction &tx: txs) {
-        db.addPayment(tx);
-    }
-    db.setBalance(currency, address, balance);
-    transactionGuard.commit();
+    writeDb(currency, address, [txs, currency, address, balance](TransactionsDBStorage &db) {
+        auto transactionGuard = db.beginTransaction();
+        for (const Transaction &tx: txs) {
+            db.addPayment(tx);
+        }
+        db.setBalance(currency, address, balance);
+        transactionGuard.commit();
+    }, std::bind(&Transactions::newBalanceCommited, this, address, currency, confirmedCountTxsInThisLoop, balance, curBalance, servStruct));
+}
 
+void Transactions::newBalanceCommited(const QString &address, const QString &currency, uint64_t confirmedCountTxsInThisLoop, const BalanceInfo &balance, const BalanceInfo &curBalance, const std::shared_ptr<ServersStruct> &servStruct) {
     BalanceInfo balanceCopy = balance;
     balanceCopy.savedTxs = std::min(confirmedCountTxsInThisLoop, balance.countTxs);
     if (balanceCopy.savedTxs == balance.countTxs) {
-        BigNumber sumch = (balance.received - balance.spent) - (curBalance.received - curBalance.spent);
+        BigNumber256 sumch = (balance.received - balance.spent) - (curBalance.received - curBalance.spent);
         QString value = sumch.getFracDecimal(BNModule);
         // remove '-' if present
         if (value.front() == QChar('-'))
@@ -194,7 +317,7 @@ void Transactions::updateBalanceTime(const QString &currency, const std::shared_
 void Transactions::processPendings() {
     const auto processPendingTx = [this](const SimpleClient::Response &response) {
         CHECK(!response.exception.isSet(), "Server error: " + response.exception.toString());
-        const Transaction tx = parseGetTxResponse(QString::fromStdString(response.response), "", "");
+        const Transaction tx = parseGetTxResponse(response.response, "", "");
         if (tx.status != Transaction::PENDING) {
             const auto foundIter = std::remove_if(pendingTxsAfterSend.begin(), pendingTxsAfterSend.end(), [txHash=tx.tx](const auto &pair){
                 return pair.first == txHash;
@@ -221,11 +344,14 @@ void Transactions::processPendings() {
 void Transactions::processPendings(const QString &address, const QString &currency, const std::vector<Transaction> &txsPending, const std::vector<QString> &serversContract, const std::vector<QString> &serversSimple) {
     const auto processPendingTx = [this, currency, address](const SimpleClient::Response &response) {
         CHECK(!response.exception.isSet(), "Server error: " + response.exception.toString());
-        const Transaction tx = parseGetTxResponse(QString::fromStdString(response.response), address, currency);
+        const Transaction tx = parseGetTxResponse(response.response, address, currency);
         if (tx.status != Transaction::PENDING) {
-            db.updatePayment(address, currency, tx.tx, tx.blockNumber, tx.blockIndex, tx);
-            emit javascriptWrapper.transactionStatusChangedSig(address, currency, tx.tx, tx);
-            emit javascriptWrapper.transactionStatusChanged2Sig(tx.tx, tx);
+            writeDb(currency, address, [address, currency, tx](TransactionsDBStorage &db) {
+                db.updatePayment(address, currency, tx.tx, tx.blockNumber, tx.blockIndex, tx);
+            }, [this, address, currency, tx] {
+                emit javascriptWrapper.transactionStatusChangedSig(address, currency, tx.tx, tx);
+                emit javascriptWrapper.transactionStatusChanged2Sig(tx.tx, tx);
+            });
         }
     };
 
@@ -284,7 +410,7 @@ void Transactions::processAddressMth(const std::vector<QString> &addresses, cons
 
     const auto getBalanceConfirmeCallback = [currency, processNewTransactions](const QString &address, const BalanceInfo &serverBalance, uint64_t savedCountTxs, uint64_t confirmedCountTxsInThisLoop, const std::vector<Transaction> &txs, const QUrl &server, const SimpleClient::Response &response) {
         CHECK(!response.exception.isSet(), "Server error: " + response.exception.toString());
-        const BalanceInfo balance = parseBalanceResponse(QString::fromStdString(response.response));
+        const BalanceInfo balance = parseBalanceResponse(response.response);
         const uint64_t countInServer = balance.countTxs;
         const uint64_t countSave = serverBalance.countTxs;
         if (countInServer - countSave <= ADD_TO_COUNT_TXS) {
@@ -295,7 +421,7 @@ void Transactions::processAddressMth(const std::vector<QString> &addresses, cons
 
     const auto getHistoryCallback = [this, currency, getBalanceConfirmeCallback](const QString &address, const BalanceInfo &serverBalance, uint64_t savedCountTxs, uint64_t confirmedCountTxsInThisLoop, const QUrl &server, const SimpleClient::Response &response) {
         CHECK(!response.exception.isSet(), "Server error: " + response.exception.toString());
-        const std::vector<Transaction> txs = parseHistoryResponse(address, currency, QString::fromStdString(response.response));
+        const std::vector<Transaction> txs = parseHistoryResponse(address, currency, response.response);
 
         LOG << "geted with duplicates " << address << " " << txs.size();
 
@@ -309,18 +435,20 @@ void Transactions::processAddressMth(const std::vector<QString> &addresses, cons
         CHECK(servers.size() == responses.size(), "Incorrect response size");
 
         std::vector<std::pair<QUrl, BalanceInfo>> bestAnswers(addresses.size());
+        std::vector<std::vector<std::pair<QUrl, uint64_t>>> serversCountTxs(addresses.size());
         for (size_t i = 0; i < responses.size(); i++) {
             const auto &r = responses[i];
             const auto &exception = r.exception;
             const std::string &response = r.response;
             const QUrl &server = servers[i];
             if (!exception.isSet()) {
-                const std::vector<BalanceInfo> balancesResponse = parseBalancesResponse(QString::fromStdString(response));
+                const std::vector<BalanceInfo> balancesResponse = parseBalancesResponse(response);
                 CHECK(balancesResponse.size() == addresses.size(), "Incorrect balances response");
                 for (size_t j = 0; j < balancesResponse.size(); j++) {
                     const BalanceInfo &balanceResponse = balancesResponse[j];
                     const QString &address = addresses[j];
                     CHECK(balanceResponse.address == address, "Incorrect response: address not equal. Expected " + address.toStdString() + ". Received " + balanceResponse.address.toStdString());
+                    serversCountTxs[j].emplace_back(server, balanceResponse.countTxs);
                     if (balanceResponse.currBlockNum > bestAnswers[j].second.currBlockNum) {
                         bestAnswers[j].second = balanceResponse;
                         bestAnswers[j].first = server;
@@ -345,12 +473,26 @@ void Transactions::processAddressMth(const std::vector<QString> &addresses, cons
                 return;
             }
 
+            // Db does not show the result of queued writes yet, address is checked on the next loop
+            if (isDbWritePending(currency, address) && historyBackfills.find(std::make_pair(currency, address)) == historyBackfills.end()) {
+                updateBalanceTime(currency, servStruct);
+                continue;
+            }
+
             processTokens(address, bestServer, serverBalance, confirmedBalance);
 
             const uint64_t countAll = calcCountTxs(address, currency);
             const uint64_t countInServer = serverBalance.countTxs;
+            const bool isChanged = countAll != countInServer
+                || confirmedBalance.countTxs != countInServer
+                || confirmedBalance.received != serverBalance.received
+                || confirmedBalance.spent != serverBalance.spent
+                || confirmedBalance.countDelegated != serverBalance.countDelegated;
+            pollScheduler.polled(currency, address, isChanged, ::now());
             LOG << PeriodicLog::make(std::string("t_") + currency[0].toLatin1() + "," + address.right(4).toStdString()) << "Automatic get txs " << address << " " << currency << " " << countAll << " " << countInServer;
-            if (countAll < countInServer) {
+            if (processHistoryBackfill(address, currency, serverBalance, countAll, serversCountTxs[i])) {
+                updateBalanceTime(currency, servStruct);
+            } else if (countAll < countInServer) {
                 processCheckTxsOneServer(address, currency, bestServer);
 
                 const uint64_t countMissingTxs = countInServer - countAll;
@@ -383,7 +525,141 @@ void Transactions::processAddressMth(const std::vector<QString> &addresses, cons
 
     const QString requestBalance = makeGetBalancesRequest(addresses);
     const std::vector<QUrl> urls(servers.begin(), servers.end());
-    client.sendMessagesPost(addresses[0].toStdString(), urls, requestBalance, std::bind(getBalanceCallback, urls, _1), timeout);
+    client.sendMessagesPostHedged(addresses[0].toStdString(), urls, requestBalance, std::bind(getBalanceCallback, urls, _1), timeout, BALANCE_HEDGE_ANSWERS);
+}
+
+bool Transactions::processHistoryBackfill(const QString &address, const QString &currency, const BalanceInfo &serverBalance, uint64_t countAll, const std::vector<std::pair<QUrl, uint64_t>> &serversCountTxs) {
+    const auto key = std::make_pair(currency, address);
+    auto found = historyBackfills.find(key);
+    if (found == historyBackfills.end()) {
+        if (countAll >= serverBalance.countTxs) {
+            return false;
+        }
+        HistoryBackfillInfo info = db.getHistoryBackfill(currency, address);
+        const bool isResume = info.targetTxs != 0 && info.savedTxs < info.targetTxs && info.targetTxs <= serverBalance.countTxs;
+        if (!isResume) {
+            if (serverBalance.countTxs - countAll <= MAX_TXS_IN_RESPONSE) {
+                return false;
+            }
+            info.savedTxs = countAll;
+            info.targetTxs = serverBalance.countTxs;
+            writeDb(currency, address, [address, currency, info](TransactionsDBStorage &db) {
+                db.setHistoryBackfill(currency, address, info);
+            }, []{});
+        }
+        LOG << "Backfill history " << address << " " << currency << " " << info.savedTxs << " " << info.targetTxs << (isResume ? " resumed" : "");
+        const HistoryBackfill plan(info.savedTxs, info.targetTxs, MAX_TXS_IN_RESPONSE, HISTORY_BACKFILL_TARGET_LATENCY);
+        found = historyBackfills.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(++lastHistoryBackfillId, plan)).first;
+    }
+
+    HistoryBackfillState &state = found->second;
+    state.serverBalance = serverBalance;
+    state.servers.clear();
+    for (const auto &pair: serversCountTxs) {
+        if (pair.second >= state.plan.targetTxs()) {
+            state.servers.emplace_back(pair);
+        }
+    }
+    requestHistoryBackfillPages(address, currency);
+    return true;
+}
+
+void Transactions::requestHistoryBackfillPages(const QString &address, const QString &currency) {
+    HistoryBackfillState &state = historyBackfills.at(std::make_pair(currency, address));
+    const uint64_t id = state.id;
+
+    const auto getBalanceConfirmCallback = [this, address, currency, id](const HistoryBackfill::Page &page, uint64_t serverCountTxs, const milliseconds &latency, const std::vector<Transaction> &txs, const SimpleClient::Response &response) {
+        bool isConfirmed = false;
+        if (!response.exception.isSet()) {
+            try {
+                const BalanceInfo balance = parseBalanceResponse(response.response);
+                isConfirmed = balance.countTxs >= serverCountTxs && balance.countTxs - serverCountTxs <= ADD_TO_COUNT_TXS;
+            } catch (const Exception &e) {
+                LOG << "Backfill balance error " << address << ": " << e.message;
+            }
+        }
+        finishHistoryBackfillPage(address, currency, id, page, isConfirmed, latency, txs);
+    };
+
+    const auto getHistoryCallback = [this, address, currency, id, getBalanceConfirmCallback](const HistoryBackfill::Page &page, uint64_t serverCountTxs, const QUrl &server, const SimpleClient::Response &response) {
+        if (!response.exception.isSet()) {
+            try {
+                const std::vector<Transaction> txs = parseHistoryResponse(address, currency, response.response);
+                if (txs.size() >= page.count) {
+                    // Offsets are counted from the newest transaction, so check that they did not shift while page was downloaded
+                    const QString requestBalance = makeGetBalanceRequest(address);
+                    client.sendMessagePost(server, requestBalance, std::bind(getBalanceConfirmCallback, page, serverCountTxs, response.time, txs, _1), timeout);
+                    return;
+                }
+            } catch (const Exception &e) {
+                LOG << "Backfill history error " << address << ": " << e.message;
+            }
+        } else if (response.exception.isTimeout()) {
+            emit nsLookup.rejectServer(server.toString());
+        }
+        finishHistoryBackfillPage(address, currency, id, page, false, milliseconds(0), {});
+    };
+
+    HistoryBackfill::Page page;
+    while (!state.servers.empty() && state.plan.countInFlight() < HISTORY_BACKFILL_PAGES_IN_FLIGHT && state.plan.nextPage(page)) {
+        const auto &server = state.servers[state.nextServer % state.servers.size()];
+        state.nextServer++;
+        const uint64_t beginTx = server.second - page.from - page.count;
+        const QString requestForTxs = makeGetHistoryRequest(address, true, beginTx, page.count + ADD_TO_COUNT_TXS);
+        client.sendMessagePost(server.first, requestForTxs, std::bind(getHistoryCallback, page, server.second, server.first, _1), timeout);
+    }
+}
+
+void Transactions::finishHistoryBackfillPage(const QString &address, const QString &currency, uint64_t id, const HistoryBackfill::Page &page, bool isOk, const milliseconds &latency, const std::vector<Transaction> &txs) {
+    const auto found = historyBackfills.find(std::make_pair(currency, address));
+    if (found == historyBackfills.end() || found->second.id != id) {
+        return;
+    }
+    HistoryBackfillState &state = found->second;
+
+    if (!isOk) {
+        state.plan.pageFailed(page);
+        LOG << PeriodicLog::makeAuto("t_bf") << "Backfill page failed " << address << " " << page.from << " " << page.count << ". Page size " << state.plan.pageSize();
+        requestHistoryBackfillPages(address, currency);
+        return;
+    }
+
+    const uint64_t prevSavedTxs = state.plan.savedTxs();
+    state.plan.pageDone(page, latency);
+
+    // Page and the progress it completes are written together
+    if (state.plan.isFinished()) {
+        LOG << "Backfill history " << address << " " << currency << " finished";
+        const BalanceInfo balance = state.serverBalance;
+        BalanceInfo balanceCopy = balance;
+        balanceCopy.savedTxs = std::min(state.plan.targetTxs(), balanceCopy.countTxs);
+        historyBackfills.erase(found);
+        writeDb(currency, address, [address, currency, txs, balance](TransactionsDBStorage &db) {
+            db.addPayments(txs);
+            db.setBalance(currency, address, balance);
+        }, [this, address, currency, balanceCopy] {
+            emit javascriptWrapper.newBalanceSig(address, currency, balanceCopy);
+        });
+        return;
+    }
+
+    const bool isProgress = state.plan.savedTxs() != prevSavedTxs;
+    HistoryBackfillInfo info;
+    info.targetTxs = state.plan.targetTxs();
+    info.savedTxs = state.plan.savedTxs();
+    BalanceInfo balanceCopy = state.serverBalance;
+    balanceCopy.savedTxs = info.savedTxs;
+    writeDb(currency, address, [address, currency, txs, isProgress, info](TransactionsDBStorage &db) {
+        db.addPayments(txs);
+        if (isProgress) {
+            db.setHistoryBackfill(currency, address, info);
+        }
+    }, [this, address, currency, isProgress, balanceCopy] {
+        if (isProgress) {
+            emit javascriptWrapper.newBalanceSig(address, currency, balanceCopy);
+        }
+    });
+    requestHistoryBackfillPages(address, currency);
 }
 
 void Transactions::processTokens(const QString& address,
@@ -399,7 +675,9 @@ void Transactions::processTokens(const QString& address,
         for (const auto& tokenBalance : tokens) {
             LOG << "TOKEN: " << tokenBalance.tokenAddress;
             updateTokenInfo(tokenBalance.tokenAddress, server);
-            db.updateTokenBalance(tokenBalance);
+            writeDb(QString(), tokenBalance.address, [tokenBalance](TransactionsDBStorage &db) {
+                db.updateTokenBalance(tokenBalance);
+            }, []{});
         }
     };
 
@@ -418,7 +696,9 @@ void Transactions::updateTokenInfo(const QString& tokenAddress, const QUrl& serv
         Token info = parseTokenGetInfoResponse(tokenAddress, QString::fromStdString(response.response));
         //qDebug() << QString::fromStdString(response.response);
         LOG << "Token: " << info.name << info.type;
-        db.updateToken(info);
+        writeDb(QString(), tokenAddress, [info](TransactionsDBStorage &db) {
+            db.updateToken(info);
+        }, []{});
     };
 
     const QString requestTokensInfo = makeTokenGetInfoRequest(tokenAddress);
@@ -456,8 +736,11 @@ void Transactions::processCheckTxsOneServer(const QString &address, const QStrin
 
 void Transactions::removeAddress(const QString &address, const QString &currency) {
     LOG << "Remove txs " << address << " " << currency;
-    db.removePaymentsForDest(address, currency);
-    db.removeBalance(currency, address);
+    historyBackfills.erase(std::make_pair(currency, address));
+    writeDb(currency, address, [address, currency](TransactionsDBStorage &db) {
+        db.removePaymentsForDest(address, currency);
+        db.removeBalance(currency, address);
+    }, []{});
 }
 
 void Transactions::processCheckTxsInternal(const QString &address, const QString &currency, const QUrl &server, const Transaction &tx, int64_t serverBlockNumber) {
@@ -518,97 +801,95 @@ void Transactions::processCheckTxs(const QString &address, const QString &curren
 }
 
 void Transactions::timerMethod() {
-    static const size_t COUNT_PARALLEL_REQUESTS = 15;
-    static const size_t MAXIMUM_ADDRESSES_IN_BATCH = 20;
+    static const size_t MAXIMUM_ADDRESSES_IN_TIMER = 300;
+    static const size_t MAXIMUM_ADDRESSES_IN_BATCH = 100;
 
     const auto CHECK_TXS_PERIOD = 3min;
+    // Tracked addresses are reread after changes made by this class, the period covers changes made elsewhere
+    const auto TRACKED_REFRESH_PERIOD = 1min;
 
+    const time_point now = ::now();
 
-    if (posInAddressInfos >= addressesInfos.size()) {
-        if (!addressesInfos.empty()) {
-            LOG << "All txs getted";
-        }
-        addressesInfos.clear();
+    if (isTrackedChanged || now - trackedReadTime >= TRACKED_REFRESH_PERIOD) {
+        trackedAddresses = getAddressesInfos(makeGroupName(currentUserName));
+        pollScheduler.setAddresses(trackedAddresses, now);
+        isTrackedChanged = false;
+        trackedReadTime = now;
     }
+    const std::vector<AddressInfo> &addressesInfos = trackedAddresses;
 
-    if (addressesInfos.empty()) {
-        addressesInfos = getAddressesInfos(makeGroupName(currentUserName));
-        std::sort(addressesInfos.begin(), addressesInfos.end(), [](const AddressInfo &first, const AddressInfo &second) {
-            return first.currency < second.currency;
-        });
-        posInAddressInfos = 0;
-    }
+    std::vector<std::pair<QString, QString>> dueAddresses = pollScheduler.takeDue(now, MAXIMUM_ADDRESSES_IN_TIMER);
+    std::stable_sort(dueAddresses.begin(), dueAddresses.end(), [](const auto &first, const auto &second) {
+        return first.first < second.first;
+    });
 
-    LOG << PeriodicLog::make("f_bln") << "Try fetch balance " << addressesInfos.size();
+    LOG << PeriodicLog::make("f_bln") << "Try fetch balance " << dueAddresses.size() << " of " << addressesInfos.size();
     QString currentCurrency;
     std::map<QString, std::shared_ptr<ServersStruct>> servStructs;
     std::vector<QString> batch;
-    size_t countParallelRequests = 0;
-
-    const auto processBatch = [this, &batch, &countParallelRequests, &servStructs](const QString &currentCurrency) {
-        if (servStructs.find(currentCurrency) != servStructs.end()) {
-            infrastructureNsLookup.getTorrents(currentCurrency, 3, 3, InfrastructureNsLookup::GetServersCallback([this, batch, currentCurrency, servStruct=servStructs.at(currentCurrency)](const std::vector<QString> &servers) {
-                infrastructureNsLookup.getContractTorrent(currentCurrency, 3, 3, InfrastructureNsLookup::GetServersCallback([this, batch, currentCurrency, serversSimple=servers](const std::vector<QString> &serversContract) {
-                    for (const QString &address: batch) {
-                        const std::vector<Transaction> pendingTxs = db.getPaymentsForAddressPending(address, currentCurrency, true);
-                        processPendings(address, currentCurrency, pendingTxs, serversContract, serversSimple);
-                    }
-                }, [](const TypedException &error) {
-                    LOG << "Error while get servers: " << error.description;
-                }, signalFunc));
+    size_t countBatches = 0;
 
-                if (servers.empty()) {
-                    LOG << PeriodicLog::makeAuto("t_s0") << "Warn: servers empty: " << currentCurrency;
-                    return;
+    const auto processBatch = [this, &batch, &countBatches, &servStructs](const QString &currentCurrency) {
+        if (batch.empty()) {
+            return;
+        }
+        infrastructureNsLookup.getTorrents(currentCurrency, 3, 3, InfrastructureNsLookup::GetServersCallback([this, batch, currentCurrency, servStruct=servStructs.at(currentCurrency)](const std::vector<QString> &servers) {
+            infrastructureNsLookup.getContractTorrent(currentCurrency, 3, 3, InfrastructureNsLookup::GetServersCallback([this, batch, currentCurrency, serversSimple=servers](const std::vector<QString> &serversContract) {
+                for (const QString &address: batch) {
+                    const std::vector<Transaction> pendingTxs = db.getPaymentsForAddressPending(address, currentCurrency, true);
+                    processPendings(address, currentCurrency, pendingTxs, serversContract, serversSimple);
                 }
-                processAddressMth(batch, currentCurrency, servers, servStruct);
             }, [](const TypedException &error) {
                 LOG << "Error while get servers: " << error.description;
             }, signalFunc));
 
-            batch.clear();
-            countParallelRequests++;
-        } else {
-            // В предыдущий раз список серверов оказался пустым, поэтому структуру мы не заполнили. Пропускаем
-        }
+            if (servers.empty()) {
+                LOG << PeriodicLog::makeAuto("t_s0") << "Warn: servers empty: " << currentCurrency;
+                return;
+            }
+            processAddressMth(batch, currentCurrency, servers, servStruct);
+        }, [](const TypedException &error) {
+            LOG << "Error while get servers: " << error.description;
+        }, signalFunc));
+
+        batch.clear();
+        countBatches++;
     };
 
-    const time_point now = ::now();
-    while (posInAddressInfos < addressesInfos.size()) {
-        const AddressInfo &addr = addressesInfos[posInAddressInfos];
-        if ((!currentCurrency.isEmpty() && (addr.currency != currentCurrency)) || batch.size() >= MAXIMUM_ADDRESSES_IN_BATCH) {
+    for (const auto &pair: dueAddresses) {
+        const QString &currency = pair.first;
+        if (currency != currentCurrency || batch.size() >= MAXIMUM_ADDRESSES_IN_BATCH) {
             processBatch(currentCurrency);
-            if (countParallelRequests >= COUNT_PARALLEL_REQUESTS) {
-                break;
-            }
-            currentCurrency = addr.currency;
-        }
-        if (currentCurrency.isEmpty()) {
-            currentCurrency = addr.currency;
+            currentCurrency = currency;
         }
 
-        const auto found = servStructs.find(addr.currency);
+        const auto found = servStructs.find(currency);
         if (found == servStructs.end()) {
-            servStructs.emplace(std::piecewise_construct, std::forward_as_tuple(addr.currency), std::forward_as_tuple(std::make_shared<ServersStruct>(addr.currency)));
+            servStructs.emplace(std::piecewise_construct, std::forward_as_tuple(currency), std::forward_as_tuple(std::make_shared<ServersStruct>(currency)));
         }
-        servStructs.at(addr.currency)->countRequests++; // Не очень хорошо здесь прибавлять по 1, но пофиг
-        if (now - lastCheckTxsTime >= CHECK_TXS_PERIOD) {
+        servStructs.at(currency)->countRequests++; // Не очень хорошо здесь прибавлять по 1, но пофиг
+
+        batch.emplace_back(pair.second);
+    }
+    processBatch(currentCurrency);
+    pollScheduler.addBatches(countBatches);
+
+    // Reorganization check walks all addresses regardless of their poll interval
+    if (now - lastCheckTxsTime >= CHECK_TXS_PERIOD) {
+        const size_t endPos = std::min(posInAddressInfos + MAXIMUM_ADDRESSES_IN_TIMER, addressesInfos.size());
+        for (; posInAddressInfos < endPos; posInAddressInfos++) {
+            const AddressInfo &addr = addressesInfos[posInAddressInfos];
             infrastructureNsLookup.getTorrents(addr.currency, 3, 3, InfrastructureNsLookup::GetServersCallback([this, address=addr.address, currency=addr.currency](const std::vector<QString> &servers) {
                 processCheckTxs(address, currency, servers);
             }, [](const TypedException &error) {
                 LOG << "Error while get servers: " << error.description;
             }, signalFunc));
         }
-
-        batch.emplace_back(addr.address);
-
-        posInAddressInfos++;
-    }
-    processBatch(currentCurrency);
-
-    if (now - lastCheckTxsTime >= CHECK_TXS_PERIOD && posInAddressInfos >= addressesInfos.size()) {
-        LOG << "All txs checked";
-        lastCheckTxsTime = now;
+        if (posInAddressInfos >= addressesInfos.size()) {
+            LOG << "All txs checked";
+            lastCheckTxsTime = now;
+            posInAddressInfos = 0;
+        }
     }
 
     processPendings();
@@ -623,6 +904,7 @@ void Transactions::fetchBalanceAddress(const QString &address) {
 
     LOG << "Found " << addressInfos.size() << " records on adrress " << address;
     for (const AddressInfo &addr: addressInfos) {
+        pollScheduler.wakeUp(addr.currency, addr.address, ::now());
         infrastructureNsLookup.getTorrents(addr.currency, 3, 3, InfrastructureNsLookup::GetServersCallback([this, addr](const std::vector<QString> &servers) {
             if (servers.empty()) {
                 LOG << "Warn: servers empty: " << addr.currency;
@@ -646,6 +928,7 @@ BEGIN_SLOT_WRAPPER
             db.addTracked(address);
         }
         transactionGuard.commit();
+        isTrackedChanged = true;
     }, callback);
 END_SLOT_WRAPPER
 }
@@ -687,6 +970,20 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void Transactions::onGetTxsCursor(const QString &address, const QString &currency, const Filters &filter, const QString &cursor, int count, bool asc, const GetTxsCursorCallback &callback) {
+BEGIN_SLOT_WRAPPER
+    runAndEmitCallback([&, this] {
+        CHECK(count > 0, "Incorrect count");
+        const std::vector<Transaction> txs = db.getPaymentsForAddressCursor(address, convertCurrency(currency), filter, cursorFromString(cursor), count, asc);
+        QString nextCursor;
+        if (txs.size() == static_cast<size_t>(count)) {
+            nextCursor = cursorToString(txs.back());
+        }
+        return std::make_tuple(txs, nextCursor);
+    }, callback);
+END_SLOT_WRAPPER
+}
+
 void Transactions::onGetTxsAll2(const QString &currency, int from, int count, bool asc, const GetTxsCallback &callback) {
 BEGIN_SLOT_WRAPPER
     runAndEmitCallback([&, this] {
@@ -772,7 +1069,7 @@ BEGIN_SLOT_WRAPPER
                 }
                 if (!response.exception.isSet()) {
                     try {
-                        const Transaction tx = parseGetTxResponse(QString::fromStdString(response.response), "", "");
+                        const Transaction tx = parseGetTxResponse(response.response, "", "");
                         emit javascriptWrapper.transactionInTorrentSig(requestId, server, QString::fromStdString(hash), tx, TypedException());
                         if (tx.status == Transaction::Status::PENDING) {
                             pendingTxsAfterSend.emplace_back(tx.tx, serversCopy);
@@ -801,7 +1098,18 @@ BEGIN_SLOT_WRAPPER
             iter++;
         }
     }
-    if (sendTxWathcers.empty()) {
+
+    for (auto iter = sendBatches.begin(); iter != sendBatches.end();) {
+        const bool isFinished = processSendBatch(iter->first, iter->second, now);
+        emitBatchProgress(iter->first, iter->second, isFinished);
+        if (isFinished) {
+            iter = sendBatches.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+
+    if (sendTxWathcers.empty() && sendBatches.empty()) {
         LOG << "SendTxWatchers timer send stop";
         timerSendTx.stop();
     }
@@ -822,6 +1130,7 @@ void Transactions::addTrackedForCurrentLogin() {
             return;
         }
 
+        flushDb();
         auto transactionGuard = db.beginTransaction();
         for (const QString &currency: found->second) {
             db.removeTrackedForGroup(currency, makeGroupName(currentUserName));
@@ -830,6 +1139,7 @@ void Transactions::addTrackedForCurrentLogin() {
             }
         }
         transactionGuard.commit();
+        isTrackedChanged = true;
     };
 
     emit wallets.getListWallets2(wallets::WalletCurrency::Mth, currentUserName, wallets::Wallets::WalletsListCallback([processWallets](const QString &userName, const std::vector<wallets::WalletInfo> &walletAddresses) {
@@ -852,6 +1162,7 @@ BEGIN_SLOT_WRAPPER
     }
     isUserNameSetted = true;
     currentUserName = login;
+    isTrackedChanged = true;
     addTrackedForCurrentLogin();
 END_SLOT_WRAPPER
 }
@@ -863,9 +1174,11 @@ BEGIN_SLOT_WRAPPER
     if (found == currencyList.end()) {
         return;
     }
+    flushDb();
     for (const QString &currency: found->second) {
         db.addTracked(currency, address, makeGroupName(userName));
     }
+    isTrackedChanged = true;
 END_SLOT_WRAPPER
 }
 
@@ -876,11 +1189,13 @@ BEGIN_SLOT_WRAPPER
     if (found == currencyList.end()) {
         return;
     }
+    flushDb();
     for (const QString &currency: found->second) {
         for (const auto &pair: created) {
             db.addTracked(currency, pair.first, makeGroupName(username));
         }
     }
+    isTrackedChanged = true;
 END_SLOT_WRAPPER
 }
 
@@ -946,6 +1261,163 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void Transactions::onSendTransactions(const QString &requestId, const QString &from, const std::vector<BatchTransaction> &txs, const SendParameters &sendParams, const SendTransactionsCallback &callback) {
+BEGIN_SLOT_WRAPPER
+    runAndEmitErrorCallback([&, this] {
+        CHECK_TYPED(!txs.empty(), TypeErrors::INCORRECT_USER_DATA, "Empty transactions batch");
+        CHECK_TYPED(sendBatches.find(requestId) == sendBatches.end(), TypeErrors::INCORRECT_USER_DATA, "Batch already sending " + requestId.toStdString());
+
+        // Servers are chosen once for the whole batch
+        const auto sendBatch = [this, requestId, from, txs, sendParams, callback](const std::vector<QString> &serversSend) {
+            CHECK_TYPED(!serversSend.empty(), TypeErrors::TRANSACTIONS_SERVER_NOT_FOUND, "Not enough servers send");
+
+            const auto startBatch = [this, requestId, from, txs, sendParams, serversSend, callback](const std::vector<QString> &serversGet) {
+                CHECK_TYPED(!serversGet.empty(), TypeErrors::TRANSACTIONS_SERVER_NOT_FOUND, "Not enough servers get");
+                CHECK_TYPED(sendBatches.find(requestId) == sendBatches.end(), TypeErrors::INCORRECT_USER_DATA, "Batch already sending " + requestId.toStdString());
+
+                sendBatches.emplace(std::piecewise_construct, std::forward_as_tuple(requestId), std::forward_as_tuple(from, sendParams, serversSend, serversGet, SendBatchState(txs, serversSend.size(), BATCH_SEND_WINDOW, BATCH_CHECK_WINDOW, BATCH_CHECK_PERIOD, sendParams.timeout, ::now())));
+                LOG << "Send batch " << requestId << " " << from << " " << txs.size() << " " << serversSend.size() << " " << serversGet.size();
+                continueSendBatch(requestId);
+                timerSendTx.start();
+
+                callback.emitCallback();
+            };
+
+            if (!sendParams.currency.isEmpty()) {
+                infrastructureNsLookup.getTorrents(sendParams.currency, sendParams.countServersGet, sendParams.countServersGet, InfrastructureNsLookup::GetServersCallback(startBatch, callback, signalFunc));
+            } else {
+                nsLookup.getRandomServers(sendParams.typeGet, sendParams.countServersGet, sendParams.countServersGet, NsLookup::GetServersCallback(startBatch, callback, signalFunc)); // deprecated
+            }
+        };
+
+        if (!sendParams.currency.isEmpty()) {
+            infrastructureNsLookup.getProxy(sendParams.currency, sendParams.countServersSend, sendParams.countServersSend, InfrastructureNsLookup::GetServersCallback(sendBatch, callback, signalFunc));
+        } else {
+            nsLookup.getRandomServers(sendParams.typeSend, sendParams.countServersSend, sendParams.countServersSend, NsLookup::GetServersCallback(sendBatch, callback, signalFunc)); // deprecated
+        }
+    }, callback);
+END_SLOT_WRAPPER
+}
+
+void Transactions::continueSendBatch(const QString &requestId) {
+    const auto found = sendBatches.find(requestId);
+    if (found == sendBatches.end()) {
+        return;
+    }
+    SendBatch &batch = found->second;
+
+    for (const size_t index: batch.state.takeToSend()) {
+        const BatchTransaction &tx = batch.state.getTx(index).tx;
+        const QString request = makeSendTransactionRequest(tx.to, tx.value, tx.nonce, tx.data, tx.fee, tx.pubkey, tx.sign);
+        for (const QString &server: batch.serversSend) {
+            tcpClient.sendMessagePost(server, request, [this, server, requestId, index](const std::string &response, const TypedException &error) {
+                QString result;
+                const TypedException exception = apiVrapper2([&] {
+                    if (error.isSet()) {
+                        nsLookup.rejectServer(server);
+                    }
+                    CHECK_TYPED(!error.isSet(), TypeErrors::TRANSACTIONS_SERVER_SEND_ERROR, error.description + ". " + server.toStdString());
+                    result = parseSendTransactionResponse(QString::fromStdString(response));
+                });
+                finishSendBatchTx(requestId, index, result, exception);
+            }, timeout);
+        }
+    }
+}
+
+void Transactions::finishSendBatchTx(const QString &requestId, size_t index, const QString &hash, const TypedException &exception) {
+    const auto found = sendBatches.find(requestId);
+    if (found == sendBatches.end()) {
+        return;
+    }
+    SendBatch &batch = found->second;
+
+    batch.state.sendAnswered(index, !exception.isSet(), hash, QString::fromStdString(exception.description), ::now());
+    continueSendBatch(requestId);
+}
+
+void Transactions::finishCheckBatchTx(const QString &requestId, size_t index, const SimpleClient::Response &response) {
+    const auto found = sendBatches.find(requestId);
+    if (found == sendBatches.end()) {
+        return;
+    }
+    SendBatch &batch = found->second;
+
+    if (!batch.state.checkAnswered(index, ::now())) {
+        return;
+    }
+    if (response.exception.isSet()) {
+        return;
+    }
+
+    Transaction txResponse;
+    try {
+        txResponse = parseGetTxResponse(response.response, "", "");
+    } catch (const Exception &e) {
+        // Not on torrent yet
+        return;
+    } catch (...) {
+        return;
+    }
+
+    if (!batch.isBalanceFetched) {
+        batch.isBalanceFetched = true;
+        fetchBalanceAddress(batch.from);
+    }
+
+    batch.state.checkFound(index, txResponse.status);
+}
+
+bool Transactions::processSendBatch(const QString &requestId, SendBatch &batch, const time_point &now) {
+    std::vector<size_t> pendingAfterTimeout;
+    const bool isFinished = batch.state.checkFinished(now, pendingAfterTimeout);
+    for (const size_t index: pendingAfterTimeout) {
+        // Final status comes with transactionStatusChanged2Sig
+        pendingTxsAfterSend.emplace_back(batch.state.getTx(index).hash, std::set<QString>(batch.serversGet.begin(), batch.serversGet.end()));
+    }
+
+    if (!isFinished) {
+        for (const size_t index: batch.state.takeToCheck(now)) {
+            // One server per check, servers are rotated between checks
+            const QString &server = batch.serversGet[batch.nextServerGet % batch.serversGet.size()];
+            batch.nextServerGet++;
+            client.sendMessagePost(server, makeGetTxRequest(batch.state.getTx(index).hash), [this, requestId, index](const SimpleClient::Response &response) {
+                finishCheckBatchTx(requestId, index, response);
+            }, timeout);
+        }
+        return false;
+    }
+
+    size_t failedNonce = 0;
+    const bool isFailed = batch.state.getFailedNonce(failedNonce);
+    if (isFailed) {
+        // Nonces from the failed transaction are free again
+        reservedNonces.release(batch.from, failedNonce);
+    }
+    LOG << "Send batch finished " << requestId << " " << isFailed;
+    return true;
+}
+
+void Transactions::emitBatchProgress(const QString &requestId, SendBatch &batch, bool isFinished) {
+    if (!batch.state.isChanged() && !isFinished) {
+        return;
+    }
+    emit javascriptWrapper.transactionsBatchProgressSig(requestId, batch.state.takeProgress(isFinished));
+}
+
+void Transactions::onReserveNonces(const QString &from, size_t count, const SendParameters &sendParams, const ReserveNoncesCallback &callback) {
+BEGIN_SLOT_WRAPPER
+    runAndEmitErrorCallback([&, this]{
+        CHECK_TYPED(count != 0, TypeErrors::INCORRECT_USER_DATA, "Incorrect count nonces");
+        onGetNonce(from, sendParams, GetNonceCallback([this, from, count, callback](size_t nonce, const QString &serverError) {
+            const size_t firstNonce = reservedNonces.reserve(from, nonce, count, ::now());
+            LOG << "Nonces reserved " << from << " " << firstNonce << " " << count;
+            callback.emitCallback(firstNonce, serverError);
+        }, callback, signalFunc));
+    }, callback);
+END_SLOT_WRAPPER
+}
+
 void Transactions::onGetNonce(const QString &from, const SendParameters &sendParams, const GetNonceCallback &callback) {
 BEGIN_SLOT_WRAPPER
     runAndEmitErrorCallback([&, this]{
@@ -970,7 +1442,7 @@ BEGIN_SLOT_WRAPPER
                 nonceStruct->count--;
 
                 if (!response.exception.isSet()) {
-                    const BalanceInfo balanceResponse = parseBalanceResponse(QString::fromStdString(response.response));
+                    const BalanceInfo balanceResponse = parseBalanceResponse(response.response);
                     nonceStruct->isSet = true;
                     nonceStruct->nonce = std::max(nonceStruct->nonce, balanceResponse.countSpent);
                 } else {
@@ -1015,7 +1487,7 @@ BEGIN_SLOT_WRAPPER
                 Transaction tx;
                 const TypedException exception = apiVrapper2([&] {
                     CHECK_TYPED(!response.exception.isSet(), TypeErrors::CLIENT_ERROR, response.exception.description);
-                    tx = parseGetTxResponse(QString::fromStdString(response.response), "", "");
+                    tx = parseGetTxResponse(response.response, "", "");
                 });
                 callback.emitFunc(exception, tx);
             }, timeout);
@@ -1040,6 +1512,14 @@ void Transactions::onGetLastUpdateBalance(const QString& currency, const GetLast
     END_SLOT_WRAPPER
 }
 
+void Transactions::onGetBalancePollStats(const GetBalancePollStatsCallback &callback) {
+BEGIN_SLOT_WRAPPER
+    runAndEmitCallback([&, this] {
+        return pollScheduler.getStats(::now());
+    }, callback);
+END_SLOT_WRAPPER
+}
+
 void Transactions::onGetTokensAddress(const QString& address, const GetTokensCallback& callback)
 {
     BEGIN_SLOT_WRAPPER
@@ -1062,6 +1542,7 @@ BEGIN_SLOT_WRAPPER
                 db.addTracked(currency, wallet.address, makeGroupName(currentUserName));
             }
             transactionGuard.commit();
+            isTrackedChanged = true;
 
             callback.emitCallback();
         };
@@ -1096,7 +1577,7 @@ BEGIN_SLOT_WRAPPER
 
         } else {
             const std::string &resp = response.response;
-            const std::map<QString, BalanceInfo> infos = parseBalancesResponseToMap(QString::fromStdString(resp));
+            const std::map<QString, BalanceInfo> infos = parseBalancesResponseToMap(resp);
             CHECK(infos.size() == addresses.size(), "Incorrect balances response");
 
             std::transform(addresses.begin(), addresses.end(), std::back_inserter(res), [infos](const auto &pair) {
@@ -1121,7 +1602,16 @@ END_SLOT_WRAPPER
 void Transactions::onClearDb(const QString &currency, const ClearDbCallback &callback) {
 BEGIN_SLOT_WRAPPER
     runAndEmitCallback([&, this] {
+        flushDb();
         db.removePaymentsForCurrency(currency);
+        isTrackedChanged = true;
+        for (auto iter = historyBackfills.begin(); iter != historyBackfills.end();) {
+            if (currency.isEmpty() || iter->first.first == currency) {
+                iter = historyBackfills.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
         nsLookup.resetFile();
     }, callback);
 END_SLOT_WRAPPER
@@ -5,6 +5,7 @@
 #include <QString>
 
 #include <functional>
+#include <memory>
 #include <vector>
 #include <map>
 #include <set>
@@ -18,6 +19,9 @@
 
 #include "Transaction.h"
 #include "TransactionsFilter.h"
+#include "HistoryBackfill.h"
+#include "BalancePollScheduler.h"
+#include "SendBatchState.h"
 
 class NsLookup;
 class InfrastructureNsLookup;
@@ -26,6 +30,8 @@ struct TypedException;
 
 class MainWindow;
 
+class DBWriter;
+
 namespace wallets {
 class Wallets;
 }
@@ -118,6 +124,27 @@ private:
         std::map<QString, QString> errors;
     };
 
+    // Transactions of one batch send with their confirmations. Replaces SendedTransactionWatcher per transaction
+    struct SendBatch {
+        const QString from;
+        const SendParameters sendParams;
+        const std::vector<QString> serversSend;
+        const std::vector<QString> serversGet;
+
+        SendBatchState state;
+
+        size_t nextServerGet = 0;
+        bool isBalanceFetched = false;
+
+        SendBatch(const QString &from, const SendParameters &sendParams, const std::vector<QString> &serversSend, const std::vector<QString> &serversGet, const SendBatchState &state)
+            : from(from)
+            , sendParams(sendParams)
+            , serversSend(serversSend)
+            , serversGet(serversGet)
+            , state(state)
+        {}
+    };
+
     struct ServersStruct {
         int countRequests = 0;
         QString currency;
@@ -127,12 +154,28 @@ private:
         {}
     };
 
+    struct HistoryBackfillState {
+        const uint64_t id;
+        HistoryBackfill plan;
+        BalanceInfo serverBalance;
+        // Servers with count of address txs on them, needed to convert positions to history offsets
+        std::vector<std::pair<QUrl, uint64_t>> servers;
+        size_t nextServer = 0;
+
+        HistoryBackfillState(uint64_t id, const HistoryBackfill &plan)
+            : id(id)
+            , plan(plan)
+        {}
+    };
+
 public:
 
     using RegisterAddressCallback = CallbackWrapper<void()>;
 
     using GetTxsCallback = CallbackWrapper<void(const std::vector<Transaction> &txs)>;
 
+    using GetTxsCursorCallback = CallbackWrapper<void(const std::vector<Transaction> &txs, const QString &nextCursor)>;
+
     using CalcBalanceCallback = CallbackWrapper<void(const BalanceInfo &txs)>;
 
     using SetCurrentGroupCallback = CallbackWrapper<void()>;
@@ -143,10 +186,16 @@ public:
 
     using GetLastUpdateCallback = CallbackWrapper<void(const system_time_point &lastUpdate, const system_time_point &now)>;
 
+    using GetBalancePollStatsCallback = CallbackWrapper<void(const BalancePollScheduler::Stats &stats)>;
+
     using GetNonceCallback = CallbackWrapper<void(size_t nonce, const QString &serverError)>;
 
     using SendTransactionCallback = CallbackWrapper<void()>;
 
+    using ReserveNoncesCallback = CallbackWrapper<void(size_t firstNonce, const QString &serverError)>;
+
+    using SendTransactionsCallback = CallbackWrapper<void()>;
+
     using GetTokensCallback = CallbackWrapper<void(const std::vector<TokenInfo>& tokens)>;
 
     using ClearDbCallback = CallbackWrapper<void()>;
@@ -186,6 +235,8 @@ signals:
 
     void getTxsAll2(const QString &currency, int from, int count, bool asc, const GetTxsCallback &callback);
 
+    void getTxsCursor(const QString &address, const QString &currency, const Filters &filter, const QString &cursor, int count, bool asc, const GetTxsCursorCallback &callback);
+
     void getForgingTxs(const QString &address, const QString &currency, int from, int count, bool asc, const GetTxsCallback &callback);
 
     void getDelegateTxs(const QString &address, const QString &currency, const QString &to, int from, int count, bool asc, const GetTxsCallback &callback);
@@ -200,10 +251,18 @@ signals:
 
     void sendTransaction(const QString &requestId, const QString &to, const QString &value, size_t nonce, const QString &data, const QString &fee, const QString &pubkey, const QString &sign, const SendParameters &sendParams, const SendTransactionCallback &callback);
 
+    // Server nonce or the nonce after the previous reservation for this address, whichever is bigger
+    void reserveNonces(const QString &from, size_t count, const SendParameters &sendParams, const ReserveNoncesCallback &callback);
+
+    // Progress goes to TransactionsJavascript::transactionsBatchProgressSig
+    void sendTransactions(const QString &requestId, const QString &from, const std::vector<BatchTransaction> &txs, const SendParameters &sendParams, const SendTransactionsCallback &callback);
+
     void getTxFromServer(const QString &txHash, const QString &type, const GetTxCallback &callback);
 
     void getLastUpdateBalance(const QString& currency, const GetLastUpdateCallback& callback);
 
+    void getBalancePollStats(const GetBalancePollStatsCallback &callback);
+
     void getTokensAddress(const QString& address, const GetTokensCallback& callback);
 
     void clearDb(const QString& currency, const ClearDbCallback& callback);
@@ -226,6 +285,8 @@ public slots:
 
     void onGetTxsAll2(const QString &currency, int from, int count, bool asc, const GetTxsCallback &callback);
 
+    void onGetTxsCursor(const QString &address, const QString &currency, const Filters &filter, const QString &cursor, int count, bool asc, const GetTxsCursorCallback &callback);
+
     void onGetForgingTxs(const QString &address, const QString &currency, int from, int count, bool asc, const GetTxsCallback &callback);
 
     void onGetDelegateTxs(const QString &address, const QString &currency, const QString &to, int from, int count, bool asc, const GetTxsCallback &callback);
@@ -240,10 +301,16 @@ public slots:
 
     void onSendTransaction(const QString &requestId, const QString &to, const QString &value, size_t nonce, const QString &data, const QString &fee, const QString &pubkey, const QString &sign, const SendParameters &sendParams, const SendTransactionCallback &callback);
 
+    void onReserveNonces(const QString &from, size_t count, const SendParameters &sendParams, const ReserveNoncesCallback &callback);
+
+    void onSendTransactions(const QString &requestId, const QString &from, const std::vector<BatchTransaction> &txs, const SendParameters &sendParams, const SendTransactionsCallback &callback);
+
     void onGetTxFromServer(const QString &txHash, const QString &type, const GetTxCallback &callback);
 
     void onGetLastUpdateBalance(const QString& currency, const GetLastUpdateCallback& callback);
 
+    void onGetBalancePollStats(const GetBalancePollStatsCallback &callback);
+
     void onGetTokensAddress(const QString& address, const GetTokensCallback& callback);
 
     void onClearDb(const QString& currency, const ClearDbCallback& callback);
@@ -275,6 +342,12 @@ private:
         const std::vector<QString>& servers,
         const std::shared_ptr<ServersStruct>& servStruct);
 
+    bool processHistoryBackfill(const QString &address, const QString &currency, const BalanceInfo &serverBalance, uint64_t countAll, const std::vector<std::pair<QUrl, uint64_t>> &serversCountTxs);
+
+    void requestHistoryBackfillPages(const QString &address, const QString &currency);
+
+    void finishHistoryBackfillPage(const QString &address, const QString &currency, uint64_t id, const HistoryBackfill::Page &page, bool isOk, const milliseconds &latency, const std::vector<Transaction> &txs);
+
     void processTokens(const QString& address,
         const QUrl& server,
         const BalanceInfo& serverBalance,
@@ -289,8 +362,19 @@ private:
 
     uint64_t calcCountTxs(const QString &address, const QString &currency) const;
 
+    // Runs func on the db writer thread, commited is called on this thread after the commit.
+    // Without db writer both run immediately
+    void writeDb(const QString &currency, const QString &address, const std::function<void(TransactionsDBStorage &db)> &func, const std::function<void()> &commited);
+
+    bool isDbWritePending(const QString &currency, const QString &address) const;
+
+    // Blocks until queued writes are commited. For rare user actions that write through db directly
+    void flushDb();
+
     void newBalance(const QString &address, const QString &currency, uint64_t savedCountTxs, uint64_t confirmedCountTxsInThisLoop, const BalanceInfo &balance, const BalanceInfo &curBalance, const std::vector<Transaction> &txs, const std::shared_ptr<ServersStruct> &servStruct);
 
+    void newBalanceCommited(const QString &address, const QString &currency, uint64_t confirmedCountTxsInThisLoop, const BalanceInfo &balance, const BalanceInfo &curBalance, const std::shared_ptr<ServersStruct> &servStruct);
+
     void updateBalanceTime(const QString &currency, const std::shared_ptr<ServersStruct> &servStruct);
 
     std::vector<AddressInfo> getAddressesInfos(const QString &group);
@@ -301,6 +385,17 @@ private:
 
     void sendErrorGetTx(const QString &requestId, const TransactionHash &hash, const QString &server);
 
+    void continueSendBatch(const QString &requestId);
+
+    void finishSendBatchTx(const QString &requestId, size_t index, const QString &hash, const TypedException &exception);
+
+    void finishCheckBatchTx(const QString &requestId, size_t index, const SimpleClient::Response &response);
+
+    // Returns true when all transactions of the batch are in final status
+    bool processSendBatch(const QString &requestId, SendBatch &batch, const time_point &now);
+
+    void emitBatchProgress(const QString &requestId, SendBatch &batch, bool isFinished);
+
     void fetchBalanceAddress(const QString &address);
 
     void removeAddress(const QString &address, const QString &currency);
@@ -333,6 +428,11 @@ private:
 
     std::map<TransactionHash, SendedTransactionWatcher> sendTxWathcers;
 
+    // Key is requestId
+    std::map<QString, SendBatch> sendBatches;
+
+    NonceReservations reservedNonces;
+
     std::map<QString, system_time_point> lastSuccessUpdateTimestamps;
 
     std::vector<std::pair<QString, std::set<QString>>> pendingTxsAfterSend;
@@ -341,9 +441,27 @@ private:
 
     time_point lastCheckTxsTime;
 
-    std::vector<AddressInfo> addressesInfos;
+    // Position of reorganization check in tracked addresses
+    size_t posInAddressInfos = 0;
+
+    BalancePollScheduler pollScheduler;
+
+    // Tracked addresses of current group used by timerMethod. Reread from db when isTrackedChanged is set or by period
+    std::vector<AddressInfo> trackedAddresses;
+
+    bool isTrackedChanged = true;
+
+    time_point trackedReadTime;
+
+    // Key is currency and address
+    std::map<std::pair<QString, QString>, HistoryBackfillState> historyBackfills;
+
+    uint64_t lastHistoryBackfillId = 0;
+
+    // Count of queued and not yet commited writes. Key is currency and address
+    std::map<std::pair<QString, QString>, size_t> pendingDbWrites;
 
-    size_t posInAddressInfos;
+    std::unique_ptr<DBWriter> dbWriter;
 };
 
 SendParameters parseSendParams(const QString &paramsJson);
@@ -7,7 +7,11 @@ namespace transactions {
 
 static const QString databaseName = "payments";
 static const QString databaseFileName = "payments.db";
-static const int databaseVersion = 8;
+static const int databaseVersion = 14;
+
+static const QString settingsAmountsEncoding = "amountsEncoding";
+static const QString amountsEncodingText = "text";
+static const QString amountsEncodingBinary = "binary";
 
 static const QString createPaymentsTable = "CREATE TABLE payments ( "
                                                 "id INTEGER PRIMARY KEY NOT NULL, "
@@ -29,6 +33,7 @@ static const QString createPaymentsTable = "CREATE TABLE payments ( "
                                                 "blockHash TEXT NOT NULL DEFAULT '', "
                                                 "type INTEGER DEFAULT 0, "
                                                 "intStatus INTEGER DEFAULT 0, "
+                                                "flags INTEGER NOT NULL DEFAULT 0, "
                                                 "status INT8 "
                                                 ")";
 
@@ -52,19 +57,38 @@ static const QString createBalanceTable = "CREATE TABLE balance ( "
                                           "undelegated TEXT NOT NULL, "
                                           "reserved TEXT NOT NULL, "
                                           "forged TEXT NOT NULL, "
-                                          "tokenBlockNum INT8 NOT NULL DEFAULT 0"
+                                          "tokenBlockNum INT8 NOT NULL DEFAULT 0, "
+                                          "backfillTarget INT8 NOT NULL DEFAULT 0, "
+                                          "backfillSaved INT8 NOT NULL DEFAULT 0"
                                           ")";
 
+// Maintained by TransactionsDBStorage on every insert, status update and delete of payments
+// received and spent are sums of values of confirmed payments to and from the address
+static const QString createPaymentsStatTable = "CREATE TABLE paymentsStat ( "
+                                               "id INTEGER PRIMARY KEY NOT NULL, "
+                                               "currency VARCHAR(100) NOT NULL, "
+                                               "address TEXT NOT NULL, "
+                                               "countTxs INT8 NOT NULL DEFAULT 0, "
+                                               "countPending INT8 NOT NULL DEFAULT 0, "
+                                               "received BLOB NOT NULL DEFAULT '0', "
+                                               "spent BLOB NOT NULL DEFAULT '0' "
+                                               ")";
+
+static const QString createPaymentsStatUniqueIndex = "CREATE UNIQUE INDEX paymentsStatUniqueIdx ON paymentsStat ( "
+                                                     "address ASC, currency ASC) ";
+
 static const QString createBalanceUniqueIndex = "CREATE UNIQUE INDEX balanceUniqueIdx ON balance ( "
                                                     "currency ASC, address ASC) ";
 
-static const QString createPaymentsIndex1 = "CREATE INDEX paymentsIdx1 ON payments(address, currency, txid, blockNumber, ind)";
-static const QString createPaymentsIndex2 = "CREATE INDEX paymentsIdx2 ON payments(address, currency, ts, txid)";
+// Chosen by EXPLAIN QUERY PLAN over the payments selects below:
+// paymentsUniqueIdx serves update and count, paymentsIdx10 serves history, cursor pages and pending,
+// paymentsIdx3 serves history for currency, paymentsIdx5 serves last forging, paymentsIdx8 serves last transaction.
+// id in paymentsIdx10 keeps index order equal to ORDER BY ts, txid, id of the cursor select.
+// flags is the last column, so it is not a seek key: the mask is checked on each index entry
+// of the (address, currency) range scan
+static const QString createPaymentsIndex10 = "CREATE INDEX paymentsIdx10 ON payments(address, currency, ts, txid, id, flags)";
 static const QString createPaymentsIndex3 = "CREATE INDEX paymentsIdx3 ON payments(currency, ts, txid)";
-static const QString createPaymentsIndex4 = "CREATE INDEX paymentsIdx4 ON payments(address, currency, status, ts, txid)";
 static const QString createPaymentsIndex5 = "CREATE INDEX paymentsIdx5 ON payments(address, currency, type, ts, txid)";
-static const QString createPaymentsIndex6 = "CREATE INDEX paymentsIdx6 ON payments(address, currency, ufrom, uto, type, status, ts, txid)";
-static const QString createPaymentsIndex7 = "CREATE INDEX paymentsIdx7 ON payments(address, currency, ufrom, type, status, ts, txid)";
 static const QString createPaymentsIndex8 = "CREATE INDEX paymentsIdx8 ON payments(address, currency, blockNumber)";
 
 static const QString createBalanceIndex1 = "CREATE INDEX balanceIdx1 ON balance(address, currency)";
@@ -118,18 +142,50 @@ static const QString deleteBalance = "DELETE FROM balance WHERE address = :addre
 static const QString insertBalance = "INSERT OR IGNORE INTO balance (currency, address, received, spent, countReceived, countSpent, countTxs, currBlockNum, countDelegated, delegate, undelegate, delegated, undelegated, reserved, forged, tokenBlockNum) "
                                      "VALUES (:currency, :address, :received, :spent, :countReceived, :countSpent, :countTxs, :currBlockNum, :countDelegated, :delegate, :undelegate, :delegated, :undelegated, :reserved, :forged, :tokenBlockNum)";
 
-static const QString insertPayment = "INSERT OR IGNORE INTO payments (currency, txid, address, ind, ufrom, uto, value, ts, data, fee, nonce, isDelegate, delegateValue, delegateHash, status, type, blockNumber, blockHash, intStatus) "
-                                        "VALUES (:currency, :txid, :address, :ind, :ufrom, :uto, :value, :ts, :data, :fee, :nonce, :isDelegate, :delegateValue, :delegateHash, :status, :type, :blockNumber, :blockHash, :intStatus)";
+static const QString insertPayment = "INSERT OR IGNORE INTO payments (currency, txid, address, ind, ufrom, uto, value, ts, data, fee, nonce, isDelegate, delegateValue, delegateHash, status, type, blockNumber, blockHash, intStatus, flags) "
+                                        "VALUES (:currency, :txid, :address, :ind, :ufrom, :uto, :value, :ts, :data, :fee, :nonce, :isDelegate, :delegateValue, :delegateHash, :status, :type, :blockNumber, :blockHash, :intStatus, :flags)";
+
+static const QString insertPaymentsBulk = "INSERT OR IGNORE INTO payments (currency, txid, address, ind, ufrom, uto, value, ts, data, fee, nonce, isDelegate, delegateValue, delegateHash, status, type, blockNumber, blockHash, intStatus, flags) "
+                                            "VALUES %1";
+
+static const QString insertPaymentsBulkRow = "(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+
+static const int insertPaymentsBulkColumns = 20;
+// 20 * 49 fits in default SQLITE_MAX_VARIABLE_NUMBER (999)
+static const int insertPaymentsBulkRows = 49;
 
 static const QString selectBalance = "SELECT * FROM balance "
                                                     "WHERE address = :address AND  currency = :currency ";
 
+static const QString updateBalanceBackfill = "UPDATE balance SET backfillTarget = :backfillTarget, backfillSaved = :backfillSaved "
+                                                    "WHERE address = :address AND  currency = :currency ";
+
+static const QString resetBalanceBackfill = "UPDATE balance SET backfillTarget = 0, backfillSaved = 0 %1";
+
+// Filters are compiled to a mask over the flags column, so the text of the select does not depend on them
 static const QString selectPaymentsForDestFilter = "SELECT * FROM payments "
                                                     "WHERE address = :address AND  currency = :currency "
-                                                    "%filter% "
+                                                    "AND (flags & :flagsMask) = :flagsValue "
+                                                    "ORDER BY ts %1, txid %1 "
+                                                    "LIMIT :count OFFSET :offset";
+
+static const QString selectPaymentsForDestCursor = "SELECT * FROM payments "
+                                                    "WHERE address = :address AND  currency = :currency "
+                                                    "AND (flags & :flagsMask) = :flagsValue "
+                                                    "%cursor% "
+                                                    "ORDER BY ts %1, txid %1, id %1 "
+                                                    "LIMIT :count";
+
+static const QString selectPaymentsForDestFilterTo = "SELECT * FROM payments "
+                                                    "WHERE address = :address AND  currency = :currency "
+                                                    "AND (flags & :flagsMask) = :flagsValue AND uto = :to "
                                                     "ORDER BY ts %1, txid %1 "
                                                     "LIMIT :count OFFSET :offset";
 
+static const QString paymentsCursorAsc = "AND (ts, txid, id) > (:cursorTs, :cursorTxid, :cursorId) ";
+
+static const QString paymentsCursorDesc = "AND (ts, txid, id) < (:cursorTs, :cursorTxid, :cursorId) ";
+
 static const QString selectPaymentsForCurrency = "SELECT * FROM payments "
                                                     "WHERE currency = :currency "
                                                     "AND address in (SELECT address FROM tracked WHERE currency = :currency AND tgroup = :tgroup)"
@@ -157,15 +213,47 @@ static const QString updatePaymentForAddress = "UPDATE payments "
                                                     "    value = :value, ts = :ts, data = :data, fee = :fee, nonce = :nonce, "
                                                     "    isDelegate = :isDelegate, "
                                                     "    delegateValue = :delegateValue, delegateHash = :delegateHash, "
-                                                    "    status = :status, type = :type, blockHash = :blockHash, intStatus = :intStatus "
+                                                    "    status = :status, type = :type, blockHash = :blockHash, intStatus = :intStatus, flags = :flags "
                                                     "WHERE currency = :currency AND txid = :txid "
                                                     "    AND address = :address AND blockNumber = :blockNumber AND ind = :ind";
 
 static const QString deletePaymentsForAddress = "DELETE FROM payments "
                                                 "WHERE address = :address AND  currency = :currency";
 
-static const QString selectPaymentsCountForAddress2 = "SELECT COUNT(DISTINCT txid || ',' || blockNumber || ',' || ind) AS count FROM payments "
-                                                    "WHERE address = :address AND currency = :currency ";
+static const QString insertPaymentsStat = "INSERT OR IGNORE INTO paymentsStat (currency, address) "
+                                            "VALUES (:currency, :address)";
+
+static const QString updatePaymentsStat = "UPDATE paymentsStat SET countTxs = countTxs + :countTxs, countPending = countPending + :countPending "
+                                            "WHERE address = :address AND currency = :currency";
+
+static const QString updatePaymentsStatAmounts = "UPDATE paymentsStat SET countTxs = countTxs + :countTxs, countPending = countPending + :countPending, "
+                                                "    received = :received, spent = :spent "
+                                                "WHERE address = :address AND currency = :currency";
+
+static const QString selectPaymentsStat = "SELECT countTxs, countPending, received, spent FROM paymentsStat "
+                                            "WHERE address = :address AND currency = :currency";
+
+static const QString deletePaymentsStatForAddress = "DELETE FROM paymentsStat "
+                                                    "WHERE address = :address AND currency = :currency";
+
+static const QString removePaymentsStatForCurrencyQuery = "DELETE FROM paymentsStat %1";
+
+static const QString selectAllPaymentsStat = "SELECT currency, address, countTxs, countPending, received, spent FROM paymentsStat";
+
+// %1 is the table, %2 are the amount columns
+static const QString selectAmountsForConvert = "SELECT rowid AS rid, %2 FROM %1";
+
+static const QString updateAmountsForConvert = "UPDATE %1 SET %2 WHERE rowid = :rid";
+
+// Amounts may be BLOB, so they are summed in code
+static const QString selectAllPaymentsForStat = "SELECT currency, address, ufrom, uto, value, status FROM payments";
+
+static const QString insertPaymentsStatRecount = "INSERT INTO paymentsStat (currency, address, countTxs, countPending, received, spent) "
+                                                    "VALUES (:currency, :address, :countTxs, :countPending, :received, :spent)";
+
+static const QString selectPaymentForStat = "SELECT status, ufrom, uto, value FROM payments "
+                                            "WHERE currency = :currency AND txid = :txid "
+                                            "    AND address = :address AND blockNumber = :blockNumber AND ind = :ind";
 
 static const QString insertTracked = "INSERT OR IGNORE INTO tracked (currency, address, tgroup) "
                                             "VALUES (:currency, :address, :tgroup)";
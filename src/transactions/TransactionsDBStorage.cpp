@@ -3,6 +3,9 @@
 #include <QtSql>
 #include <QDebug>
 
+#include <map>
+#include <tuple>
+
 #include "TransactionsDBRes.h"
 #include "check.h"
 #include "Log.h"
@@ -11,45 +14,175 @@ SET_LOG_NAMESPACE("TXS");
 
 namespace transactions {
 
-static void addFilter(QString &request, const Filters &filters) {
-    QString filter;
-    if (filters.isDelegate == FilterType::False) {
-        filter += " AND type != " + QString::number(Transaction::Type::DELEGATE) + " ";
-    } else if (filters.isDelegate == FilterType::True) {
-        filter += " AND type = " + QString::number(Transaction::Type::DELEGATE) + " ";
+enum PaymentFlag {
+    FLAG_INPUT = 1 << 0,
+    FLAG_OUTPUT = 1 << 1,
+    FLAG_FORGING = 1 << 2,
+    FLAG_DELEGATE = 1 << 3,
+    FLAG_TESTING = 1 << 4,
+    FLAG_SUCCESS = 1 << 5
+};
+
+// Keep in sync with the CASE expression in payments_12to13.sql
+static int paymentFlags(const QString &address, const QString &ufrom, const QString &uto, Transaction::Type type, Transaction::Status status, int intStatus) {
+    int flags = 0;
+    if (ufrom == address) {
+        flags |= FLAG_INPUT;
+    }
+    if (uto == address) {
+        flags |= FLAG_OUTPUT;
+    }
+    if (type == Transaction::Type::FORGING) {
+        flags |= FLAG_FORGING;
     }
-    if (filters.isForging == FilterType::False) {
-        filter += " AND type != " + QString::number(Transaction::Type::FORGING) + " ";
-    } else if (filters.isForging == FilterType::True) {
-        filter += " AND type = " + QString::number(Transaction::Type::FORGING) + " ";
+    if (type == Transaction::Type::DELEGATE) {
+        flags |= FLAG_DELEGATE;
     }
-    if (filters.isInput == FilterType::False) {
-        filter += " AND ufrom != :from ";
-    } else if (filters.isInput == FilterType::True) {
-        filter += " AND ufrom = :from ";
+    if (intStatus == STATUS_TESTING) {
+        flags |= FLAG_TESTING;
+    }
+    if (status == Transaction::Status::OK) {
+        flags |= FLAG_SUCCESS;
+    }
+    return flags;
+}
+
+static int paymentFlags(const Transaction &trans) {
+    return paymentFlags(trans.address, trans.from, trans.to, trans.type, trans.status, trans.intStatus);
+}
+
+static void addFilter(int &mask, int &value, FilterType filter, int flag) {
+    if (filter == FilterType::True) {
+        mask |= flag;
+        value |= flag;
+    } else if (filter == FilterType::False) {
+        mask |= flag;
     }
-    if (filters.isOutput == FilterType::False) {
-        filter += " AND uto != :to ";
-    } else if (filters.isOutput == FilterType::True) {
-        filter += " AND uto = :to ";
+}
+
+static void bindFilter(QSqlQuery &query, const Filters &filters) {
+    int mask = 0;
+    int value = 0;
+    addFilter(mask, value, filters.isInput, FLAG_INPUT);
+    addFilter(mask, value, filters.isOutput, FLAG_OUTPUT);
+    addFilter(mask, value, filters.isForging, FLAG_FORGING);
+    addFilter(mask, value, filters.isDelegate, FLAG_DELEGATE);
+    addFilter(mask, value, filters.isTesting, FLAG_TESTING);
+    addFilter(mask, value, filters.isSuccess, FLAG_SUCCESS);
+    query.bindValue(":flagsMask", mask);
+    query.bindValue(":flagsValue", value);
+}
+
+static const int amountBinarySize128 = 16;
+static const int amountBinarySize256 = 32;
+
+static bool isCanonicalDecimal(const QString &dec) {
+    if (dec.isEmpty() || (dec.size() > 1 && dec.at(0) == QChar('0'))) {
+        return false;
+    }
+    for (const QChar &c: dec) {
+        if (c < QChar('0') || c > QChar('9')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Non-negative amounts are stored as 128 or 256 bit little-endian BLOB, everything else as TEXT
+static QVariant encodeAmount(bool isBinary, const BigNumber256 &amount) {
+    if (isBinary) {
+        const QByteArray bytes = amount.getLittleEndian(amount.countBytes() <= amountBinarySize128 ? amountBinarySize128 : amountBinarySize256);
+        if (!bytes.isEmpty()) {
+            return bytes;
+        }
+    }
+    return QString::fromLatin1(amount.getDecimal());
+}
+
+static QVariant encodeAmount(bool isBinary, const QString &amount) {
+    BigNumber256 number;
+    if (isBinary && isCanonicalDecimal(amount) && BigNumber256::parseDecimal(amount.toLatin1(), number)) {
+        return encodeAmount(isBinary, number);
+    }
+    return amount;
+}
+
+static BigNumber256 decodeAmount(const QVariant &value) {
+    BigNumber256 result;
+    if (value.type() == QVariant::ByteArray) {
+        result.setLittleEndian(value.toByteArray());
+    } else {
+        result.setDecimal(value.toString().toLatin1());
     }
-    if (filters.isTesting == FilterType::False) {
-        filter += " AND intStatus != " + QString::number(STATUS_TESTING) + " ";
-    } else if (filters.isTesting == FilterType::True) {
-        filter += " AND intStatus = " + QString::number(STATUS_TESTING) + " ";
+    return result;
+}
+
+static QString decodeAmountString(const QVariant &value) {
+    if (value.type() == QVariant::ByteArray) {
+        return QString::fromLatin1(decodeAmount(value).getDecimal());
     }
-    if (filters.isSuccess == FilterType::False) {
-        filter += " AND status != " + QString::number(Transaction::Status::OK) + " ";
-    } else if (filters.isTesting == FilterType::True) {
-        filter += " AND status = " + QString::number(Transaction::Status::OK) + " ";
+    return value.toString();
+}
+
+static QString makeInsertPaymentsBulk(int countRows) {
+    QStringList rows;
+    for (int i = 0; i < countRows; i++) {
+        rows.append(insertPaymentsBulkRow);
     }
+    return insertPaymentsBulk.arg(rows.join(", "));
+}
+
+static bool isPendingStatus(Transaction::Status status) {
+    return status == Transaction::Status::PENDING || status == Transaction::Status::MODULE_NOT_SET;
+}
 
-    request.replace("%filter%", filter);
-    (void)filter;
+// Sums of paymentsStat are over confirmed payments. Values that are not decimal are skipped
+static void addPaymentAmounts(TransactionsDBStorage::PaymentsStat &stat, const QString &ufrom, const QString &uto, const QString &value, Transaction::Status status, bool isSubtract) {
+    BigNumber256 amount;
+    if (status != Transaction::OK || !BigNumber256::parseDecimal(value.toLatin1(), amount)) {
+        return;
+    }
+    if (uto == stat.address) {
+        if (isSubtract) {
+            stat.received -= amount;
+        } else {
+            stat.received += amount;
+        }
+    }
+    if (ufrom == stat.address) {
+        if (isSubtract) {
+            stat.spent -= amount;
+        } else {
+            stat.spent += amount;
+        }
+    }
 }
 
-TransactionsDBStorage::TransactionsDBStorage(const QString &path)
-    : DBStorage(path, databaseName)
+static void bindPaymentBulk(QSqlQuery &query, int offset, const Transaction &trans, bool isBinaryAmounts) {
+    query.bindValue(offset + 0, trans.currency);
+    query.bindValue(offset + 1, trans.tx);
+    query.bindValue(offset + 2, trans.address);
+    query.bindValue(offset + 3, static_cast<qint64>(trans.blockIndex));
+    query.bindValue(offset + 4, trans.from);
+    query.bindValue(offset + 5, trans.to);
+    query.bindValue(offset + 6, encodeAmount(isBinaryAmounts, trans.value));
+    query.bindValue(offset + 7, static_cast<qint64>(trans.timestamp));
+    query.bindValue(offset + 8, trans.data);
+    query.bindValue(offset + 9, encodeAmount(isBinaryAmounts, trans.fee));
+    query.bindValue(offset + 10, static_cast<qint64>(trans.nonce));
+    query.bindValue(offset + 11, trans.isDelegate);
+    query.bindValue(offset + 12, encodeAmount(isBinaryAmounts, trans.delegateValue));
+    query.bindValue(offset + 13, trans.delegateHash);
+    query.bindValue(offset + 14, trans.status);
+    query.bindValue(offset + 15, trans.type);
+    query.bindValue(offset + 16, static_cast<qint64>(trans.blockNumber));
+    query.bindValue(offset + 17, trans.blockHash);
+    query.bindValue(offset + 18, trans.intStatus);
+    query.bindValue(offset + 19, paymentFlags(trans));
+}
+
+TransactionsDBStorage::TransactionsDBStorage(const QString &path, const QString &connectionName)
+    : DBStorage(path, databaseName, connectionName)
 {
 
 }
@@ -65,29 +198,38 @@ void TransactionsDBStorage::addPayment(const QString &currency, const QString &t
                                        bool isDelegate, const QString &delegateValue, const QString &delegateHash,
                                        Transaction::Status status, Transaction::Type type, qint64 blockNumber, const QString &blockHash, int intStatus)
 {
-    QSqlQuery query(database());
-    CHECK(query.prepare(insertPayment), query.lastError().text().toStdString());
+    const bool isBinary = isBinaryAmounts();
+    QSqlQuery &query = cachedQuery(insertPayment);
     query.bindValue(":currency", currency);
     query.bindValue(":txid", txid);
     query.bindValue(":address", address);
     query.bindValue(":ind", index);
     query.bindValue(":ufrom", ufrom);
     query.bindValue(":uto", uto);
-    query.bindValue(":value", value);
+    query.bindValue(":value", encodeAmount(isBinary, value));
     query.bindValue(":ts", ts);
     query.bindValue(":data", data);
-    query.bindValue(":fee", fee);
+    query.bindValue(":fee", encodeAmount(isBinary, fee));
     query.bindValue(":nonce", nonce);
     query.bindValue(":isDelegate", isDelegate);
-    query.bindValue(":delegateValue", delegateValue);
+    query.bindValue(":delegateValue", encodeAmount(isBinary, delegateValue));
     query.bindValue(":delegateHash", delegateHash);
     query.bindValue(":status", status);
     query.bindValue(":type", type);
     query.bindValue(":blockNumber", blockNumber);
     query.bindValue(":blockHash", blockHash);
     query.bindValue(":intStatus", intStatus);
+    query.bindValue(":flags", paymentFlags(address, ufrom, uto, type, status, intStatus));
     CHECK(query.exec(), query.lastError().text().toStdString());
-
+    if (query.numRowsAffected() > 0) {
+        PaymentsStat delta;
+        delta.currency = currency;
+        delta.address = address;
+        delta.countTxs = 1;
+        delta.countPending = isPendingStatus(status) ? 1 : 0;
+        addPaymentAmounts(delta, ufrom, uto, value, status, false);
+        changePaymentsStat(delta);
+    }
 }
 
 void TransactionsDBStorage::addPayment(const Transaction &trans)
@@ -102,46 +244,151 @@ void TransactionsDBStorage::addPayment(const Transaction &trans)
 void TransactionsDBStorage::addPayments(const std::vector<Transaction> &transactions)
 {
     auto transactionGuard = beginTransaction();
-    for (const Transaction &transaction: transactions) {
-        addPayment(transaction);
-    }
+    addPaymentsBulk(transactions);
     transactionGuard.commit();
 }
 
+void TransactionsDBStorage::addPaymentsBulk(const std::vector<Transaction> &transactions)
+{
+    static const QString insertBulk = makeInsertPaymentsBulk(insertPaymentsBulkRows);
+    static const QString insertOne = makeInsertPaymentsBulk(1);
+
+    // Rows of one group share counters, so counters are changed by the number of rows actually inserted.
+    // Sums need the inserted rows themselves, so a chunk that is inserted partially is inserted again row by row
+    std::map<std::tuple<QString, QString, bool>, std::vector<const Transaction*>> groups;
+    for (const Transaction &trans: transactions) {
+        groups[std::make_tuple(trans.currency, trans.address, isPendingStatus(trans.status))].emplace_back(&trans);
+    }
+
+    const bool isBinary = isBinaryAmounts();
+    for (const auto &group: groups) {
+        const std::vector<const Transaction*> &rows = group.second;
+        PaymentsStat delta;
+        delta.currency = std::get<0>(group.first);
+        delta.address = std::get<1>(group.first);
+        size_t pos = 0;
+        while (pos < rows.size()) {
+            const int countRows = rows.size() - pos >= static_cast<size_t>(insertPaymentsBulkRows) ? insertPaymentsBulkRows : 1;
+            if (countRows != 1) {
+                PaymentsStat chunk;
+                chunk.address = delta.address;
+                QSqlQuery &query = cachedQuery(insertBulk);
+                for (int i = 0; i < countRows; i++) {
+                    const Transaction &trans = *rows[pos + i];
+                    bindPaymentBulk(query, i * insertPaymentsBulkColumns, trans, isBinary);
+                    addPaymentAmounts(chunk, trans.from, trans.to, trans.value, trans.status, false);
+                }
+                auto chunkGuard = beginTransaction();
+                CHECK(query.exec(), query.lastError().text().toStdString());
+                const int countInserted = query.numRowsAffected();
+                if (countInserted == 0 || countInserted == countRows) {
+                    chunkGuard.commit();
+                    if (countInserted != 0) {
+                        delta.countTxs += countInserted;
+                        delta.received += chunk.received;
+                        delta.spent += chunk.spent;
+                    }
+                    pos += countRows;
+                    continue;
+                }
+                // chunkGuard rolls back the chunk before it is inserted row by row
+            }
+            QSqlQuery &query = cachedQuery(insertOne);
+            for (int i = 0; i < countRows; i++) {
+                const Transaction &trans = *rows[pos + i];
+                bindPaymentBulk(query, 0, trans, isBinary);
+                CHECK(query.exec(), query.lastError().text().toStdString());
+                if (query.numRowsAffected() > 0) {
+                    delta.countTxs++;
+                    addPaymentAmounts(delta, trans.from, trans.to, trans.value, trans.status, false);
+                }
+            }
+            pos += countRows;
+        }
+        if (delta.countTxs > 0) {
+            delta.countPending = std::get<2>(group.first) ? delta.countTxs : 0;
+            changePaymentsStat(delta);
+        }
+    }
+}
+
+void TransactionsDBStorage::changePaymentsStat(const PaymentsStat &delta)
+{
+    QSqlQuery &insertQuery = cachedQuery(insertPaymentsStat);
+    insertQuery.bindValue(":currency", delta.currency);
+    insertQuery.bindValue(":address", delta.address);
+    CHECK(insertQuery.exec(), insertQuery.lastError().text().toStdString());
+
+    if (delta.received.isZero() && delta.spent.isZero()) {
+        QSqlQuery &query = cachedQuery(updatePaymentsStat);
+        query.bindValue(":currency", delta.currency);
+        query.bindValue(":address", delta.address);
+        query.bindValue(":countTxs", delta.countTxs);
+        query.bindValue(":countPending", delta.countPending);
+        CHECK(query.exec(), query.lastError().text().toStdString());
+        return;
+    }
+
+    // Amounts may be BLOB, so sums are changed in code
+    PaymentsStat stat = getPaymentsStat(delta.address, delta.currency);
+    stat.received += delta.received;
+    stat.spent += delta.spent;
+    const bool isBinary = isBinaryAmounts();
+    QSqlQuery &query = cachedQuery(updatePaymentsStatAmounts);
+    query.bindValue(":currency", delta.currency);
+    query.bindValue(":address", delta.address);
+    query.bindValue(":countTxs", delta.countTxs);
+    query.bindValue(":countPending", delta.countPending);
+    query.bindValue(":received", encodeAmount(isBinary, stat.received));
+    query.bindValue(":spent", encodeAmount(isBinary, stat.spent));
+    CHECK(query.exec(), query.lastError().text().toStdString());
+}
+
 std::vector<Transaction> TransactionsDBStorage::getPaymentsForAddress(const QString &address, const QString &currency,
                                                                       qint64 offset, qint64 count, bool asc)
 {
+    return getPaymentsForAddressFilter(address, currency, Filters(), offset, count, asc);
+}
+
+std::vector<Transaction> TransactionsDBStorage::getPaymentsForAddressFilter(const QString &address, const QString &currency, const Filters &filters,
+                                                     qint64 offset, qint64 count, bool asc) {
+    static const QString selectAsc = selectPaymentsForDestFilter.arg(QStringLiteral("ASC"));
+    static const QString selectDesc = selectPaymentsForDestFilter.arg(QStringLiteral("DESC"));
+
     std::vector<Transaction> res;
-    QSqlQuery query(database());
-    QString q = selectPaymentsForDestFilter.arg(asc ? QStringLiteral("ASC") : QStringLiteral("DESC"));
-    addFilter(q, Filters());
-    CHECK(query.prepare(q),
-          query.lastError().text().toStdString());
+    QSqlQuery &query = cachedQuery(asc ? selectAsc : selectDesc);
     query.bindValue(":address", address);
     query.bindValue(":currency", currency);
+    bindFilter(query, filters);
     query.bindValue(":offset", offset);
     query.bindValue(":count", count);
     CHECK(query.exec(), query.lastError().text().toStdString());
     createPaymentsList(query, res);
+    query.finish();
     return res;
 }
 
-std::vector<Transaction> TransactionsDBStorage::getPaymentsForAddressFilter(const QString &address, const QString &currency, const Filters &filters,
-                                                     qint64 offset, qint64 count, bool asc) {
+std::vector<Transaction> TransactionsDBStorage::getPaymentsForAddressCursor(const QString &address, const QString &currency, const Filters &filters,
+                                                     const TxsCursor &cursor, qint64 count, bool asc) {
+    static const QString selectFirstAsc = QString(selectPaymentsForDestCursor).replace("%cursor%", QString()).arg(QStringLiteral("ASC"));
+    static const QString selectFirstDesc = QString(selectPaymentsForDestCursor).replace("%cursor%", QString()).arg(QStringLiteral("DESC"));
+    static const QString selectNextAsc = QString(selectPaymentsForDestCursor).replace("%cursor%", paymentsCursorAsc).arg(QStringLiteral("ASC"));
+    static const QString selectNextDesc = QString(selectPaymentsForDestCursor).replace("%cursor%", paymentsCursorDesc).arg(QStringLiteral("DESC"));
+
     std::vector<Transaction> res;
-    QSqlQuery query(database());
-    QString q = selectPaymentsForDestFilter.arg(asc ? QStringLiteral("ASC") : QStringLiteral("DESC"));
-    addFilter(q, filters);
-    CHECK(query.prepare(q),
-          query.lastError().text().toStdString());
+    QSqlQuery &query = cachedQuery(cursor.isSet ? (asc ? selectNextAsc : selectNextDesc) : (asc ? selectFirstAsc : selectFirstDesc));
     query.bindValue(":address", address);
-    query.bindValue(":from", address);
-    query.bindValue(":to", address);
     query.bindValue(":currency", currency);
-    query.bindValue(":offset", offset);
+    bindFilter(query, filters);
+    if (cursor.isSet) {
+        query.bindValue(":cursorTs", cursor.ts);
+        query.bindValue(":cursorTxid", cursor.txid);
+        query.bindValue(":cursorId", cursor.id);
+    }
     query.bindValue(":count", count);
     CHECK(query.exec(), query.lastError().text().toStdString());
     createPaymentsList(query, res);
+    query.finish();
     return res;
 }
 
@@ -164,6 +411,9 @@ std::vector<Transaction> TransactionsDBStorage::getPaymentsForCurrency(const QSt
 std::vector<Transaction> TransactionsDBStorage::getPaymentsForAddressPending(const QString &address, const QString &currency, bool asc) const
 {
     std::vector<Transaction> res;
+    if (getPaymentsStat(address, currency).countPending == 0) {
+        return res;
+    }
     QSqlQuery query(database());
     CHECK(query.prepare(selectPaymentsForDestPending.arg(asc ? QStringLiteral("ASC") : QStringLiteral("DESC")).arg(Transaction::Status::PENDING).arg(Transaction::Status::MODULE_NOT_SET)),
           query.lastError().text().toStdString());
@@ -176,65 +426,38 @@ std::vector<Transaction> TransactionsDBStorage::getPaymentsForAddressPending(con
 
 std::vector<transactions::Transaction> transactions::TransactionsDBStorage::getForgingPaymentsForAddress(const QString &address, const QString &currency, qint64 offset, qint64 count, bool asc)
 {
-    std::vector<Transaction> res;
-    QSqlQuery query(database());
-    QString q = selectPaymentsForDestFilter.arg(asc ? QStringLiteral("ASC") : QStringLiteral("DESC"));
     Filters filter;
     filter.isForging = FilterType::True;
-    addFilter(q, filter);
-    CHECK(query.prepare(q),
-          query.lastError().text().toStdString());
-    query.bindValue(":address", address);
-    query.bindValue(":currency", currency);
-    query.bindValue(":offset", offset);
-    query.bindValue(":count", count);
-    CHECK(query.exec(), query.lastError().text().toStdString());
-    createPaymentsList(query, res);
-    return res;
+    return getPaymentsForAddressFilter(address, currency, filter, offset, count, asc);
 }
 
 std::vector<Transaction> TransactionsDBStorage::getDelegatePaymentsForAddress(const QString &address, const QString &to, const QString &currency, qint64 offset, qint64 count, bool asc) {
+    static const QString selectAsc = selectPaymentsForDestFilterTo.arg(QStringLiteral("ASC"));
+    static const QString selectDesc = selectPaymentsForDestFilterTo.arg(QStringLiteral("DESC"));
+
     std::vector<Transaction> res;
-    QSqlQuery query(database());
-    QString q = selectPaymentsForDestFilter.arg(asc ? QStringLiteral("ASC") : QStringLiteral("DESC"));
+    // Failed delegations are listed too
     Filters filter;
     filter.isDelegate = FilterType::True;
-    filter.isSuccess = FilterType::True;
     filter.isInput = FilterType::True;
-    filter.isOutput = FilterType::True;
-    addFilter(q, filter);
-    CHECK(query.prepare(q),
-          query.lastError().text().toStdString());
+    QSqlQuery &query = cachedQuery(asc ? selectAsc : selectDesc);
     query.bindValue(":address", address);
-    query.bindValue(":from", address);
-    query.bindValue(":to", to);
     query.bindValue(":currency", currency);
+    bindFilter(query, filter);
+    query.bindValue(":to", to);
     query.bindValue(":offset", offset);
     query.bindValue(":count", count);
     CHECK(query.exec(), query.lastError().text().toStdString());
     createPaymentsList(query, res);
+    query.finish();
     return res;
 }
 
 std::vector<Transaction> TransactionsDBStorage::getDelegatePaymentsForAddress(const QString &address, const QString &currency, qint64 offset, qint64 count, bool asc) {
-    std::vector<Transaction> res;
-    QSqlQuery query(database());
-    QString q = selectPaymentsForDestFilter.arg(asc ? QStringLiteral("ASC") : QStringLiteral("DESC"));
     Filters filter;
     filter.isDelegate = FilterType::True;
-    filter.isSuccess = FilterType::True;
     filter.isInput = FilterType::True;
-    addFilter(q, filter);
-    CHECK(query.prepare(q),
-          query.lastError().text().toStdString());
-    query.bindValue(":address", address);
-    query.bindValue(":from", address);
-    query.bindValue(":currency", currency);
-    query.bindValue(":offset", offset);
-    query.bindValue(":count", count);
-    CHECK(query.exec(), query.lastError().text().toStdString());
-    createPaymentsList(query, res);
-    return res;
+    return getPaymentsForAddressFilter(address, currency, filter, offset, count, asc);
 }
 
 Transaction TransactionsDBStorage::getLastTransaction(const QString &address, const QString &currency) {
@@ -266,6 +489,29 @@ Transaction TransactionsDBStorage::getLastForgingTransaction(const QString &addr
 
 void TransactionsDBStorage::updatePayment(const QString &address, const QString &currency, const QString &txid, qint64 blockNumber, qint64 index, const Transaction &trans)
 {
+    auto transactionGuard = beginTransaction();
+    bool isFound = false;
+    bool wasPending = false;
+    PaymentsStat delta;
+    delta.currency = currency;
+    delta.address = address;
+    {
+        QSqlQuery query(database());
+        CHECK(query.prepare(selectPaymentForStat), query.lastError().text().toStdString());
+        query.bindValue(":address", address);
+        query.bindValue(":currency", currency);
+        query.bindValue(":txid", txid);
+        query.bindValue(":blockNumber", blockNumber);
+        query.bindValue(":ind", index);
+        CHECK(query.exec(), query.lastError().text().toStdString());
+        if (query.next()) {
+            isFound = true;
+            const Transaction::Status status = static_cast<Transaction::Status>(query.value("status").toInt());
+            wasPending = isPendingStatus(status);
+            addPaymentAmounts(delta, query.value("ufrom").toString(), query.value("uto").toString(), decodeAmountString(query.value("value")), status, true);
+        }
+    }
+
     QSqlQuery query(database());
     CHECK(query.prepare(updatePaymentForAddress), query.lastError().text().toStdString())
             query.bindValue(":address", address);
@@ -276,40 +522,146 @@ void TransactionsDBStorage::updatePayment(const QString &address, const QString
 
     query.bindValue(":ufrom", trans.from);
     query.bindValue(":uto", trans.to);
-    query.bindValue(":value", trans.value);
+    query.bindValue(":value", encodeAmount(isBinaryAmounts(), trans.value));
     query.bindValue(":ts", static_cast<qint64>(trans.timestamp));
     query.bindValue(":data", trans.data);
-    query.bindValue(":fee", trans.fee);
+    query.bindValue(":fee", encodeAmount(isBinaryAmounts(), trans.fee));
     query.bindValue(":nonce", static_cast<qint64>(trans.nonce));
     query.bindValue(":isDelegate", trans.isDelegate);
-    query.bindValue(":delegateValue", trans.delegateValue);
+    query.bindValue(":delegateValue", encodeAmount(isBinaryAmounts(), trans.delegateValue));
     query.bindValue(":delegateHash", trans.delegateHash);
     query.bindValue(":status", trans.status);
     query.bindValue(":type", trans.type);
     query.bindValue(":blockHash", trans.blockHash);
     query.bindValue(":intStatus", trans.intStatus);
+    query.bindValue(":flags", paymentFlags(address, trans.from, trans.to, trans.type, trans.status, trans.intStatus));
     CHECK(query.exec(), query.lastError().text().toStdString());
+
+    if (isFound) {
+        const bool isPending = isPendingStatus(trans.status);
+        delta.countPending = (isPending ? 1 : 0) - (wasPending ? 1 : 0);
+        addPaymentAmounts(delta, trans.from, trans.to, trans.value, trans.status, false);
+        if (delta.countPending != 0 || !delta.received.isZero() || !delta.spent.isZero()) {
+            changePaymentsStat(delta);
+        }
+    }
+    transactionGuard.commit();
 }
 
 void TransactionsDBStorage::removePaymentsForDest(const QString &address, const QString &currency)
 {
+    auto transactionGuard = beginTransaction();
     QSqlQuery query(database());
     CHECK(query.prepare(deletePaymentsForAddress), query.lastError().text().toStdString());
     query.bindValue(":address", address);
     query.bindValue(":currency", currency);
     CHECK(query.exec(), query.lastError().text().toStdString());
+    CHECK(query.prepare(deletePaymentsStatForAddress), query.lastError().text().toStdString());
+    query.bindValue(":address", address);
+    query.bindValue(":currency", currency);
+    CHECK(query.exec(), query.lastError().text().toStdString());
+    transactionGuard.commit();
 }
 
 qint64 TransactionsDBStorage::getPaymentsCountForAddress(const QString &address, const QString &currency) {
+    return getPaymentsStat(address, currency).countTxs;
+}
+
+TransactionsDBStorage::PaymentsStat TransactionsDBStorage::getPaymentsStat(const QString &address, const QString &currency) const {
+    PaymentsStat stat;
+    stat.currency = currency;
+    stat.address = address;
     QSqlQuery query(database());
-    CHECK(query.prepare(selectPaymentsCountForAddress2), query.lastError().text().toStdString());
+    CHECK(query.prepare(selectPaymentsStat), query.lastError().text().toStdString());
     query.bindValue(":address", address);
     query.bindValue(":currency", currency);
     CHECK(query.exec(), query.lastError().text().toStdString());
     if (query.next()) {
-        return query.value("count").toLongLong();
+        stat.countTxs = query.value("countTxs").toLongLong();
+        stat.countPending = query.value("countPending").toLongLong();
+        stat.received = decodeAmount(query.value("received"));
+        stat.spent = decodeAmount(query.value("spent"));
     }
-    return 0;
+    return stat;
+}
+
+std::map<std::pair<QString, QString>, TransactionsDBStorage::PaymentsStat> TransactionsDBStorage::recountPaymentsStat() {
+    std::map<std::pair<QString, QString>, PaymentsStat> stats;
+    QSqlQuery query(database());
+    CHECK(query.prepare(selectAllPaymentsForStat), query.lastError().text().toStdString());
+    CHECK(query.exec(), query.lastError().text().toStdString());
+    while (query.next()) {
+        const QString currency = query.value("currency").toString();
+        const QString address = query.value("address").toString();
+        PaymentsStat &stat = stats[std::make_pair(currency, address)];
+        stat.currency = currency;
+        stat.address = address;
+        const Transaction::Status status = static_cast<Transaction::Status>(query.value("status").toInt());
+        stat.countTxs++;
+        if (isPendingStatus(status)) {
+            stat.countPending++;
+        }
+        addPaymentAmounts(stat, query.value("ufrom").toString(), query.value("uto").toString(), decodeAmountString(query.value("value")), status, false);
+    }
+    return stats;
+}
+
+std::vector<std::pair<TransactionsDBStorage::PaymentsStat, TransactionsDBStorage::PaymentsStat>> TransactionsDBStorage::checkPaymentsStat() {
+    std::map<std::pair<QString, QString>, PaymentsStat> stored;
+    QSqlQuery query(database());
+    CHECK(query.prepare(selectAllPaymentsStat), query.lastError().text().toStdString());
+    CHECK(query.exec(), query.lastError().text().toStdString());
+    while (query.next()) {
+        PaymentsStat stat;
+        stat.currency = query.value("currency").toString();
+        stat.address = query.value("address").toString();
+        stat.countTxs = query.value("countTxs").toLongLong();
+        stat.countPending = query.value("countPending").toLongLong();
+        stat.received = decodeAmount(query.value("received"));
+        stat.spent = decodeAmount(query.value("spent"));
+        stored[std::make_pair(stat.currency, stat.address)] = stat;
+    }
+
+    std::map<std::pair<QString, QString>, PaymentsStat> recounted = recountPaymentsStat();
+
+    // Missing row is the same as zero counters
+    for (const auto &pair: stored) {
+        PaymentsStat &stat = recounted[pair.first];
+        stat.currency = pair.second.currency;
+        stat.address = pair.second.address;
+    }
+    std::vector<std::pair<PaymentsStat, PaymentsStat>> result;
+    for (const auto &pair: recounted) {
+        PaymentsStat &stat = stored[pair.first];
+        stat.currency = pair.second.currency;
+        stat.address = pair.second.address;
+        if (stat.countTxs != pair.second.countTxs || stat.countPending != pair.second.countPending
+                || stat.received != pair.second.received || stat.spent != pair.second.spent) {
+            result.emplace_back(stat, pair.second);
+        }
+    }
+    return result;
+}
+
+void TransactionsDBStorage::rebuildPaymentsStat() {
+    auto transactionGuard = beginTransaction();
+    const std::map<std::pair<QString, QString>, PaymentsStat> recounted = recountPaymentsStat();
+    QSqlQuery query(database());
+    CHECK(query.prepare(removePaymentsStatForCurrencyQuery.arg(QStringLiteral(""))), query.lastError().text().toStdString());
+    CHECK(query.exec(), query.lastError().text().toStdString());
+    const bool isBinary = isBinaryAmounts();
+    CHECK(query.prepare(insertPaymentsStatRecount), query.lastError().text().toStdString());
+    for (const auto &pair: recounted) {
+        const PaymentsStat &stat = pair.second;
+        query.bindValue(":currency", stat.currency);
+        query.bindValue(":address", stat.address);
+        query.bindValue(":countTxs", stat.countTxs);
+        query.bindValue(":countPending", stat.countPending);
+        query.bindValue(":received", encodeAmount(isBinary, stat.received));
+        query.bindValue(":spent", encodeAmount(isBinary, stat.spent));
+        CHECK(query.exec(), query.lastError().text().toStdString());
+    }
+    transactionGuard.commit();
 }
 
 void TransactionsDBStorage::addTracked(const QString &currency, const QString &address, const QString &tgroup)
@@ -365,29 +717,38 @@ void TransactionsDBStorage::removePaymentsForCurrency(const QString &currency)
     if (!currency.isEmpty())
         query.bindValue(":currency", currency);
     CHECK(query.exec(), query.lastError().text().toStdString());
+    CHECK(query.prepare(removePaymentsStatForCurrencyQuery.arg(currency.isEmpty() ? QStringLiteral(""): removePaymentsCurrencyWhere)), query.lastError().text().toStdString());
+    if (!currency.isEmpty())
+        query.bindValue(":currency", currency);
+    CHECK(query.exec(), query.lastError().text().toStdString());
+    CHECK(query.prepare(resetBalanceBackfill.arg(currency.isEmpty() ? QStringLiteral(""): removePaymentsCurrencyWhere)), query.lastError().text().toStdString());
+    if (!currency.isEmpty())
+        query.bindValue(":currency", currency);
+    CHECK(query.exec(), query.lastError().text().toStdString());
     transactionGuard.commit();
 }
 
 void TransactionsDBStorage::setBalance(const QString &currency, const QString &address, const BalanceInfo &balance) {
     removeBalance(currency, address);
 
+    const bool isBinary = isBinaryAmounts();
     QSqlQuery query(database());
     CHECK(query.prepare(insertBalance), query.lastError().text().toStdString());
     query.bindValue(":currency", currency);
     query.bindValue(":address", address);
-    query.bindValue(":received", balance.received.getDecimal());
-    query.bindValue(":spent", balance.spent.getDecimal());
+    query.bindValue(":received", encodeAmount(isBinary, balance.received));
+    query.bindValue(":spent", encodeAmount(isBinary, balance.spent));
     query.bindValue(":countReceived", (qint64)balance.countReceived);
     query.bindValue(":countSpent", (qint64)balance.countSpent);
     query.bindValue(":countTxs", (qint64)balance.countTxs);
     query.bindValue(":currBlockNum", (qint64)balance.currBlockNum);
     query.bindValue(":countDelegated", (qint64)balance.countDelegated);
-    query.bindValue(":delegate", balance.delegate.getDecimal());
-    query.bindValue(":undelegate", balance.undelegate.getDecimal());
-    query.bindValue(":delegated", balance.delegated.getDecimal());
-    query.bindValue(":undelegated", balance.undelegated.getDecimal());
-    query.bindValue(":reserved", balance.reserved.getDecimal());
-    query.bindValue(":forged", balance.forged.getDecimal());
+    query.bindValue(":delegate", encodeAmount(isBinary, balance.delegate));
+    query.bindValue(":undelegate", encodeAmount(isBinary, balance.undelegate));
+    query.bindValue(":delegated", encodeAmount(isBinary, balance.delegated));
+    query.bindValue(":undelegated", encodeAmount(isBinary, balance.undelegated));
+    query.bindValue(":reserved", encodeAmount(isBinary, balance.reserved));
+    query.bindValue(":forged", encodeAmount(isBinary, balance.forged));
     query.bindValue(":tokenBlockNum", (qint64)balance.tokenBlockNum);
     CHECK(query.exec(), query.lastError().text().toStdString());
 }
@@ -403,19 +764,19 @@ BalanceInfo TransactionsDBStorage::getBalance(const QString &currency, const QSt
     balance.address = address;
 
     if (query.next()) {
-        balance.received = query.value("received").toByteArray();
-        balance.spent = query.value("spent").toByteArray();
+        balance.received = decodeAmount(query.value("received"));
+        balance.spent = decodeAmount(query.value("spent"));
         balance.countReceived = static_cast<quint64>(query.value("countReceived").toLongLong());
         balance.countSpent = static_cast<quint64>(query.value("countSpent").toLongLong());
         balance.countTxs = static_cast<quint64>(query.value("countTxs").toLongLong());
         balance.currBlockNum = static_cast<quint64>(query.value("currBlockNum").toLongLong());
         balance.countDelegated = static_cast<quint64>(query.value("countDelegated").toLongLong());
-        balance.delegate = query.value("delegate").toByteArray();
-        balance.undelegate = query.value("undelegate").toByteArray();
-        balance.delegated = query.value("delegated").toByteArray();
-        balance.undelegated = query.value("undelegated").toByteArray();
-        balance.reserved = query.value("reserved").toByteArray();
-        balance.forged = query.value("forged").toByteArray();
+        balance.delegate = decodeAmount(query.value("delegate"));
+        balance.undelegate = decodeAmount(query.value("undelegate"));
+        balance.delegated = decodeAmount(query.value("delegated"));
+        balance.undelegated = decodeAmount(query.value("undelegated"));
+        balance.reserved = decodeAmount(query.value("reserved"));
+        balance.forged = decodeAmount(query.value("forged"));
         balance.tokenBlockNum = static_cast<quint64>(query.value("tokenBlockNum").toLongLong());
     }
     return balance;
@@ -429,6 +790,35 @@ void TransactionsDBStorage::removeBalance(const QString &currency, const QString
     CHECK(queryDelete.exec(), queryDelete.lastError().text().toStdString());
 }
 
+void TransactionsDBStorage::setHistoryBackfill(const QString &currency, const QString &address, const HistoryBackfillInfo &info) {
+    QSqlQuery query(database());
+    CHECK(query.prepare(updateBalanceBackfill), query.lastError().text().toStdString());
+    query.bindValue(":currency", currency);
+    query.bindValue(":address", address);
+    query.bindValue(":backfillTarget", (qint64)info.targetTxs);
+    query.bindValue(":backfillSaved", (qint64)info.savedTxs);
+    CHECK(query.exec(), query.lastError().text().toStdString());
+    if (query.numRowsAffected() == 0) {
+        setBalance(currency, address, BalanceInfo(address));
+        CHECK(query.exec(), query.lastError().text().toStdString());
+    }
+}
+
+HistoryBackfillInfo TransactionsDBStorage::getHistoryBackfill(const QString &currency, const QString &address) {
+    QSqlQuery query(database());
+    CHECK(query.prepare(selectBalance), query.lastError().text().toStdString());
+    query.bindValue(":address", address);
+    query.bindValue(":currency", currency);
+    CHECK(query.exec(), query.lastError().text().toStdString());
+
+    HistoryBackfillInfo info;
+    if (query.next()) {
+        info.targetTxs = static_cast<quint64>(query.value("backfillTarget").toLongLong());
+        info.savedTxs = static_cast<quint64>(query.value("backfillSaved").toLongLong());
+    }
+    return info;
+}
+
 void TransactionsDBStorage::addToCurrency(bool isMhc, const QString &currency) {
     QSqlQuery queryDelete(database());
     CHECK(queryDelete.prepare(insertToCurrency), queryDelete.lastError().text().toStdString());
@@ -512,6 +902,60 @@ std::vector<TokenInfo> TransactionsDBStorage::getTokensForAddress(const QString&
     return res;
 }
 
+void TransactionsDBStorage::setBinaryAmounts(bool isBinary)
+{
+    setSettings(settingsAmountsEncoding, isBinary ? amountsEncodingBinary : amountsEncodingText);
+    binaryAmounts = isBinary;
+    isBinaryAmountsLoaded = true;
+}
+
+bool TransactionsDBStorage::isBinaryAmounts()
+{
+    if (!isBinaryAmountsLoaded) {
+        binaryAmounts = getSettings(settingsAmountsEncoding).toString() == amountsEncodingBinary;
+        isBinaryAmountsLoaded = true;
+    }
+    return binaryAmounts;
+}
+
+void TransactionsDBStorage::setAmountsEncoding(bool isBinary)
+{
+    if (isBinaryAmounts() == isBinary) {
+        return;
+    }
+    auto transactionGuard = beginTransaction();
+    setBinaryAmounts(isBinary);
+    convertAmounts(QStringLiteral("payments"), {QStringLiteral("value"), QStringLiteral("fee"), QStringLiteral("delegateValue")}, isBinary);
+    convertAmounts(QStringLiteral("balance"), {QStringLiteral("received"), QStringLiteral("spent"), QStringLiteral("delegate"), QStringLiteral("undelegate"),
+                                               QStringLiteral("delegated"), QStringLiteral("undelegated"), QStringLiteral("reserved"), QStringLiteral("forged")}, isBinary);
+    convertAmounts(QStringLiteral("paymentsStat"), {QStringLiteral("received"), QStringLiteral("spent")}, isBinary);
+    transactionGuard.commit();
+}
+
+void TransactionsDBStorage::convertAmounts(const QString &table, const QStringList &columns, bool isBinary)
+{
+    QStringList sets;
+    for (const QString &column: columns) {
+        sets.append(QString("%1 = :%1").arg(column));
+    }
+
+    QSqlQuery update(database());
+    CHECK(update.prepare(updateAmountsForConvert.arg(table, sets.join(", "))), update.lastError().text().toStdString());
+
+    QSqlQuery query(database());
+    query.setForwardOnly(true);
+    CHECK(query.prepare(selectAmountsForConvert.arg(table, columns.join(", "))), query.lastError().text().toStdString());
+    CHECK(query.exec(), query.lastError().text().toStdString());
+    while (query.next()) {
+        update.bindValue(":rid", query.value("rid"));
+        for (const QString &column: columns) {
+            const QVariant value = query.value(column);
+            update.bindValue(":" + column, value.isNull() ? value : encodeAmount(isBinary, decodeAmountString(value)));
+        }
+        CHECK(update.exec(), update.lastError().text().toStdString());
+    }
+}
+
 void TransactionsDBStorage::createDatabase()
 {
     createTable(QStringLiteral("payments"), createPaymentsTable);
@@ -520,13 +964,10 @@ void TransactionsDBStorage::createDatabase()
     createTable(QStringLiteral("currency"), createCurrencyTable);
     createTable(QStringLiteral("tokens"), createTokensTable);
     createTable(QStringLiteral("tokenBalances"), createTokenBalancesTable);
-    createIndex(createPaymentsIndex1);
-    createIndex(createPaymentsIndex2);
+    createTable(QStringLiteral("paymentsStat"), createPaymentsStatTable);
+    createIndex(createPaymentsIndex10);
     createIndex(createPaymentsIndex3);
-    createIndex(createPaymentsIndex4);
     createIndex(createPaymentsIndex5);
-    createIndex(createPaymentsIndex6);
-    createIndex(createPaymentsIndex7);
     createIndex(createPaymentsIndex8);
     createIndex(createBalanceIndex1);
     createIndex(createBalanceUniqueIndex);
@@ -534,6 +975,15 @@ void TransactionsDBStorage::createDatabase()
     createIndex(createTrackedUniqueIndex);
     createIndex(createCurrencyUniqueIndex);
     createIndex(createTokenBalancesUniqueIndex);
+    createIndex(createPaymentsStatUniqueIndex);
+}
+
+void TransactionsDBStorage::updatedDatabase(int oldVersion)
+{
+    if (oldVersion < 12) {
+        // paymentsStat created by payments_11to12.sql is filled in code, amounts may be BLOB
+        rebuildPaymentsStat();
+    }
 }
 
 void TransactionsDBStorage::setTransactionFromQuery(QSqlQuery& query, Transaction& trans) const
@@ -544,13 +994,13 @@ void TransactionsDBStorage::setTransactionFromQuery(QSqlQuery& query, Transactio
     trans.tx = query.value("txid").toString();
     trans.from = query.value("ufrom").toString();
     trans.to = query.value("uto").toString();
-    trans.value = query.value("value").toString();
+    trans.value = decodeAmountString(query.value("value"));
     trans.data = query.value("data").toString();
     trans.timestamp = static_cast<quint64>(query.value("ts").toLongLong());
-    trans.fee = query.value("fee").toString();
+    trans.fee = decodeAmountString(query.value("fee"));
     trans.nonce = query.value("nonce").toLongLong();
     trans.isDelegate = query.value("isDelegate").toBool();
-    trans.delegateValue = query.value("delegateValue").toString();
+    trans.delegateValue = decodeAmountString(query.value("delegateValue"));
     trans.delegateHash = query.value("delegateHash").toString();
     trans.status = static_cast<Transaction::Status>(query.value("status").toInt());
     trans.type = static_cast<Transaction::Type>(query.value("type").toInt());
@@ -3,10 +3,13 @@
 
 #include "dbstorage.h"
 #include "Transaction.h"
-#include "utilites/BigNumber.h"
+#include "utilites/BigNumber256.h"
+
+#include <QStringList>
 
 #include <vector>
 #include <set>
+#include <map>
 
 #include "TransactionsFilter.h"
 
@@ -15,7 +18,18 @@ namespace transactions {
 class TransactionsDBStorage : public DBStorage
 {
 public:
-    TransactionsDBStorage(const QString &path = QString());
+
+    struct PaymentsStat {
+        QString currency;
+        QString address;
+        qint64 countTxs = 0;
+        qint64 countPending = 0;
+        BigNumber256 received;
+        BigNumber256 spent;
+    };
+
+public:
+    TransactionsDBStorage(const QString &path = QString(), const QString &connectionName = QString());
 
     virtual int currentVersion() const final;
 
@@ -34,6 +48,10 @@ public:
     std::vector<Transaction> getPaymentsForAddressFilter(const QString &address, const QString &currency, const Filters &filters,
                                               qint64 offset, qint64 count, bool asc);
 
+    // Keyset page. Cost does not depend on how deep the page is
+    std::vector<Transaction> getPaymentsForAddressCursor(const QString &address, const QString &currency, const Filters &filters,
+                                              const TxsCursor &cursor, qint64 count, bool asc);
+
     std::vector<Transaction> getPaymentsForCurrency(const QString &group, const QString &currency,
                                                   qint64 offset, qint64 count, bool asc) const;
 
@@ -54,8 +72,16 @@ public:
     void updatePayment(const QString &address, const QString &currency, const QString &txid, qint64 blockNumber, qint64 index, const Transaction &trans);
     void removePaymentsForDest(const QString &address, const QString &currency);
 
+    // Reads maintained counter. Single addPayment should be called inside transaction to keep counter consistent
     qint64 getPaymentsCountForAddress(const QString &address, const QString &currency);
 
+    PaymentsStat getPaymentsStat(const QString &address, const QString &currency) const;
+
+    // Returns pairs of stored and recounted counters and sums that differ
+    std::vector<std::pair<PaymentsStat, PaymentsStat>> checkPaymentsStat();
+
+    void rebuildPaymentsStat();
+
     qint64 getIsSetDelegatePaymentsCountForAddress(const QString &address, const QString &currency, Transaction::Status status = Transaction::OK);
 
     void addTracked(const QString &currency, const QString &address, const QString &tgroup);
@@ -73,6 +99,11 @@ public:
 
     void removeBalance(const QString &currency, const QString &address);
 
+    // Creates empty balance if address has no balance yet. setBalance resets progress
+    void setHistoryBackfill(const QString &currency, const QString &address, const HistoryBackfillInfo &info);
+
+    HistoryBackfillInfo getHistoryBackfill(const QString &currency, const QString &address);
+
     void addToCurrency(bool isMhc, const QString &currency);
 
     std::map<bool, std::set<QString>> getAllCurrencys();
@@ -81,14 +112,36 @@ public:
     void updateTokenBalance(const TokenBalance& tokenBalance);
     std::vector<TokenInfo> getTokensForAddress(const QString& address = QString());
 
+    // Store amounts as little-endian BLOB instead of decimal TEXT. Rows of both kinds are readable
+    void setBinaryAmounts(bool isBinary);
+    bool isBinaryAmounts();
+
+    // setBinaryAmounts and rewrite the stored amounts in the new encoding, if it differs
+    void setAmountsEncoding(bool isBinary);
+
 protected:
     virtual void createDatabase() final;
 
+    virtual void updatedDatabase(int oldVersion) final;
+
 private:
+    void addPaymentsBulk(const std::vector<Transaction> &transactions);
+
+    // delta holds the changes of counters and sums
+    void changePaymentsStat(const PaymentsStat &delta);
+
+    std::map<std::pair<QString, QString>, PaymentsStat> recountPaymentsStat();
+
+    void convertAmounts(const QString &table, const QStringList &columns, bool isBinary);
+
     void setTransactionFromQuery(QSqlQuery &query, Transaction &trans) const;
 
     void createPaymentsList(QSqlQuery &query, std::vector<Transaction> &payments) const;
 
+private:
+    bool isBinaryAmountsLoaded = false;
+    bool binaryAmounts = false;
+
 };
 
 }
@@ -1,6 +1,8 @@
 #ifndef TRANSACTIONSFILTER_H
 #define TRANSACTIONSFILTER_H
 
+#include <QString>
+
 namespace transactions {
 
 enum class FilterType {
@@ -16,6 +18,14 @@ struct Filters {
     FilterType isSuccess = FilterType::None;
 };
 
+// Position after the last returned payment, in sort order ts, txid, id
+struct TxsCursor {
+    bool isSet = false;
+    qint64 ts = 0;
+    QString txid;
+    qint64 id = 0;
+};
+
 } // namespace transactions
 
 #endif // TRANSACTIONSFILTER_H
@@ -30,9 +30,11 @@ TransactionsJavascript::TransactionsJavascript()
     Q_CONNECT(this, &TransactionsJavascript::transactionInTorrentSig, this, &TransactionsJavascript::onTransactionInTorrent);
     Q_CONNECT(this, &TransactionsJavascript::transactionStatusChangedSig, this, &TransactionsJavascript::onTransactionStatusChanged);
     Q_CONNECT(this, &TransactionsJavascript::transactionStatusChanged2Sig, this, &TransactionsJavascript::onTransactionStatusChanged2);
+    Q_CONNECT(this, &TransactionsJavascript::transactionsBatchProgressSig, this, &TransactionsJavascript::onTransactionsBatchProgress);
 
     Q_REG(BalanceInfo, "BalanceInfo");
     Q_REG(Transaction, "Transaction");
+    Q_REG(BatchProgress, "BatchProgress");
 }
 
 static QJsonObject balanceToJson1(const BalanceInfo &balance) {
@@ -139,6 +141,55 @@ static QJsonDocument txInfoToJson(const Transaction &tx) {
     return QJsonDocument(txToJson(tx));
 }
 
+static QString batchStatusToString(const BatchProgress::Status &status) {
+    switch (status) {
+    case BatchProgress::Status::QUEUED:
+        return "queued";
+    case BatchProgress::Status::SENDED:
+        return "sended";
+    case BatchProgress::Status::SEND_ERROR:
+        return "send_error";
+    case BatchProgress::Status::NOT_SENT:
+        return "not_sent";
+    case BatchProgress::Status::PENDING:
+        return "pending";
+    case BatchProgress::Status::CONFIRMED:
+        return "confirmed";
+    case BatchProgress::Status::REJECTED:
+        return "rejected";
+    case BatchProgress::Status::NOT_FOUND:
+        return "not_found";
+    }
+    throwErr("Unknown batch status");
+}
+
+static QJsonDocument batchProgressToJson(const BatchProgress &progress) {
+    QJsonObject progressJson;
+    progressJson.insert("count", QString::number(progress.count));
+    progressJson.insert("sended", QString::number(progress.countSended));
+    progressJson.insert("sendErrors", QString::number(progress.countSendErrors));
+    progressJson.insert("notSent", QString::number(progress.countNotSent));
+    progressJson.insert("pending", QString::number(progress.countPending));
+    progressJson.insert("confirmed", QString::number(progress.countConfirmed));
+    progressJson.insert("rejected", QString::number(progress.countRejected));
+    progressJson.insert("notFound", QString::number(progress.countNotFound));
+    progressJson.insert("finished", progress.isFinished);
+
+    QJsonArray changedJson;
+    for (const BatchProgress::TxStatus &tx: progress.changed) {
+        QJsonObject txJson;
+        txJson.insert("index", QString::number(tx.index));
+        txJson.insert("nonce", QString::number(tx.nonce));
+        txJson.insert("hash", tx.hash);
+        txJson.insert("status", batchStatusToString(tx.status));
+        txJson.insert("error", tx.error);
+        changedJson.push_back(txJson);
+    }
+    progressJson.insert("txs", changedJson);
+
+    return QJsonDocument(progressJson);
+}
+
 static QJsonObject tokenToJson(const TokenInfo& token)
 {
     QJsonObject tokenJson;
@@ -170,6 +221,28 @@ static QJsonDocument tokensToJson(const std::vector<TokenInfo>& tokens)
     return QJsonDocument(messagesTokensJson);
 }
 
+static QJsonDocument balancePollStatsToJson(const BalancePollScheduler::Stats &stats) {
+    QJsonObject statsJson;
+    statsJson.insert("countAddresses", QString::fromStdString(std::to_string(stats.countAddresses)));
+    statsJson.insert("queueDepth", QString::fromStdString(std::to_string(stats.queueDepth)));
+    statsJson.insert("countPolls", QString::fromStdString(std::to_string(stats.countPolls)));
+    statsJson.insert("countBatches", QString::fromStdString(std::to_string(stats.countBatches)));
+    QJsonArray addressesJson;
+    for (const BalancePollScheduler::AddressPoll &poll: stats.addresses) {
+        QJsonObject pollJson;
+        pollJson.insert("currency", poll.currency);
+        pollJson.insert("address", poll.address);
+        pollJson.insert("intervalMs", QString::fromStdString(std::to_string(poll.interval.count())));
+        const milliseconds nextPollIn = std::max(milliseconds(0), std::chrono::duration_cast<milliseconds>(poll.nextPoll - stats.now));
+        pollJson.insert("nextPollMs", QString::fromStdString(std::to_string(nextPollIn.count())));
+        pollJson.insert("countPolls", QString::fromStdString(std::to_string(poll.countPolls)));
+        pollJson.insert("countChanges", QString::fromStdString(std::to_string(poll.countChanges)));
+        addressesJson.push_back(pollJson);
+    }
+    statsJson.insert("addresses", addressesJson);
+    return QJsonDocument(statsJson);
+}
+
 void TransactionsJavascript::onNewBalance(const QString &address, const QString &currency, const BalanceInfo &balance) {
 BEGIN_SLOT_WRAPPER
     const QString JS_NAME_RESULT = "txsNewBalanceJs";
@@ -373,6 +446,26 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void TransactionsJavascript::getTxsCursor(QString address, QString currency, QString filtersJson, QString cursor, int count, bool asc) {
+BEGIN_SLOT_WRAPPER
+    CHECK(transactionsManager != nullptr, "transactions not set");
+
+    const QString JS_NAME_RESULT = "txsGetTxsCursorJs";
+
+    LOG << "get txs cursor address " << address << " " << currency << " " << cursor << " " << count << " " << asc << " " << filtersJson;
+
+    const auto makeFunc = makeJavascriptReturnAndErrorFuncs(JS_NAME_RESULT, JsTypeReturn<QString>(address), JsTypeReturn<QString>(currency), JsTypeReturn<QJsonDocument>(QJsonDocument()), JsTypeReturn<QString>(""));
+
+    wrapOperation([&, this](){
+        const Filters filters = filtersJson.isEmpty() ? Filters() : jsonToFilters(filtersJson);
+        emit transactionsManager->getTxsCursor(address, currency, filters, cursor, count, asc, Transactions::GetTxsCursorCallback([address, currency, makeFunc](const std::vector<Transaction> &txs, const QString &nextCursor) {
+            LOG << "get txs cursor address ok " << address << " " << currency << " " << txs.size();
+            makeFunc.func(TypedException(), address, currency, txsToJson(txs), nextCursor);
+        }, makeFunc.error, signalFunc));
+    }, makeFunc.error);
+END_SLOT_WRAPPER
+}
+
 void TransactionsJavascript::getForgingTxsAll(QString address, QString currency, int from, int count, bool asc) {
 BEGIN_SLOT_WRAPPER
     CHECK(transactionsManager != nullptr, "transactions not set");
@@ -508,6 +601,25 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void TransactionsJavascript::getBalancePollStats() {
+BEGIN_SLOT_WRAPPER
+    CHECK(transactionsManager != nullptr, "transactions not set");
+
+    const QString JS_NAME_RESULT = "txsGetBalancePollStatsResultJs";
+
+    LOG << "getBalancePollStats";
+
+    const auto makeFunc = makeJavascriptReturnAndErrorFuncs(JS_NAME_RESULT, JsTypeReturn<QJsonDocument>(QJsonDocument()));
+
+    wrapOperation([&, this](){
+        emit transactionsManager->getBalancePollStats(Transactions::GetBalancePollStatsCallback([makeFunc](const BalancePollScheduler::Stats &stats) {
+            LOG << "Get balance poll stats ok " << stats.countAddresses << " " << stats.queueDepth;
+            makeFunc.func(TypedException(), balancePollStatsToJson(stats));
+        }, makeFunc.error, signalFunc));
+    }, makeFunc.error);
+END_SLOT_WRAPPER
+}
+
 void TransactionsJavascript::addCurrencyConformity(bool isMhc, QString currency) {
 BEGIN_SLOT_WRAPPER
     CHECK(transactionsManager != nullptr, "transactions not set");
@@ -603,4 +715,12 @@ BEGIN_SLOT_WRAPPER
 END_SLOT_WRAPPER
 }
 
+void TransactionsJavascript::onTransactionsBatchProgress(const QString &requestId, const BatchProgress &progress) {
+BEGIN_SLOT_WRAPPER
+    const QString JS_NAME_RESULT = "txsSendBatchProgressJs";
+    LOG << "Transactions batch progress " << requestId << " " << progress.countSended << " " << progress.countConfirmed << " " << progress.count << " " << progress.isFinished;
+    makeAndRunJsFuncParams(JS_NAME_RESULT, TypedException(), requestId, batchProgressToJson(progress));
+END_SLOT_WRAPPER
+}
+
 }
@@ -13,6 +13,7 @@ class Transactions;
 
 struct BalanceInfo;
 struct Transaction;
+struct BatchProgress;
 
 class TransactionsJavascript: public WrapperJavascript {
     Q_OBJECT
@@ -36,6 +37,8 @@ signals:
 
     void transactionStatusChanged2Sig(const QString &txHash, const Transaction &tx);
 
+    void transactionsBatchProgressSig(const QString &requestId, const BatchProgress &progress);
+
 private slots:
 
     void onNewBalance(const QString &address, const QString &currency, const BalanceInfo &balance);
@@ -48,6 +51,8 @@ private slots:
 
     void onTransactionStatusChanged2(const QString &txHash, const Transaction &tx);
 
+    void onTransactionsBatchProgress(const QString &requestId, const BatchProgress &progress);
+
 public slots:
 
     Q_INVOKABLE void registerAddress(QString address, QString currency, QString type, QString group, QString name);
@@ -64,6 +69,8 @@ public slots:
 
     Q_INVOKABLE void getTxsFilters(QString address, QString currency, QString filtersJson, int from, int count, bool asc);
 
+    Q_INVOKABLE void getTxsCursor(QString address, QString currency, QString filtersJson, QString cursor, int count, bool asc);
+
     Q_INVOKABLE void getForgingTxsAll(QString address, QString currency, int from, int count, bool asc);
 
     Q_INVOKABLE void getDelegateTxsAll(QString address, QString currency, QString to, int from, int count, bool asc);
@@ -78,6 +85,8 @@ public slots:
 
     Q_INVOKABLE void getLastUpdatedBalance(QString currency);
 
+    Q_INVOKABLE void getBalancePollStats();
+
     Q_INVOKABLE void addCurrencyConformity(bool isMhc, QString currency);
 
     Q_INVOKABLE void getTokensForAddress(QString address);
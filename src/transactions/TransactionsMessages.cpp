@@ -5,10 +5,14 @@
 #include <QJsonValue>
 #include <QJsonObject>
 
+#include <algorithm>
+
 #include "check.h"
 #include "Log.h"
 #include "duration.h"
 
+#include "utilites/JsonStreamReader.h"
+
 #include "Transaction.h"
 
 SET_LOG_NAMESPACE("TXS");
@@ -44,69 +48,167 @@ static QString getIntOrString(const QJsonObject &json, const QString &key) {
     }
 }
 
-static BalanceInfo parseBalanceResponseInternal(const QJsonObject &json) {
+// Streaming equivalent of getIntOrString: numbers are converted through double as QJsonValue does
+struct IntOrStringField {
+    bool isFound = false;
+    bool isNumber = false;
+    bool isString = false;
+    QString value;
+
+    void read(JsonStreamReader &reader) {
+        isFound = true;
+        const JsonStreamReader::Type type = reader.peekType();
+        if (type == JsonStreamReader::Type::Number) {
+            isNumber = true;
+            const QLatin1String number = reader.readNumber();
+            if (number.size() <= 15 && std::all_of(number.data(), number.data() + number.size(), [](char c) { return c >= '0' && c <= '9'; })) {
+                value = number;
+            } else {
+                value = QString::fromStdString(std::to_string(uint64_t(QByteArray::fromRawData(number.data(), number.size()).toDouble())));
+            }
+        } else if (type == JsonStreamReader::Type::String) {
+            isString = true;
+            value = reader.readString();
+        } else {
+            reader.skipValue();
+        }
+    }
+
+    const QString &get(const char *key) const {
+        CHECK(isFound && (isNumber || isString), "Incorrect json: " + std::string(key) + " field not found");
+        return value;
+    }
+};
+
+static bool readStringField(JsonStreamReader &reader, QString &value) {
+    if (reader.peekType() == JsonStreamReader::Type::String) {
+        value = reader.readString();
+        return true;
+    } else {
+        reader.skipValue();
+        return false;
+    }
+}
+
+static BalanceInfo readBalance(JsonStreamReader &reader) {
     BalanceInfo result;
 
-    CHECK(json.contains("address") && json.value("address").isString(), "Incorrect json: address field not found");
-    result.address = json.value("address").toString();
-    result.received = getIntOrString(json, "received");
-    result.spent = getIntOrString(json, "spent");
-    result.countReceived = getIntOrString(json, "count_received").toULong();
-    result.countSpent = getIntOrString(json, "count_spent").toULong();
-    result.countTxs = getIntOrString(json, "count_txs").toULong();
-    result.currBlockNum = getIntOrString(json, "currentBlock").toULong();
-
-    if (json.contains("countDelegatedOps")) {
-        result.countDelegated = getIntOrString(json, "countDelegatedOps").toULong();
-        result.delegate = getIntOrString(json, "delegate");
-        result.undelegate = getIntOrString(json, "undelegate");
-        result.delegated = getIntOrString(json, "delegated");
-        result.undelegated = getIntOrString(json, "undelegated");
-        if (json.contains("reserved")) {
-            result.reserved = getIntOrString(json, "reserved");
+    bool isAddress = false;
+    IntOrStringField received, spent, countReceived, countSpent, countTxs, currentBlock;
+    IntOrStringField countDelegatedOps, delegate, undelegate, delegated, undelegated, reserved;
+    IntOrStringField tokenBlockNumber, forged;
+
+    reader.beginObject();
+    QLatin1String key;
+    while (reader.nextKey(key)) {
+        if (key == QLatin1String("address")) {
+            isAddress = readStringField(reader, result.address);
+        } else if (key == QLatin1String("received")) {
+            received.read(reader);
+        } else if (key == QLatin1String("spent")) {
+            spent.read(reader);
+        } else if (key == QLatin1String("count_received")) {
+            countReceived.read(reader);
+        } else if (key == QLatin1String("count_spent")) {
+            countSpent.read(reader);
+        } else if (key == QLatin1String("count_txs")) {
+            countTxs.read(reader);
+        } else if (key == QLatin1String("currentBlock")) {
+            currentBlock.read(reader);
+        } else if (key == QLatin1String("countDelegatedOps")) {
+            countDelegatedOps.read(reader);
+        } else if (key == QLatin1String("delegate")) {
+            delegate.read(reader);
+        } else if (key == QLatin1String("undelegate")) {
+            undelegate.read(reader);
+        } else if (key == QLatin1String("delegated")) {
+            delegated.read(reader);
+        } else if (key == QLatin1String("undelegated")) {
+            undelegated.read(reader);
+        } else if (key == QLatin1String("reserved")) {
+            reserved.read(reader);
+        } else if (key == QLatin1String("token_block_number")) {
+            tokenBlockNumber.read(reader);
+        } else if (key == QLatin1String("forged")) {
+            forged.read(reader);
+        } else {
+            reader.skipValue();
+        }
+    }
+
+    CHECK(isAddress, "Incorrect json: address field not found");
+    result.received = received.get("received");
+    result.spent = spent.get("spent");
+    result.countReceived = countReceived.get("count_received").toULong();
+    result.countSpent = countSpent.get("count_spent").toULong();
+    result.countTxs = countTxs.get("count_txs").toULong();
+    result.currBlockNum = currentBlock.get("currentBlock").toULong();
+
+    if (countDelegatedOps.isFound) {
+        result.countDelegated = countDelegatedOps.get("countDelegatedOps").toULong();
+        result.delegate = delegate.get("delegate");
+        result.undelegate = undelegate.get("undelegate");
+        result.delegated = delegated.get("delegated");
+        result.undelegated = undelegated.get("undelegated");
+        if (reserved.isFound) {
+            result.reserved = reserved.get("reserved");
         } else {
             result.reserved = QString("0");
         }
     }
 
-    if (json.contains("token_block_number")) {
-        result.tokenBlockNum = getIntOrString(json, "token_block_number").toULong();
+    if (tokenBlockNumber.isFound) {
+        result.tokenBlockNum = tokenBlockNumber.get("token_block_number").toULong();
     }
 
-    if (json.contains("forged")) {
-        result.forged = getIntOrString(json, "forged");
+    if (forged.isFound) {
+        result.forged = forged.get("forged");
     }
 
     return result;
 }
 
-BalanceInfo parseBalanceResponse(const QString &response) {
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(response.toUtf8());
-    CHECK(jsonResponse.isObject(), "Incorrect json ");
-    const QJsonObject &json1 = jsonResponse.object();
-    CHECK(json1.contains("result") && json1.value("result").isObject(), "Incorrect json: result field not found");
-    const QJsonObject &json = json1.value("result").toObject();
+// Calls readResult when top level object contains result field of the expected type. Other fields are skipped
+static void readResponse(JsonStreamReader &reader, JsonStreamReader::Type resultType, const std::function<void(JsonStreamReader &reader)> &readResult) {
+    CHECK(reader.peekType() == JsonStreamReader::Type::Object, "Incorrect json ");
+    bool isResult = false;
+    reader.beginObject();
+    QLatin1String key;
+    while (reader.nextKey(key)) {
+        if (!isResult && key == QLatin1String("result") && reader.peekType() == resultType) {
+            isResult = true;
+            readResult(reader);
+        } else {
+            reader.skipValue();
+        }
+    }
+    reader.finish();
+    CHECK(isResult, "Incorrect json: result field not found");
+}
 
-    return parseBalanceResponseInternal(json);
+BalanceInfo parseBalanceResponse(const std::string &response) {
+    JsonStreamReader reader(response);
+    BalanceInfo result;
+    readResponse(reader, JsonStreamReader::Type::Object, [&result](JsonStreamReader &reader) {
+        result = readBalance(reader);
+    });
+    return result;
 }
 
-void parseBalancesResponseWithHandler(const QString &response, const std::function<void(const BalanceInfo &info)> &handler)
+// Balances are passed to handler one by one as they are parsed
+static void parseBalancesResponseWithHandler(const std::string &response, const std::function<void(const BalanceInfo &info)> &handler)
 {
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(response.toUtf8());
-    CHECK(jsonResponse.isObject(), "Incorrect json ");
-    const QJsonObject &json1 = jsonResponse.object();
-    CHECK(json1.contains("result") && json1.value("result").isArray(), "Incorrect json: result field not found");
-    const QJsonArray &json = json1.value("result").toArray();
-
-    std::vector<BalanceInfo> result;
-    for (const auto &j: json) {
-        CHECK(j.isObject(), "result field not found");
-        BalanceInfo info = parseBalanceResponseInternal(j.toObject());
-        handler(info);
-    }
+    JsonStreamReader reader(response);
+    readResponse(reader, JsonStreamReader::Type::Array, [&handler](JsonStreamReader &reader) {
+        reader.beginArray();
+        while (reader.nextElement()) {
+            CHECK(reader.peekType() == JsonStreamReader::Type::Object, "result field not found");
+            handler(readBalance(reader));
+        }
+    });
 }
 
-std::vector<BalanceInfo> parseBalancesResponse(const QString &response)
+std::vector<BalanceInfo> parseBalancesResponse(const std::string &response)
 {
     std::vector<BalanceInfo> result;
     parseBalancesResponseWithHandler(response, [&result](const BalanceInfo &info) {
@@ -116,7 +218,7 @@ std::vector<BalanceInfo> parseBalancesResponse(const QString &response)
     return result;
 }
 
-std::map<QString, BalanceInfo> parseBalancesResponseToMap(const QString &response)
+std::map<QString, BalanceInfo> parseBalancesResponseToMap(const std::string &response)
 {
     std::map<QString, BalanceInfo> result;
     parseBalancesResponseWithHandler(response, [&result](const BalanceInfo &info) {
@@ -137,33 +239,81 @@ QString makeGetTxRequest(const QString &hash) {
     return "{\"id\":1,\"params\":{\"hash\": \"" + hash + "\"},\"method\":\"get-tx\", \"pretty\": false}";
 }
 
-static Transaction parseTransaction(const QJsonObject &txJson, const QString &address, const QString &currency) {
+static Transaction readTransaction(JsonStreamReader &reader, const QString &address, const QString &currency) {
     Transaction res;
 
-    CHECK(txJson.contains("from") && txJson.value("from").isString(), "Incorrect json: from field not found");
-    res.from = txJson.value("from").toString();
-    CHECK(txJson.contains("to") && txJson.value("to").isString(), "Incorrect json: to field not found");
-    res.to = txJson.value("to").toString();
-    res.value = getIntOrString(txJson, "value");
-    CHECK(txJson.contains("transaction") && txJson.value("transaction").isString(), "Incorrect json: transaction field not found");
-    res.tx = txJson.value("transaction").toString();
-    CHECK(txJson.contains("data") && txJson.value("data").isString(), "Incorrect json: data field not found");
-    res.data = txJson.value("data").toString();
-    res.timestamp = getIntOrString(txJson, "timestamp").toULongLong();
-    res.fee = getIntOrString(txJson, "realFee");
-    CHECK(txJson.contains("nonce") && txJson.value("nonce").isDouble(), "Incorrect json: nonce field not found");
-    res.nonce = getIntOrString(txJson, "nonce").toLong();
-    if (txJson.contains("delegate_info") && txJson.value("delegate_info").isObject()) {
-        const auto &delegateJson = txJson.value("delegate_info").toObject();
-        res.isDelegate = delegateJson.value("isDelegate").toBool();
-        res.delegateValue = getIntOrString(delegateJson, "delegate");
-        if (delegateJson.contains("delegateHash") && delegateJson.value("delegateHash").isString()) {
-            res.delegateHash = delegateJson.value("delegateHash").toString();
+    bool isFrom = false, isTo = false, isTransaction = false, isData = false, isStatus = false;
+    bool isDelegateInfo = false, isForging = false, isScriptInfo = false;
+    IntOrStringField value, timestamp, realFee, nonce, blockNumber, blockIndex, delegate;
+    QString status;
+
+    reader.beginObject();
+    QLatin1String key;
+    while (reader.nextKey(key)) {
+        if (key == QLatin1String("from")) {
+            isFrom = readStringField(reader, res.from);
+        } else if (key == QLatin1String("to")) {
+            isTo = readStringField(reader, res.to);
+        } else if (key == QLatin1String("value")) {
+            value.read(reader);
+        } else if (key == QLatin1String("transaction")) {
+            isTransaction = readStringField(reader, res.tx);
+        } else if (key == QLatin1String("data")) {
+            isData = readStringField(reader, res.data);
+        } else if (key == QLatin1String("timestamp")) {
+            timestamp.read(reader);
+        } else if (key == QLatin1String("realFee")) {
+            realFee.read(reader);
+        } else if (key == QLatin1String("nonce")) {
+            nonce.read(reader);
+        } else if (key == QLatin1String("delegate_info") && reader.peekType() == JsonStreamReader::Type::Object) {
+            isDelegateInfo = true;
+            res.isDelegate = false;
+            reader.beginObject();
+            while (reader.nextKey(key)) {
+                if (key == QLatin1String("isDelegate") && reader.peekType() == JsonStreamReader::Type::Bool) {
+                    res.isDelegate = reader.readBool();
+                } else if (key == QLatin1String("delegate")) {
+                    delegate.read(reader);
+                } else if (key == QLatin1String("delegateHash")) {
+                    readStringField(reader, res.delegateHash);
+                } else {
+                    reader.skipValue();
+                }
+            }
+        } else if (key == QLatin1String("status")) {
+            isStatus = readStringField(reader, status);
+        } else if (key == QLatin1String("blockNumber")) {
+            blockNumber.read(reader);
+        } else if (key == QLatin1String("blockIndex")) {
+            blockIndex.read(reader);
+        } else if (key == QLatin1String("type")) {
+            QString type;
+            isForging = readStringField(reader, type) && type == "forging";
+        } else if (key == QLatin1String("script_info")) {
+            isScriptInfo = reader.peekType() == JsonStreamReader::Type::Object;
+            reader.skipValue();
+        } else if (key == QLatin1String("intStatus") && reader.peekType() == JsonStreamReader::Type::Number) {
+            res.intStatus = static_cast<int>(reader.readDouble());
+        } else {
+            reader.skipValue();
         }
+    }
+
+    CHECK(isFrom, "Incorrect json: from field not found");
+    CHECK(isTo, "Incorrect json: to field not found");
+    res.value = value.get("value");
+    CHECK(isTransaction, "Incorrect json: transaction field not found");
+    CHECK(isData, "Incorrect json: data field not found");
+    res.timestamp = timestamp.get("timestamp").toULongLong();
+    res.fee = realFee.get("realFee");
+    CHECK(nonce.isNumber, "Incorrect json: nonce field not found");
+    res.nonce = nonce.get("nonce").toLong();
+    if (isDelegateInfo) {
+        res.delegateValue = delegate.get("delegate");
         res.type = Transaction::DELEGATE;
     }
-    CHECK(txJson.contains("status") && txJson.value("status").isString(), "Incorrect json: status field not found");
-    const QString status = txJson.value("status").toString();
+    CHECK(isStatus, "Incorrect json: status field not found");
     if (status == "ok") {
         res.status = Transaction::OK;
     } else if (status == "error") {
@@ -174,45 +324,34 @@ static Transaction parseTransaction(const QJsonObject &txJson, const QString &ad
         res.status = Transaction::MODULE_NOT_SET;
     }
 
-    CHECK(txJson.contains("blockNumber") && txJson.value("blockNumber").isDouble(), "Incorrect json: blockNumber field not found");
-    res.blockNumber = getIntOrString(txJson, "blockNumber").toLong();
+    CHECK(blockNumber.isNumber, "Incorrect json: blockNumber field not found");
+    res.blockNumber = blockNumber.get("blockNumber").toLong();
 
-    CHECK(txJson.contains("blockIndex") && txJson.value("blockIndex").isDouble(), "Incorrect json: blockIndex field not found");
-    res.blockIndex = getIntOrString(txJson, "blockIndex").toLong();
+    CHECK(blockIndex.isNumber, "Incorrect json: blockIndex field not found");
+    res.blockIndex = blockIndex.get("blockIndex").toLong();
 
-    if (txJson.contains("type") && txJson.value("type").isString() && txJson.value("type").toString() == "forging") {
+    if (isForging) {
         res.type = Transaction::FORGING;
     }
-    if (txJson.contains("script_info") && txJson.value("script_info").isObject()) {
+    if (isScriptInfo) {
         res.type = Transaction::CONTRACT;
     }
-    if (txJson.contains("intStatus") && txJson.value("intStatus").isDouble()) {
-        res.intStatus = txJson.value("intStatus").toInt();
-    }
 
     res.address = address;
     res.currency = currency;
     return res;
 }
 
-std::vector<Transaction> parseHistoryResponse(const QString &address, const QString &currency, const QString &response) {
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(response.toUtf8());
-    CHECK(jsonResponse.isObject(), "Incorrect json ");
-    const QJsonObject &json1 = jsonResponse.object();
-    CHECK(json1.contains("result") && json1.value("result").isArray(), "Incorrect json: result field not found");
-    const QJsonArray &json = json1.value("result").toArray();
-
+std::vector<Transaction> parseHistoryResponse(const QString &address, const QString &currency, const std::string &response) {
     std::vector<Transaction> result;
-
-    for (const QJsonValue &elementJson: json) {
-        CHECK(elementJson.isObject(), "Incorrect json");
-        const QJsonObject txJson = elementJson.toObject();
-
-        const Transaction res = parseTransaction(txJson, address, currency);
-
-        result.emplace_back(res);
-    }
-
+    JsonStreamReader reader(response);
+    readResponse(reader, JsonStreamReader::Type::Array, [&address, &currency, &result](JsonStreamReader &reader) {
+        reader.beginArray();
+        while (reader.nextElement()) {
+            CHECK(reader.peekType() == JsonStreamReader::Type::Object, "Incorrect json");
+            result.emplace_back(readTransaction(reader, address, currency));
+        }
+    });
     return result;
 }
 
@@ -242,17 +381,50 @@ QString parseSendTransactionResponse(const QString &response) {
     return json1.value("params").toString();
 }
 
-Transaction parseGetTxResponse(const QString &response, const QString &address, const QString &currency) {
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(response.toUtf8());
-    CHECK(jsonResponse.isObject(), "Incorrect json ");
-    const QJsonObject &json1 = jsonResponse.object();
-    CHECK(!json1.contains("error") || !json1.value("error").isObject(), json1.value("error").toObject().value("message").toString().toStdString());
+Transaction parseGetTxResponse(const std::string &response, const QString &address, const QString &currency) {
+    JsonStreamReader reader(response);
+    CHECK(reader.peekType() == JsonStreamReader::Type::Object, "Incorrect json ");
+
+    bool isError = false;
+    QString errorMessage;
+    bool isResult = false;
+    bool isTransaction = false;
+    Transaction result;
+
+    reader.beginObject();
+    QLatin1String key;
+    while (reader.nextKey(key)) {
+        if (key == QLatin1String("error") && reader.peekType() == JsonStreamReader::Type::Object) {
+            isError = true;
+            reader.beginObject();
+            while (reader.nextKey(key)) {
+                if (key == QLatin1String("message")) {
+                    readStringField(reader, errorMessage);
+                } else {
+                    reader.skipValue();
+                }
+            }
+        } else if (key == QLatin1String("result") && reader.peekType() == JsonStreamReader::Type::Object) {
+            isResult = true;
+            reader.beginObject();
+            while (reader.nextKey(key)) {
+                if (key == QLatin1String("transaction") && reader.peekType() == JsonStreamReader::Type::Object) {
+                    isTransaction = true;
+                    result = readTransaction(reader, address, currency);
+                } else {
+                    reader.skipValue();
+                }
+            }
+        } else {
+            reader.skipValue();
+        }
+    }
+    reader.finish();
 
-    CHECK(json1.contains("result") && json1.value("result").isObject(), "Incorrect json: result field not found");
-    const QJsonObject &obj = json1.value("result").toObject();
-    CHECK(obj.contains("transaction") && obj.value("transaction").isObject(), "Incorrect json: transaction field not found");
-    const QJsonObject &transaction = obj.value("transaction").toObject();
-    return parseTransaction(transaction, address, currency);
+    CHECK(!isError, errorMessage.toStdString());
+    CHECK(isResult, "Incorrect json: result field not found");
+    CHECK(isTransaction, "Incorrect json: transaction field not found");
+    return result;
 }
 
 QString makeGetBlockInfoRequest(int64_t blockNumber) {
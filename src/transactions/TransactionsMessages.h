@@ -6,6 +6,7 @@
 #include <vector>
 #include <map>
 #include <functional>
+#include <string>
 
 namespace transactions {
 
@@ -18,27 +19,25 @@ struct Token;
 
 QString makeGetBalanceRequest(const QString &address);
 
-BalanceInfo parseBalanceResponse(const QString &response);
+BalanceInfo parseBalanceResponse(const std::string &response);
 
 QString makeGetBalancesRequest(const std::vector<QString> &addresses);
 
-void parseBalancesResponseWithHandler(const QString &response, const std::function<void(const BalanceInfo &info)> &handler);
+std::vector<BalanceInfo> parseBalancesResponse(const std::string &response);
 
-std::vector<BalanceInfo> parseBalancesResponse(const QString &response);
-
-std::map<QString, BalanceInfo> parseBalancesResponseToMap(const QString &response);
+std::map<QString, BalanceInfo> parseBalancesResponseToMap(const std::string &response);
 
 QString makeGetHistoryRequest(const QString &address, bool isCnt, uint64_t fromTx, uint64_t cnt);
 
 QString makeGetTxRequest(const QString &hash);
 
-std::vector<Transaction> parseHistoryResponse(const QString &address, const QString &currency, const QString &response);
+std::vector<Transaction> parseHistoryResponse(const QString &address, const QString &currency, const std::string &response);
 
 QString makeSendTransactionRequest(const QString &to, const QString &value, size_t nonce, const QString &data, const QString &fee, const QString &pubkey, const QString &sign);
 
 QString parseSendTransactionResponse(const QString &response);
 
-Transaction parseGetTxResponse(const QString &response, const QString &address, const QString &currency);
+Transaction parseGetTxResponse(const std::string &response, const QString &address, const QString &currency);
 
 QString makeGetBlockInfoRequest(int64_t blockNumber);
 
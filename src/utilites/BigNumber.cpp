@@ -2,6 +2,8 @@
 
 #include <QByteArray>
 
+#include <algorithm>
+
 #include <openssl/bn.h>
 
 #include "check.h"
@@ -59,6 +61,30 @@ QByteArray BigNumber::getDecimal() const
     return res;
 }
 
+void BigNumber::setLittleEndian(const QByteArray &bytes)
+{
+    QByteArray bigEndian(bytes.size(), '\0');
+    std::reverse_copy(bytes.begin(), bytes.end(), bigEndian.begin());
+    CHECK(BN_bin2bn(reinterpret_cast<const unsigned char*>(bigEndian.data()), bigEndian.size(), ptr.get()) != nullptr, "BN error");
+}
+
+QByteArray BigNumber::getLittleEndian(int size) const
+{
+    const int countBytes = this->countBytes();
+    if (isNegative() || countBytes > size) {
+        return QByteArray();
+    }
+    QByteArray result(size, '\0');
+    BN_bn2bin(ptr.get(), reinterpret_cast<unsigned char*>(result.data()));
+    std::reverse(result.begin(), result.begin() + countBytes);
+    return result;
+}
+
+int BigNumber::countBytes() const
+{
+    return BN_num_bytes(ptr.get());
+}
+
 #include <QDebug>
 QString BigNumber::getFracDecimal(int mod) const
 {
@@ -22,6 +22,11 @@ public:
     void setDecimal(const QByteArray &dec);
     QByteArray getDecimal() const;
 
+    void setLittleEndian(const QByteArray &bytes);
+    // Returns empty array if number is negative or not fit in size bytes
+    QByteArray getLittleEndian(int size) const;
+    int countBytes() const;
+
     QString getFracDecimal(int mod) const;
 
     quint32 divAndModToWord(quint32 w, BigNumber &div) const;
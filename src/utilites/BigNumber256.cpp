@@ -0,0 +1,224 @@
+#include "BigNumber256.h"
+
+#include <QByteArray>
+
+#include <algorithm>
+
+#include "check.h"
+
+static const uint32_t DECIMAL_CHUNK = 1000000000;
+static const int DECIMAL_CHUNK_DIGITS = 9;
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    } else {
+        return -1;
+    }
+}
+
+BigNumber256::BigNumber256(const QByteArray &dec)
+{
+    setDecimal(dec);
+}
+
+BigNumber256::BigNumber256(const QString &dec)
+{
+    setDecimal(dec.toUtf8());
+}
+
+bool BigNumber256::parseDecimal(const QByteArray &dec, BigNumber256 &result)
+{
+    // Same as BN_dec2bn: optional minus and leading digits, the rest is ignored
+    result = BigNumber256();
+    int pos = 0;
+    bool isNegative = false;
+    if (pos < dec.size() && dec.at(pos) == '-') {
+        isNegative = true;
+        pos++;
+    }
+    while (pos < dec.size() && dec.at(pos) >= '0' && dec.at(pos) <= '9') {
+        uint32_t multiplier = 1;
+        uint32_t chunk = 0;
+        for (int i = 0; i < DECIMAL_CHUNK_DIGITS && pos < dec.size() && dec.at(pos) >= '0' && dec.at(pos) <= '9'; i++, pos++) {
+            multiplier *= 10;
+            chunk = chunk * 10 + (dec.at(pos) - '0');
+        }
+        if (mulAddWord(result, multiplier, chunk) != 0) {
+            return false;
+        }
+    }
+    result.negative = isNegative && !result.isZero();
+    return true;
+}
+
+void BigNumber256::setDecimal(const QByteArray &dec)
+{
+    CHECK(parseDecimal(dec, *this), "Number " + dec.toStdString() + " is too big for 256 bit");
+}
+
+QByteArray BigNumber256::getDecimal() const
+{
+    if (isZero()) {
+        return "0";
+    }
+    char buffer[countBytesMax * 3 + 2];
+    char *end = buffer + sizeof(buffer);
+    char *begin = end;
+    BigNumber256 value = *this;
+    while (!isZeroMagnitude(value)) {
+        uint32_t chunk = divModWord(value, DECIMAL_CHUNK);
+        const bool isLast = isZeroMagnitude(value);
+        for (int i = 0; i < DECIMAL_CHUNK_DIGITS && (!isLast || chunk != 0); i++) {
+            *--begin = '0' + chunk % 10;
+            chunk /= 10;
+        }
+    }
+    if (negative) {
+        *--begin = '-';
+    }
+    return QByteArray(begin, static_cast<int>(end - begin));
+}
+
+void BigNumber256::setHex(const QByteArray &hex)
+{
+    *this = BigNumber256();
+    int pos = 0;
+    bool isNegative = false;
+    if (pos < hex.size() && hex.at(pos) == '-') {
+        isNegative = true;
+        pos++;
+    }
+    for (; pos < hex.size(); pos++) {
+        const int digit = hexDigit(hex.at(pos));
+        CHECK(digit >= 0, "Incorrect hex number " + hex.toStdString());
+        CHECK(mulAddWord(*this, 16, static_cast<uint32_t>(digit)) == 0, "Number " + hex.toStdString() + " is too big for 256 bit");
+    }
+    negative = isNegative && !isZero();
+}
+
+QByteArray BigNumber256::getHex() const
+{
+    if (isZero()) {
+        return "0";
+    }
+    static const char digits[] = "0123456789abcdef";
+    QByteArray result;
+    result.reserve(countBytesMax * 2 + 1);
+    if (negative) {
+        result += '-';
+    }
+    bool isLeading = true;
+    for (int i = countLimbs - 1; i >= 0; i--) {
+        for (int shift = 60; shift >= 0; shift -= 4) {
+            const int digit = static_cast<int>((limbs[i] >> shift) & 0xF);
+            if (isLeading && digit == 0) {
+                continue;
+            }
+            isLeading = false;
+            result += digits[digit];
+        }
+    }
+    return result;
+}
+
+void BigNumber256::setLittleEndian(const QByteArray &bytes)
+{
+    *this = BigNumber256();
+    for (int i = 0; i < bytes.size(); i++) {
+        const uint64_t byte = static_cast<unsigned char>(bytes.at(i));
+        if (i >= countBytesMax) {
+            CHECK(byte == 0, "Number is too big for 256 bit");
+            continue;
+        }
+        limbs[i / 8] |= byte << (8 * (i % 8));
+    }
+}
+
+QByteArray BigNumber256::getLittleEndian(int size) const
+{
+    const int countBytes = this->countBytes();
+    if (isNegative() || countBytes > size) {
+        return QByteArray();
+    }
+    QByteArray result(size, '\0');
+    for (int i = 0; i < countBytes; i++) {
+        result[i] = static_cast<char>((limbs[i / 8] >> (8 * (i % 8))) & 0xFF);
+    }
+    return result;
+}
+
+int BigNumber256::countBytes() const
+{
+    for (int i = countLimbs - 1; i >= 0; i--) {
+        if (limbs[i] != 0) {
+            int bytes = 8;
+            while ((limbs[i] >> (8 * (bytes - 1))) == 0) {
+                bytes--;
+            }
+            return i * 8 + bytes;
+        }
+    }
+    return 0;
+}
+
+QString BigNumber256::getFracDecimal(int mod) const
+{
+    quint32 w = 1;
+    for (int i = 0; i < mod; i++)
+        w *= 10;
+    BigNumber256 p;
+    quint32 q = divAndModToWord(w, p);
+    QString ret = QString::fromLatin1(p.getDecimal());
+    QString sq = QString::number(q);
+    sq = sq.rightJustified(mod, '0');
+    int n = mod - 1;
+    for (; n >= 0; n--)
+        if (sq.at(n) != '0')
+            break;
+    sq = sq.left(n + 1);
+    if (!sq.isEmpty())
+        ret += QStringLiteral(".") + sq;
+    return ret;
+}
+
+quint32 BigNumber256::divAndModToWord(quint32 w, BigNumber256 &div) const
+{
+    CHECK(w != 0, "Division by zero");
+    div = *this;
+    const quint32 mod = divModWord(div, w);
+    if (div.isZero()) {
+        div.negative = false;
+    }
+    return mod;
+}
+
+BigNumber256 &BigNumber256::operator+=(const BigNumber256 &rhs)
+{
+    CHECK(addSigned(rhs, rhs.negative), "BigNumber256 overflow");
+    return *this;
+}
+
+BigNumber256 &BigNumber256::operator-=(const BigNumber256 &rhs)
+{
+    CHECK(addSigned(rhs, !rhs.negative), "BigNumber256 overflow");
+    return *this;
+}
+
+const BigNumber256 operator+(const BigNumber256 &lhs, const BigNumber256 &rhs)
+{
+    BigNumber256 res(lhs);
+    res += rhs;
+    return res;
+}
+
+const BigNumber256 operator-(const BigNumber256 &lhs, const BigNumber256 &rhs)
+{
+    BigNumber256 res(lhs);
+    res -= rhs;
+    return res;
+}
@@ -0,0 +1,189 @@
+#ifndef BIGNUMBER256_H
+#define BIGNUMBER256_H
+
+#include <QString>
+
+#include <cstdint>
+
+class QByteArray;
+
+// Fixed width alternative to BigNumber without heap allocations.
+// Stores 256-bit unsigned magnitude and sign, so interface and semantic repeat BigNumber
+class BigNumber256 {
+public:
+
+    static const int countLimbs = 4;
+
+    static const int countBytesMax = countLimbs * 8;
+
+public:
+
+    constexpr BigNumber256() = default;
+
+    constexpr explicit BigNumber256(uint64_t value)
+        : limbs{value, 0, 0, 0}
+    {}
+
+    BigNumber256(const QByteArray &dec);
+    BigNumber256(const QString &dec);
+
+    constexpr bool isZero() const {
+        return isZeroMagnitude(*this);
+    }
+
+    constexpr bool isNegative() const {
+        return negative;
+    }
+
+    void setDecimal(const QByteArray &dec);
+    QByteArray getDecimal() const;
+
+    // Returns false if dec not a number or not fit in 256 bit
+    static bool parseDecimal(const QByteArray &dec, BigNumber256 &result);
+
+    void setHex(const QByteArray &hex);
+    QByteArray getHex() const;
+
+    void setLittleEndian(const QByteArray &bytes);
+    // Returns empty array if number is negative or not fit in size bytes
+    QByteArray getLittleEndian(int size) const;
+    int countBytes() const;
+
+    QString getFracDecimal(int mod) const;
+
+    quint32 divAndModToWord(quint32 w, BigNumber256 &div) const;
+
+    BigNumber256 &operator+=(const BigNumber256 &rhs);
+    BigNumber256 &operator-=(const BigNumber256 &rhs);
+
+    constexpr int compare(const BigNumber256 &second) const {
+        if (negative != second.negative) {
+            return negative ? -1 : 1;
+        }
+        const int cmp = compareMagnitude(*this, second);
+        return negative ? -cmp : cmp;
+    }
+
+    constexpr bool operator==(const BigNumber256 &second) const {
+        return compare(second) == 0;
+    }
+
+    constexpr bool operator!=(const BigNumber256 &second) const {
+        return compare(second) != 0;
+    }
+
+    constexpr bool operator<(const BigNumber256 &second) const {
+        return compare(second) < 0;
+    }
+
+    constexpr bool operator>(const BigNumber256 &second) const {
+        return compare(second) > 0;
+    }
+
+    // Returns false on overflow
+    constexpr bool addSigned(const BigNumber256 &rhs, bool rhsNegative) {
+        bool isOverflow = false;
+        if (negative == rhsNegative) {
+            isOverflow = addMagnitude(*this, rhs) != 0;
+        } else if (compareMagnitude(*this, rhs) >= 0) {
+            subMagnitude(*this, rhs);
+        } else {
+            BigNumber256 tmp = rhs;
+            subMagnitude(tmp, *this);
+            for (int i = 0; i < countLimbs; i++) {
+                limbs[i] = tmp.limbs[i];
+            }
+            negative = rhsNegative;
+        }
+        if (isZeroMagnitude(*this)) {
+            negative = false;
+        }
+        return !isOverflow;
+    }
+
+private:
+
+    static constexpr bool isZeroMagnitude(const BigNumber256 &a) {
+        for (int i = 0; i < countLimbs; i++) {
+            if (a.limbs[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr int compareMagnitude(const BigNumber256 &a, const BigNumber256 &b) {
+        for (int i = countLimbs - 1; i >= 0; i--) {
+            if (a.limbs[i] != b.limbs[i]) {
+                return a.limbs[i] < b.limbs[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    // Returns carry
+    static constexpr uint64_t addMagnitude(BigNumber256 &a, const BigNumber256 &b) {
+        uint64_t carry = 0;
+        for (int i = 0; i < countLimbs; i++) {
+            const uint64_t sum = a.limbs[i] + b.limbs[i];
+            const uint64_t carry1 = sum < a.limbs[i] ? 1 : 0;
+            const uint64_t result = sum + carry;
+            const uint64_t carry2 = result < sum ? 1 : 0;
+            a.limbs[i] = result;
+            carry = carry1 | carry2;
+        }
+        return carry;
+    }
+
+    // a >= b required
+    static constexpr void subMagnitude(BigNumber256 &a, const BigNumber256 &b) {
+        uint64_t borrow = 0;
+        for (int i = 0; i < countLimbs; i++) {
+            const uint64_t diff = a.limbs[i] - b.limbs[i];
+            const uint64_t borrow1 = a.limbs[i] < b.limbs[i] ? 1 : 0;
+            const uint64_t result = diff - borrow;
+            const uint64_t borrow2 = diff < borrow ? 1 : 0;
+            a.limbs[i] = result;
+            borrow = borrow1 | borrow2;
+        }
+    }
+
+    // a = a * m + add. Returns carry
+    static constexpr uint64_t mulAddWord(BigNumber256 &a, uint32_t m, uint32_t add) {
+        uint64_t carry = add;
+        for (int i = 0; i < countLimbs; i++) {
+            const uint64_t lo = (a.limbs[i] & 0xFFFFFFFFULL) * m + carry;
+            carry = lo >> 32;
+            const uint64_t hi = (a.limbs[i] >> 32) * m + carry;
+            carry = hi >> 32;
+            a.limbs[i] = (hi << 32) | (lo & 0xFFFFFFFFULL);
+        }
+        return carry;
+    }
+
+    // a = a / w. Returns remainder
+    static constexpr uint32_t divModWord(BigNumber256 &a, uint32_t w) {
+        uint64_t rem = 0;
+        for (int i = countLimbs - 1; i >= 0; i--) {
+            rem = (rem << 32) | (a.limbs[i] >> 32);
+            const uint64_t hi = rem / w;
+            rem %= w;
+            rem = (rem << 32) | (a.limbs[i] & 0xFFFFFFFFULL);
+            const uint64_t lo = rem / w;
+            rem %= w;
+            a.limbs[i] = (hi << 32) | lo;
+        }
+        return static_cast<uint32_t>(rem);
+    }
+
+private:
+
+    uint64_t limbs[countLimbs] = {0, 0, 0, 0};
+
+    bool negative = false;
+};
+
+const BigNumber256 operator+(const BigNumber256 &lhs, const BigNumber256 &rhs);
+const BigNumber256 operator-(const BigNumber256 &lhs, const BigNumber256 &rhs);
+
+#endif // BIGNUMBER256_H
@@ -0,0 +1,316 @@
+#include "JsonStreamReader.h"
+
+#include <QByteArray>
+
+#include <cstring>
+
+#include "check.h"
+
+JsonStreamReader::JsonStreamReader(const char *begin, const char *end)
+    : begin(begin)
+    , pos(begin)
+    , end(end)
+{}
+
+JsonStreamReader::JsonStreamReader(const std::string &buffer)
+    : JsonStreamReader(buffer.data(), buffer.data() + buffer.size())
+{}
+
+std::string JsonStreamReader::position() const {
+    return " at offset " + std::to_string(pos - begin);
+}
+
+void JsonStreamReader::skipWhitespace() {
+    while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) {
+        pos++;
+    }
+}
+
+char JsonStreamReader::peekChar() {
+    skipWhitespace();
+    CHECK(pos < end, "Incorrect json: unexpected end");
+    return *pos;
+}
+
+void JsonStreamReader::expect(char c) {
+    CHECK(peekChar() == c, "Incorrect json: expected '" + std::string(1, c) + "'" + position());
+    pos++;
+}
+
+JsonStreamReader::Type JsonStreamReader::peekType() {
+    const char c = peekChar();
+    switch (c) {
+    case '{':
+        return Type::Object;
+    case '[':
+        return Type::Array;
+    case '"':
+        return Type::String;
+    case 't':
+    case 'f':
+        return Type::Bool;
+    case 'n':
+        return Type::Null;
+    default:
+        CHECK(c == '-' || (c >= '0' && c <= '9'), "Incorrect json: unexpected symbol" + position());
+        return Type::Number;
+    }
+}
+
+void JsonStreamReader::beginObject() {
+    expect('{');
+    isFirstStack.push_back(true);
+}
+
+bool JsonStreamReader::nextKey(QLatin1String &key) {
+    CHECK(!isFirstStack.empty(), "Incorrect json: not in object");
+    if (peekChar() == '}') {
+        pos++;
+        isFirstStack.pop_back();
+        return false;
+    }
+    if (!isFirstStack.back()) {
+        expect(',');
+    }
+    isFirstStack.back() = false;
+
+    CHECK(peekChar() == '"', "Incorrect json: expected key" + position());
+    const char *strBegin;
+    const char *strEnd;
+    if (scanString(strBegin, strEnd)) {
+        unescapeString(strBegin, strEnd, keyBuffer);
+        key = QLatin1String(keyBuffer.data(), static_cast<int>(keyBuffer.size()));
+    } else {
+        key = QLatin1String(strBegin, static_cast<int>(strEnd - strBegin));
+    }
+    expect(':');
+    return true;
+}
+
+void JsonStreamReader::beginArray() {
+    expect('[');
+    isFirstStack.push_back(true);
+}
+
+bool JsonStreamReader::nextElement() {
+    CHECK(!isFirstStack.empty(), "Incorrect json: not in array");
+    if (peekChar() == ']') {
+        pos++;
+        isFirstStack.pop_back();
+        return false;
+    }
+    if (!isFirstStack.back()) {
+        expect(',');
+    }
+    isFirstStack.back() = false;
+    return true;
+}
+
+bool JsonStreamReader::scanString(const char *&strBegin, const char *&strEnd) {
+    pos++;
+    strBegin = pos;
+    bool isEscapes = false;
+    while (pos < end) {
+        const char c = *pos;
+        if (c == '"') {
+            strEnd = pos;
+            pos++;
+            return isEscapes;
+        } else if (c == '\\') {
+            isEscapes = true;
+            pos += 2;
+        } else {
+            CHECK(static_cast<unsigned char>(c) >= 0x20, "Incorrect json: control symbol in string" + position());
+            pos++;
+        }
+    }
+    throwErr("Incorrect json: unterminated string");
+}
+
+static void appendUtf8(uint32_t code, std::string &result) {
+    if (code < 0x80) {
+        result += static_cast<char>(code);
+    } else if (code < 0x800) {
+        result += static_cast<char>(0xC0 | (code >> 6));
+        result += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        result += static_cast<char>(0xE0 | (code >> 12));
+        result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        result += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        result += static_cast<char>(0xF0 | (code >> 18));
+        result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        result += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+static uint32_t readHex4(const char *p, const char *end) {
+    CHECK(end - p >= 4, "Incorrect json: incorrect escape");
+    uint32_t result = 0;
+    for (int i = 0; i < 4; i++) {
+        const char c = p[i];
+        result <<= 4;
+        if (c >= '0' && c <= '9') {
+            result |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            result |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            result |= c - 'A' + 10;
+        } else {
+            throwErr("Incorrect json: incorrect escape");
+        }
+    }
+    return result;
+}
+
+void JsonStreamReader::unescapeString(const char *strBegin, const char *strEnd, std::string &result) const {
+    result.clear();
+    const char *p = strBegin;
+    while (p < strEnd) {
+        const char *escape = static_cast<const char*>(std::memchr(p, '\\', strEnd - p));
+        if (escape == nullptr) {
+            result.append(p, strEnd);
+            break;
+        }
+        result.append(p, escape);
+        p = escape + 1;
+        CHECK(p < strEnd, "Incorrect json: incorrect escape");
+        const char c = *p++;
+        switch (c) {
+        case '"': result += '"'; break;
+        case '\\': result += '\\'; break;
+        case '/': result += '/'; break;
+        case 'b': result += '\b'; break;
+        case 'f': result += '\f'; break;
+        case 'n': result += '\n'; break;
+        case 'r': result += '\r'; break;
+        case 't': result += '\t'; break;
+        case 'u': {
+            uint32_t code = readHex4(p, strEnd);
+            p += 4;
+            if (code >= 0xD800 && code <= 0xDBFF && strEnd - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                const uint32_t low = readHex4(p + 2, strEnd);
+                if (low >= 0xDC00 && low <= 0xDFFF) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    p += 6;
+                }
+            }
+            appendUtf8(code, result);
+            break;
+        }
+        default:
+            throwErr("Incorrect json: incorrect escape");
+        }
+    }
+}
+
+QString JsonStreamReader::readString() {
+    CHECK(peekChar() == '"', "Incorrect json: expected string" + position());
+    const char *strBegin;
+    const char *strEnd;
+    if (scanString(strBegin, strEnd)) {
+        unescapeString(strBegin, strEnd, stringBuffer);
+        return QString::fromUtf8(stringBuffer.data(), static_cast<int>(stringBuffer.size()));
+    } else {
+        return QString::fromUtf8(strBegin, static_cast<int>(strEnd - strBegin));
+    }
+}
+
+static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+QLatin1String JsonStreamReader::readNumber() {
+    skipWhitespace();
+    const char *numBegin = pos;
+    if (pos < end && *pos == '-') {
+        pos++;
+    }
+    CHECK(pos < end && isDigit(*pos), "Incorrect json: expected number" + position());
+    if (*pos == '0') {
+        pos++;
+    } else {
+        while (pos < end && isDigit(*pos)) {
+            pos++;
+        }
+    }
+    if (pos < end && *pos == '.') {
+        pos++;
+        CHECK(pos < end && isDigit(*pos), "Incorrect json: incorrect number" + position());
+        while (pos < end && isDigit(*pos)) {
+            pos++;
+        }
+    }
+    if (pos < end && (*pos == 'e' || *pos == 'E')) {
+        pos++;
+        if (pos < end && (*pos == '+' || *pos == '-')) {
+            pos++;
+        }
+        CHECK(pos < end && isDigit(*pos), "Incorrect json: incorrect number" + position());
+        while (pos < end && isDigit(*pos)) {
+            pos++;
+        }
+    }
+    return QLatin1String(numBegin, static_cast<int>(pos - numBegin));
+}
+
+double JsonStreamReader::readDouble() {
+    const QLatin1String number = readNumber();
+    return QByteArray::fromRawData(number.data(), number.size()).toDouble();
+}
+
+bool JsonStreamReader::readBool() {
+    const char c = peekChar();
+    const char *literal = c == 't' ? "true" : "false";
+    const size_t size = std::strlen(literal);
+    CHECK(static_cast<size_t>(end - pos) >= size && std::memcmp(pos, literal, size) == 0, "Incorrect json: expected bool" + position());
+    pos += size;
+    return c == 't';
+}
+
+void JsonStreamReader::readNull() {
+    peekChar();
+    CHECK(end - pos >= 4 && std::memcmp(pos, "null", 4) == 0, "Incorrect json: expected null" + position());
+    pos += 4;
+}
+
+void JsonStreamReader::skipValue() {
+    switch (peekType()) {
+    case Type::Object: {
+        beginObject();
+        QLatin1String key;
+        while (nextKey(key)) {
+            skipValue();
+        }
+        break;
+    }
+    case Type::Array:
+        beginArray();
+        while (nextElement()) {
+            skipValue();
+        }
+        break;
+    case Type::String: {
+        const char *strBegin;
+        const char *strEnd;
+        scanString(strBegin, strEnd);
+        break;
+    }
+    case Type::Number:
+        readNumber();
+        break;
+    case Type::Bool:
+        readBool();
+        break;
+    case Type::Null:
+        readNull();
+        break;
+    }
+}
+
+void JsonStreamReader::finish() {
+    skipWhitespace();
+    CHECK(pos == end, "Incorrect json: unexpected data" + position());
+    CHECK(isFirstStack.empty(), "Incorrect json: unexpected end");
+}
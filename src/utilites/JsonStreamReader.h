@@ -0,0 +1,77 @@
+#ifndef JSONSTREAMREADER_H
+#define JSONSTREAMREADER_H
+
+#include <QString>
+#include <QLatin1String>
+
+#include <string>
+#include <vector>
+
+// Single pass json reader over raw utf-8 buffer.
+// Values are read in document order without building QJsonDocument, so callers can emit parsed records as soon as the record object is closed.
+// Buffer must outlive the reader
+class JsonStreamReader {
+public:
+
+    enum class Type {
+        Object, Array, String, Number, Bool, Null
+    };
+
+public:
+
+    JsonStreamReader(const char *begin, const char *end);
+
+    explicit JsonStreamReader(const std::string &buffer);
+
+    Type peekType();
+
+    void beginObject();
+    // Returns false and leaves object on '}'. Key is valid until next call
+    bool nextKey(QLatin1String &key);
+
+    void beginArray();
+    // Returns false and leaves array on ']'
+    bool nextElement();
+
+    QString readString();
+    // Raw number text, valid while buffer alive
+    QLatin1String readNumber();
+    double readDouble();
+    bool readBool();
+    void readNull();
+
+    void skipValue();
+
+    // Checks that nothing except whitespace left
+    void finish();
+
+private:
+
+    void skipWhitespace();
+
+    char peekChar();
+
+    void expect(char c);
+
+    std::string position() const;
+
+    // Moves past string at current position. Returns true if string contains escapes
+    bool scanString(const char *&strBegin, const char *&strEnd);
+
+    void unescapeString(const char *strBegin, const char *strEnd, std::string &result) const;
+
+private:
+
+    const char *begin;
+    const char *pos;
+    const char *end;
+
+    // true while container has no elements yet
+    std::vector<bool> isFirstStack;
+
+    std::string keyBuffer;
+
+    std::string stringBuffer;
+};
+
+#endif // JSONSTREAMREADER_H
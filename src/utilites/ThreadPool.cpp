@@ -0,0 +1,96 @@
+#include "ThreadPool.h"
+
+#include <exception>
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t countThreads) {
+    for (size_t i = 0; i < countThreads; i++) {
+        threads.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mut);
+        isStop = true;
+    }
+    cond.notify_all();
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::defaultCountThreads() {
+    const size_t hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 1;
+}
+
+void ThreadPool::work() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mut);
+            cond.wait(lock, [this]{
+                return isStop || !tasks.empty();
+            });
+            if (isStop && tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t begin, size_t end)> &func) {
+    if (count == 0) {
+        return;
+    }
+    const size_t countChunks = std::min(count, threads.size() + 1);
+    if (countChunks == 1) {
+        func(0, count);
+        return;
+    }
+
+    std::vector<std::exception_ptr> exceptions(countChunks);
+    std::mutex doneMut;
+    std::condition_variable doneCond;
+    size_t countDone = 0;
+
+    const auto runChunk = [&](size_t chunk) {
+        const size_t begin = count * chunk / countChunks;
+        const size_t end = count * (chunk + 1) / countChunks;
+        try {
+            func(begin, end);
+        } catch (...) {
+            exceptions[chunk] = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(doneMut);
+        countDone++;
+        doneCond.notify_one();
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mut);
+        for (size_t chunk = 1; chunk < countChunks; chunk++) {
+            tasks.emplace_back(std::bind(runChunk, chunk));
+        }
+    }
+    cond.notify_all();
+
+    runChunk(0);
+
+    {
+        std::unique_lock<std::mutex> lock(doneMut);
+        doneCond.wait(lock, [&]{
+            return countDone == countChunks;
+        });
+    }
+
+    for (const std::exception_ptr &exception: exceptions) {
+        if (exception != nullptr) {
+            std::rethrow_exception(exception);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Fixed set of worker threads for cpu bound loops
+class ThreadPool {
+public:
+
+    explicit ThreadPool(size_t countThreads);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool& operator=(const ThreadPool &) = delete;
+
+    // Hardware concurrency without the calling thread, at least 1
+    static size_t defaultCountThreads();
+
+    size_t size() const {
+        return threads.size();
+    }
+
+    // Splits [0, count) into contiguous chunks and waits for all of them. Calling thread takes one chunk too.
+    // If several chunks throw, exception of the first chunk is rethrown
+    void parallelFor(size_t count, const std::function<void(size_t begin, size_t end)> &func);
+
+private:
+
+    void work();
+
+private:
+
+    std::vector<std::thread> threads;
+
+    std::mutex mut;
+
+    std::condition_variable cond;
+
+    std::deque<std::function<void()>> tasks;
+
+    bool isStop = false;
+
+};
+
+#endif // THREADPOOL_H
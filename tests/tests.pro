@@ -6,3 +6,6 @@ SUBDIRS += tst_qrcoder
 SUBDIRS += tst_messengerdbstorage
 SUBDIRS += tst_transactionsdbstorage
 SUBDIRS += tst_walletnamesdbstorage
+SUBDIRS += tst_transactions
+SUBDIRS += tst_nslookup
+SUBDIRS += tst_network
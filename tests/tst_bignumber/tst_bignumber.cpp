@@ -2,7 +2,11 @@
 
 #include <QTest>
 
+#include <random>
+
 #include "utilites/BigNumber.h"
+#include "utilites/BigNumber256.h"
+#include "check.h"
 
 tst_BigNumber::tst_BigNumber(QObject *parent)
     : QObject(parent)
@@ -196,4 +200,80 @@ void tst_BigNumber::testBigNumberFracDecimal()
 
 }
 
+// Up to 76 digits, so sum and difference of two numbers fit in 256 bit
+static QByteArray randomDecimal(std::mt19937_64 &rnd) {
+    const int countDigits = std::uniform_int_distribution<int>(1, 76)(rnd);
+    QByteArray result;
+    if (rnd() % 3 == 0) {
+        result += '-';
+    }
+    result += static_cast<char>('1' + rnd() % 9);
+    for (int i = 1; i < countDigits; i++) {
+        result += static_cast<char>('0' + rnd() % 10);
+    }
+    return result;
+}
+
+void tst_BigNumber::testBigNumber256Differential_data()
+{
+    QTest::addColumn<QByteArray>("dec1");
+    QTest::addColumn<QByteArray>("dec2");
+    QTest::newRow("BigNumber256Differential 01") << QByteArray("0") << QByteArray("0");
+    QTest::newRow("BigNumber256Differential 02") << QByteArray("1") << QByteArray("-1");
+    QTest::newRow("BigNumber256Differential 03") << QByteArray("18446744073709551615") << QByteArray("1");
+    QTest::newRow("BigNumber256Differential 04") << QByteArray("340282366920938463463374607431768211455") << QByteArray("340282366920938463463374607431768211456");
+    QTest::newRow("BigNumber256Differential 05") << QByteArray("115792089237316195423570985008687907853269984665640564039457584007913129639935") << QByteArray("0");
+    QTest::newRow("BigNumber256Differential 06") << QByteArray("-115792089237316195423570985008687907853269984665640564039457584007913129639935") << QByteArray("115792089237316195423570985008687907853269984665640564039457584007913129639935");
+    QTest::newRow("BigNumber256Differential 07") << QByteArray("12787328744987349849839843893434894894398") << QByteArray("-677878877866");
+    QTest::newRow("BigNumber256Differential 08") << QByteArray("-1000000000") << QByteArray("999999999");
+
+    std::mt19937_64 rnd(256);
+    for (int i = 0; i < 500; i++) {
+        QTest::newRow(QString("BigNumber256Differential random %1").arg(i).toLatin1().data()) << randomDecimal(rnd) << randomDecimal(rnd);
+    }
+}
+
+void tst_BigNumber::testBigNumber256Differential()
+{
+    QFETCH(QByteArray, dec1);
+    QFETCH(QByteArray, dec2);
+
+    const BigNumber bn1(dec1);
+    const BigNumber bn2(dec2);
+    const BigNumber256 num1(dec1);
+    const BigNumber256 num2(dec2);
+
+    QCOMPARE(num1.getDecimal(), bn1.getDecimal());
+    QCOMPARE(num1.isZero(), bn1.isZero());
+    QCOMPARE(num1.isNegative(), bn1.isNegative());
+    QCOMPARE(num1.countBytes(), bn1.countBytes());
+    QCOMPARE(num1.getLittleEndian(BigNumber256::countBytesMax), bn1.getLittleEndian(BigNumber256::countBytesMax));
+
+    QCOMPARE((num1 + num2).getDecimal(), (bn1 + bn2).getDecimal());
+    QCOMPARE((num1 - num2).getDecimal(), (bn1 - bn2).getDecimal());
+    QCOMPARE((num2 - num1).getDecimal(), (bn2 - bn1).getDecimal());
+    QCOMPARE(num1 == num2, bn1 == bn2);
+    QCOMPARE(num1 < num2, (bn1 - bn2).isNegative());
+
+    QCOMPARE(num1.getFracDecimal(6), bn1.getFracDecimal(6));
+    QCOMPARE(num2.getFracDecimal(9), bn2.getFracDecimal(9));
+
+    BigNumber256 fromHex;
+    fromHex.setHex(num1.getHex());
+    QVERIFY(fromHex == num1);
+}
+
+void tst_BigNumber::testBigNumber256Overflow()
+{
+    const QByteArray max("115792089237316195423570985008687907853269984665640564039457584007913129639935");
+    BigNumber256 num(max);
+    QVERIFY_EXCEPTION_THROWN(num += BigNumber256(1), Exception);
+    QVERIFY_EXCEPTION_THROWN(BigNumber256(QByteArray("115792089237316195423570985008687907853269984665640564039457584007913129639936")), Exception);
+
+    BigNumber256 result;
+    QVERIFY(!BigNumber256::parseDecimal("-115792089237316195423570985008687907853269984665640564039457584007913129639936", result));
+    QVERIFY(BigNumber256::parseDecimal("-" + max, result));
+    QCOMPARE(result.getDecimal(), "-" + max);
+}
+
 QTEST_MAIN(tst_BigNumber)
@@ -22,6 +22,11 @@ private slots:
 
     void testBigNumberFracDecimal_data();
     void testBigNumberFracDecimal();
+
+    void testBigNumber256Differential_data();
+    void testBigNumber256Differential();
+
+    void testBigNumber256Overflow();
 };
 
 #endif // TST_BIGNUMBER_H
@@ -329,4 +329,48 @@ void tst_MessengerDBStorage::testMessengerDecryptedText()
     }
 }
 
+void tst_MessengerDBStorage::testMessengerNotDecryptedPages()
+{
+    if (QFile::exists(messenger::databaseFileName))
+        QFile::remove(messenger::databaseFileName);
+    messenger::MessengerDBStorage db;
+    db.init();
+
+    db.setUserPublicKey("1234", "23424", "2345342", "", "");
+    DBStorage::DbId id1 = db.getUserId("1234");
+    db.addChannel(id1, "channel1", "ch1", true, "ktkt", false, true, true);
+    for (int i = 0; i < 5; i++) {
+        db.addMessage("1234", "3454", "abcd" + QString::number(i), "", false, 1, 5000 + i, true, true, true, "hash" + QString::number(i), 1);
+    }
+    db.addMessage("1234", "3454", "abcd", "", false, 1, 6000, true, true, true, "hashch", 1, "ch1");
+
+    auto page1 = db.getNotDecryptedMessagePage("1234", false, -1, 2);
+    QCOMPARE(page1.first.size(), 2);
+    QCOMPARE(page1.second[0].dataHex, "abcd0");
+    QCOMPARE(page1.second[1].dataHex, "abcd1");
+
+    // Message left not decrypted must not come back on the next page
+    db.updateDecryptedMessage({{page1.first[0], true, "dec0"}, {page1.first[1], false, ""}});
+
+    auto page2 = db.getNotDecryptedMessagePage("1234", false, page1.first.back(), 2);
+    QCOMPARE(page2.first.size(), 2);
+    QCOMPARE(page2.second[0].dataHex, "abcd2");
+    QCOMPARE(page2.second[1].dataHex, "abcd3");
+
+    auto page3 = db.getNotDecryptedMessagePage("1234", false, page2.first.back(), 2);
+    QCOMPARE(page3.first.size(), 1);
+    QCOMPARE(page3.second[0].dataHex, "abcd4");
+
+    auto page4 = db.getNotDecryptedMessagePage("1234", false, page3.first.back(), 2);
+    QCOMPARE(page4.first.size(), 0);
+
+    auto channelPage = db.getNotDecryptedMessagePage("1234", true, -1, 2);
+    QCOMPARE(channelPage.first.size(), 1);
+    QCOMPARE(channelPage.second[0].isChannel, true);
+    QCOMPARE(channelPage.second[0].channel, "ch1");
+
+    auto all = db.getNotDecryptedMessage("1234");
+    QCOMPARE(all.second.size(), 5);
+}
+
 QTEST_MAIN(tst_MessengerDBStorage)
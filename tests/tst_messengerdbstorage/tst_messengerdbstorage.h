@@ -17,6 +17,7 @@ private slots:
     void testMessengerDBChannels();
     void testMessengerDBSpeed();
     void testMessengerDecryptedText();
+    void testMessengerNotDecryptedPages();
 };
 
 #endif // TST_MESSENGERDBSTORAGE_H
@@ -0,0 +1,66 @@
+#include "TestHttpServer.h"
+
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+
+#include <memory>
+
+TestHttpServer::TestHttpServer(QObject *parent)
+    : QTcpServer(parent)
+{}
+
+QUrl TestHttpServer::url(const QString &path) const {
+    return QUrl(QStringLiteral("http://127.0.0.1:%1%2").arg(serverPort()).arg(path));
+}
+
+void TestHttpServer::incomingConnection(qintptr handle) {
+    countConnections++;
+    QTcpSocket *socket = new QTcpSocket(this);
+    socket->setSocketDescriptor(handle);
+    std::shared_ptr<QByteArray> buffer = std::make_shared<QByteArray>();
+    QObject::connect(socket, &QTcpSocket::readyRead, [this, socket, buffer]{
+        *buffer += socket->readAll();
+        while (true) {
+            const int headerEnd = buffer->indexOf("\r\n\r\n");
+            if (headerEnd == -1) {
+                return;
+            }
+            const QByteArray header = buffer->left(headerEnd);
+            const QByteArray headerLower = header.toLower();
+            int contentLength = 0;
+            const int pos = headerLower.indexOf("content-length:");
+            if (pos != -1) {
+                const int end = headerLower.indexOf("\r\n", pos);
+                contentLength = headerLower.mid(pos + 15, end == -1 ? -1 : end - pos - 15).trimmed().toInt();
+            }
+            if (buffer->size() < headerEnd + 4 + contentLength) {
+                return;
+            }
+            const QByteArray body = buffer->mid(headerEnd + 4, contentLength);
+            buffer->remove(0, headerEnd + 4 + contentLength);
+            countRequests++;
+
+            const QList<QByteArray> requestLine = header.left(header.indexOf("\r\n")).split(' ');
+            const QByteArray path = requestLine.size() > 1 ? requestLine[1] : QByteArray("/");
+
+            QByteArray response;
+            if (path == "/error") {
+                response = "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n";
+            } else {
+                response = "HTTP/1.1 200 OK\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+            }
+            int delay = 0;
+            if (path.startsWith("/sleep/")) {
+                delay = path.mid(7).toInt();
+            } else if (body.startsWith("sleep:")) {
+                delay = body.mid(6).toInt();
+            }
+            QTimer::singleShot(delay, socket, [this, socket, response]{
+                countAnswers++;
+                socket->write(response);
+            });
+        }
+    });
+    QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+}
@@ -0,0 +1,27 @@
+#ifndef TEST_HTTP_SERVER_H
+#define TEST_HTTP_SERVER_H
+
+#include <QTcpServer>
+
+// Loopback server answering every POST with its body over keep-alive connection.
+// Path /sleep/N or body "sleep:N" delays the answer for N milliseconds, path /error answers 500
+class TestHttpServer : public QTcpServer {
+public:
+
+    explicit TestHttpServer(QObject *parent = nullptr);
+
+    QUrl url(const QString &path = QString()) const;
+
+    int countConnections = 0;
+
+    int countRequests = 0;
+
+    int countAnswers = 0;
+
+protected:
+
+    void incomingConnection(qintptr handle) override;
+
+};
+
+#endif // TEST_HTTP_SERVER_H
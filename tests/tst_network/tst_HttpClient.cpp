@@ -0,0 +1,95 @@
+#include "tst_HttpClient.h"
+
+#include <QTest>
+#include <QEventLoop>
+#include <QTimer>
+
+#include "Network/HttpClient.h"
+#include "TypedException.h"
+
+#include "TestHttpServer.h"
+
+struct RequestResult {
+    bool isDone = false;
+    bool isError = false;
+    std::string response;
+};
+
+static RequestResult sendAndWait(HttpSimpleClient &client, const QUrl &url, const QString &message, bool isTimeout, milliseconds timeout) {
+    RequestResult result;
+    QEventLoop loop;
+    const auto callback = [&result, &loop](const std::string &response, const TypedException &exception) {
+        result.isDone = true;
+        result.isError = exception.isSet();
+        result.response = response;
+        loop.quit();
+    };
+    if (isTimeout) {
+        client.sendMessagePost(url, message, callback, timeout);
+    } else {
+        client.sendMessagePost(url, message, callback);
+    }
+    QTimer::singleShot(15000, &loop, &QEventLoop::quit);
+    loop.exec();
+    return result;
+}
+
+tst_HttpClient::tst_HttpClient(QObject *parent)
+    : QObject(parent)
+{}
+
+void tst_HttpClient::testPooledConnectionReused() {
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    const QUrl url = server.url();
+
+    HttpSimpleClient client;
+    client.setPoolParameters(true, 1, 30s);
+    QObject::connect(&client, &HttpSimpleClient::callbackCall, [](const HttpSimpleClient::ReturnCallback &callback) {
+        callback();
+    });
+
+    for (int i = 0; i < 3; i++) {
+        const RequestResult result = sendAndWait(client, url, QString::number(i), true, 5s);
+        QCOMPARE(result.isDone, true);
+        QCOMPARE(result.isError, false);
+        QCOMPARE(result.response, QString::number(i).toStdString());
+    }
+    QCOMPARE(server.countConnections, 1);
+}
+
+void tst_HttpClient::testPooledTimeoutReset() {
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    const QUrl url = server.url();
+
+    HttpSimpleClient client;
+    client.setPoolParameters(true, 1, 30s);
+    QObject::connect(&client, &HttpSimpleClient::callbackCall, [](const HttpSimpleClient::ReturnCallback &callback) {
+        callback();
+    });
+
+    // Short timeout leaves its begin time on the pooled socket
+    const RequestResult first = sendAndWait(client, url, "first", true, 300ms);
+    QCOMPARE(first.isError, false);
+    QCOMPARE(first.response, std::string("first"));
+
+    // Request without timeout on the same socket outlives the previous timeout
+    const RequestResult second = sendAndWait(client, url, "sleep:2500", false, 0ms);
+    QCOMPARE(second.isDone, true);
+    QCOMPARE(second.isError, false);
+    QCOMPARE(second.response, std::string("sleep:2500"));
+    QCOMPARE(server.countConnections, 1);
+
+    // Timeout is applied again on the reused socket
+    const RequestResult third = sendAndWait(client, url, "sleep:10000", true, 500ms);
+    QCOMPARE(third.isDone, true);
+    QCOMPARE(third.isError, true);
+    QCOMPARE(server.countConnections, 1);
+
+    // Timed out socket is not returned to the pool
+    const RequestResult fourth = sendAndWait(client, url, "fourth", false, 0ms);
+    QCOMPARE(fourth.isError, false);
+    QCOMPARE(fourth.response, std::string("fourth"));
+    QCOMPARE(server.countConnections, 2);
+}
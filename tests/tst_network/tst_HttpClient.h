@@ -0,0 +1,20 @@
+#ifndef TST_HTTPCLIENT_H
+#define TST_HTTPCLIENT_H
+
+#include <QObject>
+
+class tst_HttpClient : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_HttpClient(QObject *parent = nullptr);
+
+private slots:
+
+    void testPooledConnectionReused();
+
+    void testPooledTimeoutReset();
+
+};
+
+#endif // TST_HTTPCLIENT_H
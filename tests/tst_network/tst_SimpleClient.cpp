@@ -0,0 +1,156 @@
+#include "tst_SimpleClient.h"
+
+#include <QTest>
+#include <QEventLoop>
+#include <QTimer>
+
+#include "Network/SimpleClient.h"
+
+#include "TestHttpServer.h"
+
+using Response = SimpleClient::Response;
+using ServerException = SimpleClient::ServerException;
+
+struct HedgedResult {
+    int countCalls = 0;
+    std::vector<Response> responses;
+    milliseconds time;
+};
+
+static HedgedResult sendHedgedAndWait(SimpleClient &client, const std::vector<QUrl> &urls, size_t countAnswers, milliseconds timeout, milliseconds waitAfter = 0ms) {
+    HedgedResult result;
+    QEventLoop loop;
+    const time_point begin = ::now();
+    client.sendMessagesPostHedged("test", urls, "message", [&result, &loop, begin](const std::vector<Response> &responses) {
+        result.countCalls++;
+        result.responses = responses;
+        result.time = std::chrono::duration_cast<milliseconds>(::now() - begin);
+        loop.quit();
+    }, timeout, countAnswers);
+    QTimer::singleShot(15000, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    // Late answers of cancelled requests would come here
+    if (waitAfter != 0ms) {
+        QEventLoop waitLoop;
+        QTimer::singleShot(waitAfter.count(), &waitLoop, &QEventLoop::quit);
+        waitLoop.exec();
+    }
+    return result;
+}
+
+static void connectCallbacks(SimpleClient &client) {
+    QObject::connect(&client, &SimpleClient::callbackCall, [](const SimpleClient::ReturnCallback &callback) {
+        callback();
+    });
+}
+
+tst_SimpleClient::tst_SimpleClient(QObject *parent)
+    : QObject(parent)
+{}
+
+void tst_SimpleClient::testHedgeDelay() {
+    std::deque<milliseconds> latencies;
+    QCOMPARE(SimpleClient::calcHedgeDelay(latencies, 10s), milliseconds(500ms));
+
+    // Default delay until 20 latencies are collected
+    for (int i = 1; i < 20; i++) {
+        latencies.emplace_back(milliseconds(i * 100));
+    }
+    QCOMPARE(SimpleClient::calcHedgeDelay(latencies, 10s), milliseconds(500ms));
+
+    latencies.emplace_back(2000ms);
+    QCOMPARE(SimpleClient::calcHedgeDelay(latencies, 10s), milliseconds(2000ms));
+
+    // p95 of 100 latencies 1..100 in reverse order
+    latencies.clear();
+    for (int i = 100; i >= 1; i--) {
+        latencies.emplace_back(milliseconds(i * 10));
+    }
+    QCOMPARE(SimpleClient::calcHedgeDelay(latencies, 10s), milliseconds(960ms));
+
+    // 150 latencies, single slow answers do not move p95
+    latencies.clear();
+    for (int i = 0; i < 150; i++) {
+        latencies.emplace_back(i % 50 == 0 ? 5000ms : 100ms);
+    }
+    QCOMPARE(SimpleClient::calcHedgeDelay(latencies, 10s), milliseconds(100ms));
+
+    // Limited by timeout and by minimal delay
+    QCOMPARE(SimpleClient::calcHedgeDelay(latencies, 50ms), milliseconds(50ms));
+    latencies.assign(30, 1ms);
+    QCOMPARE(SimpleClient::calcHedgeDelay(latencies, 10s), milliseconds(20ms));
+}
+
+void tst_SimpleClient::testHedgedFirstAnswers() {
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    SimpleClient client;
+    connectCallbacks(client);
+
+    const HedgedResult result = sendHedgedAndWait(client, {server.url("/sleep/50"), server.url("/sleep/100"), server.url("/sleep/50")}, 2, 10s);
+    QCOMPARE(result.countCalls, 1);
+    QCOMPARE(result.responses.size(), size_t(3));
+    QCOMPARE(result.responses[0].exception.isSet(), false);
+    QCOMPARE(result.responses[0].response, std::string("message"));
+    QCOMPARE(result.responses[1].exception.isSet(), false);
+    QCOMPARE(result.responses[1].response, std::string("message"));
+    // Two answers came before hedge delay, third url is not asked
+    QCOMPARE(result.responses[2].exception.code, ServerException::CANCELED_REQUEST_ERROR);
+    QCOMPARE(server.countRequests, 2);
+}
+
+void tst_SimpleClient::testHedgedCancelLosers() {
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    SimpleClient client;
+    connectCallbacks(client);
+    std::vector<QUrl> observed;
+    client.setResponseObserver([&observed](const QUrl &url, const Response &/*response*/) {
+        observed.emplace_back(url);
+    });
+
+    // Second url is asked after default hedge delay and answers first
+    const HedgedResult result = sendHedgedAndWait(client, {server.url("/sleep/3000"), server.url("/sleep/50")}, 1, 10s, 3500ms);
+    QCOMPARE(result.countCalls, 1);
+    QVERIFY(result.time < 2000ms);
+    QCOMPARE(result.responses[0].exception.code, ServerException::CANCELED_REQUEST_ERROR);
+    QCOMPARE(result.responses[1].exception.isSet(), false);
+    QCOMPARE(result.responses[1].response, std::string("message"));
+    QCOMPARE(server.countRequests, 2);
+    // Aborted request reaches neither the callback nor the observer
+    QCOMPARE(observed, std::vector<QUrl>({server.url("/sleep/50")}));
+}
+
+void tst_SimpleClient::testHedgedAfterError() {
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    SimpleClient client;
+    connectCallbacks(client);
+
+    // Next url is asked right after the error, without hedge delay
+    const HedgedResult result = sendHedgedAndWait(client, {server.url("/error"), server.url("/sleep/50"), server.url("/sleep/50")}, 1, 10s);
+    QCOMPARE(result.countCalls, 1);
+    QVERIFY(result.time < 400ms);
+    QCOMPARE(result.responses[0].exception.isSet(), true);
+    QVERIFY(result.responses[0].exception.code != ServerException::CANCELED_REQUEST_ERROR);
+    QCOMPARE(result.responses[1].exception.isSet(), false);
+    QCOMPARE(result.responses[2].exception.code, ServerException::CANCELED_REQUEST_ERROR);
+    QCOMPARE(server.countRequests, 2);
+}
+
+void tst_SimpleClient::testHedgedAllFailed() {
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    SimpleClient client;
+    connectCallbacks(client);
+
+    const HedgedResult result = sendHedgedAndWait(client, {server.url("/error"), server.url("/error"), server.url("/error")}, 2, 10s);
+    QCOMPARE(result.countCalls, 1);
+    QCOMPARE(result.responses.size(), size_t(3));
+    for (const Response &response: result.responses) {
+        QCOMPARE(response.exception.isSet(), true);
+        QVERIFY(response.exception.code != ServerException::CANCELED_REQUEST_ERROR);
+    }
+    QCOMPARE(server.countRequests, 3);
+}
@@ -0,0 +1,26 @@
+#ifndef TST_SIMPLECLIENT_H
+#define TST_SIMPLECLIENT_H
+
+#include <QObject>
+
+class tst_SimpleClient : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_SimpleClient(QObject *parent = nullptr);
+
+private slots:
+
+    void testHedgeDelay();
+
+    void testHedgedFirstAnswers();
+
+    void testHedgedCancelLosers();
+
+    void testHedgedAfterError();
+
+    void testHedgedAllFailed();
+
+};
+
+#endif // TST_SIMPLECLIENT_H
@@ -0,0 +1,23 @@
+#include <QTest>
+#include <QCoreApplication>
+
+#include "tst_HttpClient.h"
+#include "tst_SimpleClient.h"
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    int status = 0;
+    auto ASSERT_TEST = [&status, argc, argv](QObject* obj) {
+        if (status) {
+            return;
+        }
+        status |= QTest::qExec(obj, argc, argv);
+        delete obj;
+    };
+
+    ASSERT_TEST(new tst_HttpClient());
+    ASSERT_TEST(new tst_SimpleClient());
+
+    return status;
+}
@@ -0,0 +1,36 @@
+QT       += testlib network
+QT       -= gui
+TARGET = tst_network
+CONFIG   += testcase
+CONFIG += c++14
+CONFIG += static
+
+TEMPLATE = app
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    ../../src/Network/HttpClient.cpp \
+    ../../src/Network/SimpleClient.cpp \
+    ../../src/TypedException.cpp \
+    ../../src/qt_utilites/QRegister.cpp \
+    ../LogMock.cpp \
+    TestHttpServer.cpp \
+    tst_HttpClient.cpp \
+    tst_SimpleClient.cpp \
+    tst_main.cpp
+
+HEADERS += \
+    ../../src/Network/HttpClient.h \
+    ../../src/Network/SimpleClient.h \
+    ../../src/TypedException.h \
+    ../../src/qt_utilites/QRegister.h \
+    ../../src/Log.h \
+    TestHttpServer.h \
+    tst_HttpClient.h \
+    tst_SimpleClient.h
+
+QMAKE_LFLAGS += -rdynamic
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
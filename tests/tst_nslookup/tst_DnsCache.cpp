@@ -0,0 +1,131 @@
+#include "tst_DnsCache.h"
+
+#include <QTest>
+
+#include "NsLookup/DnsCache.h"
+
+using namespace nslookup;
+
+tst_DnsCache::tst_DnsCache(QObject *parent)
+    : QObject(parent)
+{}
+
+void tst_DnsCache::testDnsCacheTtl() {
+    DnsCache cache;
+    const time_point now;
+    std::vector<QString> ips;
+    QCOMPARE(cache.find("node.metahash.io", now, ips), false);
+
+    cache.add("node.metahash.io", {"1.1.1.1:80", "2.2.2.2:80"}, 5min, now);
+    QCOMPARE(cache.find("node.metahash.io", now + 5min - 1s, ips), true);
+    QCOMPARE(ips, std::vector<QString>({"1.1.1.1:80", "2.2.2.2:80"}));
+    QCOMPARE(cache.find("other.metahash.io", now, ips), false);
+
+    // Expired record is a miss
+    QCOMPARE(cache.find("node.metahash.io", now + 5min, ips), false);
+
+    // New record replaces expired one with its own ttl
+    cache.add("node.metahash.io", {"3.3.3.3:80"}, 10min, now + 5min);
+    QCOMPARE(cache.find("node.metahash.io", now + 15min - 1s, ips), true);
+    QCOMPARE(ips, std::vector<QString>({"3.3.3.3:80"}));
+    QCOMPARE(cache.find("node.metahash.io", now + 15min, ips), false);
+
+    const DnsCacheStats stats = cache.getStats();
+    QCOMPARE(stats.countRecords, size_t(1));
+    QCOMPARE(stats.hits, size_t(2));
+    QCOMPARE(stats.negativeHits, size_t(0));
+    QCOMPARE(stats.misses, size_t(4));
+}
+
+void tst_DnsCache::testDnsCacheTtlBounds() {
+    DnsCache cache;
+    const time_point now;
+    std::vector<QString> ips;
+
+    // Too short ttl is raised to a minute, too long is cut to an hour
+    cache.add("short", {"1.1.1.1:80"}, 1s, now);
+    cache.add("long", {"1.1.1.1:80"}, hours(24), now);
+    QCOMPARE(cache.find("short", now + 59s, ips), true);
+    QCOMPARE(cache.find("short", now + 1min, ips), false);
+    QCOMPARE(cache.find("long", now + 1h - 1s, ips), true);
+    QCOMPARE(cache.find("long", now + 1h, ips), false);
+}
+
+void tst_DnsCache::testDnsCacheNegative() {
+    DnsCache cache;
+    const time_point now;
+    std::vector<QString> ips = {"1.1.1.1:80"};
+
+    // Failed lookup is cached for a short time as a record without ips
+    cache.addNegative("node.metahash.io", now);
+    QCOMPARE(cache.find("node.metahash.io", now + 29s, ips), true);
+    QCOMPARE(ips.size(), size_t(0));
+    QCOMPARE(cache.find("node.metahash.io", now + 30s, ips), false);
+
+    // Empty answer is the same as failure
+    cache.add("empty.metahash.io", {}, 1h, now);
+    QCOMPARE(cache.find("empty.metahash.io", now + 29s, ips), true);
+    QCOMPARE(ips.size(), size_t(0));
+    QCOMPARE(cache.find("empty.metahash.io", now + 30s, ips), false);
+
+    // Successful lookup replaces negative record
+    cache.addNegative("node.metahash.io", now + 1min);
+    cache.add("node.metahash.io", {"1.1.1.1:80"}, 5min, now + 1min + 1s);
+    QCOMPARE(cache.find("node.metahash.io", now + 1min + 2s, ips), true);
+    QCOMPARE(ips.size(), size_t(1));
+
+    const DnsCacheStats stats = cache.getStats();
+    QCOMPARE(stats.countRecords, size_t(2));
+    QCOMPARE(stats.negativeHits, size_t(2));
+    QCOMPARE(stats.hits, size_t(1));
+    QCOMPARE(stats.misses, size_t(2));
+}
+
+void tst_DnsCache::testDnsCacheNegativeKeepsRecord() {
+    DnsCache cache;
+    const time_point now;
+    std::vector<QString> ips;
+
+    // Failure while the record is valid does not replace it
+    cache.add("node.metahash.io", {"1.1.1.1:80"}, 10min, now);
+    cache.addNegative("node.metahash.io", now + 9min);
+    QCOMPARE(cache.find("node.metahash.io", now + 10min - 1s, ips), true);
+    QCOMPARE(ips, std::vector<QString>({"1.1.1.1:80"}));
+
+    // After expiration failure is cached as negative
+    cache.addNegative("node.metahash.io", now + 10min);
+    QCOMPARE(cache.find("node.metahash.io", now + 10min + 1s, ips), true);
+    QCOMPARE(ips.size(), size_t(0));
+}
+
+void tst_DnsCache::testDnsCachePrefetch() {
+    DnsCache cache;
+    const time_point now;
+    std::vector<QString> ips;
+
+    cache.add("used", {"1.1.1.1:80"}, 10min, now);
+    cache.add("unused", {"2.2.2.2:80"}, 10min, now);
+    cache.addNegative("negative", now + 9min);
+    for (int i = 0; i < 2; i++) {
+        QCOMPARE(cache.find("used", now + 1min, ips), true);
+        QCOMPARE(cache.find("negative", now + 9min, ips), true);
+    }
+    QCOMPARE(cache.find("unused", now + 1min, ips), true);
+
+    // Only used records are prefetched, during the last tenth of ttl
+    QCOMPARE(cache.getPrefetch(now + 9min - 1s).size(), size_t(0));
+    QCOMPARE(cache.getPrefetch(now + 9min), std::vector<QString>({"used"}));
+    QCOMPARE(cache.getPrefetch(now + 9min + 1s).size(), size_t(0));
+
+    // Failed prefetch keeps the record and is not repeated until it is used again
+    cache.addNegative("used", now + 9min + 2s);
+    QCOMPARE(cache.getPrefetch(now + 9min + 3s).size(), size_t(0));
+    QCOMPARE(cache.find("used", now + 9min + 4s, ips), true);
+    QCOMPARE(cache.find("used", now + 9min + 5s, ips), true);
+    QCOMPARE(cache.getPrefetch(now + 9min + 6s), std::vector<QString>({"used"}));
+
+    // Updated record is prefetched again after it is used
+    cache.add("used", {"1.1.1.1:80"}, 10min, now + 9min + 7s);
+    QCOMPARE(cache.getPrefetch(now + 19min + 7s).size(), size_t(0));
+    QCOMPARE(cache.getStats().prefetches, size_t(2));
+}
@@ -0,0 +1,26 @@
+#ifndef TST_DNSCACHE_H
+#define TST_DNSCACHE_H
+
+#include <QObject>
+
+class tst_DnsCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_DnsCache(QObject *parent = nullptr);
+
+private slots:
+
+    void testDnsCacheTtl();
+
+    void testDnsCacheTtlBounds();
+
+    void testDnsCacheNegative();
+
+    void testDnsCacheNegativeKeepsRecord();
+
+    void testDnsCachePrefetch();
+
+};
+
+#endif // TST_DNSCACHE_H
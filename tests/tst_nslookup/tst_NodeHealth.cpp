@@ -0,0 +1,199 @@
+#include "tst_NodeHealth.h"
+
+#include <QTest>
+
+#include <cmath>
+
+#include "NsLookup/NodeHealth.h"
+#include "check.h"
+
+using namespace nslookup;
+
+static NodeInfo makeNode(const QString &address, const milliseconds &ping) {
+    NodeInfo node;
+    node.address = address;
+    node.ping = ping;
+    return node;
+}
+
+static bool isClose(double first, double second) {
+    return std::abs(first - second) < 1e-6;
+}
+
+tst_NodeHealth::tst_NodeHealth(QObject *parent)
+    : QObject(parent)
+{}
+
+void tst_NodeHealth::testNodeHealthBreakerOpen() {
+    NodeHealth health;
+    const std::vector<NodeInfo> nodes = {makeNode("1.1.1.1:80", 10ms), makeNode("2.2.2.2:80", 20ms)};
+    const time_point now;
+
+    for (int i = 0; i < 5; i++) {
+        health.success("1.1.1.1:80", 10ms, now);
+    }
+    health.failure("1.1.1.1:80", now);
+    health.failure("1.1.1.1:80", now);
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::Closed);
+    // The third failure in row opens the breaker while the error rate is still below a half
+    health.failure("1.1.1.1:80", now);
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::Open);
+
+    // Open node is not chosen until the open period ends
+    const std::vector<size_t> chosen = health.choose(nodes, 2, 2, now + 9s);
+    QCOMPARE(chosen.size(), size_t(1));
+    QCOMPARE(chosen[0], size_t(1));
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::Open);
+    QCOMPARE(health.getState("2.2.2.2:80"), NodeHealth::State::Closed);
+
+    // Address with scheme is the same node
+    health.failure("http://2.2.2.2:80", now);
+    health.failure("http://2.2.2.2:80", now);
+    health.failure("http://2.2.2.2:80", now);
+    QCOMPARE(health.getState("2.2.2.2:80"), NodeHealth::State::Open);
+    QCOMPARE(health.choose(nodes, 2, 2, now + 1s).size(), size_t(0));
+}
+
+void tst_NodeHealth::testNodeHealthBreakerErrorRate() {
+    NodeHealth health;
+    const time_point now;
+    // No 3 failures in row, but the weighted error rate exceeds a half after 5 results
+    health.failure("1.1.1.1:80", now);
+    health.failure("1.1.1.1:80", now);
+    health.success("1.1.1.1:80", 10ms, now);
+    health.failure("1.1.1.1:80", now);
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::Closed);
+    health.failure("1.1.1.1:80", now);
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::Open);
+}
+
+void tst_NodeHealth::testNodeHealthBreakerHalfOpen() {
+    NodeHealth health;
+    const std::vector<NodeInfo> nodes = {makeNode("1.1.1.1:80", 10ms)};
+    time_point now;
+    for (int i = 0; i < 3; i++) {
+        health.failure("1.1.1.1:80", now);
+    }
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::Open);
+
+    // After the open period one probe request is allowed
+    now += 10s;
+    QCOMPARE(health.choose(nodes, 1, 1, now).size(), size_t(1));
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::HalfOpen);
+    QCOMPARE(health.choose(nodes, 1, 1, now + 1s).size(), size_t(0));
+
+    // Failed probe opens the breaker for a doubled period
+    health.failure("1.1.1.1:80", now);
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::Open);
+    QCOMPARE(health.choose(nodes, 1, 1, now + 19s).size(), size_t(0));
+    now += 20s;
+    QCOMPARE(health.choose(nodes, 1, 1, now).size(), size_t(1));
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::HalfOpen);
+
+    // Successful probe closes the breaker
+    health.success("1.1.1.1:80", 10ms, now);
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::Closed);
+    QCOMPARE(health.choose(nodes, 1, 1, now).size(), size_t(1));
+    QCOMPARE(health.choose(nodes, 1, 1, now).size(), size_t(1));
+
+    // The next opening starts from the minimum period again
+    for (int i = 0; i < 3; i++) {
+        health.failure("1.1.1.1:80", now);
+    }
+    QCOMPARE(health.choose(nodes, 1, 1, now + 9s).size(), size_t(0));
+    QCOMPARE(health.choose(nodes, 1, 1, now + 10s).size(), size_t(1));
+}
+
+void tst_NodeHealth::testNodeHealthProbeTimeout() {
+    NodeHealth health;
+    const std::vector<NodeInfo> nodes = {makeNode("1.1.1.1:80", 10ms)};
+    time_point now;
+    for (int i = 0; i < 3; i++) {
+        health.failure("1.1.1.1:80", now);
+    }
+    now += 10s;
+    QCOMPARE(health.choose(nodes, 1, 1, now).size(), size_t(1));
+    // Result of the probe is lost, the next probe is allowed after timeout
+    QCOMPARE(health.choose(nodes, 1, 1, now + 29s).size(), size_t(0));
+    QCOMPARE(health.choose(nodes, 1, 1, now + 30s).size(), size_t(1));
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::HalfOpen);
+}
+
+void tst_NodeHealth::testNodeHealthEwma() {
+    NodeHealth health;
+    const NodeInfo node = makeNode("1.1.1.1:80", 50ms);
+    const time_point now;
+
+    // Node without results is estimated by ping
+    QVERIFY(isClose(health.score(node), 50.));
+    health.failure("1.1.1.1:80", now);
+    QVERIFY(isClose(health.score(node), 50. / 0.8));
+
+    // The first latency is taken as is, the next are weighted by 0.2
+    health.success("1.1.1.1:80", 100ms, now);
+    QVERIFY(isClose(health.score(node), 100. / (1. - 0.16)));
+    health.success("1.1.1.1:80", 200ms, now);
+    QVERIFY(isClose(health.score(node), 120. / (1. - 0.128)));
+
+    // Error rate is limited, so a failing node still has a finite score
+    for (int i = 0; i < 50; i++) {
+        health.failure("1.1.1.1:80", now);
+    }
+    QVERIFY(isClose(health.score(node), 120. / 0.05));
+}
+
+void tst_NodeHealth::testNodeHealthChoose() {
+    NodeHealth health;
+    const std::vector<NodeInfo> nodes = {makeNode("1.1.1.1:80", 30ms), makeNode("2.2.2.2:80", 10ms), makeNode("3.3.3.3:80", 20ms)};
+    const time_point now;
+
+    // Only the first limit nodes are candidates, the result is ordered from the best
+    const std::vector<size_t> chosen = health.choose(nodes, 2, 2, now);
+    QCOMPARE(chosen.size(), size_t(2));
+    QCOMPARE(chosen[0], size_t(1));
+    QCOMPARE(chosen[1], size_t(0));
+
+    const std::vector<size_t> all = health.choose(nodes, 3, 3, now);
+    QCOMPARE(all, std::vector<size_t>({1, 2, 0}));
+
+    // Measured latency replaces ping
+    health.success("2.2.2.2:80", 100ms, now);
+    QCOMPARE(health.choose(nodes, 3, 3, now), std::vector<size_t>({2, 0, 1}));
+
+    QVERIFY_EXCEPTION_THROWN(health.choose(nodes, 1, 2, now), Exception);
+}
+
+void tst_NodeHealth::testNodeHealthChooseWeighting() {
+    NodeHealth health;
+    const std::vector<NodeInfo> nodes = {makeNode("1.1.1.1:80", 10ms), makeNode("2.2.2.2:80", 20ms), makeNode("3.3.3.3:80", 30ms)};
+    const time_point now;
+
+    // Of two random candidates the better is taken, so the worst is never chosen alone
+    // and the best is chosen when it is one of the pair, with probability 2/3
+    std::vector<size_t> counts(nodes.size());
+    const size_t countChoices = 3000;
+    for (size_t i = 0; i < countChoices; i++) {
+        const std::vector<size_t> chosen = health.choose(nodes, 3, 1, now);
+        QCOMPARE(chosen.size(), size_t(1));
+        counts[chosen[0]]++;
+    }
+    QCOMPARE(counts[2], size_t(0));
+    QVERIFY(counts[0] > countChoices / 2);
+    QVERIFY(counts[1] > countChoices / 5);
+    QVERIFY(counts[0] > counts[1]);
+
+    // Errors make the fast node worse than the slower ones
+    health.success("1.1.1.1:80", 25ms, now);
+    health.failure("1.1.1.1:80", now);
+    health.failure("1.1.1.1:80", now);
+    health.success("1.1.1.1:80", 25ms, now);
+    health.failure("1.1.1.1:80", now);
+    QCOMPARE(health.getState("1.1.1.1:80"), NodeHealth::State::Closed);
+    QVERIFY(health.score(nodes[0]) > health.score(nodes[2]));
+    std::fill(counts.begin(), counts.end(), 0);
+    for (size_t i = 0; i < countChoices; i++) {
+        counts[health.choose(nodes, 3, 1, now)[0]]++;
+    }
+    QCOMPARE(counts[0], size_t(0));
+    QVERIFY(counts[1] > counts[2]);
+}
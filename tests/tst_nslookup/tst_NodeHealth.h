@@ -0,0 +1,30 @@
+#ifndef TST_NODEHEALTH_H
+#define TST_NODEHEALTH_H
+
+#include <QObject>
+
+class tst_NodeHealth : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_NodeHealth(QObject *parent = nullptr);
+
+private slots:
+
+    void testNodeHealthBreakerOpen();
+
+    void testNodeHealthBreakerErrorRate();
+
+    void testNodeHealthBreakerHalfOpen();
+
+    void testNodeHealthProbeTimeout();
+
+    void testNodeHealthEwma();
+
+    void testNodeHealthChoose();
+
+    void testNodeHealthChooseWeighting();
+
+};
+
+#endif // TST_NODEHEALTH_H
@@ -0,0 +1,20 @@
+#include <QTest>
+
+#include "tst_NodeHealth.h"
+#include "tst_DnsCache.h"
+
+int main(int argc, char *argv[]) {
+    int status = 0;
+    auto ASSERT_TEST = [&status, argc, argv](QObject* obj) {
+        if (status) {
+            return;
+        }
+        status |= QTest::qExec(obj, argc, argv);
+        delete obj;
+    };
+
+    ASSERT_TEST(new tst_NodeHealth());
+    ASSERT_TEST(new tst_DnsCache());
+
+    return status;
+}
@@ -0,0 +1,28 @@
+QT       += testlib
+QT       -= gui
+TARGET = tst_nslookup
+CONFIG   += testcase
+CONFIG += c++14
+CONFIG += static
+
+TEMPLATE = app
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    ../../src/NsLookup/NodeHealth.cpp \
+    ../../src/NsLookup/DnsCache.cpp \
+    tst_NodeHealth.cpp \
+    tst_DnsCache.cpp \
+    tst_main.cpp
+
+HEADERS += \
+    ../../src/NsLookup/NodeHealth.h \
+    ../../src/NsLookup/DnsCache.h \
+    tst_NodeHealth.h \
+    tst_DnsCache.h
+
+QMAKE_LFLAGS += -rdynamic
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
@@ -0,0 +1,141 @@
+#include "tst_BalancePollScheduler.h"
+
+#include <QTest>
+
+#include "transactions/BalancePollScheduler.h"
+#include "transactions/Transaction.h"
+
+using namespace transactions;
+
+static const milliseconds MIN_INTERVAL = 5s;
+static const milliseconds MAX_INTERVAL = 40s;
+
+tst_BalancePollScheduler::tst_BalancePollScheduler(QObject *parent)
+    : QObject(parent)
+{}
+
+void tst_BalancePollScheduler::testBalancePollBackoff() {
+    BalancePollScheduler scheduler(MIN_INTERVAL, MAX_INTERVAL);
+    const time_point start;
+    scheduler.setAddresses({AddressInfo("mh", "addr1", "group")}, start);
+
+    // New address is polled at once
+    QCOMPARE(scheduler.takeDue(start, 10).size(), size_t(1));
+    QCOMPARE(scheduler.takeDue(start, 10).size(), size_t(0));
+
+    // Each poll without changes doubles the interval up to maximum
+    time_point now = start;
+    const std::vector<milliseconds> intervals = {10s, 20s, 40s, 40s};
+    for (const milliseconds &interval: intervals) {
+        scheduler.polled("mh", "addr1", false, now);
+        QCOMPARE(scheduler.takeDue(now + interval - 1s, 10).size(), size_t(0));
+        now += interval;
+        QCOMPARE(scheduler.takeDue(now, 10).size(), size_t(1));
+    }
+
+    // Change returns the address to minimum interval
+    scheduler.polled("mh", "addr1", true, now);
+    QCOMPARE(scheduler.takeDue(now + MIN_INTERVAL - 1s, 10).size(), size_t(0));
+    QCOMPARE(scheduler.takeDue(now + MIN_INTERVAL, 10).size(), size_t(1));
+
+    const BalancePollScheduler::Stats stats = scheduler.getStats(now);
+    QCOMPARE(stats.countPolls, size_t(6));
+    QCOMPARE(stats.addresses.size(), size_t(1));
+    QCOMPARE(stats.addresses[0].countChanges, size_t(1));
+    QCOMPARE(stats.addresses[0].interval, MIN_INTERVAL);
+}
+
+void tst_BalancePollScheduler::testBalancePollHotIdle() {
+    BalancePollScheduler scheduler(MIN_INTERVAL, MAX_INTERVAL);
+    time_point now;
+    scheduler.setAddresses({AddressInfo("mh", "hot", "group"), AddressInfo("mh", "idle", "group")}, now);
+
+    // Timer of 1 second during 10 minutes. Balance of hot address changes on every poll
+    size_t countHot = 0;
+    size_t countIdle = 0;
+    for (int i = 0; i < 600; i++, now += 1s) {
+        for (const auto &pair: scheduler.takeDue(now, 10)) {
+            const bool isHot = pair.second == "hot";
+            if (isHot) {
+                countHot++;
+            } else {
+                countIdle++;
+            }
+            scheduler.polled(pair.first, pair.second, isHot, now);
+        }
+    }
+    // Hot address every MIN_INTERVAL, idle at 0, 10, 30, 70 seconds and then every MAX_INTERVAL
+    QCOMPARE(countHot, size_t(120));
+    QCOMPARE(countIdle, size_t(17));
+
+    const BalancePollScheduler::Stats stats = scheduler.getStats(now);
+    QCOMPARE(stats.countAddresses, size_t(2));
+    QCOMPARE(stats.countPolls, countHot + countIdle);
+    for (const BalancePollScheduler::AddressPoll &poll: stats.addresses) {
+        if (poll.address == "hot") {
+            QCOMPARE(poll.countChanges, countHot);
+            QCOMPARE(poll.interval, MIN_INTERVAL);
+        } else {
+            QCOMPARE(poll.countChanges, size_t(0));
+            QCOMPARE(poll.interval, MAX_INTERVAL);
+        }
+    }
+}
+
+void tst_BalancePollScheduler::testBalancePollWakeUp() {
+    BalancePollScheduler scheduler(MIN_INTERVAL, MAX_INTERVAL);
+    time_point now;
+    scheduler.setAddresses({AddressInfo("mh", "addr1", "group")}, now);
+    for (int i = 0; i < 5; i++) {
+        QCOMPARE(scheduler.takeDue(now, 10).size(), size_t(1));
+        scheduler.polled("mh", "addr1", false, now);
+        now += MAX_INTERVAL;
+    }
+    QCOMPARE(scheduler.getStats(now).addresses[0].interval, MAX_INTERVAL);
+
+    now += 1s;
+    QCOMPARE(scheduler.takeDue(now, 10).size(), size_t(1));
+    QCOMPARE(scheduler.takeDue(now + 1s, 10).size(), size_t(0));
+    scheduler.wakeUp("mh", "addr1", now + 1s);
+    QCOMPARE(scheduler.takeDue(now + 1s, 10).size(), size_t(1));
+    QCOMPARE(scheduler.getStats(now).addresses[0].interval, MIN_INTERVAL);
+
+    // Unknown address is ignored
+    scheduler.wakeUp("mh", "addr2", now);
+    scheduler.polled("mh", "addr2", true, now);
+    QCOMPARE(scheduler.getStats(now).countAddresses, size_t(1));
+}
+
+void tst_BalancePollScheduler::testBalancePollSetAddresses() {
+    BalancePollScheduler scheduler(MIN_INTERVAL, MAX_INTERVAL);
+    time_point now;
+    scheduler.setAddresses({AddressInfo("mh", "addr1", "group"), AddressInfo("mh", "addr2", "group"), AddressInfo("tmh", "addr1", "group")}, now);
+    QCOMPARE(scheduler.getStats(now).queueDepth, size_t(3));
+
+    // At most maxCount addresses, the others stay in queue
+    QCOMPARE(scheduler.takeDue(now, 2).size(), size_t(2));
+    QCOMPARE(scheduler.getStats(now).queueDepth, size_t(1));
+    QCOMPARE(scheduler.takeDue(now, 2).size(), size_t(1));
+
+    // Earlier poll time goes first
+    scheduler.polled("mh", "addr1", false, now);
+    scheduler.polled("mh", "addr2", true, now);
+    scheduler.polled("tmh", "addr1", false, now + 1s);
+    const std::vector<std::pair<QString, QString>> due = scheduler.takeDue(now + 20s, 10);
+    QCOMPARE(due.size(), size_t(3));
+    QCOMPARE(due[0], std::make_pair(QString("mh"), QString("addr2")));
+    QCOMPARE(due[1], std::make_pair(QString("mh"), QString("addr1")));
+    QCOMPARE(due[2], std::make_pair(QString("tmh"), QString("addr1")));
+
+    // Removed address is not polled, the address added again is polled at once
+    scheduler.setAddresses({AddressInfo("mh", "addr1", "group"), AddressInfo("tmh", "addr1", "group")}, now);
+    QCOMPARE(scheduler.getStats(now).countAddresses, size_t(2));
+    scheduler.setAddresses({AddressInfo("mh", "addr1", "group"), AddressInfo("mh", "addr2", "group"), AddressInfo("tmh", "addr1", "group")}, now + 1s);
+    const std::vector<std::pair<QString, QString>> added = scheduler.takeDue(now + 1s, 10);
+    QCOMPARE(added.size(), size_t(1));
+    QCOMPARE(added[0].second, QString("addr2"));
+
+    scheduler.setAddresses({}, now);
+    QCOMPARE(scheduler.getStats(now).countAddresses, size_t(0));
+    QCOMPARE(scheduler.takeDue(now + 1min, 10).size(), size_t(0));
+}
@@ -0,0 +1,24 @@
+#ifndef TST_BALANCEPOLLSCHEDULER_H
+#define TST_BALANCEPOLLSCHEDULER_H
+
+#include <QObject>
+
+class tst_BalancePollScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_BalancePollScheduler(QObject *parent = nullptr);
+
+private slots:
+
+    void testBalancePollBackoff();
+
+    void testBalancePollHotIdle();
+
+    void testBalancePollWakeUp();
+
+    void testBalancePollSetAddresses();
+
+};
+
+#endif // TST_BALANCEPOLLSCHEDULER_H
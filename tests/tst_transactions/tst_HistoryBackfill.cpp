@@ -0,0 +1,235 @@
+#include "tst_HistoryBackfill.h"
+
+#include <QTest>
+
+#include <random>
+
+#include "transactions/HistoryBackfill.h"
+#include "check.h"
+
+using namespace transactions;
+
+Q_DECLARE_METATYPE(milliseconds)
+
+static const milliseconds TARGET_LATENCY = 1s;
+
+tst_HistoryBackfill::tst_HistoryBackfill(QObject *parent)
+    : QObject(parent)
+{}
+
+void tst_HistoryBackfill::testHistoryBackfillPages() {
+    HistoryBackfill plan(100, 900, 250, TARGET_LATENCY);
+    QCOMPARE(plan.isFinished(), false);
+
+    HistoryBackfill::Page page;
+    std::vector<HistoryBackfill::Page> pages;
+    while (plan.nextPage(page)) {
+        pages.emplace_back(page);
+    }
+    QCOMPARE(pages.size(), size_t(4));
+    QCOMPARE(pages[0].from, uint64_t(100));
+    QCOMPARE(pages[0].count, uint64_t(250));
+    QCOMPARE(pages[2].from, uint64_t(600));
+    QCOMPARE(pages[2].count, uint64_t(250));
+    // The last page is cut by the target
+    QCOMPARE(pages[3].from, uint64_t(850));
+    QCOMPARE(pages[3].count, uint64_t(50));
+    QCOMPARE(plan.countInFlight(), size_t(4));
+
+    for (const HistoryBackfill::Page &p: pages) {
+        plan.pageDone(p, TARGET_LATENCY);
+    }
+    QCOMPARE(plan.countInFlight(), size_t(0));
+    QCOMPARE(plan.savedTxs(), uint64_t(900));
+    QCOMPARE(plan.isFinished(), true);
+    QCOMPARE(plan.nextPage(page), false);
+
+    HistoryBackfill empty(500, 500, 250, TARGET_LATENCY);
+    QCOMPARE(empty.isFinished(), true);
+    QCOMPARE(empty.nextPage(page), false);
+}
+
+void tst_HistoryBackfill::testHistoryBackfillPageSize_data() {
+    QTest::addColumn<unsigned long long>("initSize");
+    QTest::addColumn<milliseconds>("latency");
+    QTest::addColumn<unsigned long long>("size");
+
+    QTest::newRow("PageSize clamp min") << 10ULL << TARGET_LATENCY << 250ULL;
+    QTest::newRow("PageSize clamp max") << 100000ULL << TARGET_LATENCY << 10000ULL;
+    QTest::newRow("PageSize fast") << 1000ULL << milliseconds(100) << 2000ULL;
+    QTest::newRow("PageSize fast max") << 8000ULL << milliseconds(100) << 10000ULL;
+    QTest::newRow("PageSize half of target is not fast") << 1000ULL << milliseconds(500) << 1000ULL;
+    QTest::newRow("PageSize target") << 1000ULL << TARGET_LATENCY << 1000ULL;
+    QTest::newRow("PageSize slow") << 1000ULL << milliseconds(1500) << 500ULL;
+    QTest::newRow("PageSize slow min") << 300ULL << milliseconds(5000) << 250ULL;
+}
+
+void tst_HistoryBackfill::testHistoryBackfillPageSize() {
+    QFETCH(unsigned long long, initSize);
+    QFETCH(milliseconds, latency);
+    QFETCH(unsigned long long, size);
+
+    const unsigned long long firstSize = std::min(std::max(initSize, 250ULL), 10000ULL);
+    HistoryBackfill plan(0, 1000000, initSize, TARGET_LATENCY);
+    HistoryBackfill::Page page;
+    QVERIFY(plan.nextPage(page));
+    QCOMPARE((unsigned long long)page.count, firstSize);
+
+    plan.pageDone(page, latency);
+    QCOMPARE((unsigned long long)plan.pageSize(), size);
+    QVERIFY(plan.nextPage(page));
+    QCOMPARE((unsigned long long)page.from, firstSize);
+    QCOMPARE((unsigned long long)page.count, size);
+}
+
+void tst_HistoryBackfill::testHistoryBackfillFailedPage() {
+    HistoryBackfill plan(0, 10000, 2000, TARGET_LATENCY);
+
+    HistoryBackfill::Page first;
+    HistoryBackfill::Page second;
+    QVERIFY(plan.nextPage(first));
+    QVERIFY(plan.nextPage(second));
+    QCOMPARE(second.from, uint64_t(2000));
+
+    // Short page or timeout: the page is split into parts of the new size, the oldest part is requested first
+    plan.pageFailed(first);
+    QCOMPARE(plan.pageSize(), uint64_t(1000));
+    QCOMPARE(plan.countInFlight(), size_t(1));
+
+    HistoryBackfill::Page page;
+    QVERIFY(plan.nextPage(page));
+    QCOMPARE(page.from, uint64_t(0));
+    QCOMPARE(page.count, uint64_t(1000));
+    HistoryBackfill::Page retry2;
+    QVERIFY(plan.nextPage(retry2));
+    QCOMPARE(retry2.from, uint64_t(1000));
+    QCOMPARE(retry2.count, uint64_t(1000));
+    HistoryBackfill::Page next;
+    QVERIFY(plan.nextPage(next));
+    QCOMPARE(next.from, uint64_t(4000));
+    QCOMPARE(next.count, uint64_t(1000));
+
+    // Failed again: the part is split down to the minimum page size
+    plan.pageFailed(page);
+    QCOMPARE(plan.pageSize(), uint64_t(500));
+    plan.pageFailed(retry2);
+    QCOMPARE(plan.pageSize(), uint64_t(250));
+    std::vector<HistoryBackfill::Page> retries;
+    for (size_t i = 0; i < 6; i++) {
+        QVERIFY(plan.nextPage(page));
+        retries.emplace_back(page);
+    }
+    QCOMPARE(retries[0].from, uint64_t(1000));
+    QCOMPARE(retries[0].count, uint64_t(250));
+    QCOMPARE(retries[3].from, uint64_t(1750));
+    QCOMPARE(retries[4].from, uint64_t(0));
+    QCOMPARE(retries[4].count, uint64_t(500));
+    QCOMPARE(retries[5].from, uint64_t(500));
+    QVERIFY(plan.nextPage(page));
+    QCOMPARE(page.from, uint64_t(5000));
+    QCOMPARE(page.count, uint64_t(250));
+
+    QCOMPARE(plan.savedTxs(), uint64_t(0));
+}
+
+void tst_HistoryBackfill::testHistoryBackfillOutOfOrder() {
+    HistoryBackfill plan(0, 1000, 250, TARGET_LATENCY);
+    std::vector<HistoryBackfill::Page> pages(4);
+    for (HistoryBackfill::Page &page: pages) {
+        QVERIFY(plan.nextPage(page));
+    }
+
+    plan.pageDone(pages[2], TARGET_LATENCY);
+    QCOMPARE(plan.savedTxs(), uint64_t(0));
+    plan.pageDone(pages[1], TARGET_LATENCY);
+    QCOMPARE(plan.savedTxs(), uint64_t(0));
+    plan.pageDone(pages[0], TARGET_LATENCY);
+    QCOMPARE(plan.savedTxs(), uint64_t(750));
+    QCOMPARE(plan.isFinished(), false);
+    plan.pageDone(pages[3], TARGET_LATENCY);
+    QCOMPARE(plan.savedTxs(), uint64_t(1000));
+    QCOMPARE(plan.isFinished(), true);
+}
+
+void tst_HistoryBackfill::testHistoryBackfillSimulation_data() {
+    QTest::addColumn<unsigned long long>("target");
+    QTest::addColumn<int>("failPercent");
+    QTest::addColumn<int>("seed");
+
+    QTest::newRow("Simulation no errors") << 50000ULL << 0 << 1;
+    QTest::newRow("Simulation some errors") << 50000ULL << 20 << 2;
+    QTest::newRow("Simulation many errors") << 20000ULL << 60 << 3;
+    QTest::newRow("Simulation small") << 100ULL << 50 << 4;
+}
+
+void tst_HistoryBackfill::testHistoryBackfillSimulation() {
+    QFETCH(unsigned long long, target);
+    QFETCH(int, failPercent);
+    QFETCH(int, seed);
+
+    // Server answers pages in random order with random latency, short pages and timeouts are failures
+    std::mt19937 random(seed);
+    const size_t pagesInFlight = 4;
+    HistoryBackfill plan(0, target, 1000, TARGET_LATENCY);
+    std::vector<HistoryBackfill::Page> requested;
+    std::vector<int> downloaded(target, 0);
+    uint64_t prevSaved = 0;
+
+    size_t steps = 0;
+    while (!plan.isFinished()) {
+        QVERIFY(steps++ < 100000);
+
+        HistoryBackfill::Page page;
+        while (plan.countInFlight() < pagesInFlight && plan.nextPage(page)) {
+            QVERIFY(page.count >= 1);
+            QVERIFY(page.count <= HistoryBackfill::MAX_PAGE_SIZE);
+            QVERIFY(page.from + page.count <= target);
+            requested.emplace_back(page);
+        }
+        QCOMPARE(plan.countInFlight(), requested.size());
+        QVERIFY(!requested.empty());
+
+        const size_t index = random() % requested.size();
+        const HistoryBackfill::Page answered = requested[index];
+        requested.erase(requested.begin() + index);
+        if (int(random() % 100) < failPercent) {
+            plan.pageFailed(answered);
+        } else {
+            for (uint64_t i = answered.from; i < answered.from + answered.count; i++) {
+                downloaded[i]++;
+            }
+            plan.pageDone(answered, milliseconds(random() % 2000));
+        }
+
+        QVERIFY(plan.savedTxs() >= prevSaved);
+        prevSaved = plan.savedTxs();
+        for (uint64_t i = 0; i < plan.savedTxs(); i += 97) {
+            QCOMPARE(downloaded[i], 1);
+        }
+        QVERIFY(plan.pageSize() >= HistoryBackfill::MIN_PAGE_SIZE);
+        QVERIFY(plan.pageSize() <= HistoryBackfill::MAX_PAGE_SIZE);
+    }
+
+    QCOMPARE(plan.countInFlight(), size_t(0));
+    QCOMPARE((unsigned long long)plan.savedTxs(), target);
+    // Every transaction is downloaded exactly once
+    for (const int count: downloaded) {
+        QCOMPARE(count, 1);
+    }
+}
+
+void tst_HistoryBackfill::testHistoryBackfillIncorrectPage() {
+    QVERIFY_EXCEPTION_THROWN(HistoryBackfill(10, 5, 250, TARGET_LATENCY), Exception);
+
+    HistoryBackfill plan(0, 1000, 250, TARGET_LATENCY);
+    HistoryBackfill::Page page;
+    QVERIFY(plan.nextPage(page));
+
+    HistoryBackfill::Page other = page;
+    other.count = page.count + 1;
+    QVERIFY_EXCEPTION_THROWN(plan.pageDone(other, TARGET_LATENCY), Exception);
+    QVERIFY_EXCEPTION_THROWN(plan.pageFailed(other), Exception);
+
+    plan.pageDone(page, TARGET_LATENCY);
+    QVERIFY_EXCEPTION_THROWN(plan.pageDone(page, TARGET_LATENCY), Exception);
+}
@@ -0,0 +1,30 @@
+#ifndef TST_HISTORYBACKFILL_H
+#define TST_HISTORYBACKFILL_H
+
+#include <QObject>
+
+class tst_HistoryBackfill : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_HistoryBackfill(QObject *parent = nullptr);
+
+private slots:
+
+    void testHistoryBackfillPages();
+
+    void testHistoryBackfillPageSize_data();
+    void testHistoryBackfillPageSize();
+
+    void testHistoryBackfillFailedPage();
+
+    void testHistoryBackfillOutOfOrder();
+
+    void testHistoryBackfillSimulation_data();
+    void testHistoryBackfillSimulation();
+
+    void testHistoryBackfillIncorrectPage();
+
+};
+
+#endif // TST_HISTORYBACKFILL_H
@@ -0,0 +1,157 @@
+#include "tst_SendBatchState.h"
+
+#include <QTest>
+
+#include "transactions/SendBatchState.h"
+#include "check.h"
+
+using namespace transactions;
+
+static const milliseconds CHECK_PERIOD = 1s;
+static const milliseconds TIMEOUT = 60s;
+
+static std::vector<BatchTransaction> makeBatch(size_t firstNonce, size_t count) {
+    std::vector<BatchTransaction> batch(count);
+    for (size_t i = 0; i < count; i++) {
+        batch[i].to = "to";
+        batch[i].value = "1";
+        batch[i].nonce = firstNonce + i;
+    }
+    return batch;
+}
+
+tst_SendBatchState::tst_SendBatchState(QObject *parent)
+    : QObject(parent)
+{}
+
+void tst_SendBatchState::testSendBatchWindow() {
+    const time_point start;
+    SendBatchState state(makeBatch(10, 40), 1, 16, 16, CHECK_PERIOD, TIMEOUT, start);
+
+    const std::vector<size_t> first = state.takeToSend();
+    QCOMPARE(first.size(), size_t(16));
+    QCOMPARE(first.front(), size_t(0));
+    QCOMPARE(first.back(), size_t(15));
+    QCOMPARE(state.takeToSend().size(), size_t(0));
+
+    // Answered transaction frees one place in window
+    state.sendAnswered(0, true, "hash0", "", start);
+    const std::vector<size_t> next = state.takeToSend();
+    QCOMPARE(next.size(), size_t(1));
+    QCOMPARE(next.front(), size_t(16));
+
+    const BatchProgress progress = state.takeProgress(false);
+    QCOMPARE(progress.count, size_t(40));
+    QCOMPARE(progress.countSended, size_t(1));
+    QCOMPARE(progress.changed.size(), size_t(1));
+    QCOMPARE(progress.changed[0].nonce, size_t(10));
+    QCOMPARE(progress.changed[0].hash, QString("hash0"));
+    QVERIFY(!state.isChanged());
+}
+
+void tst_SendBatchState::testSendBatchStopAfterError() {
+    const time_point start;
+    SendBatchState state(makeBatch(10, 5), 2, 2, 16, CHECK_PERIOD, TIMEOUT, start);
+    QCOMPARE(state.takeToSend().size(), size_t(2));
+
+    // One answer of two servers is enough
+    state.sendAnswered(0, false, "", "server error", start);
+    state.sendAnswered(0, true, "hash0", "", start);
+    QCOMPARE(state.getTx(0).status, BatchProgress::Status::SENDED);
+    QCOMPARE(state.getTx(0).error, QString(""));
+
+    state.sendAnswered(1, false, "", "error1", start);
+    QCOMPARE(state.getTx(1).status, BatchProgress::Status::QUEUED);
+    state.sendAnswered(1, false, "", "error2", start);
+    QCOMPARE(state.getTx(1).status, BatchProgress::Status::SEND_ERROR);
+
+    // Rest transactions are not sent after the error
+    QCOMPARE(state.takeToSend().size(), size_t(0));
+    const BatchProgress progress = state.takeProgress(false);
+    QCOMPARE(progress.countSended, size_t(1));
+    QCOMPARE(progress.countSendErrors, size_t(1));
+    QCOMPARE(progress.countNotSent, size_t(3));
+    QCOMPARE(progress.changed.size(), size_t(5));
+    for (size_t i = 2; i < 5; i++) {
+        QCOMPARE(progress.changed[i].status, BatchProgress::Status::NOT_SENT);
+    }
+
+    size_t failedNonce = 0;
+    QVERIFY(state.getFailedNonce(failedNonce));
+    QCOMPARE(failedNonce, size_t(11));
+
+    // Batch waits for confirmation of the sent transaction only
+    std::vector<size_t> pending;
+    QVERIFY(!state.checkFinished(start, pending));
+    QVERIFY(state.checkFinished(start + TIMEOUT, pending));
+    QCOMPARE(pending.size(), size_t(0));
+    QCOMPARE(state.getTx(0).status, BatchProgress::Status::NOT_FOUND);
+    QVERIFY(state.getFailedNonce(failedNonce));
+    QCOMPARE(failedNonce, size_t(10));
+}
+
+void tst_SendBatchState::testSendBatchConfirm() {
+    const time_point start;
+    SendBatchState state(makeBatch(0, 3), 1, 16, 2, CHECK_PERIOD, TIMEOUT, start);
+    QCOMPARE(state.takeToSend().size(), size_t(3));
+    for (size_t i = 0; i < 3; i++) {
+        state.sendAnswered(i, true, "hash" + QString::number(i), "", start);
+    }
+
+    std::vector<size_t> pending;
+    QVERIFY(!state.checkFinished(start, pending));
+    QCOMPARE(state.takeToCheck(start).size(), size_t(0));
+
+    // Check window limits requests in flight
+    time_point now = start + CHECK_PERIOD;
+    const std::vector<size_t> checks = state.takeToCheck(now);
+    QCOMPARE(checks.size(), size_t(2));
+    QCOMPARE(state.takeToCheck(now).size(), size_t(0));
+
+    QVERIFY(state.checkAnswered(0, now));
+    state.checkFound(0, Transaction::Status::OK);
+    QVERIFY(state.checkAnswered(1, now));
+    state.checkFound(1, Transaction::Status::PENDING);
+    QCOMPARE(state.takeToCheck(now), std::vector<size_t>{2});
+
+    QVERIFY(state.checkAnswered(2, now));
+    state.checkFound(2, Transaction::Status::ERROR);
+
+    const BatchProgress progress = state.takeProgress(false);
+    QCOMPARE(progress.countSended, size_t(3));
+    QCOMPARE(progress.countConfirmed, size_t(1));
+    QCOMPARE(progress.countPending, size_t(1));
+    QCOMPARE(progress.countRejected, size_t(1));
+
+    // Pending transaction is handed to status watchers on timeout
+    QVERIFY(!state.checkFinished(start + TIMEOUT - 1s, pending));
+    QVERIFY(state.checkFinished(start + TIMEOUT, pending));
+    QCOMPARE(pending, std::vector<size_t>{1});
+    size_t failedNonce = 0;
+    QVERIFY(!state.getFailedNonce(failedNonce));
+}
+
+void tst_SendBatchState::testNonceReservations() {
+    NonceReservations reservations(5min);
+    time_point now;
+
+    QCOMPARE(reservations.reserve("addr1", 10, 5, now), size_t(10));
+    QCOMPARE(reservations.reserve("addr1", 10, 3, now), size_t(15));
+    QCOMPARE(reservations.reserve("addr2", 7, 1, now), size_t(7));
+
+    // Node nonce ahead of reservation wins
+    QCOMPARE(reservations.reserve("addr1", 30, 2, now), size_t(30));
+
+    // Failed nonce is given again even after later reservations
+    reservations.release("addr1", 31);
+    QCOMPARE(reservations.reserve("addr1", 30, 2, now), size_t(31));
+    reservations.release("addr1", 100);
+    QCOMPARE(reservations.reserve("addr1", 30, 1, now), size_t(33));
+    reservations.release("addr3", 1);
+    QCOMPARE(reservations.reserve("addr3", 4, 1, now), size_t(4));
+
+    // Reservation expires
+    now += 5min;
+    QCOMPARE(reservations.reserve("addr1", 30, 1, now), size_t(30));
+    QVERIFY_EXCEPTION_THROWN(reservations.reserve("addr1", 30, 0, now), Exception);
+}
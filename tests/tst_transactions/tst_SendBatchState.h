@@ -0,0 +1,24 @@
+#ifndef TST_SENDBATCHSTATE_H
+#define TST_SENDBATCHSTATE_H
+
+#include <QObject>
+
+class tst_SendBatchState : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_SendBatchState(QObject *parent = nullptr);
+
+private slots:
+
+    void testSendBatchWindow();
+
+    void testSendBatchStopAfterError();
+
+    void testSendBatchConfirm();
+
+    void testNonceReservations();
+
+};
+
+#endif // TST_SENDBATCHSTATE_H
@@ -0,0 +1,387 @@
+#include "tst_TransactionsMessages.h"
+
+#include <QTest>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include "utilites/JsonStreamReader.h"
+#include "transactions/TransactionsMessages.h"
+#include "transactions/Transaction.h"
+#include "check.h"
+
+using namespace transactions;
+
+Q_DECLARE_METATYPE(std::string)
+
+tst_TransactionsMessages::tst_TransactionsMessages(QObject *parent)
+    : QObject(parent)
+{}
+
+static std::string readResponse(const QString &name) {
+    QFile file(":/responses/" + name);
+    CHECK(file.open(QIODevice::ReadOnly), "Cannot open " + name.toStdString());
+    return file.readAll().toStdString();
+}
+
+// Former QJsonDocument parsing of responses, the reference for the stream parser
+
+static QString legacyIntOrString(const QJsonObject &json, const QString &key) {
+    CHECK(json.contains(key), "Incorrect json: " + key.toStdString() + " field not found");
+    if (json.value(key).isDouble()) {
+        return QString::fromStdString(std::to_string(uint64_t(json.value(key).toDouble())));
+    } else if (json.value(key).isString()) {
+        return json.value(key).toString();
+    } else {
+        throwErr("Incorrect json: " + key.toStdString() + " field not found");
+    }
+}
+
+static QJsonArray legacyResult(const std::string &response) {
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(QByteArray::fromStdString(response));
+    CHECK(jsonResponse.isObject(), "Incorrect json ");
+    const QJsonObject &json1 = jsonResponse.object();
+    CHECK(json1.contains("result") && json1.value("result").isArray(), "Incorrect json: result field not found");
+    return json1.value("result").toArray();
+}
+
+static std::vector<Transaction> legacyParseHistory(const QString &address, const QString &currency, const std::string &response) {
+    std::vector<Transaction> result;
+    for (const QJsonValue &elementJson: legacyResult(response)) {
+        CHECK(elementJson.isObject(), "Incorrect json");
+        const QJsonObject txJson = elementJson.toObject();
+        Transaction res;
+        CHECK(txJson.value("from").isString(), "Incorrect json: from field not found");
+        res.from = txJson.value("from").toString();
+        CHECK(txJson.value("to").isString(), "Incorrect json: to field not found");
+        res.to = txJson.value("to").toString();
+        res.value = legacyIntOrString(txJson, "value");
+        CHECK(txJson.value("transaction").isString(), "Incorrect json: transaction field not found");
+        res.tx = txJson.value("transaction").toString();
+        CHECK(txJson.value("data").isString(), "Incorrect json: data field not found");
+        res.data = txJson.value("data").toString();
+        res.timestamp = legacyIntOrString(txJson, "timestamp").toULongLong();
+        res.fee = legacyIntOrString(txJson, "realFee");
+        CHECK(txJson.value("nonce").isDouble(), "Incorrect json: nonce field not found");
+        res.nonce = legacyIntOrString(txJson, "nonce").toLong();
+        res.isDelegate = false;
+        if (txJson.value("delegate_info").isObject()) {
+            const QJsonObject delegateJson = txJson.value("delegate_info").toObject();
+            res.isDelegate = delegateJson.value("isDelegate").toBool();
+            res.delegateValue = legacyIntOrString(delegateJson, "delegate");
+            if (delegateJson.value("delegateHash").isString()) {
+                res.delegateHash = delegateJson.value("delegateHash").toString();
+            }
+            res.type = Transaction::DELEGATE;
+        }
+        CHECK(txJson.value("status").isString(), "Incorrect json: status field not found");
+        const QString status = txJson.value("status").toString();
+        if (status == "ok") {
+            res.status = Transaction::OK;
+        } else if (status == "error") {
+            res.status = Transaction::ERROR;
+        } else if (status == "pending") {
+            res.status = Transaction::PENDING;
+        } else if (status == "module_not_set") {
+            res.status = Transaction::MODULE_NOT_SET;
+        }
+        CHECK(txJson.value("blockNumber").isDouble(), "Incorrect json: blockNumber field not found");
+        res.blockNumber = legacyIntOrString(txJson, "blockNumber").toLong();
+        CHECK(txJson.value("blockIndex").isDouble(), "Incorrect json: blockIndex field not found");
+        res.blockIndex = legacyIntOrString(txJson, "blockIndex").toLong();
+        if (txJson.value("type").toString() == "forging") {
+            res.type = Transaction::FORGING;
+        }
+        if (txJson.value("script_info").isObject()) {
+            res.type = Transaction::CONTRACT;
+        }
+        if (txJson.value("intStatus").isDouble()) {
+            res.intStatus = txJson.value("intStatus").toInt();
+        }
+        res.address = address;
+        res.currency = currency;
+        result.emplace_back(res);
+    }
+    return result;
+}
+
+static std::vector<BalanceInfo> legacyParseBalances(const std::string &response) {
+    std::vector<BalanceInfo> result;
+    for (const QJsonValue &elementJson: legacyResult(response)) {
+        CHECK(elementJson.isObject(), "result field not found");
+        const QJsonObject json = elementJson.toObject();
+        CHECK(json.value("address").isString(), "Incorrect json: address field not found");
+        BalanceInfo info(json.value("address").toString());
+        info.received = BigNumber256(legacyIntOrString(json, "received"));
+        info.spent = BigNumber256(legacyIntOrString(json, "spent"));
+        info.countReceived = legacyIntOrString(json, "count_received").toULong();
+        info.countSpent = legacyIntOrString(json, "count_spent").toULong();
+        info.countTxs = legacyIntOrString(json, "count_txs").toULong();
+        info.currBlockNum = legacyIntOrString(json, "currentBlock").toULong();
+        if (json.contains("countDelegatedOps")) {
+            info.countDelegated = legacyIntOrString(json, "countDelegatedOps").toULong();
+            info.delegate = BigNumber256(legacyIntOrString(json, "delegate"));
+            info.undelegate = BigNumber256(legacyIntOrString(json, "undelegate"));
+            info.delegated = BigNumber256(legacyIntOrString(json, "delegated"));
+            info.undelegated = BigNumber256(legacyIntOrString(json, "undelegated"));
+            info.reserved = BigNumber256(json.contains("reserved") ? legacyIntOrString(json, "reserved") : QString("0"));
+        }
+        if (json.contains("token_block_number")) {
+            info.tokenBlockNum = legacyIntOrString(json, "token_block_number").toULong();
+        }
+        if (json.contains("forged")) {
+            info.forged = BigNumber256(legacyIntOrString(json, "forged"));
+        }
+        result.emplace_back(info);
+    }
+    return result;
+}
+
+static void compareTransactions(const Transaction &tx, const Transaction &answer) {
+    QCOMPARE(tx.address, answer.address);
+    QCOMPARE(tx.currency, answer.currency);
+    QCOMPARE(tx.tx, answer.tx);
+    QCOMPARE(tx.from, answer.from);
+    QCOMPARE(tx.to, answer.to);
+    QCOMPARE(tx.value, answer.value);
+    QCOMPARE(tx.data, answer.data);
+    QCOMPARE(tx.timestamp, answer.timestamp);
+    QCOMPARE(tx.fee, answer.fee);
+    QCOMPARE(tx.nonce, answer.nonce);
+    QCOMPARE(tx.blockNumber, answer.blockNumber);
+    QCOMPARE(tx.blockIndex, answer.blockIndex);
+    QCOMPARE(tx.intStatus, answer.intStatus);
+    QCOMPARE(tx.delegateValue, answer.delegateValue);
+    QCOMPARE(tx.delegateHash, answer.delegateHash);
+    if (!answer.delegateValue.isEmpty()) {
+        QCOMPARE(tx.isDelegate, answer.isDelegate);
+    }
+    QCOMPARE(tx.type, answer.type);
+    QCOMPARE(tx.status, answer.status);
+}
+
+static void compareBalances(const BalanceInfo &balance, const BalanceInfo &answer) {
+    QCOMPARE(balance.address, answer.address);
+    QCOMPARE(balance.received, answer.received);
+    QCOMPARE(balance.spent, answer.spent);
+    QCOMPARE(balance.countReceived, answer.countReceived);
+    QCOMPARE(balance.countSpent, answer.countSpent);
+    QCOMPARE(balance.countTxs, answer.countTxs);
+    QCOMPARE(balance.currBlockNum, answer.currBlockNum);
+    QCOMPARE(balance.countDelegated, answer.countDelegated);
+    QCOMPARE(balance.delegate, answer.delegate);
+    QCOMPARE(balance.undelegate, answer.undelegate);
+    QCOMPARE(balance.delegated, answer.delegated);
+    QCOMPARE(balance.undelegated, answer.undelegated);
+    QCOMPARE(balance.reserved, answer.reserved);
+    QCOMPARE(balance.forged, answer.forged);
+    QCOMPARE(balance.tokenBlockNum, answer.tokenBlockNum);
+}
+
+void tst_TransactionsMessages::testJsonStreamReaderEscapes_data() {
+    QTest::addColumn<std::string>("json");
+    QTest::addColumn<QString>("answer");
+
+    QTest::newRow("Escapes plain") << std::string("\"abc\"") << QString("abc");
+    QTest::newRow("Escapes simple") << std::string("\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\"") << QString("a\"b\\c/d\b\f\n\r\t");
+    QTest::newRow("Escapes unicode") << std::string("\"\\u0041\\u00e9\\u20AC\"") << QString::fromUtf8(u8"Aé€");
+    QTest::newRow("Escapes surrogate pair") << std::string("\"x\\ud83d\\ude00y\"") << QString::fromUtf8(u8"x\U0001F600y");
+    QTest::newRow("Escapes utf8") << std::string(u8"\"été \U0001F600\"") << QString::fromUtf8(u8"été \U0001F600");
+}
+
+void tst_TransactionsMessages::testJsonStreamReaderEscapes() {
+    QFETCH(std::string, json);
+    QFETCH(QString, answer);
+
+    // As a value and as a key
+    JsonStreamReader reader(json);
+    QCOMPARE(reader.peekType(), JsonStreamReader::Type::String);
+    QCOMPARE(reader.readString(), answer);
+    reader.finish();
+
+    const std::string object = "{" + json + ": 1}";
+    JsonStreamReader objectReader(object);
+    objectReader.beginObject();
+    QLatin1String key;
+    QVERIFY(objectReader.nextKey(key));
+    QCOMPARE(QString::fromUtf8(key.data(), key.size()), answer);
+    objectReader.skipValue();
+    QVERIFY(!objectReader.nextKey(key));
+    objectReader.finish();
+}
+
+void tst_TransactionsMessages::testJsonStreamReaderNumbers_data() {
+    QTest::addColumn<std::string>("json");
+    QTest::addColumn<QString>("answer");
+    QTest::addColumn<double>("value");
+
+    QTest::newRow("Numbers zero") << std::string("0") << QString("0") << 0.0;
+    QTest::newRow("Numbers negative") << std::string(" -15 ") << QString("-15") << -15.0;
+    QTest::newRow("Numbers fraction") << std::string("2.5") << QString("2.5") << 2.5;
+    QTest::newRow("Numbers exponent") << std::string("-1.5E+3") << QString("-1.5E+3") << -1500.0;
+    QTest::newRow("Numbers long") << std::string("12345678901234567890") << QString("12345678901234567890") << 12345678901234567890.0;
+}
+
+void tst_TransactionsMessages::testJsonStreamReaderNumbers() {
+    QFETCH(std::string, json);
+    QFETCH(QString, answer);
+    QFETCH(double, value);
+
+    JsonStreamReader reader(json);
+    QCOMPARE(reader.peekType(), JsonStreamReader::Type::Number);
+    QCOMPARE(QString(reader.readNumber()), answer);
+    reader.finish();
+
+    JsonStreamReader reader2(json);
+    QCOMPARE(reader2.readDouble(), value);
+}
+
+void tst_TransactionsMessages::testJsonStreamReaderSkipValue() {
+    const std::string json = "{\"unknown\": {\"a\": [1, -2.5e3, {\"b\": [[], {}]}, \"s\\\"}]\"], \"c\": null, \"d\": true},"
+                             " \"arr\": [false, null, \"x\"], \"key\": \"value\", \"last\": 7}";
+    JsonStreamReader reader(json);
+    reader.beginObject();
+    QLatin1String key;
+    QString value;
+    QString last;
+    QStringList skipped;
+    while (reader.nextKey(key)) {
+        if (key == QLatin1String("key")) {
+            value = reader.readString();
+        } else if (key == QLatin1String("last")) {
+            last = reader.readNumber();
+        } else {
+            skipped.append(key);
+            reader.skipValue();
+        }
+    }
+    reader.finish();
+    QCOMPARE(value, QString("value"));
+    QCOMPARE(last, QString("7"));
+    QCOMPARE(skipped, QStringList({"unknown", "arr"}));
+}
+
+void tst_TransactionsMessages::testJsonStreamReaderMalformed_data() {
+    QTest::addColumn<std::string>("json");
+
+    QTest::newRow("Malformed empty") << std::string("");
+    QTest::newRow("Malformed spaces") << std::string("   ");
+    QTest::newRow("Malformed open object") << std::string("{\"a\": 1");
+    QTest::newRow("Malformed open array") << std::string("[1, 2");
+    QTest::newRow("Malformed open string") << std::string("\"abc");
+    QTest::newRow("Malformed open escape") << std::string("\"abc\\");
+    QTest::newRow("Malformed no colon") << std::string("{\"a\" 1}");
+    QTest::newRow("Malformed no comma") << std::string("[1 2]");
+    QTest::newRow("Malformed trailing comma") << std::string("{\"a\": 1,}");
+    QTest::newRow("Malformed key not string") << std::string("{a: 1}");
+    QTest::newRow("Malformed leading zero") << std::string("[01]");
+    QTest::newRow("Malformed fraction") << std::string("1.");
+    QTest::newRow("Malformed exponent") << std::string("1e");
+    QTest::newRow("Malformed minus") << std::string("-");
+    QTest::newRow("Malformed literal") << std::string("tru");
+    QTest::newRow("Malformed null") << std::string("nul");
+    QTest::newRow("Malformed symbol") << std::string("[1, x]");
+    QTest::newRow("Malformed control symbol") << std::string("\"a\nb\"");
+    QTest::newRow("Malformed trailing data") << std::string("{} {}");
+    QTest::newRow("Malformed close") << std::string("]");
+}
+
+void tst_TransactionsMessages::testJsonStreamReaderMalformed() {
+    QFETCH(std::string, json);
+
+    JsonStreamReader reader(json);
+    QVERIFY_EXCEPTION_THROWN({
+        reader.skipValue();
+        reader.finish();
+    }, Exception);
+}
+
+void tst_TransactionsMessages::testHistoryAmounts_data() {
+    QTest::addColumn<std::string>("value");
+    QTest::addColumn<std::string>("fee");
+    QTest::addColumn<QString>("answerValue");
+    QTest::addColumn<QString>("answerFee");
+
+    QTest::newRow("Amounts numbers") << std::string("1000") << std::string("0") << QString("1000") << QString("0");
+    QTest::newRow("Amounts strings") << std::string("\"1000\"") << std::string("\"25\"") << QString("1000") << QString("25");
+    QTest::newRow("Amounts big string") << std::string("\"1200215463145647002239\"") << std::string("\"0\"") << QString("1200215463145647002239") << QString("0");
+    QTest::newRow("Amounts 15 digits") << std::string("999999999999999") << std::string("1") << QString("999999999999999") << QString("1");
+    QTest::newRow("Amounts through double") << std::string("1234567890123456789") << std::string("1e3") << QString("1234567890123456768") << QString("1000");
+}
+
+void tst_TransactionsMessages::testHistoryAmounts() {
+    QFETCH(std::string, value);
+    QFETCH(std::string, fee);
+    QFETCH(QString, answerValue);
+    QFETCH(QString, answerFee);
+
+    const std::string response = "{\"id\": 1, \"result\": [{\"from\": \"0x01\", \"to\": \"0x02\", \"value\": " + value +
+            ", \"transaction\": \"abc\", \"data\": \"\", \"timestamp\": 1550000000, \"fee\": 0, \"realFee\": " + fee +
+            ", \"nonce\": 5, \"status\": \"ok\", \"blockNumber\": 100, \"blockIndex\": 2, \"intStatus\": 20}]}";
+    const std::vector<Transaction> txs = parseHistoryResponse("0x02", "mhc", response);
+    QCOMPARE(txs.size(), size_t(1));
+    QCOMPARE(txs[0].value, answerValue);
+    QCOMPARE(txs[0].fee, answerFee);
+
+    const std::vector<Transaction> legacy = legacyParseHistory("0x02", "mhc", response);
+    compareTransactions(txs[0], legacy[0]);
+}
+
+void tst_TransactionsMessages::testBalancesAmounts() {
+    const std::string response = "{\"id\": 1, \"result\": ["
+            "{\"address\": \"0x01\", \"received\": 1000, \"spent\": \"10\", \"count_received\": 2, \"count_spent\": \"1\", \"count_txs\": 3, \"currentBlock\": 77},"
+            "{\"address\": \"0x02\", \"received\": \"1200215463145647002239\", \"spent\": 0, \"count_received\": 1, \"count_spent\": 0, \"count_txs\": 1, \"currentBlock\": 77,"
+            " \"countDelegatedOps\": 1, \"delegate\": \"500\", \"undelegate\": 0, \"delegated\": 0, \"undelegated\": 0, \"forged\": 9, \"token_block_number\": 70}]}";
+    const std::vector<BalanceInfo> balances = parseBalancesResponse(response);
+    QCOMPARE(balances.size(), size_t(2));
+    QCOMPARE(balances[0].received.getDecimal(), QByteArray("1000"));
+    QCOMPARE(balances[0].spent.getDecimal(), QByteArray("10"));
+    QCOMPARE(balances[0].countSpent, uint64_t(1));
+    QCOMPARE(balances[1].received.getDecimal(), QByteArray("1200215463145647002239"));
+    QCOMPARE(balances[1].delegate.getDecimal(), QByteArray("500"));
+    QCOMPARE(balances[1].reserved.getDecimal(), QByteArray("0"));
+    QCOMPARE(balances[1].tokenBlockNum, uint64_t(70));
+
+    const std::vector<BalanceInfo> legacy = legacyParseBalances(response);
+    for (size_t i = 0; i < balances.size(); i++) {
+        compareBalances(balances[i], legacy[i]);
+    }
+
+    QVERIFY_EXCEPTION_THROWN(parseBalancesResponse("{\"id\": 1, \"result\": [{\"address\": \"0x01\", \"received\": 1000}]}"), Exception);
+    QVERIFY_EXCEPTION_THROWN(parseBalancesResponse("{\"id\": 1, \"result\": [{\"address\": \"0x01\", \"received\": null, \"spent\": 0, \"count_received\": 0, \"count_spent\": 0, \"count_txs\": 0, \"currentBlock\": 0}]}"), Exception);
+}
+
+void tst_TransactionsMessages::testHistoryRecorded() {
+    const std::string response = readResponse("fetch-history.json");
+    const std::vector<Transaction> txs = parseHistoryResponse("0x00addr", "mhc", response);
+    const std::vector<Transaction> legacy = legacyParseHistory("0x00addr", "mhc", response);
+    QCOMPARE(txs.size(), legacy.size());
+    QVERIFY(!txs.empty());
+    for (size_t i = 0; i < txs.size(); i++) {
+        compareTransactions(txs[i], legacy[i]);
+    }
+}
+
+void tst_TransactionsMessages::testBalancesRecorded() {
+    const std::string response = readResponse("fetch-balances.json");
+    const std::vector<BalanceInfo> balances = parseBalancesResponse(response);
+    const std::vector<BalanceInfo> legacy = legacyParseBalances(response);
+    QCOMPARE(balances.size(), legacy.size());
+    QVERIFY(!balances.empty());
+    for (size_t i = 0; i < balances.size(); i++) {
+        compareBalances(balances[i], legacy[i]);
+    }
+}
+
+void tst_TransactionsMessages::testHistoryTruncated() {
+    const std::string response = readResponse("fetch-history.json");
+    // Any prefix without the closing brace of the response
+    const size_t end = response.rfind('}');
+    for (size_t size = 0; size < end; size += 997) {
+        const std::string truncated = response.substr(0, size);
+        QVERIFY_EXCEPTION_THROWN(parseHistoryResponse("0x00addr", "mhc", truncated), Exception);
+    }
+    QVERIFY_EXCEPTION_THROWN(parseHistoryResponse("0x00addr", "mhc", "{\"id\": 1, \"error\": {\"code\": -32603}}"), Exception);
+    QVERIFY_EXCEPTION_THROWN(parseHistoryResponse("0x00addr", "mhc", "{\"id\": 1, \"result\": [{\"from\": \"0x01\"}]}"), Exception);
+}
@@ -0,0 +1,38 @@
+#ifndef TST_TRANSACTIONSMESSAGES_H
+#define TST_TRANSACTIONSMESSAGES_H
+
+#include <QObject>
+
+class tst_TransactionsMessages : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_TransactionsMessages(QObject *parent = nullptr);
+
+private slots:
+
+    void testJsonStreamReaderEscapes_data();
+    void testJsonStreamReaderEscapes();
+
+    void testJsonStreamReaderNumbers_data();
+    void testJsonStreamReaderNumbers();
+
+    void testJsonStreamReaderSkipValue();
+
+    void testJsonStreamReaderMalformed_data();
+    void testJsonStreamReaderMalformed();
+
+    void testHistoryAmounts_data();
+    void testHistoryAmounts();
+
+    void testBalancesAmounts();
+
+    void testHistoryRecorded();
+
+    void testBalancesRecorded();
+
+    void testHistoryTruncated();
+
+};
+
+#endif // TST_TRANSACTIONSMESSAGES_H
@@ -0,0 +1,24 @@
+#include <QTest>
+
+#include "tst_HistoryBackfill.h"
+#include "tst_BalancePollScheduler.h"
+#include "tst_SendBatchState.h"
+#include "tst_TransactionsMessages.h"
+
+int main(int argc, char *argv[]) {
+    int status = 0;
+    auto ASSERT_TEST = [&status, argc, argv](QObject* obj) {
+        if (status) {
+            return;
+        }
+        status |= QTest::qExec(obj, argc, argv);
+        delete obj;
+    };
+
+    ASSERT_TEST(new tst_HistoryBackfill());
+    ASSERT_TEST(new tst_BalancePollScheduler());
+    ASSERT_TEST(new tst_SendBatchState());
+    ASSERT_TEST(new tst_TransactionsMessages());
+
+    return status;
+}
@@ -0,0 +1,47 @@
+QT       += testlib
+QT       -= gui
+QT       += sql
+TARGET = tst_transactions
+CONFIG   += testcase
+CONFIG += c++14
+CONFIG += static
+
+TEMPLATE = app
+
+INCLUDEPATH = ../../src
+
+SOURCES += \
+    ../../src/transactions/HistoryBackfill.cpp \
+    ../../src/transactions/BalancePollScheduler.cpp \
+    ../../src/transactions/SendBatchState.cpp \
+    ../../src/transactions/TransactionsMessages.cpp \
+    ../../src/utilites/JsonStreamReader.cpp \
+    ../../src/utilites/BigNumber256.cpp \
+    ../../src/TypedException.cpp \
+    ../LogMock.cpp \
+    tst_HistoryBackfill.cpp \
+    tst_BalancePollScheduler.cpp \
+    tst_SendBatchState.cpp \
+    tst_TransactionsMessages.cpp \
+    tst_main.cpp
+
+HEADERS += \
+    ../../src/transactions/HistoryBackfill.h \
+    ../../src/transactions/BalancePollScheduler.h \
+    ../../src/transactions/SendBatchState.h \
+    ../../src/transactions/TransactionsMessages.h \
+    ../../src/utilites/JsonStreamReader.h \
+    ../../src/utilites/BigNumber256.h \
+    ../../src/TypedException.h \
+    tst_HistoryBackfill.h \
+    tst_BalancePollScheduler.h \
+    tst_SendBatchState.h \
+    tst_TransactionsMessages.h
+
+RESOURCES += \
+    data/responses.qrc
+
+QMAKE_LFLAGS += -rdynamic
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)
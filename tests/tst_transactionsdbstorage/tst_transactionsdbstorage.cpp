@@ -1,9 +1,15 @@
 #include "tst_transactionsdbstorage.h"
 
 #include <QTest>
+#include <QSqlQuery>
+
+#include <future>
 
 #include "TransactionsDBStorage.h"
 #include "TransactionsDBRes.h"
+#include "dbwriter.h"
+#include "TypedException.h"
+#include "check.h"
 
 tst_TransactionsDBStorage::tst_TransactionsDBStorage(QObject *parent)
     : QObject(parent)
@@ -157,11 +163,30 @@ void tst_TransactionsDBStorage::tstFilterDelegate() {
     db.addPayment("mh", "gfklklklruuiuifdidgjkg", "address100", 2, "user1", "address100", "2340", 568869455856, "nvcmnjkdfjkgf", "100", 8896865, true, "1435400", "jkgh", transactions::Transaction::OK, transactions::Transaction::DELEGATE, 11119, "", 1);
     db.addPayment("mh", "gfklkl545uuiuiduidgjkg", "address100", 2, "address100", "user2", "2340", 568869455856, "nvcmnjkdfjkgf", "100", 8896865, false, "1004040", "jkgh", transactions::Transaction::OK, transactions::Transaction::DELEGATE, 11120, "324521354", 2);
 
+    // Failed delegation 11117 is listed too
     const auto res = db.getDelegatePaymentsForAddress("address100", "user1", "mh", 0, -1, true);
     QCOMPARE(res.size(), 2);
 
     const auto res2 = db.getDelegatePaymentsForAddress("address100", "mh", 0, -1, true);
     QCOMPARE(res2.size(), 3);
+
+    transactions::Filters failed;
+    failed.isSuccess = transactions::FilterType::False;
+    QCOMPARE(db.getPaymentsForAddressFilter("address100", "mh", failed, 0, -1, true).size(), 1);
+
+    transactions::Filters simpleSuccess;
+    simpleSuccess.isDelegate = transactions::FilterType::False;
+    simpleSuccess.isSuccess = transactions::FilterType::True;
+    QCOMPARE(db.getPaymentsForAddressFilter("address100", "mh", simpleSuccess, 0, -1, true).size(), 3);
+
+    transactions::Filters delegateNotInput;
+    delegateNotInput.isDelegate = transactions::FilterType::True;
+    delegateNotInput.isInput = transactions::FilterType::False;
+    QCOMPARE(db.getPaymentsForAddressFilter("address100", "mh", delegateNotInput, 0, -1, true).size(), 3);
+
+    transactions::Filters output;
+    output.isOutput = transactions::FilterType::True;
+    QCOMPARE(db.getPaymentsForAddressFilter("address100", "mh", output, 0, -1, true).size(), 1);
 }
 
 static void compareBalances(const transactions::BalanceInfo &balance1, const transactions::BalanceInfo &balance2) {
@@ -194,7 +219,7 @@ void tst_TransactionsDBStorage::tstBalance() {
     balance1.countSpent = 101;
     balance1.countTxs = 200;
     balance1.currBlockNum = 1000;
-    balance1.delegate = BigNumber(QString("1202239"));
+    balance1.delegate = BigNumber256(QString("1202239"));
 
     db.setBalance("cur1", balance1.address, balance1);
 
@@ -205,14 +230,14 @@ void tst_TransactionsDBStorage::tstBalance() {
     balance2.countSpent = 102;
     balance2.countTxs = 200000000;
     balance2.currBlockNum = 1000000000;
-    balance2.delegate = BigNumber(QString("1200215463145647002239"));
-    balance2.delegated = BigNumber(QString("100"));
-    balance2.forged = BigNumber(QString("0"));
-    balance2.received = BigNumber(QString("1000"));
-    balance2.reserved = BigNumber(QString("233"));
-    balance2.spent = BigNumber(QString("2000"));
-    balance2.undelegate = BigNumber(QString("343"));
-    balance2.undelegated = BigNumber(QString("445"));
+    balance2.delegate = BigNumber256(QString("1200215463145647002239"));
+    balance2.delegated = BigNumber256(QString("100"));
+    balance2.forged = BigNumber256(QString("0"));
+    balance2.received = BigNumber256(QString("1000"));
+    balance2.reserved = BigNumber256(QString("233"));
+    balance2.spent = BigNumber256(QString("2000"));
+    balance2.undelegate = BigNumber256(QString("343"));
+    balance2.undelegated = BigNumber256(QString("445"));
 
     db.setBalance("cur1", balance2.address, balance2);
 
@@ -223,14 +248,14 @@ void tst_TransactionsDBStorage::tstBalance() {
     balance3.countSpent = 201;
     balance3.countTxs = 300000000;
     balance3.currBlockNum = 4000000000;
-    balance3.delegate = BigNumber(QString("3145647002239"));
-    balance3.delegated = BigNumber(QString("1000100000000000000"));
-    balance3.forged = BigNumber(QString("0"));
-    balance3.received = BigNumber(QString("10001"));
-    balance3.reserved = BigNumber(QString("546368"));
-    balance3.spent = BigNumber(QString("3000"));
-    balance3.undelegate = BigNumber(QString("5543"));
-    balance3.undelegated = BigNumber(QString("41445"));
+    balance3.delegate = BigNumber256(QString("3145647002239"));
+    balance3.delegated = BigNumber256(QString("1000100000000000000"));
+    balance3.forged = BigNumber256(QString("0"));
+    balance3.received = BigNumber256(QString("10001"));
+    balance3.reserved = BigNumber256(QString("546368"));
+    balance3.spent = BigNumber256(QString("3000"));
+    balance3.undelegate = BigNumber256(QString("5543"));
+    balance3.undelegated = BigNumber256(QString("41445"));
 
     db.setBalance("cur1", balance3.address, balance3);
 
@@ -311,6 +336,98 @@ void tst_TransactionsDBStorage::testGetPayments()
     }
 }
 
+void tst_TransactionsDBStorage::testGetPaymentsCursor()
+{
+    if (QFile::exists(transactions::databaseFileName))
+        QFile::remove(transactions::databaseFileName);
+    transactions::TransactionsDBStorage db;
+    db.init();
+    auto transactionGuard = db.beginTransaction();
+    for (int n = 0; n < 25; n++) {
+        // Pairs of payments with equal ts
+        db.addPayment("mh", QString("tx%1").arg(n, 2, 10, QChar('0')), "address100", 3, n % 2 ? "address100" : "user7", "user1", "9000000000000000000", 1000 + n / 2, "nvcmnjkdfjkgf", "100", 8896865, false, "100", "kghkghk", transactions::Transaction::OK, transactions::Transaction::SIMPLE, 11112, "", 1);
+    }
+    db.addPayment("mh", "tx00", "address20", 3, "user7", "user1", "9000000000000000000", 1000, "nvcmnjkdfjkgf", "100", 8896865, false, "100", "kghkghk", transactions::Transaction::OK, transactions::Transaction::SIMPLE, 11112, "", 1);
+    transactionGuard.commit();
+
+    for (const bool asc: {true, false}) {
+        const std::vector<transactions::Transaction> all = db.getPaymentsForAddress("address100", "mh", 0, 100, asc);
+        QCOMPARE(all.size(), 25);
+
+        std::vector<transactions::Transaction> paged;
+        transactions::TxsCursor cursor;
+        while (true) {
+            const std::vector<transactions::Transaction> page = db.getPaymentsForAddressCursor("address100", "mh", transactions::Filters(), cursor, 10, asc);
+            paged.insert(paged.end(), page.begin(), page.end());
+            if (page.size() < 10) {
+                break;
+            }
+            cursor.isSet = true;
+            cursor.ts = page.back().timestamp;
+            cursor.txid = page.back().tx;
+            cursor.id = page.back().id;
+        }
+        QCOMPARE(paged.size(), all.size());
+        for (size_t i = 0; i < all.size(); i++) {
+            QCOMPARE(paged[i].tx, all[i].tx);
+        }
+    }
+
+    transactions::Filters filters;
+    filters.isInput = transactions::FilterType::True;
+    const std::vector<transactions::Transaction> inputs = db.getPaymentsForAddressCursor("address100", "mh", filters, transactions::TxsCursor(), 100, true);
+    QCOMPARE(inputs.size(), 12);
+    for (const transactions::Transaction &tx: inputs) {
+        QCOMPARE(tx.from, QStringLiteral("address100"));
+    }
+}
+
+static std::vector<QString> queryPlan(const QString &select) {
+    QSqlQuery query(QSqlDatabase::database(transactions::databaseName));
+    CHECK(query.prepare("EXPLAIN QUERY PLAN " + select), query.lastError().text().toStdString());
+    query.bindValue(":address", "address100");
+    query.bindValue(":currency", "mh");
+    query.bindValue(":flagsMask", 1);
+    query.bindValue(":flagsValue", 1);
+    query.bindValue(":cursorTs", 1000);
+    query.bindValue(":cursorTxid", "tx00");
+    query.bindValue(":cursorId", 1);
+    query.bindValue(":count", 10);
+    query.bindValue(":offset", 0);
+    CHECK(query.exec(), query.lastError().text().toStdString());
+    std::vector<QString> plan;
+    while (query.next()) {
+        plan.emplace_back(query.value("detail").toString());
+    }
+    return plan;
+}
+
+void tst_TransactionsDBStorage::testGetPaymentsCursorPlan()
+{
+    if (QFile::exists(transactions::databaseFileName))
+        QFile::remove(transactions::databaseFileName);
+    transactions::TransactionsDBStorage db;
+    db.init();
+    for (int n = 0; n < 10; n++) {
+        db.addPayment("mh", QString("tx%1").arg(n, 2, 10, QChar('0')), "address100", 3, n % 2 ? "address100" : "user7", "user1", "100", 1000 + n / 2, "", "100", n, false, "0", "", transactions::Transaction::OK, transactions::Transaction::SIMPLE, 11112, "", 1);
+    }
+
+    // Cursor pages and filtered history are read in index order, without sorting
+    const std::vector<QString> selects = {
+        QString(transactions::selectPaymentsForDestCursor).replace("%cursor%", QString()).arg("ASC"),
+        QString(transactions::selectPaymentsForDestCursor).replace("%cursor%", QString()).arg("DESC"),
+        QString(transactions::selectPaymentsForDestCursor).replace("%cursor%", transactions::paymentsCursorAsc).arg("ASC"),
+        QString(transactions::selectPaymentsForDestCursor).replace("%cursor%", transactions::paymentsCursorDesc).arg("DESC"),
+        QString(transactions::selectPaymentsForDestFilter).arg("DESC"),
+    };
+    for (const QString &select: selects) {
+        const std::vector<QString> plan = queryPlan(select);
+        QCOMPARE(plan.size(), size_t(1));
+        QVERIFY2(plan[0].startsWith("SEARCH") && plan[0].contains("paymentsIdx10 (address=? AND currency=?"), plan[0].toStdString().c_str());
+        QVERIFY2(!plan[0].contains("TEMP B-TREE"), plan[0].toStdString().c_str());
+    }
+}
+
 void tst_TransactionsDBStorage::testAddressInfos()
 {
     if (QFile::exists(transactions::databaseFileName))
@@ -368,4 +485,341 @@ void tst_TransactionsDBStorage::tstCurrency() {
     QCOMPARE(res.at(false).size(), 2);
 }
 
+static QString amountType(const QString &column, const QString &table) {
+    QSqlQuery query(QSqlDatabase::database(transactions::databaseName));
+    query.exec(QString("SELECT typeof(%1) AS t FROM %2 LIMIT 1").arg(column).arg(table));
+    if (query.next()) {
+        return query.value("t").toString();
+    }
+    return QString();
+}
+
+void tst_TransactionsDBStorage::tstBinaryAmounts() {
+    if (QFile::exists(transactions::databaseFileName))
+        QFile::remove(transactions::databaseFileName);
+    transactions::TransactionsDBStorage db;
+    db.init();
+    QCOMPARE(db.isBinaryAmounts(), false);
+    db.setBinaryAmounts(true);
+
+    db.addPayment("mh", "gfklklkltrklklgfmjgfhg", "address100", 0, "user7", "user1", "115792089237316195423570985008687907853269984665640564039457584007913129639935", 568869455886, "nvcmnjkdfjkgf", "0", 8896865, false, "", "jkgh", transactions::Transaction::OK, transactions::Transaction::SIMPLE, 11112, "", 1);
+    QCOMPARE(amountType("value", "payments"), QStringLiteral("blob"));
+
+    db.setBinaryAmounts(false);
+    db.addPayment("mh", "gfklklkltrklklklgfkfhg", "address100", 0, "user7", "user2", "1200215463145647002239", 568869455887, "nvcmnjkdfjkgf", "100", 8896865, true, "0100", "jkgh", transactions::Transaction::OK, transactions::Transaction::SIMPLE, 11113, "", 1);
+
+    db.setBinaryAmounts(true);
+    std::vector<transactions::Transaction> txs(60);
+    for (size_t i = 0; i < txs.size(); i++) {
+        txs[i].currency = "mh";
+        txs[i].address = "address100";
+        txs[i].tx = QString("bulk%1").arg(i);
+        txs[i].value = QString::number(i * 1000000000000ULL);
+        txs[i].fee = "-5";
+        txs[i].delegateValue = "18446744073709551616";
+        txs[i].timestamp = 568869455888 + i;
+        txs[i].isDelegate = false;
+        txs[i].blockNumber = 11114;
+    }
+    db.addPayments(txs);
+
+    const auto res = db.getPaymentsForAddress("address100", "mh", 0, -1, true);
+    QCOMPARE(res.size(), txs.size() + 2);
+    QCOMPARE(res[0].value, QStringLiteral("115792089237316195423570985008687907853269984665640564039457584007913129639935"));
+    QCOMPARE(res[0].fee, QStringLiteral("0"));
+    QCOMPARE(res[0].delegateValue, QStringLiteral(""));
+    QCOMPARE(res[1].value, QStringLiteral("1200215463145647002239"));
+    QCOMPARE(res[1].fee, QStringLiteral("100"));
+    QCOMPARE(res[1].delegateValue, QStringLiteral("0100"));
+    for (size_t i = 0; i < txs.size(); i++) {
+        QCOMPARE(res[i + 2].value, txs[i].value);
+        QCOMPARE(res[i + 2].fee, txs[i].fee);
+        QCOMPARE(res[i + 2].delegateValue, txs[i].delegateValue);
+    }
+
+    transactions::Transaction trans = res[1];
+    trans.value = "340282366920938463463374607431768211456";
+    db.updatePayment("address100", "mh", trans.tx, trans.blockNumber, trans.blockIndex, trans);
+    const auto res2 = db.getPaymentsForAddress("address100", "mh", 1, 1, true);
+    QCOMPARE(res2.size(), 1);
+    QCOMPARE(res2[0].value, trans.value);
+}
+
+void tst_TransactionsDBStorage::tstBinaryAmountsBalance() {
+    if (QFile::exists(transactions::databaseFileName))
+        QFile::remove(transactions::databaseFileName);
+    transactions::TransactionsDBStorage db;
+    db.init();
+    db.setBinaryAmounts(true);
+
+    transactions::BalanceInfo balance1;
+    balance1.address = "addr1";
+    balance1.countTxs = 200;
+    balance1.delegate = BigNumber256(QString("1200215463145647002239"));
+    balance1.received = BigNumber256(QString("115792089237316195423570985008687907853269984665640564039457584007913129639935"));
+    balance1.reserved = BigNumber256(QString("-233"));
+    balance1.spent = BigNumber256(QString("340282366920938463463374607431768211455"));
+    db.setBalance("cur1", balance1.address, balance1);
+    QCOMPARE(amountType("received", "balance"), QStringLiteral("blob"));
+    compareBalances(balance1, db.getBalance("cur1", balance1.address));
+
+    db.setBinaryAmounts(false);
+    db.setBalance("cur1", balance1.address, balance1);
+    QCOMPARE(amountType("received", "balance"), QStringLiteral("text"));
+    compareBalances(balance1, db.getBalance("cur1", balance1.address));
+}
+
+void tst_TransactionsDBStorage::tstAmountsEncoding() {
+    if (QFile::exists(transactions::databaseFileName))
+        QFile::remove(transactions::databaseFileName);
+    transactions::TransactionsDBStorage db;
+    db.init();
+
+    db.addPayment("mh", "gfklklkltrklklgfmjgfhg", "address100", 0, "user7", "address100", "340282366920938463463374607431768211456", 568869455886, "nvcmnjkdfjkgf", "-5", 8896865, false, "0100", "jkgh", transactions::Transaction::OK, transactions::Transaction::SIMPLE, 11112, "", 1);
+    transactions::BalanceInfo balance;
+    balance.address = "address100";
+    balance.received = BigNumber256(QString("1200215463145647002239"));
+    balance.reserved = BigNumber256(QString("-233"));
+    db.setBalance("mh", balance.address, balance);
+    QCOMPARE(amountType("value", "payments"), QStringLiteral("text"));
+    QCOMPARE(amountType("received", "balance"), QStringLiteral("text"));
+    QCOMPARE(amountType("received", "paymentsStat"), QStringLiteral("text"));
+
+    db.setAmountsEncoding(true);
+    QCOMPARE(db.isBinaryAmounts(), true);
+    QCOMPARE(amountType("value", "payments"), QStringLiteral("blob"));
+    QCOMPARE(amountType("fee", "payments"), QStringLiteral("text"));
+    QCOMPARE(amountType("delegateValue", "payments"), QStringLiteral("text"));
+    QCOMPARE(amountType("received", "balance"), QStringLiteral("blob"));
+    QCOMPARE(amountType("reserved", "balance"), QStringLiteral("text"));
+    QCOMPARE(amountType("received", "paymentsStat"), QStringLiteral("blob"));
+
+    const auto check = [&db, &balance]{
+        const auto res = db.getPaymentsForAddress("address100", "mh", 0, -1, true);
+        QCOMPARE(res.size(), 1);
+        QCOMPARE(res[0].value, QStringLiteral("340282366920938463463374607431768211456"));
+        QCOMPARE(res[0].fee, QStringLiteral("-5"));
+        QCOMPARE(res[0].delegateValue, QStringLiteral("0100"));
+        compareBalances(balance, db.getBalance("mh", balance.address));
+        QCOMPARE(db.getPaymentsStat("address100", "mh").received.getDecimal(), QByteArray("340282366920938463463374607431768211456"));
+    };
+    check();
+
+    db.setAmountsEncoding(false);
+    QCOMPARE(db.isBinaryAmounts(), false);
+    QCOMPARE(amountType("value", "payments"), QStringLiteral("text"));
+    QCOMPARE(amountType("received", "balance"), QStringLiteral("text"));
+    QCOMPARE(amountType("received", "paymentsStat"), QStringLiteral("text"));
+    check();
+}
+
+void tst_TransactionsDBStorage::tstHistoryBackfill() {
+    if (QFile::exists(transactions::databaseFileName))
+        QFile::remove(transactions::databaseFileName);
+    transactions::TransactionsDBStorage db;
+    db.init();
+
+    transactions::HistoryBackfillInfo empty = db.getHistoryBackfill("cur1", "addr1");
+    QCOMPARE(empty.targetTxs, 0ULL);
+    QCOMPARE(empty.savedTxs, 0ULL);
+
+    transactions::HistoryBackfillInfo info;
+    info.targetTxs = 200000;
+    info.savedTxs = 1000;
+    db.setHistoryBackfill("cur1", "addr1", info);
+
+    transactions::HistoryBackfillInfo info2 = db.getHistoryBackfill("cur1", "addr1");
+    QCOMPARE(info2.targetTxs, info.targetTxs);
+    QCOMPARE(info2.savedTxs, info.savedTxs);
+    QCOMPARE(db.getBalance("cur1", "addr1").countTxs, 0ULL);
+    QCOMPARE(db.getHistoryBackfill("cur2", "addr1").targetTxs, 0ULL);
+
+    info.savedTxs = 51000;
+    db.setHistoryBackfill("cur1", "addr1", info);
+    QCOMPARE(db.getHistoryBackfill("cur1", "addr1").savedTxs, 51000ULL);
+
+    transactions::BalanceInfo balance;
+    balance.address = "addr1";
+    balance.countTxs = 200000;
+    db.setBalance("cur1", "addr1", balance);
+    QCOMPARE(db.getHistoryBackfill("cur1", "addr1").targetTxs, 0ULL);
+
+    db.setHistoryBackfill("cur1", "addr1", info);
+    QCOMPARE(db.getBalance("cur1", "addr1").countTxs, 200000ULL);
+    db.removePaymentsForCurrency("cur1");
+    QCOMPARE(db.getHistoryBackfill("cur1", "addr1").targetTxs, 0ULL);
+}
+
+void tst_TransactionsDBStorage::tstPaymentsStat() {
+    if (QFile::exists(transactions::databaseFileName))
+        QFile::remove(transactions::databaseFileName);
+    transactions::TransactionsDBStorage db;
+    db.init();
+
+    std::vector<transactions::Transaction> txs(120);
+    for (size_t i = 0; i < txs.size(); i++) {
+        txs[i].currency = "mh";
+        txs[i].address = i % 3 == 0 ? "address2" : "address1";
+        txs[i].tx = QString("tx%1").arg(i);
+        txs[i].from = i % 4 == 0 ? txs[i].address : "user1";
+        txs[i].to = i % 4 == 0 ? "user2" : txs[i].address;
+        txs[i].value = "100";
+        txs[i].fee = "1";
+        txs[i].timestamp = 1000 + i;
+        txs[i].isDelegate = false;
+        txs[i].blockNumber = 100 + i;
+        txs[i].status = i % 10 == 0 ? transactions::Transaction::PENDING : transactions::Transaction::OK;
+    }
+    db.addPayments(txs);
+    // Duplicates are not counted
+    db.addPayments(std::vector<transactions::Transaction>(txs.begin(), txs.begin() + 60));
+    db.addPayment(txs[1]);
+
+    QCOMPARE(db.getPaymentsCountForAddress("address1", "mh"), 80);
+    QCOMPARE(db.getPaymentsCountForAddress("address2", "mh"), 40);
+    QCOMPARE(db.getPaymentsCountForAddress("address3", "mh"), 0);
+    QCOMPARE(db.getPaymentsStat("address1", "mh").countPending, 8);
+    QCOMPARE(db.getPaymentsStat("address2", "mh").countPending, 4);
+    // Sums are over confirmed payments only
+    QCOMPARE(db.getPaymentsStat("address1", "mh").received.getDecimal(), QByteArray("5600"));
+    QCOMPARE(db.getPaymentsStat("address1", "mh").spent.getDecimal(), QByteArray("1600"));
+    QCOMPARE(db.getPaymentsStat("address3", "mh").received.getDecimal(), QByteArray("0"));
+    QCOMPARE(db.getPaymentsForAddressPending("address1", "mh", true).size(), 8);
+    QCOMPARE(db.getPaymentsForAddressPending("address3", "mh", true).size(), 0);
+
+    transactions::Transaction trans = txs[10];
+    trans.status = transactions::Transaction::OK;
+    trans.value = "1000";
+    db.updatePayment(trans.address, trans.currency, trans.tx, trans.blockNumber, trans.blockIndex, trans);
+    db.updatePayment(trans.address, trans.currency, trans.tx, trans.blockNumber, trans.blockIndex, trans);
+    QCOMPARE(db.getPaymentsStat("address1", "mh").countPending, 7);
+    QCOMPARE(db.getPaymentsStat("address1", "mh").received.getDecimal(), QByteArray("6600"));
+    QVERIFY(db.checkPaymentsStat().empty());
+    trans.value = "100";
+    trans.status = transactions::Transaction::MODULE_NOT_SET;
+    db.updatePayment(trans.address, trans.currency, trans.tx, trans.blockNumber, trans.blockIndex, trans);
+    QCOMPARE(db.getPaymentsStat("address1", "mh").countPending, 8);
+    QCOMPARE(db.getPaymentsStat("address1", "mh").received.getDecimal(), QByteArray("5600"));
+    QVERIFY(db.checkPaymentsStat().empty());
+
+    db.removePaymentsForDest("address2", "mh");
+    QCOMPARE(db.getPaymentsCountForAddress("address2", "mh"), 0);
+    QCOMPARE(db.getPaymentsCountForAddress("address1", "mh"), 80);
+    QVERIFY(db.checkPaymentsStat().empty());
+
+    db.execPragma("DELETE FROM paymentsStat");
+    const auto mismatches = db.checkPaymentsStat();
+    QCOMPARE(mismatches.size(), 1);
+    QCOMPARE(mismatches[0].first.address, QStringLiteral("address1"));
+    QCOMPARE(mismatches[0].first.countTxs, 0);
+    QCOMPARE(mismatches[0].second.countTxs, 80);
+    QCOMPARE(mismatches[0].second.countPending, 8);
+    QCOMPARE(mismatches[0].second.received.getDecimal(), QByteArray("5600"));
+    db.rebuildPaymentsStat();
+    QVERIFY(db.checkPaymentsStat().empty());
+    QCOMPARE(db.getPaymentsCountForAddress("address1", "mh"), 80);
+    QCOMPARE(db.getPaymentsStat("address1", "mh").spent.getDecimal(), QByteArray("1600"));
+
+    // The first chunk of address1 has both duplicates and new payments
+    std::vector<transactions::Transaction> more(txs.begin(), txs.begin() + 60);
+    for (size_t i = 120; i < 150; i++) {
+        transactions::Transaction tx = txs[1];
+        tx.tx = QString("tx%1").arg(i);
+        tx.timestamp = 1000 + i;
+        tx.blockNumber = 100 + i;
+        more.emplace_back(tx);
+    }
+    db.addPayments(more);
+    QCOMPARE(db.getPaymentsCountForAddress("address1", "mh"), 110);
+    QCOMPARE(db.getPaymentsStat("address1", "mh").received.getDecimal(), QByteArray("8600"));
+    QVERIFY(db.checkPaymentsStat().empty());
+
+    db.removePaymentsForCurrency("mh");
+    QCOMPARE(db.getPaymentsCountForAddress("address1", "mh"), 0);
+    QVERIFY(db.checkPaymentsStat().empty());
+}
+
+void tst_TransactionsDBStorage::tstDBWriter() {
+    if (QFile::exists(transactions::databaseFileName))
+        QFile::remove(transactions::databaseFileName);
+    transactions::TransactionsDBStorage db;
+    db.init();
+
+    std::vector<transactions::Transaction> txs(50);
+    for (size_t i = 0; i < txs.size(); i++) {
+        txs[i].currency = "mh";
+        txs[i].address = "address1";
+        txs[i].tx = QString("tx%1").arg(i);
+        txs[i].from = "user1";
+        txs[i].to = "address1";
+        txs[i].value = "100";
+        txs[i].fee = "1";
+        txs[i].timestamp = 1000 + i;
+        txs[i].blockNumber = 10 + i;
+    }
+
+    size_t countOk = 0;
+    size_t countErrors = 0;
+    bool isDroppedCalled = false;
+    {
+        const QString path = db.dbPath();
+        DBWriter writer([path]{
+            auto storage = std::make_unique<transactions::TransactionsDBStorage>(path, "payments_writer");
+            storage->initConnection();
+            return storage;
+        }, 20ms, 8);
+        // The first write holds the writer thread until all payments are queued, so they are commited in full batches
+        std::promise<void> queued;
+        const std::shared_future<void> isQueued = queued.get_future().share();
+        writer.write([isQueued](DBStorage &/*storage*/) {
+            isQueued.wait();
+        }, nullptr);
+        for (size_t i = 0; i < txs.size(); i++) {
+            const transactions::Transaction tx = txs[i];
+            writer.write([tx, i](DBStorage &storage) {
+                auto &txStorage = static_cast<transactions::TransactionsDBStorage&>(storage);
+                txStorage.addPayment(tx);
+                if (i % 10 == 5) {
+                    // Payment of the failed write is rolled back, neighbours in the same commit are kept
+                    throwErr("Write error");
+                }
+            }, [&countOk, &countErrors](const TypedException &exception) {
+                if (exception.isSet()) {
+                    countErrors++;
+                } else {
+                    countOk++;
+                }
+            });
+        }
+        queued.set_value();
+        writer.flush();
+        QCOMPARE(countOk, size_t(45));
+        QCOMPARE(countErrors, size_t(5));
+        QVERIFY(writer.getStats().countCommits < txs.size());
+        QCOMPARE(writer.getStats().maxBatch, size_t(8));
+
+        // Reads on the main connection see commited writes
+        QCOMPARE(db.getPaymentsCountForAddress("address1", "mh"), 45);
+        QCOMPARE(db.getPaymentsForAddress("address1", "mh", 0, -1, true).size(), size_t(45));
+
+        std::promise<void> dropped;
+        const std::shared_future<void> isDropped = dropped.get_future().share();
+        writer.write([isDropped](DBStorage &/*storage*/) {
+            isDropped.wait();
+        }, nullptr);
+        writer.write([&txs](DBStorage &storage) {
+            auto &txStorage = static_cast<transactions::TransactionsDBStorage&>(storage);
+            txStorage.addPayment(txs[5]);
+        }, [&isDroppedCalled](const TypedException &/*exception*/) {
+            isDroppedCalled = true;
+        });
+        writer.dropCommitedCallbacks();
+        dropped.set_value();
+    }
+    // Destructor commits the queue, dropped callbacks are not called
+    QCOMPARE(db.getPaymentsCountForAddress("address1", "mh"), 46);
+    QCOMPARE(isDroppedCalled, false);
+    QVERIFY(db.checkPaymentsStat().empty());
+}
+
 QTEST_MAIN(tst_TransactionsDBStorage)
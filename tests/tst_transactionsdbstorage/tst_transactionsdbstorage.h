@@ -14,6 +14,8 @@ private slots:
     void testDB1();
     void testBigNumSum();
     void testGetPayments();
+    void testGetPaymentsCursor();
+    void testGetPaymentsCursorPlan();
     void testAddressInfos();
     void testBlockNumer();
 
@@ -23,6 +25,16 @@ private slots:
 
     void tstCurrency();
 
+    void tstBinaryAmounts();
+    void tstBinaryAmountsBalance();
+    void tstAmountsEncoding();
+
+    void tstHistoryBackfill();
+
+    void tstPaymentsStat();
+
+    void tstDBWriter();
+
 private:
 };
 
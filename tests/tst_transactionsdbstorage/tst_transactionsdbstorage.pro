@@ -13,7 +13,9 @@ INCLUDEPATH = ../../src ../../src/transactions
 SOURCES += \
     tst_transactionsdbstorage.cpp \
     ../../src/dbstorage.cpp \
-    ../../src/utilites/BigNumber.cpp \
+    ../../src/dbwriter.cpp \
+    ../../src/TypedException.cpp \
+    ../../src/utilites/BigNumber256.cpp \
     ../LogMock.cpp \
     ../../src/transactions/TransactionsDBStorage.cpp
 
@@ -21,7 +23,9 @@ SOURCES += \
 HEADERS += \
     tst_transactionsdbstorage.h \
     ../../src/dbstorage.h \
-    ../../src/utilites/BigNumber.h \
+    ../../src/dbwriter.h \
+    ../../src/TypedException.h \
+    ../../src/utilites/BigNumber256.h \
     ../../src/Log.h \
     ../../src/transactions/TransactionsDBStorage.h
 
@@ -2,7 +2,10 @@
 
 #include <QTest>
 
+#include <algorithm>
+
 #include "Wallets/BtcWallet.h"
+#include "Wallets/BtcCoinSelection.h"
 #include "Wallets/btctx/wif.h"
 
 #include "utilites/utils.h"
@@ -245,6 +248,197 @@ void tst_Bitcoin::testReduceUtxosBtc() {
     }
 }
 
+void tst_Bitcoin::testCoinSelectionBtc_data() {
+    QTest::addColumn<QVariantList>("balances");
+    QTest::addColumn<unsigned long long>("target");
+    QTest::addColumn<unsigned long long>("feePerInput");
+    QTest::addColumn<unsigned long long>("costOfChange");
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<bool>("isFound");
+    QTest::addColumn<unsigned long long>("value");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("selectedAlgorithm");
+
+    const int bnb = (int)wallets::CoinSelectionAlgorithm::BranchAndBound;
+    const int knapsack = (int)wallets::CoinSelectionAlgorithm::Knapsack;
+    const int largestFirst = (int)wallets::CoinSelectionAlgorithm::LargestFirst;
+    const int autoAlg = (int)wallets::CoinSelectionAlgorithm::Auto;
+
+    QTest::newRow("CoinSelection bnb exact")
+        << QVariantList{1000ULL, 2000ULL, 5000ULL, 10000ULL, 20000ULL}
+        << 17000ULL << 0ULL << 0ULL << bnb
+        << true << 17000ULL << 3 << bnb;
+    QTest::newRow("CoinSelection bnb fee per input")
+        << QVariantList{1100ULL, 2100ULL, 5100ULL, 10100ULL}
+        << 17000ULL << 100ULL << 0ULL << bnb
+        << true << 17300ULL << 3 << bnb;
+    QTest::newRow("CoinSelection bnb cost of change")
+        << QVariantList{1000ULL, 2000ULL, 5000ULL, 10000ULL, 20000ULL}
+        << 16500ULL << 0ULL << 600ULL << bnb
+        << true << 17000ULL << 3 << bnb;
+    QTest::newRow("CoinSelection bnb not found")
+        << QVariantList{3000ULL, 7000ULL}
+        << 5000ULL << 0ULL << 0ULL << bnb
+        << false << 0ULL << 0 << autoAlg;
+    QTest::newRow("CoinSelection knapsack lowest larger")
+        << QVariantList{3000ULL, 7000ULL}
+        << 5000ULL << 0ULL << 0ULL << knapsack
+        << true << 7000ULL << 1 << knapsack;
+    QTest::newRow("CoinSelection knapsack subset")
+        << QVariantList{1500ULL, 2500ULL, 4000ULL, 9000ULL}
+        << 6500ULL << 0ULL << 500ULL << knapsack
+        << true << 6500ULL << 2 << knapsack;
+    QTest::newRow("CoinSelection largest first")
+        << QVariantList{1000ULL, 2000ULL, 3000ULL, 4000ULL}
+        << 6000ULL << 0ULL << 0ULL << largestFirst
+        << true << 7000ULL << 2 << largestFirst;
+    QTest::newRow("CoinSelection largest first skips dust")
+        << QVariantList{1000ULL, 2000ULL, 8000ULL}
+        << 6000ULL << 1500ULL << 0ULL << largestFirst
+        << true << 8000ULL << 1 << largestFirst;
+    QTest::newRow("CoinSelection auto bnb")
+        << QVariantList{3000ULL, 7000ULL, 2000ULL}
+        << 5000ULL << 0ULL << 0ULL << autoAlg
+        << true << 5000ULL << 2 << bnb;
+    QTest::newRow("CoinSelection auto fallback")
+        << QVariantList{3000ULL, 7000ULL}
+        << 5000ULL << 0ULL << 0ULL << autoAlg
+        << true << 7000ULL << 1 << largestFirst;
+    QTest::newRow("CoinSelection not enough")
+        << QVariantList{1000ULL, 2000ULL}
+        << 5000ULL << 0ULL << 0ULL << autoAlg
+        << false << 0ULL << 0 << autoAlg;
+}
+
+void tst_Bitcoin::testCoinSelectionBtc() {
+    QFETCH(QVariantList, balances);
+    QFETCH(unsigned long long, target);
+    QFETCH(unsigned long long, feePerInput);
+    QFETCH(unsigned long long, costOfChange);
+    QFETCH(int, algorithm);
+    QFETCH(bool, isFound);
+    QFETCH(unsigned long long, value);
+    QFETCH(int, count);
+    QFETCH(int, selectedAlgorithm);
+
+    std::vector<BtcInput> utxos;
+    for (const QVariant &balance: balances) {
+        utxos.emplace_back(balance.toULongLong());
+    }
+
+    wallets::CoinSelectionParams params;
+    params.target = target;
+    params.feePerInput = feePerInput;
+    params.costOfChange = costOfChange;
+
+    wallets::CoinSelectionResult result;
+    QCOMPARE(wallets::selectCoins(utxos, params, (wallets::CoinSelectionAlgorithm)algorithm, result), isFound);
+    QCOMPARE((unsigned long long)result.value, value);
+    QCOMPARE((int)result.indexes.size(), count);
+    QCOMPARE((int)result.algorithm, selectedAlgorithm);
+    if (isFound) {
+        QVERIFY(result.effectiveValue >= target);
+        QVERIFY(std::is_sorted(result.indexes.begin(), result.indexes.end()));
+    }
+}
+
+static uint64_t readVarInt(const std::string &tx, size_t &pos) {
+    const uint8_t first = tx.at(pos++);
+    CHECK(first < 0xfd, "Long varint in test transaction");
+    return first;
+}
+
+// Values of the outputs of a not witness transaction
+static std::vector<uint64_t> parseOutputsBtc(const std::string &txHex) {
+    const std::string tx = fromHex(txHex);
+    size_t pos = 4;
+    const uint64_t inputsCount = readVarInt(tx, pos);
+    for (uint64_t i = 0; i < inputsCount; i++) {
+        pos += 32 + 4;
+        pos += readVarInt(tx, pos);
+        pos += 4;
+    }
+    std::vector<uint64_t> outputs;
+    const uint64_t outputsCount = readVarInt(tx, pos);
+    for (uint64_t i = 0; i < outputsCount; i++) {
+        uint64_t value = 0;
+        for (size_t j = 0; j < 8; j++) {
+            value |= uint64_t(uint8_t(tx.at(pos + j))) << (8 * j);
+        }
+        pos += 8;
+        pos += readVarInt(tx, pos);
+        outputs.emplace_back(value);
+    }
+    return outputs;
+}
+
+void tst_Bitcoin::testBuildTransactionBtc_data() {
+    QTest::addColumn<QVariantList>("balances");
+    QTest::addColumn<std::string>("value");
+    QTest::addColumn<std::string>("fees");
+    QTest::addColumn<QVariantList>("used");
+    QTest::addColumn<unsigned long long>("fee");
+    QTest::addColumn<int>("outputs");
+
+    QTest::newRow("BuildTransaction exact")
+        << QVariantList{5000ULL, 12000ULL, 18000ULL, 40000ULL}
+        << std::string("20000") << std::string("10000")
+        << QVariantList{1, 2} << 10000ULL << 1;
+    QTest::newRow("BuildTransaction change")
+        << QVariantList{100000ULL, 5000ULL}
+        << std::string("20000") << std::string("10000")
+        << QVariantList{0} << 10000ULL << 2;
+    QTest::newRow("BuildTransaction dust change to fees")
+        << QVariantList{30300ULL, 5000ULL}
+        << std::string("20000") << std::string("10000")
+        << QVariantList{0} << 10300ULL << 1;
+    QTest::newRow("BuildTransaction change above dust")
+        << QVariantList{30600ULL, 5000ULL}
+        << std::string("20000") << std::string("10000")
+        << QVariantList{0} << 10000ULL << 2;
+    QTest::newRow("BuildTransaction fees not above value")
+        << QVariantList{20100ULL}
+        << std::string("10000") << std::string("9800")
+        << QVariantList{0} << 9800ULL << 2;
+}
+
+void tst_Bitcoin::testBuildTransactionBtc() {
+    QFETCH(QVariantList, balances);
+    QFETCH(std::string, value);
+    QFETCH(std::string, fees);
+    QFETCH(QVariantList, used);
+    QFETCH(unsigned long long, fee);
+    QFETCH(int, outputs);
+
+    std::vector<BtcInput> utxos;
+    uint64_t inputsValue = 0;
+    for (int i = 0; i < balances.size(); i++) {
+        BtcInput input(balances[i].toULongLong());
+        input.spendtxid = std::string(64, "0123456789abcdef"[i + 1]);
+        input.spendoutnum = 0;
+        input.scriptPubkey = "76a9145e05738474a2d065b554bd8564857e166031570688ac";
+        utxos.emplace_back(input);
+    }
+    std::set<std::string> usedAnswer;
+    for (const QVariant &index: used) {
+        usedAnswer.insert(utxos[index.toInt()].spendtxid);
+        inputsValue += utxos[index.toInt()].outBalance;
+    }
+
+    BtcWallet wallet(std::string("cUzkK2uj56xSuwY2Ha9TMjKgwPr1uBwNKXbSB3eGbcSbZ77YwQRG"));
+    const auto result = wallet.buildTransaction(utxos, 0, value, fees, "mkDQ29a4WtweYxagdhwuTx8P6BtsTnkJwi");
+    QCOMPARE(result.second, usedAnswer);
+
+    const std::vector<uint64_t> outputsValues = parseOutputsBtc(result.first);
+    QCOMPARE((int)outputsValues.size(), outputs);
+    QCOMPARE((unsigned long long)outputsValues[0], std::stoull(value));
+    uint64_t outputsValue = 0;
+    for (const uint64_t output: outputsValues) {
+        outputsValue += output;
+    }
+    QCOMPARE((unsigned long long)(inputsValue - outputsValue), fee);
+}
+
 void tst_Bitcoin::testNotCreateBtcTransaction_data() {
     QTest::addColumn<std::string>("wif");
     QTest::addColumn<std::string>("address");
@@ -17,6 +17,12 @@ private slots:
     void testReduceUtxosBtc_data();
     void testReduceUtxosBtc();
 
+    void testCoinSelectionBtc_data();
+    void testCoinSelectionBtc();
+
+    void testBuildTransactionBtc_data();
+    void testBuildTransactionBtc();
+
     void testHashBtc_data();
     void testHashBtc();
 
@@ -2,8 +2,11 @@
 
 #include <QTest>
 
+#include <vector>
+
 #include "Wallets/EthWallet.h"
 #include "Wallets/btctx/wif.h"
+#include "Wallets/ethtx/scrypt/libscrypt.h"
 
 #include "utilites/utils.h"
 #include "check.h"
@@ -132,3 +135,53 @@ void tst_Ethereum::testHashEth() {
     const std::string result = EthWallet::calcHash(transaction);
     QCOMPARE(result, answer);
 }
+
+void tst_Ethereum::testScrypt_data() {
+    QTest::addColumn<std::string>("passwd");
+    QTest::addColumn<std::string>("salt");
+    QTest::addColumn<quint64>("n");
+    QTest::addColumn<uint32_t>("r");
+    QTest::addColumn<uint32_t>("p");
+    QTest::addColumn<std::string>("answer");
+
+    // RFC 7914, section 12
+    QTest::newRow("scrypt 1")
+        << std::string("") << std::string("") << quint64(16) << uint32_t(1) << uint32_t(1)
+        << std::string("77d6576238657b203b19ca42c18a0497f16b4844e3074ae8dfdffa3fede21442fcd0069ded0948f8326a753a0fc81f17e8d3e0fb2e0d3628cf35e20c38d18906");
+
+    QTest::newRow("scrypt 2")
+        << std::string("password") << std::string("NaCl") << quint64(1024) << uint32_t(8) << uint32_t(16)
+        << std::string("fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b3731622eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdfa2cc0640");
+
+    QTest::newRow("scrypt 3")
+        << std::string("pleaseletmein") << std::string("SodiumChloride") << quint64(16384) << uint32_t(8) << uint32_t(1)
+        << std::string("7023bdcb3afd7348461c06cd81fd38ebfda8fbba904f8e3ea9b543f6545da1f2d5432955613f0fcf62d49705242a9af9e61e85dc0d651e40dfcf017b45575887");
+}
+
+void tst_Ethereum::testScrypt() {
+    QFETCH(std::string, passwd);
+    QFETCH(std::string, salt);
+    QFETCH(quint64, n);
+    QFETCH(uint32_t, r);
+    QFETCH(uint32_t, p);
+    QFETCH(std::string, answer);
+
+    std::vector<libscrypt_smix_t> kernels = {libscrypt_smix_nosse};
+#ifdef LIBSCRYPT_HAVE_SSE
+    if (libscrypt_cpu_has_sse2()) {
+        kernels.emplace_back(libscrypt_smix_sse2);
+    }
+#endif
+
+    for (const libscrypt_smix_t kernel: kernels) {
+        std::string result(answer.size() / 2, 0);
+        const int res = libscrypt_scrypt_smix(kernel, (const uint8_t*)passwd.data(), passwd.size(), (const uint8_t*)salt.data(), salt.size(), n, r, p, (uint8_t*)&result[0], result.size());
+        QCOMPARE(res, 0);
+        QCOMPARE(toHex(result), answer);
+    }
+
+    std::string result(answer.size() / 2, 0);
+    const int res = libscrypt_scrypt((const uint8_t*)passwd.data(), passwd.size(), (const uint8_t*)salt.data(), salt.size(), n, r, p, (uint8_t*)&result[0], result.size());
+    QCOMPARE(res, 0);
+    QCOMPARE(toHex(result), answer);
+}
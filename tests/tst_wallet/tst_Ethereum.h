@@ -21,6 +21,9 @@ private slots:
     void testNotCreateEthTransaction_data();
     void testNotCreateEthTransaction();
 
+    void testScrypt_data();
+    void testScrypt();
+
 };
 
 #endif // TST_ETHEREUM_H
@@ -2,7 +2,11 @@
 
 #include <QTest>
 
+#include <algorithm>
+
 #include "Wallets/Wallet.h"
+#include "Wallets/SignSessions.h"
+#include "Wallets/WalletsIndex.h"
 
 #include "utilites/utils.h"
 #include "check.h"
@@ -211,6 +215,145 @@ void tst_Metahash::testMthSignTransaction() {
     QCOMPARE(res2, false);
 }
 
+void tst_Metahash::testSignSessions() {
+    std::string tmp;
+    std::string address;
+    createFolder("./mhc");
+    Wallet::createWallet("./", true, "123", tmp, address);
+
+    wallets::SignSessions sessions;
+    const time_point start = ::now();
+    QVERIFY_EXCEPTION_THROWN(sessions.unlock("./", true, address, "1234", 60s, start), TypedException);
+    QVERIFY_EXCEPTION_THROWN(sessions.unlock("./", true, address, "123", 2h, start), TypedException);
+    QCOMPARE(sessions.size(), size_t(0));
+
+    sessions.unlock("./", true, address, "123", 60s, start);
+    QCOMPARE(sessions.isUnlocked("./", true, address, start + 30s), true);
+
+    const auto wallet1 = sessions.getWallet("./", true, address, "123", start + 30s);
+    const auto wallet2 = sessions.getWallet("./", true, address, "123", start + 30s);
+    QCOMPARE(wallet1.get(), wallet2.get());
+    QVERIFY_EXCEPTION_THROWN(sessions.getWallet("./", true, address, "1234", start + 30s), TypedException);
+
+    std::string pubkey;
+    std::string tx;
+    std::string signature;
+    wallet1->sign(address, 1000, 0, 1, "", tx, signature, pubkey);
+    QCOMPARE(Wallet::verify(fromHex(tx), signature, pubkey), true);
+
+    const auto wallet3 = sessions.getWallet("./", true, address, "123", start + 90s);
+    QVERIFY(wallet3.get() != wallet1.get());
+    sessions.removeExpired(start + 90s);
+    QCOMPARE(sessions.size(), size_t(0));
+
+    sessions.unlock("./", true, address, "123", 60s, start);
+    sessions.lockAll();
+    QCOMPARE(sessions.isUnlocked("./", true, address, start), false);
+}
+
+void tst_Metahash::testWalletsIndex() {
+    const QString folder = "./index";
+    removeFolder(folder);
+    createFolder(makePath(folder, Wallet::chooseSubfolder(true)));
+
+    std::vector<std::string> addresses(3);
+    for (std::string &address: addresses) {
+        std::string tmp;
+        Wallet::createWallet(folder, true, "123", tmp, address);
+    }
+    std::sort(addresses.begin(), addresses.end());
+    writeToFile(makePath(folder, Wallet::chooseSubfolder(true), "not_wallet.txt"), "1", false);
+
+    size_t countParsed = 0;
+    const auto parse = [&](const QString &fileName, wallets::WalletInfo &info) {
+        countParsed++;
+        return Wallet::parseWalletFileName(folder, true, fileName, info);
+    };
+    const QString subfolder = makePath(folder, Wallet::chooseSubfolder(true));
+
+    wallets::WalletsIndex index;
+    QCOMPARE(index.contains(wallets::WalletCurrency::Mth), false);
+    QCOMPARE(index.sync(wallets::WalletCurrency::Mth, subfolder, parse).added.size(), size_t(3));
+    QCOMPARE(countParsed, size_t(4));
+    QCOMPARE(index.size(wallets::WalletCurrency::Mth), size_t(3));
+    QVERIFY_EXCEPTION_THROWN(index.size(wallets::WalletCurrency::Tmh), Exception);
+
+    QString next;
+    const std::vector<wallets::WalletInfo> page1 = index.getPage(wallets::WalletCurrency::Mth, "", 2, next);
+    QCOMPARE(page1.size(), size_t(2));
+    QCOMPARE(page1[0].address.toStdString(), addresses[0]);
+    QCOMPARE(next, page1[1].address);
+    const std::vector<wallets::WalletInfo> page2 = index.getPage(wallets::WalletCurrency::Mth, next, 2, next);
+    QCOMPARE(page2.size(), size_t(1));
+    QCOMPARE(page2[0].address.toStdString(), addresses[2]);
+    QCOMPARE(next, QString(""));
+
+    // Nothing changed, nothing parsed
+    const wallets::WalletsIndex::Changes changes1 = index.sync(wallets::WalletCurrency::Mth, subfolder, parse);
+    QCOMPARE(changes1.added.size() + changes1.removed.size(), size_t(0));
+    QCOMPARE(countParsed, size_t(4));
+
+    removeFile(Wallet::makeFullWalletPath(folder, true, addresses[1]));
+    Wallet::createWalletWatch(folder, true, addresses[1]);
+    const wallets::WalletsIndex::Changes changes2 = index.sync(wallets::WalletCurrency::Mth, subfolder, parse);
+    QCOMPARE(changes2.removed.size(), size_t(1));
+    QCOMPARE(changes2.removed[0].type, wallets::WalletInfo::Type::Key);
+    QCOMPARE(changes2.added.size(), size_t(1));
+    QCOMPARE(changes2.added[0].type, wallets::WalletInfo::Type::Watch);
+    QCOMPARE(countParsed, size_t(5));
+
+    // Already known wallets are not reported
+    Wallet::removeWalletWatch(folder, true, addresses[1]);
+    index.remove(wallets::WalletCurrency::Mth, QString::fromStdString(addresses[1]), wallets::WalletInfo::Type::Watch);
+    QCOMPARE(index.sync(wallets::WalletCurrency::Mth, subfolder, parse).removed.size(), size_t(0));
+    QCOMPARE(index.getAll(wallets::WalletCurrency::Mth).size(), size_t(2));
+}
+
+void tst_Metahash::testWalletsIndexKeyAndWatch() {
+    const QString folder = "./index2";
+    removeFolder(folder);
+    createFolder(makePath(folder, Wallet::chooseSubfolder(true)));
+
+    std::string address;
+    std::string tmp;
+    Wallet::createWallet(folder, true, "123", tmp, address);
+    Wallet::createWalletWatch(folder, true, address);
+    const QString addr = QString::fromStdString(address);
+
+    const auto parse = [&](const QString &fileName, wallets::WalletInfo &info) {
+        return Wallet::parseWalletFileName(folder, true, fileName, info);
+    };
+    const QString subfolder = makePath(folder, Wallet::chooseSubfolder(true));
+
+    wallets::WalletsIndex index;
+    QCOMPARE(index.sync(wallets::WalletCurrency::Mth, subfolder, parse).added.size(), size_t(1));
+    QCOMPARE(index.getAll(wallets::WalletCurrency::Mth)[0].type, wallets::WalletInfo::Type::Key);
+
+    // Removed watch wallet does not take the key wallet with it
+    Wallet::removeWalletWatch(folder, true, address);
+    index.remove(wallets::WalletCurrency::Mth, addr, wallets::WalletInfo::Type::Watch);
+    QCOMPARE(index.size(wallets::WalletCurrency::Mth), size_t(1));
+    const wallets::WalletsIndex::Changes changes1 = index.sync(wallets::WalletCurrency::Mth, subfolder, parse);
+    QCOMPARE(changes1.added.size() + changes1.removed.size(), size_t(0));
+    QCOMPARE(index.getAll(wallets::WalletCurrency::Mth)[0].type, wallets::WalletInfo::Type::Key);
+
+    // Watch wallet of the same address takes place of the removed key wallet
+    Wallet::createWalletWatch(folder, true, address);
+    QCOMPARE(index.sync(wallets::WalletCurrency::Mth, subfolder, parse).added.size(), size_t(0));
+    removeFile(Wallet::makeFullWalletPath(folder, true, address));
+    const wallets::WalletsIndex::Changes changes2 = index.sync(wallets::WalletCurrency::Mth, subfolder, parse);
+    QCOMPARE(changes2.removed.size(), size_t(1));
+    QCOMPARE(changes2.removed[0].type, wallets::WalletInfo::Type::Key);
+    QCOMPARE(changes2.added.size(), size_t(1));
+    QCOMPARE(changes2.added[0].type, wallets::WalletInfo::Type::Watch);
+    QCOMPARE(changes2.added[0].address, addr);
+
+    // Removal of other type does not touch the wallet
+    index.remove(wallets::WalletCurrency::Mth, addr, wallets::WalletInfo::Type::Key);
+    QCOMPARE(index.size(wallets::WalletCurrency::Mth), size_t(1));
+    QCOMPARE(index.getAll(wallets::WalletCurrency::Mth)[0].type, wallets::WalletInfo::Type::Watch);
+}
+
 void tst_Metahash::testHashMth_data() {
     QTest::addColumn<std::string>("transaction");
     QTest::addColumn<std::string>("sign");
@@ -31,6 +31,12 @@ private slots:
     void testMthSignTransaction_data();
     void testMthSignTransaction();
 
+    void testSignSessions();
+
+    void testWalletsIndex();
+
+    void testWalletsIndexKeyAndWatch();
+
     void testHashMth_data();
     void testHashMth();
 
@@ -0,0 +1,231 @@
+#include "tst_ThreadPool.h"
+
+#include <QTest>
+
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+#include <algorithm>
+
+#include "utilites/ThreadPool.h"
+#include "utilites/utils.h"
+#include "Wallets/WalletRsa.h"
+#include "Wallets/openssl_wrapper/openssl_wrapper.h"
+#include "Messenger/DecryptMessages.h"
+
+#include "TypedException.h"
+
+using namespace messenger;
+
+tst_ThreadPool::tst_ThreadPool(QObject *parent)
+    : QObject(parent)
+{
+    if (!isInitOpenSSL()) {
+        InitOpenSSL();
+    }
+}
+
+void tst_ThreadPool::testParallelForChunks_data() {
+    QTest::addColumn<size_t>("countThreads");
+    QTest::addColumn<size_t>("count");
+
+    for (const size_t countThreads: {0, 1, 3, 7}) {
+        for (const size_t count: {0, 1, 2, 3, 4, 5, 8, 17, 100, 1001}) {
+            QTest::newRow(QString("threads %1 count %2").arg(countThreads).arg(count).toStdString().c_str())
+                << countThreads << count;
+        }
+    }
+}
+
+void tst_ThreadPool::testParallelForChunks() {
+    QFETCH(size_t, countThreads);
+    QFETCH(size_t, count);
+
+    ThreadPool pool(countThreads);
+    QCOMPARE(pool.size(), countThreads);
+
+    std::mutex mut;
+    std::vector<std::pair<size_t, size_t>> chunks;
+    std::vector<int> visited(count, 0);
+    bool isFirstInCallingThread = false;
+    const std::thread::id callingThread = std::this_thread::get_id();
+    pool.parallelFor(count, [&](size_t begin, size_t end) {
+        std::lock_guard<std::mutex> lock(mut);
+        chunks.emplace_back(begin, end);
+        for (size_t i = begin; i < end; i++) {
+            visited[i]++;
+        }
+        if (begin == 0) {
+            isFirstInCallingThread = std::this_thread::get_id() == callingThread;
+        }
+    });
+
+    if (count == 0) {
+        QCOMPARE(chunks.size(), size_t(0));
+        return;
+    }
+    QCOMPARE(chunks.size(), std::min(count, countThreads + 1));
+    QCOMPARE(isFirstInCallingThread, true);
+
+    // Chunks are contiguous, not empty and differ in size at most by one
+    std::sort(chunks.begin(), chunks.end());
+    QCOMPARE(chunks.front().first, size_t(0));
+    QCOMPARE(chunks.back().second, count);
+    size_t minSize = count;
+    size_t maxSize = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        QVERIFY(chunks[i].first < chunks[i].second);
+        if (i != 0) {
+            QCOMPARE(chunks[i].first, chunks[i - 1].second);
+        }
+        minSize = std::min(minSize, chunks[i].second - chunks[i].first);
+        maxSize = std::max(maxSize, chunks[i].second - chunks[i].first);
+    }
+    QVERIFY(maxSize - minSize <= 1);
+    QCOMPARE(visited, std::vector<int>(count, 1));
+}
+
+void tst_ThreadPool::testParallelForException() {
+    ThreadPool pool(3);
+
+    const auto runThrowing = [&pool](const std::function<bool(size_t begin)> &isThrow) -> std::string {
+        try {
+            pool.parallelFor(100, [&isThrow](size_t begin, size_t /*end*/) {
+                if (isThrow(begin)) {
+                    throw std::runtime_error(std::to_string(begin));
+                }
+            });
+        } catch (const std::runtime_error &e) {
+            return e.what();
+        }
+        return "";
+    };
+
+    // Exception of the first chunk wins
+    QCOMPARE(runThrowing([](size_t) { return true; }), std::string("0"));
+    QCOMPARE(runThrowing([](size_t begin) { return begin != 0; }), std::string("25"));
+    // Chunk in worker thread
+    QCOMPARE(runThrowing([](size_t begin) { return begin == 75; }), std::string("75"));
+    QCOMPARE(runThrowing([](size_t) { return false; }), std::string(""));
+
+    // Other chunks finish before rethrow, and pool stays usable
+    std::mutex mut;
+    size_t countDone = 0;
+    const auto throwFirst = [&](size_t begin, size_t end) {
+        if (begin == 0) {
+            throw std::runtime_error("first");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::lock_guard<std::mutex> lock(mut);
+        countDone += end - begin;
+    };
+    QVERIFY_EXCEPTION_THROWN(pool.parallelFor(100, throwFirst), std::runtime_error);
+    QCOMPARE(countDone, size_t(75));
+
+    std::vector<int> result(100, 0);
+    pool.parallelFor(result.size(), [&result](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            result[i] = static_cast<int>(i);
+        }
+    });
+    for (size_t i = 0; i < result.size(); i++) {
+        QCOMPARE(result[i], static_cast<int>(i));
+    }
+}
+
+static std::vector<Message> makeMessages(const WalletRsa &wallet, size_t count) {
+    std::vector<Message> messages;
+    for (size_t i = 0; i < count; i++) {
+        Message message;
+        message.isInput = true;
+        message.timestamp = i;
+        message.counter = static_cast<Message::Counter>(i);
+        message.fee = 0;
+        message.hash = QString::number(i);
+        if (i % 7 == 3) {
+            message.isChannel = true;
+            message.dataHex = QString::fromStdString(toHex("Channel message " + std::to_string(i)));
+        } else if (i % 11 == 5) {
+            message.isCanDecrypted = false;
+            message.dataHex = QString::fromStdString(wallet.encrypt("Not for this wallet " + std::to_string(i)));
+        } else if (i % 13 == 6) {
+            message.isDecrypted = true;
+            message.decryptedDataHex = QString::fromStdString(toHex("Decrypted before " + std::to_string(i)));
+        } else {
+            message.dataHex = QString::fromStdString(wallet.encrypt("Message number " + std::to_string(i)));
+        }
+        messages.emplace_back(message);
+    }
+    return messages;
+}
+
+static void createRsaWallet(const std::string &address, const std::string &password) {
+    createFolder("./mhc");
+    WalletRsa::createRsaKey("./", true, address, password);
+}
+
+void tst_ThreadPool::testDecryptParallel() {
+    const std::string address = "0x00decryptparallel";
+    const std::string password = "123";
+    createRsaWallet(address, password);
+    WalletRsa wallet("./", true, address);
+    wallet.unlock(password);
+
+    ThreadPool pool(3);
+    // Less than 16 messages are decrypted in calling thread, more on pool
+    for (const size_t count: {5, 16, 100}) {
+        const std::vector<Message> messages = makeMessages(wallet, count);
+
+        std::vector<Message> serial;
+        for (const Message &message: messages) {
+            serial.emplace_back(decryptOneMsg(message, &wallet, true));
+        }
+        const std::vector<Message> parallel = decryptMsg(pool, messages, &wallet, true);
+
+        QCOMPARE(parallel.size(), messages.size());
+        for (size_t i = 0; i < messages.size(); i++) {
+            QCOMPARE(parallel[i].hash, messages[i].hash);
+            QCOMPARE(parallel[i].counter, messages[i].counter);
+            QCOMPARE(parallel[i].isDecrypted, serial[i].isDecrypted);
+            QCOMPARE(parallel[i].decryptedDataHex, serial[i].decryptedDataHex);
+        }
+
+        for (size_t i = 0; i < messages.size(); i++) {
+            if (i % 7 == 3) {
+                QCOMPARE(parallel[i].decryptedDataHex.toStdString(), toHex("Channel message " + std::to_string(i)));
+            } else if (i % 11 == 5) {
+                QCOMPARE(parallel[i].isDecrypted, false);
+            } else if (i % 13 == 6) {
+                QCOMPARE(parallel[i].decryptedDataHex.toStdString(), toHex("Decrypted before " + std::to_string(i)));
+            } else {
+                QCOMPARE(parallel[i].isDecrypted, true);
+                QCOMPARE(parallel[i].decryptedDataHex.toStdString(), toHex("Message number " + std::to_string(i)));
+            }
+        }
+    }
+}
+
+void tst_ThreadPool::testDecryptParallelNotUnlock() {
+    const std::string address = "0x00decryptnotunlock";
+    const std::string password = "123";
+    createRsaWallet(address, password);
+    WalletRsa wallet("./", true, address);
+    wallet.unlock(password);
+
+    ThreadPool pool(3);
+    const std::vector<Message> messages = makeMessages(wallet, 100);
+
+    // Error of a chunk in worker thread reaches the caller
+    QVERIFY_EXCEPTION_THROWN(decryptMsg(pool, messages, nullptr, true), TypedException);
+
+    const std::vector<Message> result = decryptMsg(pool, messages, nullptr, false);
+    QCOMPARE(result.size(), messages.size());
+    for (size_t i = 0; i < messages.size(); i++) {
+        QCOMPARE(result[i].hash, messages[i].hash);
+        if (i % 7 == 3 || i % 13 == 6) {
+            QCOMPARE(result[i].isDecrypted, true);
+        } else {
+            QCOMPARE(result[i].isDecrypted, false);
+        }
+    }
+}
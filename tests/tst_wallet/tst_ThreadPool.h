@@ -0,0 +1,25 @@
+#ifndef TST_THREADPOOL_H
+#define TST_THREADPOOL_H
+
+#include <QObject>
+
+class tst_ThreadPool : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_ThreadPool(QObject *parent = nullptr);
+
+private slots:
+
+    void testParallelForChunks_data();
+    void testParallelForChunks();
+
+    void testParallelForException();
+
+    void testDecryptParallel();
+
+    void testDecryptParallelNotUnlock();
+
+};
+
+#endif // TST_THREADPOOL_H
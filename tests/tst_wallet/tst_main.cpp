@@ -6,6 +6,7 @@
 #include "tst_Bitcoin.h"
 #include "tst_Ethereum.h"
 #include "tst_Metahash.h"
+#include "tst_ThreadPool.h"
 
 int main(int argc, char *argv[]) {
     int status = 0;
@@ -21,6 +22,7 @@ int main(int argc, char *argv[]) {
     ASSERT_TEST(new tst_rsa());
     ASSERT_TEST(new tst_Bitcoin());
     ASSERT_TEST(new tst_Ethereum());
+    ASSERT_TEST(new tst_ThreadPool());
 
     return status;
 }
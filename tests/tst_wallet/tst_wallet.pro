@@ -12,8 +12,11 @@ INCLUDEPATH = ../../src
 
 SOURCES += \
     ../../src/Wallets/Wallet.cpp \
+    ../../src/Wallets/SignSessions.cpp \
+    ../../src/Wallets/WalletsIndex.cpp \
     ../../src/Wallets/EthWallet.cpp \
     ../../src/Wallets/ethtx/scrypt/crypto_scrypt-nosse.cpp \
+    ../../src/Wallets/ethtx/scrypt/crypto_scrypt-sse.cpp \
     ../../src/Wallets/ethtx/scrypt/sha256.cpp \
     ../../src/Wallets/ethtx/cert.cpp \
     ../../src/Wallets/ethtx/rlp.cpp \
@@ -25,8 +28,12 @@ SOURCES += \
     ../../src/Wallets/btctx/btctx.cpp \
     ../../src/Wallets/btctx/wif.cpp \
     ../../src/Wallets/BtcWallet.cpp \
+    ../../src/Wallets/BtcCoinSelection.cpp \
     ../../src/Wallets/openssl_wrapper/openssl_wrapper.cpp \
     ../../src/utilites/utils.cpp \
+    ../../src/utilites/ThreadPool.cpp \
+    ../../src/Wallets/WalletRsa.cpp \
+    ../../src/Messenger/DecryptMessages.cpp \
     ../../src/Wallets/ethtx/utils2.cpp \
     ../../src/Wallets/WalletInfo.cpp \
     ../LogMock.cpp \
@@ -34,13 +41,15 @@ SOURCES += \
     tst_Bitcoin.cpp \
     tst_Ethereum.cpp \
     tst_rsa.cpp \
+    tst_ThreadPool.cpp \
     tst_main.cpp
 
 HEADERS += \
     tst_Metahash.h \
     tst_Bitcoin.h \
     tst_Ethereum.h \
-    tst_rsa.h
+    tst_rsa.h \
+    tst_ThreadPool.h
 
 DEFINES += CRYPTOPP_IMPORTS
 DEFINES += QUAZIP_STATIC
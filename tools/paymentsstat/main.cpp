@@ -0,0 +1,46 @@
+#include <QCoreApplication>
+#include <QStringList>
+
+#include <iostream>
+
+#include "TransactionsDBStorage.h"
+#include "check.h"
+
+// Compares maintained payments counters and sums with a recount over payments table.
+// Usage: paymentsstat <directory with payments.db> [--fix]
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const QStringList args = a.arguments();
+    if (args.size() < 2) {
+        std::cout << "Usage: paymentsstat <directory with payments.db> [--fix]" << std::endl;
+        return 2;
+    }
+    const bool isFix = args.contains("--fix");
+
+    try {
+        transactions::TransactionsDBStorage db(args[1]);
+        db.init();
+
+        const auto mismatches = db.checkPaymentsStat();
+        for (const auto &pair: mismatches) {
+            std::cout << pair.first.currency.toStdString() << " " << pair.first.address.toStdString()
+                      << ": stored " << pair.first.countTxs << "/" << pair.first.countPending
+                      << " " << pair.first.received.getDecimal().toStdString() << "/" << pair.first.spent.getDecimal().toStdString()
+                      << ", recounted " << pair.second.countTxs << "/" << pair.second.countPending
+                      << " " << pair.second.received.getDecimal().toStdString() << "/" << pair.second.spent.getDecimal().toStdString() << std::endl;
+        }
+        std::cout << "Mismatches: " << mismatches.size() << std::endl;
+
+        if (!mismatches.empty() && isFix) {
+            db.rebuildPaymentsStat();
+            std::cout << "Counters rebuilt" << std::endl;
+            return 0;
+        }
+        return mismatches.empty() ? 0 : 1;
+    } catch (const Exception &e) {
+        std::cout << "Error: " << e.message << std::endl;
+        return 2;
+    }
+}
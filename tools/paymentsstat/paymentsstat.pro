@@ -0,0 +1,27 @@
+QT -= gui
+QT += sql widgets
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+INCLUDEPATH = ../../src ../../src/transactions
+
+SOURCES += \
+    main.cpp \
+    ../../src/dbstorage.cpp \
+    ../../src/utilites/BigNumber256.cpp \
+    ../../tests/LogMock.cpp \
+    ../../src/transactions/TransactionsDBStorage.cpp
+
+
+HEADERS += \
+    ../../src/dbstorage.h \
+    ../../src/utilites/BigNumber256.h \
+    ../../src/Log.h \
+    ../../src/utilites/utils.h \
+    ../../src/transactions/TransactionsDBStorage.h
+
+QMAKE_LFLAGS += -rdynamic
+unix:!macx: include(../../libs-unix.pri)
+win32: include(../../libs-win.pri)
+macx: include(../../libs-macos.pri)